@@ -0,0 +1,376 @@
+/*
+ * eos_bench.c
+ *
+ *      Kernel microbenchmarks for EvanRTOS. The suite measures the cost of the core kernel operations in core clock
+ *      cycles (EOS_GetCycles()), so that kernel changes can be checked for regressions:
+ *
+ *      	context_switch: 	two equal priority tasks yielding to each other, measured from EOS_Suspend() in one
+ *      						task to the other task running.
+ *      	sem_ping_pong:		round trip of releasing a semaphore to a higher priority task, and acquiring the
+ *      						semaphore it releases back.
+ *      	queue_put_get:		one EOS_QueuePut() plus one EOS_QueueGet() on a queue, for several item sizes.
+ *      	isr_wakeup:			from EOS_BenchIsr() releasing a semaphore inside an interrupt, to the waiting task running.
+ *      	thread_new:			a call to EOS_ThreadNew() with a static stack, as the task list grows.
+ *      	tick:				time a busy task loses to each SysTick (tick handler and the PendSV that follows),
+ *      						versus the number of tasks in the kernel.
+ *
+ *      To run the suite, call EOS_BenchInit() instead of your usual EvanRTOS_Init(). Results are printed with printf,
+ *      one JSON object per line, containing the min/avg/max and 50th/90th/99th percentile of each benchmark. A final
+ *      {"bench":"done"} line marks the end of the run, after which EOS_BenchComplete() is called.
+ *
+ *      The isr_wakeup benchmark needs an interrupt to fire on demand. Provide EOS_BenchTriggerIsr() (for example
+ *      by pending an unused IRQ with NVIC_SetPendingIRQ()) and call EOS_BenchIsr() from that IRQ's handler. Without
+ *      it, the benchmark is reported as skipped.
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "eos_bench.h"
+#include "eos_semaphore.h"
+#include "eos_queue.h"
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_BenchController(void);
+static void EOS_BenchSwitchTask(void);
+static void EOS_BenchPongTask(void);
+static void EOS_BenchIsrTask(void);
+static void EOS_BenchParkedTask(void);
+static void EOS_BenchReport(const char* name, const char* param, uint32_t value, uint32_t n);
+
+
+/*	GLOBAL VARIABLES	*/
+static uint32_t samples[EOS_BENCH_SAMPLES];
+static volatile uint32_t sample_count = 0;
+static volatile uint32_t start_cycles = 0;
+
+static EOS_semaphore_id_t bench_done;
+static EOS_semaphore_id_t bench_ping;
+static EOS_semaphore_id_t bench_pong;
+static EOS_semaphore_id_t bench_isr;
+
+static EOS_task_id_t switch_a_handle;
+static EOS_task_id_t switch_b_handle;
+
+static int32_t controller_stack[512];
+static int32_t switch_a_stack[128];
+static int32_t switch_b_stack[128];
+static int32_t pong_stack[128];
+static int32_t isr_stack[128];
+static int32_t parked_stacks[EOS_BENCH_MAX_TASKS][64];
+
+static const uint32_t queue_item_sizes[] = {1, 4, 16, 64, 256};
+static uint8_t queue_item[256];
+
+
+
+/*	BENCHMARK SETUP		*/
+
+
+/**
+ * @brief Creates the benchmark tasks and starts EvanRTOS. Call this instead of EvanRTOS_Init().
+ *
+ * This function never returns, as it passes control over to EvanRTOS.
+ */
+void EOS_BenchInit(void){
+
+	bench_done = EOS_SemaphoreNew(1);
+	bench_ping = EOS_SemaphoreNew(1);
+	bench_pong = EOS_SemaphoreNew(1);
+	bench_isr = EOS_SemaphoreNew(1);
+
+	//semaphores start full, so take them once to start them empty
+	EOS_SemaphoreAcquire(bench_done);
+	EOS_SemaphoreAcquire(bench_ping);
+	EOS_SemaphoreAcquire(bench_pong);
+	EOS_SemaphoreAcquire(bench_isr);
+
+	EOS_ThreadNew(EOS_BenchController, PRIORITY_MEDIUM, controller_stack, 512, EOS_NO_FPU);
+	EOS_ThreadNew(EOS_BenchPongTask, PRIORITY_HIGH, pong_stack, 128, EOS_NO_FPU);
+	EOS_ThreadNew(EOS_BenchIsrTask, PRIORITY_HIGH, isr_stack, 128, EOS_NO_FPU);
+
+	//the switch tasks only run while the context switch benchmark is active
+	switch_a_handle = EOS_ThreadNew(EOS_BenchSwitchTask, PRIORITY_HIGH, switch_a_stack, 128, EOS_NO_FPU);
+	switch_b_handle = EOS_ThreadNew(EOS_BenchSwitchTask, PRIORITY_HIGH, switch_b_stack, 128, EOS_NO_FPU);
+	EOS_Pause(switch_a_handle);
+	EOS_Pause(switch_b_handle);
+
+	EOS_Init(DEFAULT_TASK_PERIOD);
+}
+
+
+/**
+ * @brief Called from the benchmark interrupt handler. Wakes the task waiting in the isr_wakeup benchmark.
+ */
+void EOS_BenchIsr(void){
+	start_cycles = EOS_GetCycles();
+	EOS_SemaphoreRelease(bench_isr);
+}
+
+
+/**
+ * @brief Fires the interrupt that calls EOS_BenchIsr(). Override this in your project to enable the isr_wakeup benchmark.
+ *
+ * @return 1 if an interrupt was triggered, 0 if not supported.
+ */
+__attribute__((weak)) uint8_t EOS_BenchTriggerIsr(void){
+	return 0;
+}
+
+
+
+/**
+ * @brief Called once every benchmark has run. Override this in your project to act on the end of the run.
+ */
+__attribute__((weak)) void EOS_BenchComplete(void){
+
+}
+
+
+
+/*	BENCHMARK TASKS		*/
+
+
+/**
+ * @brief Runs each benchmark in turn, and prints the results.
+ */
+static void EOS_BenchController(void){
+
+	/* context switch */
+	sample_count = 0;
+	EOS_Resume(switch_a_handle);
+	EOS_Resume(switch_b_handle);
+	EOS_SemaphoreAcquire(bench_done);
+	EOS_BenchReport("context_switch", NULL, 0, sample_count);
+
+
+	/* semaphore ping pong */
+	for (uint32_t i = 0; i < EOS_BENCH_SAMPLES; i++)
+	{
+		uint32_t start = EOS_GetCycles();
+		EOS_SemaphoreRelease(bench_ping);
+		EOS_SemaphoreAcquire(bench_pong);
+		samples[i] = EOS_GetCycles() - start;
+	}
+	EOS_BenchReport("sem_ping_pong", NULL, 0, EOS_BENCH_SAMPLES);
+
+
+	/* queue put/get by item size */
+	for (uint32_t s = 0; s < sizeof(queue_item_sizes) / sizeof(queue_item_sizes[0]); s++)
+	{
+		EOS_queue_id_t queue = EOS_QueueCreate(16, queue_item_sizes[s]);
+
+		if (queue == NULL)
+		{
+			continue;
+		}
+
+		for (uint32_t i = 0; i < EOS_BENCH_SAMPLES; i++)
+		{
+			uint32_t start = EOS_GetCycles();
+			for (uint32_t j = 0; j < 16; j++)
+			{
+				EOS_QueuePut(queue, queue_item, EOS_NO_BLOCK);
+			}
+			for (uint32_t j = 0; j < 16; j++)
+			{
+				EOS_QueueGet(queue, queue_item, EOS_NO_BLOCK);
+			}
+			samples[i] = (EOS_GetCycles() - start) / 16;
+		}
+		EOS_BenchReport("queue_put_get", "item_size", queue_item_sizes[s], EOS_BENCH_SAMPLES);
+	}
+
+
+	/* isr to task wakeup */
+	sample_count = 0;
+	for (uint32_t i = 0; i < EOS_BENCH_SAMPLES; i++)
+	{
+		if (EOS_BenchTriggerIsr() == 0)
+		{
+			break;
+		}
+
+		while (sample_count == i)
+		{
+			//the waiting task preempts us once the interrupt has fired
+		}
+	}
+
+	if (sample_count == 0)
+	{
+		printf("{\"bench\":\"isr_wakeup\",\"skipped\":true}\n");
+		fflush(stdout);
+	}
+	else
+	{
+		EOS_BenchReport("isr_wakeup", NULL, 0, sample_count);
+	}
+
+
+	/* EOS_ThreadNew and tick cost versus task count */
+	static const uint32_t task_points[] = {0, 8, 16, EOS_BENCH_MAX_TASKS};
+	static uint32_t create_samples[EOS_BENCH_MAX_TASKS];
+	uint32_t created = 0;
+
+	for (uint32_t p = 0; p < sizeof(task_points) / sizeof(task_points[0]); p++)
+	{
+		while (created < task_points[p])
+		{
+			uint32_t start = EOS_GetCycles();
+			EOS_task_id_t task = EOS_ThreadNew(EOS_BenchParkedTask, PRIORITY_LOW, parked_stacks[created], 64, EOS_NO_FPU);
+			create_samples[created] = EOS_GetCycles() - start;
+
+			EOS_Pause(task); //keep it in the task list without ever running
+			created++;
+		}
+
+		uint32_t n = 0;
+		uint32_t prev = EOS_GetCycles();
+		while (n < EOS_BENCH_SAMPLES)
+		{
+			uint32_t now = EOS_GetCycles();
+			if (now - prev > EOS_BENCH_TICK_GAP)
+			{
+				samples[n++] = now - prev;
+			}
+			prev = now;
+		}
+		EOS_BenchReport("tick", "extra_tasks", created, EOS_BENCH_SAMPLES);
+	}
+
+	uint32_t create_count = (created < EOS_BENCH_SAMPLES) ? created : EOS_BENCH_SAMPLES;
+	memcpy(samples, create_samples, create_count * sizeof(create_samples[0]));
+	EOS_BenchReport("thread_new", NULL, 0, create_count);
+
+
+	printf("{\"bench\":\"done\"}\n");
+	fflush(stdout);
+	EOS_BenchComplete();
+
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Two of these tasks, at the same priority, yield back and forth. Each one measures the switch from the other.
+ */
+static void EOS_BenchSwitchTask(void){
+
+	while (1)
+	{
+		start_cycles = EOS_GetCycles();
+		EOS_Suspend();
+		uint32_t now = EOS_GetCycles();
+
+		if (sample_count < EOS_BENCH_SAMPLES)
+		{
+			samples[sample_count++] = now - start_cycles;
+		}
+		else
+		{
+			EOS_Pause(run_ptr == switch_a_handle ? switch_b_handle : switch_a_handle);
+			EOS_SemaphoreRelease(bench_done);
+			EOS_Pause(run_ptr);
+		}
+	}
+}
+
+
+/**
+ * @brief Answers every ping with a pong.
+ */
+static void EOS_BenchPongTask(void){
+
+	while (1)
+	{
+		EOS_SemaphoreAcquire(bench_ping);
+		EOS_SemaphoreRelease(bench_pong);
+	}
+}
+
+
+/**
+ * @brief Measures the time from EOS_BenchIsr() to this task running.
+ */
+static void EOS_BenchIsrTask(void){
+
+	while (1)
+	{
+		EOS_SemaphoreAcquire(bench_isr);
+		uint32_t now = EOS_GetCycles();
+
+		if (sample_count < EOS_BENCH_SAMPLES)
+		{
+			samples[sample_count] = now - start_cycles;
+			sample_count++;
+		}
+	}
+}
+
+
+/**
+ * @brief Body of the tasks added for the tick benchmark. They are paused as soon as they are created.
+ */
+static void EOS_BenchParkedTask(void){
+
+	while (1)
+	{
+
+	}
+}
+
+
+
+/*	HELPER FUNCTIONS	*/
+
+
+/**
+ * @brief Sorts the first n samples, and prints their statistics as one line of JSON.
+ *
+ * @param name Name of the benchmark.
+ * @param param Name of an extra parameter to print (ie item size), or NULL.
+ * @param value Value of the extra parameter.
+ * @param n Number of samples.
+ */
+static void EOS_BenchReport(const char* name, const char* param, uint32_t value, uint32_t n){
+
+	if (n == 0)
+	{
+		return;
+	}
+
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		uint32_t key = samples[i];
+		uint32_t j = i;
+
+		while (j > 0 && samples[j - 1] > key)
+		{
+			samples[j] = samples[j - 1];
+			j--;
+		}
+		samples[j] = key;
+		sum += key;
+	}
+
+	printf("{\"bench\":\"%s\"", name);
+	if (param != NULL)
+	{
+		printf(",\"%s\":%lu", param, (unsigned long)value);
+	}
+	printf(",\"unit\":\"cycles\",\"n\":%lu,\"min\":%lu,\"avg\":%lu,\"max\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu}\n",
+			(unsigned long)n,
+			(unsigned long)samples[0],
+			(unsigned long)(sum / n),
+			(unsigned long)samples[n - 1],
+			(unsigned long)samples[(n - 1) * 50 / 100],
+			(unsigned long)samples[(n - 1) * 90 / 100],
+			(unsigned long)samples[(n - 1) * 99 / 100]);
+	fflush(stdout);
+}
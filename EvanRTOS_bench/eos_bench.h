@@ -0,0 +1,37 @@
+/*
+ * eos_bench.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_BENCH_H_
+#define INC_EOS_BENCH_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* Number of samples taken for each benchmark */
+#ifndef EOS_BENCH_SAMPLES
+#define EOS_BENCH_SAMPLES 128
+#endif
+
+/* Most tasks created by the EOS_ThreadNew()/tick benchmarks */
+#ifndef EOS_BENCH_MAX_TASKS
+#define EOS_BENCH_MAX_TASKS 32
+#endif
+
+/* Smallest gap (in cycles) in a busy loop that is counted as a tick interrupt */
+#ifndef EOS_BENCH_TICK_GAP
+#define EOS_BENCH_TICK_GAP 100
+#endif
+
+
+/*	FUNCTION DECLARATIONS	*/
+void EOS_BenchInit(void);
+void EOS_BenchIsr(void);
+uint8_t EOS_BenchTriggerIsr(void);
+void EOS_BenchComplete(void);
+
+#endif /* INC_EOS_BENCH_H_ */
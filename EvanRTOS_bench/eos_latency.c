@@ -0,0 +1,513 @@
+/*
+ * eos_latency.c
+ *
+ *      Wakeup latency test for EvanRTOS, in the style of cyclictest. High priority tasks are released periodically, and
+ *      the time from when each release should have happened to when the task actually runs is recorded:
+ *
+ *      	delay:		a task sleeping with EOS_Delay(EOS_LATENCY_PERIOD_TICKS), measured from the tick it should wake
+ *      				on. The tick phase is found at startup by timing the gaps ticks leave in a busy loop.
+ *      	isr:		a periodic timer interrupt, measured from the timer expiring to the handler running.
+ *      	isr_task:	the task woken by that interrupt (through a semaphore), measured from the timer expiring.
+ *
+ *      Each gives a min/avg/max, percentiles and a histogram with EOS_LATENCY_BUCKETS buckets of
+ *      EOS_LATENCY_BUCKET_CYCLES. Meanwhile, any mix of background load (EOS_latency_load_t) runs at lower priority, so
+ *      its effect on the latency of higher priority work (through critical sections, the tick, and interrupts) shows up
+ *      directly. Running the same test before a release, or with two kernel configurations, compares them objectively.
+ *
+ *      To run the test, call EOS_LatencyInit() instead of your usual EvanRTOS_Init(). A progress line is printed every
+ *      EOS_LATENCY_REPORT_S seconds, and once the run is over, the full results are printed as JSON lines ending with
+ *      {"latency":"done"}, after which EOS_LatencyComplete() is called. A run of 0 seconds never ends, and prints the
+ *      full results with every progress line.
+ *
+ *      The interrupt tests need two interrupts, provided by overriding the weak functions below:
+ *      	- EOS_LatencyTimerStart() starts a timer interrupting every period_us. Its handler calls EOS_LatencyIsr()
+ *      	  with the cycles elapsed since the timer expired (from the timer's counter, for example
+ *      	  TIMx->CNT * (EOS_PORT_CYCLE_HZ / timer clock) for an up-counting STM32 timer).
+ *      	- EOS_LatencyTriggerFlood() pends a spare IRQ, whose handler calls EOS_LatencyFloodIsr().
+ *      Without them, the timer tests and the interrupt flood are reported as skipped.
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "eos_latency.h"
+#include "eos_semaphore.h"
+#include "eos_queue.h"
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_LatencyDelayTask(void);
+static void EOS_LatencyIsrTask(void);
+static void EOS_LatencyReportTask(void);
+static void EOS_LatencyCpuTask(void);
+static void EOS_LatencyProducerTask(void);
+static void EOS_LatencyConsumerTask(void);
+static void EOS_LatencyFloodTriggerTask(void);
+static void EOS_LatencyFloodTask(void);
+static void EOS_LatencyRecord(EOS_latency_stat_t* stat, uint32_t latency);
+static void EOS_LatencyPrint(const char* name, const EOS_latency_stat_t* stat);
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_latency_stat_t delay_stat;
+static EOS_latency_stat_t isr_stat;
+static EOS_latency_stat_t isr_task_stat;
+
+static volatile uint8_t latency_running = 0;
+static volatile uint8_t timer_started = 0;
+static volatile uint32_t isr_release = 0;
+static volatile uint32_t isr_missed = 0;
+static volatile uint32_t delay_early = 0;
+
+static volatile uint32_t cpu_loops = 0;
+static volatile uint32_t queue_items = 0;
+static volatile uint32_t flood_triggers = 0;
+static volatile uint32_t flood_wakeups = 0;
+
+static uint32_t latency_seconds;
+static uint32_t latency_load;
+
+static EOS_semaphore_id_t isr_sem;
+static EOS_semaphore_id_t flood_sem;
+static EOS_queue_id_t storm_queue;
+
+static int32_t delay_stack[256];
+static int32_t isr_task_stack[128];
+static int32_t report_stack[512];
+static int32_t cpu_stack[128];
+static int32_t producer_stack[128];
+static int32_t consumer_stack[128];
+static int32_t flood_trigger_stack[128];
+static int32_t flood_stack[128];
+
+
+
+/*	LATENCY TEST SETUP		*/
+
+
+/**
+ * @brief Creates the test and load tasks and starts EvanRTOS. Call this instead of EvanRTOS_Init().
+ *
+ * @param seconds Length of the run, or 0 to run forever.
+ * @param load Background load to run, or'ed EOS_latency_load_t values.
+ *
+ * This function never returns, as it passes control over to EvanRTOS.
+ */
+void EOS_LatencyInit(uint32_t seconds, uint32_t load){
+
+	latency_seconds = seconds;
+	latency_load = load;
+
+	isr_sem = EOS_SemaphoreNew(1);
+	flood_sem = EOS_SemaphoreNew(1);
+	storm_queue = EOS_QueueCreate(4, sizeof(uint32_t));
+
+	//semaphores start full, so take them once to start them empty
+	EOS_SemaphoreAcquire(isr_sem);
+	EOS_SemaphoreAcquire(flood_sem);
+
+	delay_stat.min = UINT32_MAX;
+	isr_stat.min = UINT32_MAX;
+	isr_task_stat.min = UINT32_MAX;
+
+	EOS_ThreadNew(EOS_LatencyDelayTask, PRIORITY_HIGH, delay_stack, 256, EOS_NO_FPU);
+	EOS_ThreadNew(EOS_LatencyIsrTask, PRIORITY_HIGH, isr_task_stack, 128, EOS_NO_FPU);
+	EOS_ThreadNew(EOS_LatencyReportTask, PRIORITY_MEDIUM, report_stack, 512, EOS_NO_FPU);
+
+	if (load & EOS_LATENCY_LOAD_CPU)
+	{
+		EOS_ThreadNew(EOS_LatencyCpuTask, PRIORITY_LOW, cpu_stack, 128, EOS_NO_FPU);
+	}
+	if (load & EOS_LATENCY_LOAD_QUEUE)
+	{
+		EOS_ThreadNew(EOS_LatencyProducerTask, PRIORITY_LOW, producer_stack, 128, EOS_NO_FPU);
+		EOS_ThreadNew(EOS_LatencyConsumerTask, PRIORITY_LOW, consumer_stack, 128, EOS_NO_FPU);
+	}
+	if (load & EOS_LATENCY_LOAD_ISR)
+	{
+		EOS_ThreadNew(EOS_LatencyFloodTriggerTask, PRIORITY_LOW, flood_trigger_stack, 128, EOS_NO_FPU);
+		EOS_ThreadNew(EOS_LatencyFloodTask, PRIORITY_MEDIUM, flood_stack, 128, EOS_NO_FPU);
+	}
+
+	EOS_Init(DEFAULT_TASK_PERIOD);
+}
+
+
+/**
+ * @brief Called from the test timer's interrupt handler.
+ *
+ * @param elapsed Cycles since the timer expired, read from the timer hardware.
+ */
+void EOS_LatencyIsr(uint32_t elapsed){
+
+	if (latency_running == 0)
+	{
+		return;
+	}
+
+	EOS_LatencyRecord(&isr_stat, elapsed);
+	isr_release = EOS_GetCycles() - elapsed;
+
+	if (EOS_SemaphoreRelease(isr_sem) == EOS_ERROR)
+	{
+		isr_missed++; //the task has not run since the last interrupt
+	}
+}
+
+
+/**
+ * @brief Called from the flood interrupt's handler. Wakes the flood task.
+ */
+void EOS_LatencyFloodIsr(void){
+	EOS_SemaphoreRelease(flood_sem);
+}
+
+
+/**
+ * @brief Starts a timer interrupt every period_us, whose handler calls EOS_LatencyIsr(). Override this in your project
+ * 			to enable the timer tests.
+ *
+ * @return 1 if the timer was started, 0 if not supported.
+ */
+__attribute__((weak)) uint8_t EOS_LatencyTimerStart(uint32_t period_us){
+	(void)period_us;
+	return 0;
+}
+
+
+/**
+ * @brief Fires the interrupt that calls EOS_LatencyFloodIsr(). Override this in your project to enable the interrupt
+ * 			flood load.
+ *
+ * @return 1 if an interrupt was triggered, 0 if not supported.
+ */
+__attribute__((weak)) uint8_t EOS_LatencyTriggerFlood(void){
+	return 0;
+}
+
+
+/**
+ * @brief Called once the run is over and the results are printed. Override this in your project to act on the end of
+ * 			the run.
+ */
+__attribute__((weak)) void EOS_LatencyComplete(void){
+
+}
+
+
+
+/*	TEST TASKS		*/
+
+
+/**
+ * @brief Finds the tick phase, starts the test, then measures its own EOS_Delay() wakeups.
+ */
+static void EOS_LatencyDelayTask(void){
+
+	//find a tick: two gaps in a busy loop a whole number of ticks apart. Nothing else runs yet, as this is the only
+	//high priority task that is ready
+	uint32_t prev = EOS_GetCycles();
+	uint32_t last_gap = 0;
+	uint8_t have_gap = 0;
+	uint32_t phase;
+
+	while (1)
+	{
+		uint32_t now = EOS_GetCycles();
+
+		if (now - prev > EOS_LATENCY_TICK_GAP)
+		{
+			uint32_t offset = (prev - last_gap) % EOS_LATENCY_TICK_CYCLES;
+
+			if (have_gap && (offset < EOS_LATENCY_TICK_CYCLES / 64 || offset > EOS_LATENCY_TICK_CYCLES - EOS_LATENCY_TICK_CYCLES / 64))
+			{
+				phase = prev; //last reading before the tick interrupt
+				break;
+			}
+			last_gap = prev;
+			have_gap = 1;
+		}
+		prev = now;
+	}
+
+	timer_started = EOS_LatencyTimerStart(EOS_LATENCY_TIMER_US);
+	latency_running = 1;
+
+	while (1)
+	{
+		uint32_t call = EOS_GetCycles();
+		uint32_t ticks = (call - phase) / EOS_LATENCY_TICK_CYCLES;
+		uint32_t intended = phase + (ticks + EOS_LATENCY_PERIOD_TICKS) * EOS_LATENCY_TICK_CYCLES;
+
+		EOS_Delay(EOS_LATENCY_PERIOD_TICKS);
+		uint32_t now = EOS_GetCycles();
+
+		if ((int32_t)(now - intended) < 0)
+		{
+			//the tick came earlier than the phase says, so move the phase back to it
+			delay_early++;
+			intended = now;
+		}
+
+		if (latency_running)
+		{
+			EOS_LatencyRecord(&delay_stat, now - intended);
+		}
+		phase = intended; //keeps the phase close, so the cycle counter wrapping does not matter
+	}
+}
+
+
+/**
+ * @brief Measures the time from the test timer expiring to this task running.
+ */
+static void EOS_LatencyIsrTask(void){
+
+	while (1)
+	{
+		EOS_SemaphoreAcquire(isr_sem);
+		uint32_t now = EOS_GetCycles();
+
+		if (latency_running)
+		{
+			EOS_LatencyRecord(&isr_task_stat, now - isr_release);
+		}
+	}
+}
+
+
+/**
+ * @brief Prints progress while the test runs, and the full results at the end.
+ */
+static void EOS_LatencyReportTask(void){
+
+	uint32_t elapsed = 0;
+
+	while (latency_running == 0)
+	{
+		EOS_Delay(1);
+	}
+
+	if (timer_started == 0)
+	{
+		printf("{\"latency\":\"isr\",\"skipped\":true}\n");
+	}
+
+	while (1)
+	{
+		EOS_Delay(1000);
+		elapsed++;
+
+		if (latency_seconds != 0 && elapsed >= latency_seconds)
+		{
+			break;
+		}
+
+		if (elapsed % EOS_LATENCY_REPORT_S == 0)
+		{
+			printf("{\"latency\":\"progress\",\"seconds\":%lu,\"unit\":\"cycles\",\"delay_max\":%lu,\"isr_max\":%lu,"
+					"\"isr_task_max\":%lu}\n", (unsigned long)elapsed, (unsigned long)delay_stat.max,
+					(unsigned long)isr_stat.max, (unsigned long)isr_task_stat.max);
+
+			if (latency_seconds == 0)
+			{
+				EOS_LatencyPrint("delay", &delay_stat);
+				EOS_LatencyPrint("isr", &isr_stat);
+				EOS_LatencyPrint("isr_task", &isr_task_stat);
+			}
+			fflush(stdout);
+		}
+	}
+
+	latency_running = 0;
+	EOS_Delay(2); //let the last measurements finish
+
+	EOS_LatencyPrint("delay", &delay_stat);
+	EOS_LatencyPrint("isr", &isr_stat);
+	EOS_LatencyPrint("isr_task", &isr_task_stat);
+
+	printf("{\"latency\":\"load\",\"load\":%lu,\"seconds\":%lu,\"cpu_loops\":%lu,\"queue_items\":%lu,"
+			"\"flood_triggers\":%lu,\"flood_wakeups\":%lu,\"isr_missed\":%lu,\"delay_early\":%lu}\n",
+			(unsigned long)latency_load, (unsigned long)elapsed, (unsigned long)cpu_loops, (unsigned long)queue_items,
+			(unsigned long)flood_triggers, (unsigned long)flood_wakeups, (unsigned long)isr_missed,
+			(unsigned long)delay_early);
+	printf("{\"latency\":\"done\"}\n");
+	fflush(stdout);
+	EOS_LatencyComplete();
+
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+
+/*	LOAD TASKS		*/
+
+
+/**
+ * @brief Spins forever, taking every cycle the higher priority tasks leave.
+ */
+static void EOS_LatencyCpuTask(void){
+
+	while (1)
+	{
+		cpu_loops++;
+	}
+}
+
+
+static void EOS_LatencyProducerTask(void){
+
+	uint32_t item = 0;
+
+	while (1)
+	{
+		EOS_QueuePut(storm_queue, &item, EOS_BLOCK);
+		item++;
+	}
+}
+
+
+static void EOS_LatencyConsumerTask(void){
+
+	uint32_t item;
+
+	while (1)
+	{
+		EOS_QueueGet(storm_queue, &item, EOS_BLOCK);
+		queue_items++;
+	}
+}
+
+
+/**
+ * @brief Fires bursts of EOS_LATENCY_FLOOD_BURST flood interrupts back to back, one per tick, once the test has
+ * 			started.
+ */
+static void EOS_LatencyFloodTriggerTask(void){
+
+	while (latency_running == 0)
+	{
+		EOS_Delay(1);
+	}
+
+	if (EOS_LatencyTriggerFlood() == 0)
+	{
+		printf("{\"latency\":\"isr_flood\",\"skipped\":true}\n");
+		fflush(stdout);
+
+		while (1)
+		{
+			EOS_Delay(1000);
+		}
+	}
+
+	while (1)
+	{
+		for (uint32_t i = 0; i < EOS_LATENCY_FLOOD_BURST; i++)
+		{
+			flood_triggers++;
+			EOS_LatencyTriggerFlood();
+		}
+		EOS_Delay(1); //lets the other low priority loads run too
+	}
+}
+
+
+/**
+ * @brief Woken by every flood interrupt, like the task behind a busy driver.
+ */
+static void EOS_LatencyFloodTask(void){
+
+	while (1)
+	{
+		EOS_SemaphoreAcquire(flood_sem);
+		flood_wakeups++;
+	}
+}
+
+
+
+/*	HELPER FUNCTIONS	*/
+
+
+static void EOS_LatencyRecord(EOS_latency_stat_t* stat, uint32_t latency){
+
+	uint32_t bucket = latency / EOS_LATENCY_BUCKET_CYCLES;
+
+	stat->count++;
+	stat->total += latency;
+	if (latency < stat->min)
+	{
+		stat->min = latency;
+	}
+	if (latency > stat->max)
+	{
+		stat->max = latency;
+	}
+
+	if (bucket < EOS_LATENCY_BUCKETS)
+	{
+		stat->histogram[bucket]++;
+	}
+	else
+	{
+		stat->overflow++;
+	}
+}
+
+
+/**
+ * @brief Returns the upper edge (in cycles) of the bucket holding the given percentile (in tenths of a percent), or the
+ * 			max if it falls into the overflow.
+ */
+static uint32_t EOS_LatencyPercentile(const EOS_latency_stat_t* stat, uint32_t per_mille){
+
+	uint64_t target = ((uint64_t)stat->count * per_mille + 999) / 1000;
+	uint64_t seen = 0;
+
+	for (uint32_t i = 0; i < EOS_LATENCY_BUCKETS; i++)
+	{
+		seen += stat->histogram[i];
+		if (seen >= target)
+		{
+			return (i + 1) * EOS_LATENCY_BUCKET_CYCLES;
+		}
+	}
+	return stat->max;
+}
+
+
+/**
+ * @brief Prints the statistics and the non empty histogram buckets ([bucket, count] pairs) of one test as one line
+ * 			of JSON.
+ */
+static void EOS_LatencyPrint(const char* name, const EOS_latency_stat_t* stat){
+
+	if (stat->count == 0)
+	{
+		printf("{\"latency\":\"%s\",\"n\":0}\n", name);
+		return;
+	}
+
+	printf("{\"latency\":\"%s\",\"unit\":\"cycles\",\"cycle_hz\":%lu,\"n\":%lu,\"min\":%lu,\"avg\":%lu,\"max\":%lu,"
+			"\"p50\":%lu,\"p99\":%lu,\"p999\":%lu,\"bucket_cycles\":%lu,\"overflow\":%lu,\"histogram\":[",
+			name, (unsigned long)EOS_PORT_CYCLE_HZ, (unsigned long)stat->count, (unsigned long)stat->min,
+			(unsigned long)(stat->total / stat->count), (unsigned long)stat->max,
+			(unsigned long)EOS_LatencyPercentile(stat, 500), (unsigned long)EOS_LatencyPercentile(stat, 990),
+			(unsigned long)EOS_LatencyPercentile(stat, 999), (unsigned long)EOS_LATENCY_BUCKET_CYCLES,
+			(unsigned long)stat->overflow);
+
+	const char* separator = "";
+	for (uint32_t i = 0; i < EOS_LATENCY_BUCKETS; i++)
+	{
+		if (stat->histogram[i] != 0)
+		{
+			printf("%s[%lu,%lu]", separator, (unsigned long)i, (unsigned long)stat->histogram[i]);
+			separator = ",";
+		}
+	}
+	printf("]}\n");
+}
@@ -0,0 +1,89 @@
+/*
+ * eos_latency.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_LATENCY_H_
+#define INC_EOS_LATENCY_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* Ticks the delay test task sleeps for each cycle */
+#ifndef EOS_LATENCY_PERIOD_TICKS
+#define EOS_LATENCY_PERIOD_TICKS 1
+#endif
+
+/* Cycles between two ticks (EOS_Init() is called with DEFAULT_TASK_PERIOD, 1ms) */
+#ifndef EOS_LATENCY_TICK_CYCLES
+#define EOS_LATENCY_TICK_CYCLES (EOS_PORT_CYCLE_HZ / 1000u)
+#endif
+
+/* Smallest gap (in cycles) in a busy loop that is counted as a tick interrupt, when finding the tick phase */
+#ifndef EOS_LATENCY_TICK_GAP
+#define EOS_LATENCY_TICK_GAP 100
+#endif
+
+/* Period of the timer interrupt test, in microseconds. Keep it away from multiples of the tick, so the two tests do
+ * not always land on top of each other */
+#ifndef EOS_LATENCY_TIMER_US
+#define EOS_LATENCY_TIMER_US 397
+#endif
+
+/* Flood interrupts fired back to back each tick by the interrupt flood load */
+#ifndef EOS_LATENCY_FLOOD_BURST
+#define EOS_LATENCY_FLOOD_BURST 100
+#endif
+
+/* Width of a histogram bucket, in cycles (1us by default) */
+#ifndef EOS_LATENCY_BUCKET_CYCLES
+#define EOS_LATENCY_BUCKET_CYCLES (EOS_PORT_CYCLE_HZ / 1000000u)
+#endif
+
+/* Number of histogram buckets, latencies past the last one are counted as overflow */
+#ifndef EOS_LATENCY_BUCKETS
+#define EOS_LATENCY_BUCKETS 200
+#endif
+
+/* Seconds between two progress lines */
+#ifndef EOS_LATENCY_REPORT_S
+#define EOS_LATENCY_REPORT_S 10
+#endif
+
+
+/*	ENUMERATIONS	*/
+
+/* Background load run during the test, or'ed together */
+typedef enum {
+	EOS_LATENCY_LOAD_NONE = 0,
+	EOS_LATENCY_LOAD_CPU = 1,		//a low priority task that never blocks
+	EOS_LATENCY_LOAD_QUEUE = 2,		//two low priority tasks passing items through a small queue as fast as they can
+	EOS_LATENCY_LOAD_ISR = 4,		//bursts of an interrupt fired back to back, waking a medium priority task each time
+	EOS_LATENCY_LOAD_ALL = 7
+} EOS_latency_load_t;
+
+
+/*	DATATYPES	*/
+
+typedef struct {
+	uint32_t count;
+	uint32_t min;					//cycles
+	uint32_t max;					//cycles
+	uint64_t total;					//cycles
+	uint32_t overflow;				//latencies past the last bucket
+	uint32_t histogram[EOS_LATENCY_BUCKETS];
+} EOS_latency_stat_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+void EOS_LatencyInit(uint32_t seconds, uint32_t load);
+void EOS_LatencyIsr(uint32_t elapsed);
+void EOS_LatencyFloodIsr(void);
+uint8_t EOS_LatencyTimerStart(uint32_t period_us);
+uint8_t EOS_LatencyTriggerFlood(void);
+void EOS_LatencyComplete(void);
+
+#endif /* INC_EOS_LATENCY_H_ */
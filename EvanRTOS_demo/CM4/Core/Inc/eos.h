@@ -0,0 +1,19 @@
+/*
+ * eos.h
+ *
+ *  Created on: Jan 11, 2025
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_APP_H_
+#define INC_EOS_APP_H_
+
+/*	INCLUDES	*/
+#include <stdint.h>
+#include "main.h"
+
+
+/*	FUNCTION PROTOTYPES		*/
+void EvanRTOS_Init();
+
+#endif /* INC_EOS_APP_H_ */
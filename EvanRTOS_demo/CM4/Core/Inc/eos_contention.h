@@ -0,0 +1,79 @@
+/*
+ * eos_contention.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_CONTENTION_H_
+#define INC_EOS_CONTENTION_H_
+
+#include "eos_kernel.h"
+
+/*	ENUMERATIONS	*/
+typedef enum {
+	EOS_CONTENTION_SEMAPHORE = 0,
+	EOS_CONTENTION_QUEUE = 1
+} EOS_contention_type_t;
+
+
+/*	DATATYPES	*/
+
+/* Counters kept in every queue and semaphore. For queues, acquisitions are gets and releases are puts */
+typedef struct eos_contention_t {
+	struct eos_contention_t* next;	//next object in the registry
+	void* object;
+	const char* name;
+	uint8_t type;					//EOS_contention_type_t
+	uint8_t waiters;				//tasks blocked on the object right now
+	uint8_t peak_waiters;
+	uint32_t acquisitions;
+	uint32_t releases;
+	uint32_t contended;				//operations that had to block
+	uint32_t wait_max;				//cycles
+	uint64_t wait_total;			//cycles
+	uint32_t high_water;			//queues: most items held at once
+	uint32_t full;					//queues: puts that found the queue full (blocking or not)
+	uint32_t empty;					//queues: gets that found the queue empty (blocking or not)
+} EOS_contention_t;
+
+/* State of one blocking operation, kept on the caller's stack */
+typedef struct {
+	uint32_t start;
+	uint8_t blocked;
+} EOS_contention_wait_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_CONTENTION_PROFILE_ENABLE
+
+#define EOS_CONTENTION_WAIT(wait) EOS_contention_wait_t wait = {0, 0}
+
+void EOS_ContentionRegister(EOS_contention_t* stats, void* object, EOS_contention_type_t type);
+void EOS_ContentionBlock(EOS_contention_t* stats, EOS_contention_wait_t* wait);
+void EOS_ContentionAcquire(EOS_contention_t* stats, EOS_contention_wait_t* wait);
+void EOS_ContentionRelease(EOS_contention_t* stats, EOS_contention_wait_t* wait);
+void EOS_ContentionLevel(EOS_contention_t* stats, uint32_t count);
+
+#define EOS_ContentionFull(stats) ((stats)->full++)
+#define EOS_ContentionEmpty(stats) ((stats)->empty++)
+
+const EOS_contention_t* EOS_ContentionRegistry(void);
+EOS_status_t EOS_ContentionName(void* object, const char* name);
+void EOS_ContentionReset(void);
+void EOS_ContentionReport(void);
+
+#else
+
+#define EOS_CONTENTION_WAIT(wait)
+#define EOS_ContentionRegister(stats, object, type)
+#define EOS_ContentionBlock(stats, wait)
+#define EOS_ContentionAcquire(stats, wait)
+#define EOS_ContentionRelease(stats, wait)
+#define EOS_ContentionLevel(stats, count)
+#define EOS_ContentionFull(stats)
+#define EOS_ContentionEmpty(stats)
+
+#endif
+
+#endif /* INC_EOS_CONTENTION_H_ */
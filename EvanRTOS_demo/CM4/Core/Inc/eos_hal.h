@@ -0,0 +1,90 @@
+/*
+ * eos_hal.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_HAL_H_
+#define INC_EOS_HAL_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* Events a wait can be completed by. A full duplex transfer waits on both */
+#define EOS_HAL_TX 0x1u
+#define EOS_HAL_RX 0x2u
+#define EOS_HAL_ABORT 0x4u			//an abort the HAL finishes in an interrupt
+#define EOS_HAL_ANY 0x7u
+
+/* Timeout that never expires, the same value as HAL_MAX_DELAY */
+#define EOS_HAL_FOREVER 0xFFFFFFFFu
+
+
+/*	ENUMERATIONS	*/
+typedef enum {
+	EOS_HAL_DONE = 0,
+	EOS_HAL_FAILED = 1,				//the port reported an error
+	EOS_HAL_TIMEOUT = 2
+} EOS_hal_result_t;
+
+
+/*	DATATYPES	*/
+
+/* One transfer a task sleeps on, from EOS_HalPrepare() until EOS_HalWait() returns. It is usually on the waiting
+ * task's stack */
+typedef struct EOS_hal_wait_t {
+	void* handle;					//the HAL handle the transfer runs on
+	uint32_t events;				//EOS_HAL_TX, EOS_HAL_RX and/or EOS_HAL_ABORT
+	uint32_t timeout;				//ticks left, or EOS_HAL_FOREVER
+	volatile uint32_t done;
+	EOS_hal_result_t result;
+	struct EOS_hal_wait_t* next;
+} EOS_hal_wait_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_HAL_ENABLE
+
+uint32_t EOS_HalCanBlock(void);
+
+/* Waiting on an interrupt driven transfer */
+void EOS_HalPrepare(EOS_hal_wait_t* wait, void* handle, uint32_t events, uint32_t timeout);
+void EOS_HalCancel(EOS_hal_wait_t* wait);
+EOS_hal_result_t EOS_HalWait(EOS_hal_wait_t* wait);
+
+/* Called by the port, from the HAL's completion and error callbacks */
+void EOS_HalComplete(void* handle, uint32_t events, EOS_hal_result_t result);
+
+/* Called by EOS_Tick() */
+void EOS_HalTick(void);
+
+/* Blocking HAL calls that sleep until the transfer's interrupt, implemented by the port (ARM_CM7). Same arguments and
+ * results as the HAL functions they stand in for; outside a task they are those functions */
+#ifdef HAL_UART_MODULE_ENABLED
+HAL_StatusTypeDef EOS_HalUartTransmit(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef EOS_HalUartReceive(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size, uint32_t timeout);
+#endif
+
+#ifdef HAL_I2C_MODULE_ENABLED
+HAL_StatusTypeDef EOS_HalI2cMasterTransmit(I2C_HandleTypeDef* hi2c, uint16_t address, uint8_t* data, uint16_t size,
+		uint32_t timeout);
+HAL_StatusTypeDef EOS_HalI2cMasterReceive(I2C_HandleTypeDef* hi2c, uint16_t address, uint8_t* data, uint16_t size,
+		uint32_t timeout);
+HAL_StatusTypeDef EOS_HalI2cMemWrite(I2C_HandleTypeDef* hi2c, uint16_t address, uint16_t memory, uint16_t memory_size,
+		uint8_t* data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef EOS_HalI2cMemRead(I2C_HandleTypeDef* hi2c, uint16_t address, uint16_t memory, uint16_t memory_size,
+		uint8_t* data, uint16_t size, uint32_t timeout);
+#endif
+
+#ifdef HAL_SPI_MODULE_ENABLED
+HAL_StatusTypeDef EOS_HalSpiTransmit(SPI_HandleTypeDef* hspi, const uint8_t* data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef EOS_HalSpiReceive(SPI_HandleTypeDef* hspi, uint8_t* data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef EOS_HalSpiTransmitReceive(SPI_HandleTypeDef* hspi, const uint8_t* tx_data, uint8_t* rx_data,
+		uint16_t size, uint32_t timeout);
+#endif
+
+#endif
+
+#endif /* INC_EOS_HAL_H_ */
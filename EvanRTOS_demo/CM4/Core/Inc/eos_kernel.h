@@ -0,0 +1,138 @@
+/*
+ * eos.h
+ *
+ *  Created on: Jan 10, 2025
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_H_
+#define INC_EOS_H_
+
+
+
+/*	INCLUDES	*/
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "eos_config.h"
+#include "eos_portmacro.h"
+//#include "eos_semaphore.h"
+//#include "eos_queue.h"
+//#include  "eos_dual_core.h"
+
+/*		ENUMERATIONS		*/
+typedef enum {
+	EOS_ERROR = 0,
+	EOS_OK = 1,
+	EOS_BLOCKED = 2,
+	EOS_USE_FPU = 3,
+	EOS_NO_FPU = 4
+} EOS_status_t;
+
+typedef enum{
+	EOS_BLOCK = 1,
+	EOS_NO_BLOCK = 0
+} EOS_block_status_t;
+
+typedef enum{
+	PRIORITY_IDLE = 0,
+	PRIORITY_LOW = 1,
+	PRIORITY_MEDIUM = 2,
+	PRIORITY_HIGH = 3
+}EOS_priority_t;
+
+typedef enum{
+	EOS_TASK_RUNNING = 0,
+	EOS_TASK_READY = 1,
+	EOS_TASK_BLOCKED = 2,	//on a queue or semaphore
+	EOS_TASK_DELAYED = 3,	//in EOS_Delay()
+	EOS_TASK_PAUSED = 4
+}EOS_task_state_t;
+
+/*		CONSTANTS		*/
+#define EOS_TIMED_OUT ((void*)2)
+#define EOS_PAUSED 1
+#define DEFAULT_TASK_PERIOD 1
+
+
+/* Largest task id the 8 bit task fields of trace and profiler records hold. Tasks created after it share it there */
+#define EOS_TASK_ID_RECORD_MAX 0xFE
+#define EOS_TASK_ID_RECORD(id) ((uint8_t)(((id) < EOS_TASK_ID_RECORD_MAX) ? (id) : EOS_TASK_ID_RECORD_MAX))
+
+
+/*		CUSTOM DATATYPES		*/
+typedef struct eos_TCB_t {
+ int32_t *sp;
+ void* blocked;
+ struct eos_TCB_t *next;
+ uint32_t timeOut;
+ uint8_t priority;
+ uint8_t paused;
+ uint16_t id;
+ int32_t* stack;		//lowest address of the task stack
+ uint32_t stack_size;	//words
+#if EOS_TASK_STATS_ENABLE
+ uint64_t cycles;			//total cycles run
+ uint64_t snapshot_cycles;	//cycles at the last EOS_TaskSnapshot()
+ uint32_t switches;			//times switched in
+#endif
+#if EOS_SMP_ENABLE
+ struct eos_TCB_t *run_next;	//next task in the same core's run queue
+ uint8_t core;				//core whose run queue holds the task
+ uint8_t running;			//core running the task, EOS_SMP_NO_CORE once switched out
+#endif
+} EOS_TCB_t;
+
+typedef EOS_TCB_t* EOS_task_id_t;
+
+/* One task, as seen by EOS_TaskSnapshot() */
+typedef struct {
+	EOS_task_id_t task;
+	void* object;			//queue or semaphore the task is blocked on, otherwise NULL
+	uint32_t timeout;		//ticks left when delayed
+	uint32_t stack_size;	//words
+	uint32_t stack_used;	//words, most ever used (0 unless stacks are painted, see EOS_StackHighWater())
+	uint64_t cycles;		//total cycles run (0 without EOS_TASK_STATS_ENABLE)
+	uint32_t switches;		//times switched in (0 without EOS_TASK_STATS_ENABLE)
+	uint16_t cpu;			//per mille of the CPU since the previous snapshot (0 without EOS_TASK_STATS_ENABLE)
+	uint16_t id;
+	uint8_t priority;
+	uint8_t state;			//EOS_task_state_t
+} EOS_task_info_t;
+
+#if EOS_SMP_ENABLE
+extern EOS_TCB_t* eos_run_ptr[EOS_SMP_CORES];	//per core, see eos_smp.c
+EOS_TCB_t* EOS_SmpRunning(void);
+#define run_ptr (EOS_SmpRunning())
+#else
+extern EOS_TCB_t* run_ptr;
+#endif
+
+
+
+/*		FUNCTION PROTOTYPES		*/
+EOS_task_id_t EOS_ThreadNew(void* function, EOS_priority_t priority, int32_t* task_stack, uint32_t stack_size, EOS_status_t use_fpu);
+void EOS_Init(uint32_t user_task_period);
+
+void EOS_Delay(uint32_t timeout);
+EOS_status_t EOS_Pause(EOS_task_id_t task);
+EOS_status_t EOS_Resume(EOS_task_id_t task);
+uint32_t EOS_TaskSnapshot(EOS_task_info_t* tasks, uint32_t max);
+uint32_t EOS_StackHighWater(EOS_task_id_t task);
+void EOS_StackOverflow(EOS_task_id_t task);
+
+void EOS_Suspend();
+#if EOS_CRITICAL_PROFILE_ENABLE
+void EOS_CriticalEnter(const char* function, uint32_t line);
+void EOS_CriticalExit(void);
+#define EOS_EnterCritical() EOS_CriticalEnter(__func__, __LINE__) //see eos_critical.h
+#define EOS_ExitCritical() EOS_CriticalExit()
+#else
+void EOS_EnterCritical();
+void EOS_ExitCritical();
+#endif
+void EOS_TaskUnblock(void* item);
+uint32_t EOS_GetCycles(void);
+
+#endif /* INC_EOS_H_ */
@@ -0,0 +1,84 @@
+/*
+ * eos_portmacro.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Port macros for ARMv7E-M (Cortex-M7/M4) with CMSIS. See eos_port.h.
+ */
+
+#ifndef INC_EOS_PORTMACRO_H_
+#define INC_EOS_PORTMACRO_H_
+
+#include <stdint.h>
+#include "main.h"
+
+
+/*	CONSTANTS	*/
+
+/* Timer used by the sampling profiler (eos_profile.c), it needs an update interrupt of its own on APB1 */
+#ifndef EOS_PORT_PROFILE_TIM
+#define EOS_PORT_PROFILE_TIM TIM7
+#define EOS_PORT_PROFILE_IRQn TIM7_IRQn
+#define EOS_PORT_PROFILE_IRQHandler TIM7_IRQHandler
+#define EOS_PORT_PROFILE_CLK_ENABLE() __HAL_RCC_TIM7_CLK_ENABLE()
+#endif
+
+/* Timer the HAL's timebase runs on with EOS_HAL_ENABLE, one per core, as each core's HAL keeps its own tick. It needs
+ * an update interrupt of its own on APB1. Its handler only counts the HAL tick, so it can run above the kernel's
+ * interrupts, and HAL timeouts keep counting in their handlers */
+#ifndef EOS_PORT_HAL_TIM
+#if defined(CORE_CM4)
+#define EOS_PORT_HAL_TIM TIM5
+#define EOS_PORT_HAL_IRQn TIM5_IRQn
+#define EOS_PORT_HAL_IRQHandler TIM5_IRQHandler
+#define EOS_PORT_HAL_CLK_ENABLE() __HAL_RCC_TIM5_CLK_ENABLE()
+#else
+#define EOS_PORT_HAL_TIM TIM6
+#define EOS_PORT_HAL_IRQn TIM6_DAC_IRQn
+#define EOS_PORT_HAL_IRQHandler TIM6_DAC_IRQHandler
+#define EOS_PORT_HAL_CLK_ENABLE() __HAL_RCC_TIM6_CLK_ENABLE()
+#endif
+#endif
+
+#ifndef EOS_PORT_HAL_PRIORITY
+#define EOS_PORT_HAL_PRIORITY 0
+#endif
+
+/* Interrupt each core of the STM32H7 dual core parts takes HSEM notifications on (EOS_DUAL_CORE_ENABLE) */
+#if defined(CORE_CM4)
+#define EOS_PORT_HSEM_IRQn HSEM2_IRQn
+#define EOS_PORT_HSEM_IRQHandler HSEM2_IRQHandler
+#else
+#define EOS_PORT_HSEM_IRQn HSEM1_IRQn
+#define EOS_PORT_HSEM_IRQHandler HSEM1_IRQHandler
+#endif
+
+/* Cycle counter, the DWT one by default. Boards without a DWT cycle counter (QEMU's MPS2 machines) define
+ * EOS_PortGetCycles() and EOS_PORT_CYCLE_HZ in main.h, and start their own counter before EOS_Init() */
+#ifndef EOS_PortGetCycles
+#define EOS_PORT_DWT_CYCLES 1
+#define EOS_PortGetCycles() (DWT->CYCCNT)
+#endif
+
+#ifndef EOS_PORT_CYCLE_HZ
+#define EOS_PORT_CYCLE_HZ SystemCoreClock
+#endif
+
+
+/*	PORT MACROS	*/
+#define EOS_PortDisableInterrupts() __disable_irq()
+#define EOS_PortEnableInterrupts() __enable_irq()
+#define EOS_PortYield() (SCB->ICSR = SCB_ICSR_PENDSVSET_Msk)
+#define EOS_PortIdle()
+
+static inline uint32_t EOS_PortMaskInterrupts(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+#define EOS_PortRestoreInterrupts(state) __set_PRIMASK(state)
+
+#endif /* INC_EOS_PORTMACRO_H_ */
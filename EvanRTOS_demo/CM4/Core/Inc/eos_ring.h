@@ -0,0 +1,71 @@
+/*
+ * eos_ring.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_RING_H_
+#define INC_EOS_RING_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* How the ring memory is seen by the cores using it, passed to EOS_RingCreate() */
+#define EOS_RING_CACHED 0		//cacheable on some core: slots and indices are cleaned and invalidated by line
+#define EOS_RING_UNCACHED 1		//non-cacheable on every core (see EOS_PortMpuUncached()), no cache maintenance
+
+/* Bytes a slot of size bytes takes in the ring, a whole number of cache lines */
+#define EOS_RING_SLOT_SIZE(size) ((((size) + EOS_CACHE_LINE - 1) / EOS_CACHE_LINE) * EOS_CACHE_LINE)
+
+/* Declares a ring and the memory of its count slots of size bytes, cache line aligned, in a linker section both sides
+ * can reach (".shared_memory", in D3 SRAM, in the demo projects). Create it with
+ * EOS_RingCreate(&name, name##_slots, count, size, flags) */
+#define EOS_RING_DEFINE(name, count, size, section) \
+	EOS_ring_t name __attribute__((section(section))); \
+	uint8_t name##_slots[(count) * EOS_RING_SLOT_SIZE(size)] \
+			__attribute__((section(section), aligned(EOS_CACHE_LINE)))
+
+
+/*	DATATYPES	*/
+
+/* Single producer, single consumer ring of fixed size slots, for passing data between cores, or between a core and a
+ * DMA master. head and tail count slots from the start, and each has a cache line of its own, written by one side
+ * only, along with that side's last copy of the other index: cleaning or invalidating a line never loses the other
+ * side's writes. The configuration line is written once, by EOS_RingCreate() */
+typedef struct {
+	uint8_t* slots;
+	uint32_t count;			//power of 2
+	uint32_t slot_size;		//bytes, a multiple of EOS_CACHE_LINE
+	uint32_t flags;
+
+	volatile uint32_t head __attribute__((aligned(EOS_CACHE_LINE)));	//producer side
+	uint32_t producer_tail;
+
+	volatile uint32_t tail __attribute__((aligned(EOS_CACHE_LINE)));	//consumer side
+	uint32_t consumer_head;
+} __attribute__((aligned(EOS_CACHE_LINE))) EOS_ring_t;
+
+typedef EOS_ring_t* EOS_ring_id_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_RING_ENABLE
+
+EOS_ring_id_t EOS_RingCreate(EOS_ring_t* ring, void* slots, uint32_t count, uint32_t slot_size, uint32_t flags);
+EOS_ring_id_t EOS_RingOpen(EOS_ring_t* ring);
+
+/* Producer side */
+uint32_t EOS_RingReserve(EOS_ring_id_t ring, void** slot);
+void EOS_RingCommit(EOS_ring_id_t ring, uint32_t slots);
+EOS_status_t EOS_RingWrite(EOS_ring_id_t ring, const void* item, uint32_t size);
+
+/* Consumer side */
+uint32_t EOS_RingPeek(EOS_ring_id_t ring, void** slot);
+void EOS_RingConsume(EOS_ring_id_t ring, uint32_t slots);
+EOS_status_t EOS_RingRead(EOS_ring_id_t ring, void* item, uint32_t size);
+
+#endif
+
+#endif /* INC_EOS_RING_H_ */
@@ -0,0 +1,71 @@
+/*
+ * eos_smp.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_SMP_H_
+#define INC_EOS_SMP_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* EOS_TCB_t.running of a task no core is running */
+#define EOS_SMP_NO_CORE 0xFF
+
+/* Number of cores the kernel schedules, and the one calling, for code shared with single core builds */
+#if EOS_SMP_ENABLE
+#define EOS_CORES EOS_SMP_CORES
+#define EOS_CORE_ID() EOS_PortCoreId()
+#else
+#define EOS_CORES 1
+#define EOS_CORE_ID() 0
+#endif
+
+#if EOS_SMP_ENABLE && (EOS_SMP_CORES < 2 || EOS_SMP_CORES > 32)
+#error "EOS_SMP_CORES must be between 2 and 32"
+#endif
+
+/* These keep their state for a single core */
+#if EOS_SMP_ENABLE && (EOS_DUAL_CORE_ENABLE || EOS_TASK_STATS_ENABLE || EOS_CRITICAL_PROFILE_ENABLE || \
+		EOS_PROFILE_ENABLE || EOS_WAIT_PROFILE_ENABLE || EOS_INVERSION_DETECT_ENABLE)
+#error "EOS_SMP_ENABLE does not support dual core mode, task statistics or the critical, sampling, wait and inversion profilers"
+#endif
+
+
+/*	DATATYPES	*/
+
+/* Scheduler counters of one core, see EOS_SmpStats() */
+typedef struct {
+	uint32_t switches;		//tasks switched in
+	uint32_t steals;		//ready tasks taken from another core's run queue while idle
+	uint32_t migrations;	//woken tasks handed to this core, as their own was busy
+	uint32_t ipis;			//reschedule interrupts received
+	uint32_t tasks;			//tasks in its run queue, not counting the idle task
+} EOS_smp_stats_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_SMP_ENABLE
+
+/* Kernel */
+void EOS_SmpSetup(void);
+EOS_TCB_t* EOS_SmpIdleTask(uint32_t core);
+void EOS_SmpLock(void);
+void EOS_SmpUnlock(void);
+void EOS_SmpAssign(EOS_TCB_t* task);
+EOS_TCB_t* EOS_SmpPick(EOS_TCB_t* previous);
+uint32_t EOS_SmpWake(EOS_TCB_t* task);
+void EOS_SmpPreempt(EOS_TCB_t* task);
+
+/* Port */
+void EOS_SmpIsr(void);
+
+/* Application */
+void EOS_SmpStats(uint32_t core, EOS_smp_stats_t* stats);
+
+#endif
+
+#endif /* INC_EOS_SMP_H_ */
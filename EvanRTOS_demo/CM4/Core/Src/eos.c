@@ -0,0 +1,83 @@
+/*
+ * eos.c
+ *
+ *      The EvanRTOS application on the Cortex-M4, the secondary core of the STM32H747 (see eos_dual_core.h). Like the
+ *      Cortex-M7's eos.c, it is an example rather than part of EvanRTOS: the Cortex-M4 runs its own instance of the
+ *      kernel, and takes the I/O work off the Cortex-M7. Here that is blinking LED1 as many times as the Cortex-M7's
+ *      task6 asks it to, through the shared queues in Common/Inc/eos_shared.h.
+ *
+ *      Build both projects with EOS_DUAL_CORE_ENABLE set. The Cortex-M7 sets up the shared memory before it releases
+ *      this core from STOP mode, and creates the shared queues once its own kernel objects are created.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos.h"
+#include "eos_kernel.h"
+#include "eos_shared.h"
+
+#if !EOS_DUAL_CORE_ENABLE
+#error "the Cortex-M4 application needs EOS_DUAL_CORE_ENABLE"
+#endif
+
+/*	QUEUES	*/
+EOS_dual_queue_id_t led_queue;
+EOS_dual_queue_id_t done_queue;
+
+/*	TASKS	*/
+
+/*Task 0*/
+EOS_task_id_t task0_handle;
+EOS_priority_t task0_priority = PRIORITY_MEDIUM;
+void task0(void);
+uint32_t task0_stack_size = 128;
+
+/*	USER VARIABLES	*/
+
+uint32_t t0_blinks = 0;
+
+
+/*	USER CODE	*/
+
+
+
+/* Function to initalize the user tasks, and to connect to the Cortex-M7.
+ *
+ * This funtion never returns, as it passes control over to EvanRTOS.
+ *
+ */
+void EvanRTOS_Init(){
+
+	EOS_DualCoreInit(EOS_CORE_SECONDARY, &eos_shared);
+
+	//the Cortex-M7 creates the queues once its kernel objects are set up
+	while ((led_queue = EOS_DualQueueOpen(EOS_SHARED_QUEUE_LED)) == NULL ||
+			(done_queue = EOS_DualQueueOpen(EOS_SHARED_QUEUE_DONE)) == NULL)
+	{
+		HAL_Delay(1);
+	}
+
+	task0_handle = EOS_ThreadNew(task0, task0_priority, NULL, task0_stack_size, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //scheduler preempts every 1 ms
+}
+
+void task0(){
+
+	while(1)
+	{
+		uint32_t blinks = 0;
+		EOS_DualQueueGet(led_queue, &blinks, EOS_BLOCK); //sleeps until the Cortex-M7 asks
+
+		for (uint32_t i = 0; i < blinks; i++)
+		{
+			HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, GPIO_PIN_RESET); //LED1 is active low
+			EOS_Delay(100);
+			HAL_GPIO_WritePin(LED1_GPIO_Port, LED1_Pin, GPIO_PIN_SET);
+			EOS_Delay(100);
+		}
+
+		t0_blinks += blinks;
+		EOS_DualQueuePut(done_queue, &blinks, EOS_BLOCK);
+	}
+}
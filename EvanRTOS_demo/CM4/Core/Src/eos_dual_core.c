@@ -0,0 +1,483 @@
+/*
+ * eos_dual_core.c
+ *
+ *      Semaphores and queues shared between two EvanRTOS instances, each running on its own core: on the STM32H747,
+ *      one on the Cortex-M7 and one on the Cortex-M4, so work such as I/O handling can be moved to the M4. Enabled with
+ *      EOS_DUAL_CORE_ENABLE in eos_config.h, on both cores.
+ *
+ *      The objects live in one EOS_dual_shared_t, placed by the application in memory both cores can reach (D2 or D3
+ *      SRAM). Both cores call EOS_DualCoreInit() with it before EOS_Init(): the primary core (EOS_CORE_PRIMARY) clears
+ *      it, and the secondary core waits until it has. Objects are then created by index on one core, with
+ *      EOS_DualSemaphoreNew() and EOS_DualQueueCreate(), and looked up by the same index on the other with
+ *      EOS_DualSemaphoreOpen() and EOS_DualQueueOpen(). Queue buffers come from a pool in the shared memory
+ *      (EOS_DUAL_CORE_POOL_SIZE), as neither core's heap can be used by the other.
+ *
+ *      The shared objects are guarded by a lock both cores can take (EOS_PortCoreLock(), a hardware semaphore on the
+ *      STM32H7), held with interrupts masked for the length of the update, and the acquire, release, get and put
+ *      functions otherwise work like their single core counterparts, including from interrupts with EOS_NO_BLOCK.
+ *      A task can only be woken by its own core, so when a task blocks, its core marks the object in the shared
+ *      waiting mask. The core that next changes the object moves that mark to the other core's pending mask, and
+ *      raises an interrupt on it (EOS_PortCoreNotify(), the HSEM interrupt on the STM32H7) unless one is already on
+ *      its way. That interrupt runs EOS_DualCoreIsr(), which wakes every task blocked on the pending objects. Each one
+ *      checks the object again, and blocks again if another task got there first.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_dual_core.h"
+#include "eos_trace.h"
+#include "eos_wait.h"
+
+#if EOS_DUAL_CORE_ENABLE
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static uint32_t EOS_DualCoreBit(const void* object);
+static void EOS_DualCoreBlock(void* object);
+static uint32_t EOS_DualCoreChanged(uint32_t bit);
+static void EOS_DualCoreWake(void* object);
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_dual_shared_t* dual_shared = NULL;
+static uint32_t dual_core = EOS_CORE_PRIMARY;
+
+
+
+/*	SETUP	*/
+
+
+/**
+ * @brief Connects this core to the shared memory, and enables the interrupt the other core wakes it with. Must be
+ * 			called by both cores before EOS_Init(), and before any other function in this file. The secondary core
+ * 			waits here until the primary core has cleared the shared memory.
+ *
+ * @param core EOS_CORE_PRIMARY or EOS_CORE_SECONDARY.
+ * @param shared The shared memory, at the same physical location on both cores.
+ */
+void EOS_DualCoreInit(uint32_t core, EOS_dual_shared_t* shared)
+{
+	dual_shared = shared;
+	dual_core = core;
+
+	if (core == EOS_CORE_PRIMARY)
+	{
+		memset((void*)shared, 0, sizeof(EOS_dual_shared_t));
+		__atomic_store_n(&shared->magic, EOS_DUAL_CORE_MAGIC, __ATOMIC_RELEASE);
+	}
+	else
+	{
+		while (__atomic_load_n(&shared->magic, __ATOMIC_ACQUIRE) != EOS_DUAL_CORE_MAGIC)
+		{
+		}
+	}
+
+	EOS_PortCoreListen(core);
+}
+
+
+/**
+ * @brief Handler of the interrupt raised by the other core. Wakes every task on this core blocked on an object the
+ * 			other core has changed since the last one.
+ */
+void EOS_DualCoreIsr(void)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+	EOS_PortCoreLock(&dual_shared->lock);
+	uint32_t pending = dual_shared->pending[dual_core];
+	dual_shared->pending[dual_core] = 0;
+	EOS_PortCoreUnlock(&dual_shared->lock);
+	EOS_PortRestoreInterrupts(state);
+
+	for (uint32_t i = 0; i < EOS_DUAL_CORE_SEMAPHORES; i++)
+	{
+		if (pending & (1u << i))
+		{
+			EOS_DualCoreWake(&dual_shared->semaphores[i]);
+		}
+	}
+
+	for (uint32_t i = 0; i < EOS_DUAL_CORE_QUEUES; i++)
+	{
+		if (pending & (1u << (16 + i)))
+		{
+			EOS_DualCoreWake(&dual_shared->queues[i]);
+		}
+	}
+}
+
+
+
+/*	SEMAPHORES	*/
+
+
+/**
+ * @brief Creates a shared semaphore.
+ *
+ * @param index Which semaphore, below EOS_DUAL_CORE_SEMAPHORES. The other core opens it with the same index.
+ * @param count The initial and maximum count of the semaphore.
+ * @return The semaphore, or NULL if the index is out of range or already created.
+ */
+EOS_dual_semaphore_id_t EOS_DualSemaphoreNew(uint32_t index, uint8_t count)
+{
+	if (index >= EOS_DUAL_CORE_SEMAPHORES)
+	{
+		return NULL;
+	}
+
+	EOS_dual_semaphore_t* semaphore = &dual_shared->semaphores[index];
+	uint32_t state = EOS_PortMaskInterrupts();
+	EOS_PortCoreLock(&dual_shared->lock);
+
+	if (semaphore->created)
+	{
+		semaphore = NULL;
+	}
+	else
+	{
+		semaphore->count = count;
+		semaphore->max_count = count;
+		semaphore->created = 1;
+	}
+
+	EOS_PortCoreUnlock(&dual_shared->lock);
+	EOS_PortRestoreInterrupts(state);
+	return semaphore;
+}
+
+
+/**
+ * @brief Looks up a shared semaphore created by either core.
+ *
+ * @return The semaphore, or NULL if it has not been created yet.
+ */
+EOS_dual_semaphore_id_t EOS_DualSemaphoreOpen(uint32_t index)
+{
+	if (index >= EOS_DUAL_CORE_SEMAPHORES || dual_shared->semaphores[index].created == 0)
+	{
+		return NULL;
+	}
+	return &dual_shared->semaphores[index];
+}
+
+
+/**
+ * @brief Acquires a shared semaphore, blocking the current task until the count is above 0.
+ *
+ * @return EOS_OK on successful acquisition.
+ */
+EOS_status_t EOS_DualSemaphoreAcquire(EOS_dual_semaphore_id_t semaphore)
+{
+	EOS_EnterCritical();
+
+	while (1)
+	{
+		EOS_PortCoreLock(&dual_shared->lock);
+
+		if (semaphore->count > 0)
+		{
+			semaphore->count--;
+			EOS_PortCoreUnlock(&dual_shared->lock);
+			EOS_TRACE(EOS_TRACE_SEM_ACQUIRE, run_ptr, semaphore);
+			EOS_ExitCritical();
+			return EOS_OK;
+		}
+
+		EOS_DualCoreBlock(semaphore);
+		EOS_ExitCritical();
+		EOS_Suspend();
+		EOS_EnterCritical();
+	}
+}
+
+
+/**
+ * @brief Releases a shared semaphore, waking a task waiting on it on either core.
+ *
+ * @return EOS_OK on success, EOS_ERROR if the semaphore is already at its maximum count.
+ */
+EOS_status_t EOS_DualSemaphoreRelease(EOS_dual_semaphore_id_t semaphore)
+{
+	EOS_EnterCritical();
+	EOS_PortCoreLock(&dual_shared->lock);
+
+	if (semaphore->count >= semaphore->max_count)
+	{
+		EOS_PortCoreUnlock(&dual_shared->lock);
+		EOS_ExitCritical();
+		return EOS_ERROR;
+	}
+
+	semaphore->count++;
+	uint32_t notify = EOS_DualCoreChanged(EOS_DualCoreBit(semaphore));
+	EOS_PortCoreUnlock(&dual_shared->lock);
+
+	if (notify)
+	{
+		EOS_PortCoreNotify(dual_core ^ 1);
+	}
+
+	EOS_TRACE(EOS_TRACE_SEM_RELEASE, run_ptr, semaphore);
+	EOS_TaskUnblock(semaphore);
+	EOS_ExitCritical();
+	return EOS_OK;
+}
+
+
+
+/*	QUEUES	*/
+
+
+/**
+ * @brief Creates a shared queue, with its buffer in the shared pool.
+ *
+ * @param index Which queue, below EOS_DUAL_CORE_QUEUES. The other core opens it with the same index.
+ * @param size The max number of items the queue can hold.
+ * @param item_size The size of each item, in bytes.
+ * @return The queue, or NULL if the index is out of range or already created, or the pool is full.
+ */
+EOS_dual_queue_id_t EOS_DualQueueCreate(uint32_t index, uint32_t size, uint32_t item_size)
+{
+	if (index >= EOS_DUAL_CORE_QUEUES || size == 0 || item_size == 0)
+	{
+		return NULL;
+	}
+
+	EOS_dual_queue_t* queue = &dual_shared->queues[index];
+	uint32_t bytes = (size * item_size + 3u) & ~3u;
+	uint32_t state = EOS_PortMaskInterrupts();
+	EOS_PortCoreLock(&dual_shared->lock);
+
+	if (queue->created || bytes > EOS_DUAL_CORE_POOL_SIZE - dual_shared->pool_used)
+	{
+		queue = NULL;
+	}
+	else
+	{
+		queue->buffer = dual_shared->pool_used;
+		queue->head = 0;
+		queue->tail = 0;
+		queue->size = size;
+		queue->item_size = item_size;
+		queue->count = 0;
+		queue->created = 1;
+		dual_shared->pool_used += bytes;
+	}
+
+	EOS_PortCoreUnlock(&dual_shared->lock);
+	EOS_PortRestoreInterrupts(state);
+	return queue;
+}
+
+
+/**
+ * @brief Looks up a shared queue created by either core.
+ *
+ * @return The queue, or NULL if it has not been created yet.
+ */
+EOS_dual_queue_id_t EOS_DualQueueOpen(uint32_t index)
+{
+	if (index >= EOS_DUAL_CORE_QUEUES || dual_shared->queues[index].created == 0)
+	{
+		return NULL;
+	}
+	return &dual_shared->queues[index];
+}
+
+
+/**
+ * @brief Retrieves an item from a shared queue.
+ *
+ * @param queue Queue to take the item from.
+ * @param item  Where the item is copied to.
+ * @param block EOS_BLOCK to wait for an item if the queue is empty, EOS_NO_BLOCK to return straight away.
+ *
+ * @return EOS_OK if an item was retrieved, EOS_BLOCKED if the queue is empty and blocking is disabled.
+ */
+EOS_status_t EOS_DualQueueGet(EOS_dual_queue_id_t queue, void* item, EOS_block_status_t block)
+{
+	EOS_EnterCritical();
+
+	while (1)
+	{
+		EOS_PortCoreLock(&dual_shared->lock);
+
+		if (queue->count > 0)
+		{
+			break;
+		}
+
+		if (block == EOS_NO_BLOCK)
+		{
+			EOS_PortCoreUnlock(&dual_shared->lock);
+			EOS_ExitCritical();
+			return EOS_BLOCKED;
+		}
+
+		EOS_DualCoreBlock(queue);
+		EOS_ExitCritical();
+		EOS_Suspend();
+		EOS_EnterCritical();
+	}
+
+	memcpy(item, &dual_shared->pool[queue->buffer + queue->head * queue->item_size], queue->item_size);
+	queue->head = (queue->head + 1) % queue->size;
+	queue->count--;
+	uint32_t notify = EOS_DualCoreChanged(EOS_DualCoreBit(queue));
+	EOS_PortCoreUnlock(&dual_shared->lock);
+
+	if (notify)
+	{
+		EOS_PortCoreNotify(dual_core ^ 1);
+	}
+
+	EOS_TRACE(EOS_TRACE_QUEUE_GET, run_ptr, queue);
+	EOS_TaskUnblock(queue);
+	EOS_ExitCritical();
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Adds an item to a shared queue.
+ *
+ * @param queue Queue to add the item to.
+ * @param item  The item, item_size bytes.
+ * @param block EOS_BLOCK to wait for space if the queue is full, EOS_NO_BLOCK to return straight away.
+ *
+ * @return EOS_OK if the item was added, EOS_BLOCKED if the queue is full and blocking is disabled.
+ */
+EOS_status_t EOS_DualQueuePut(EOS_dual_queue_id_t queue, const void* item, EOS_block_status_t block)
+{
+	EOS_EnterCritical();
+
+	while (1)
+	{
+		EOS_PortCoreLock(&dual_shared->lock);
+
+		if (queue->count < queue->size)
+		{
+			break;
+		}
+
+		if (block == EOS_NO_BLOCK)
+		{
+			EOS_PortCoreUnlock(&dual_shared->lock);
+			EOS_ExitCritical();
+			return EOS_BLOCKED;
+		}
+
+		EOS_DualCoreBlock(queue);
+		EOS_ExitCritical();
+		EOS_Suspend();
+		EOS_EnterCritical();
+	}
+
+	memcpy(&dual_shared->pool[queue->buffer + queue->tail * queue->item_size], item, queue->item_size);
+	queue->tail = (queue->tail + 1) % queue->size;
+	queue->count++;
+	uint32_t notify = EOS_DualCoreChanged(EOS_DualCoreBit(queue));
+	EOS_PortCoreUnlock(&dual_shared->lock);
+
+	if (notify)
+	{
+		EOS_PortCoreNotify(dual_core ^ 1);
+	}
+
+	EOS_TRACE(EOS_TRACE_QUEUE_PUT, run_ptr, queue);
+	EOS_TaskUnblock(queue);
+	EOS_ExitCritical();
+	return EOS_OK;
+}
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Returns the bit of an object in the waiting and pending masks.
+ */
+static uint32_t EOS_DualCoreBit(const void* object)
+{
+	const uint8_t* address = (const uint8_t*)object;
+	const uint8_t* semaphores = (const uint8_t*)dual_shared->semaphores;
+
+	if (address >= semaphores && address < (const uint8_t*)&dual_shared->semaphores[EOS_DUAL_CORE_SEMAPHORES])
+	{
+		return 1u << (uint32_t)((const EOS_dual_semaphore_t*)object - dual_shared->semaphores);
+	}
+	return 1u << (16 + (uint32_t)((const EOS_dual_queue_t*)object - dual_shared->queues));
+}
+
+
+/**
+ * @brief Blocks the running task on a shared object. Called in a critical section, with the lock held, which it
+ * 			releases. The task is marked blocked before the lock is released, so the other core's interrupt, which
+ * 			can only be taken once the critical section ends, always finds it.
+ */
+static void EOS_DualCoreBlock(void* object)
+{
+	dual_shared->waiting[dual_core] |= EOS_DualCoreBit(object);
+	run_ptr->blocked = object;
+	EOS_PortCoreUnlock(&dual_shared->lock);
+
+	EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, object);
+	EOS_WaitProfileBlock(run_ptr, object);
+}
+
+
+/**
+ * @brief Called with the lock held after an object has changed. If the other core has tasks blocked on it, marks it
+ * 			pending for that core.
+ *
+ * @return 1 if the other core must be interrupted, 0 if it has no waiters, or an interrupt is already on its way.
+ */
+static uint32_t EOS_DualCoreChanged(uint32_t bit)
+{
+	uint32_t other = dual_core ^ 1;
+
+	if ((dual_shared->waiting[other] & bit) == 0)
+	{
+		return 0;
+	}
+
+	uint32_t pending = dual_shared->pending[other];
+	dual_shared->waiting[other] &= ~bit;
+	dual_shared->pending[other] = pending | bit;
+	return pending == 0;
+}
+
+
+/**
+ * @brief Unblocks every task on this core blocked on an object, highest priority first. The interrupt can be taken
+ * 			right after a task has blocked, before it has switched out, so the running task is unblocked here too, as
+ * 			EOS_TaskUnblock() only looks at the others.
+ */
+static void EOS_DualCoreWake(void* object)
+{
+	uint32_t waiters = 0;
+
+	EOS_EnterCritical();
+	if (run_ptr->blocked == object)
+	{
+		run_ptr->blocked = 0;
+		EOS_TRACE(EOS_TRACE_UNBLOCK, run_ptr, object);
+		EOS_WaitProfileUnblock(run_ptr);
+	}
+
+	for (EOS_TCB_t* task = run_ptr->next; task != run_ptr; task = task->next)
+	{
+		waiters += (task->blocked == object);
+	}
+	EOS_ExitCritical();
+
+	while (waiters--)
+	{
+		EOS_EnterCritical();
+		EOS_TaskUnblock(object);
+		EOS_ExitCritical();
+	}
+}
+
+#endif
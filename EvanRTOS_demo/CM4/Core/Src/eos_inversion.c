@@ -0,0 +1,347 @@
+/*
+ * eos_inversion.c
+ *
+ *      Priority inversion detector for EvanRTOS. EvanRTOS semaphores have no owner and no priority inheritance, so a
+ *      high priority task blocked on a semaphore held by a low priority task waits for as long as the low priority task
+ *      keeps it, and for as long as any other task runs instead of the holder. When EOS_INVERSION_DETECT_ENABLE is set
+ *      in eos_config.h, this file makes that visible:
+ *      	- EOS_InversionAcquire()/EOS_InversionRelease() keep a table of which task holds each semaphore count
+ *      	- EOS_InversionBlock() starts an inversion when a task blocks on a semaphore held by a lower priority task
+ *      	- EOS_InversionSwitch() adds the time other tasks run in the meantime to each inversion in progress
+ *      	- the inversion ends when the waiting task finally acquires the semaphore
+ *
+ *      Each finished inversion records the semaphore, both tasks and their priorities, the total duration, and how much
+ *      of it was spent running tasks other than the holder (the part of the wait the holder's own work does not
+ *      explain, often a medium priority task preempting the holder). The last EOS_INVERSION_LOG inversions are kept,
+ *      along with totals and the worst case.
+ *
+ *      Semaphores are often released by a task (or interrupt) other than the one that acquired them, for signalling.
+ *      Such a release frees the oldest count held on that semaphore, so the holds table stays in step with the count.
+ *      Queues have no holder, and are not checked.
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "eos_port.h"
+#include "eos_inversion.h"
+
+#if EOS_INVERSION_DETECT_ENABLE
+
+/*	DATATYPES	*/
+
+typedef struct {
+	void* object;
+	EOS_TCB_t* task;
+} EOS_inversion_hold_t;
+
+typedef struct {
+	void* object;			//NULL when the task is not in an inversion
+	EOS_TCB_t* holder;
+	uint8_t waiter_priority;
+	uint8_t holder_priority;
+	uint32_t start;
+	uint32_t others;
+} EOS_inversion_active_t;
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_inversion_hold_t inversion_holds[EOS_INVERSION_HOLDS];
+static EOS_inversion_active_t inversion_active[EOS_INVERSION_TASKS];
+static EOS_inversion_t inversion_log[EOS_INVERSION_LOG];
+static uint32_t inversion_log_next = 0;
+static EOS_inversion_stats_t inversion_stats;
+static uint32_t inversion_last_switch = 0;
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Ends the inversion of a waiting task, and records it.
+ */
+static void EOS_InversionEnd(EOS_TCB_t* task)
+{
+	EOS_inversion_active_t* active = &inversion_active[task->id];
+	EOS_inversion_t* event = &inversion_log[inversion_log_next];
+	uint32_t now = EOS_GetCycles();
+
+	event->object = active->object;
+	event->waiter = task->id;
+	event->holder = active->holder->id;
+	event->waiter_priority = active->waiter_priority;
+	event->holder_priority = active->holder_priority;
+	event->duration = now - active->start;
+	event->others = active->others;
+	event->end = now;
+
+	inversion_log_next = (inversion_log_next + 1) % EOS_INVERSION_LOG;
+
+	inversion_stats.count++;
+	inversion_stats.total += event->duration;
+	if (event->duration > inversion_stats.worst.duration)
+	{
+		inversion_stats.worst = *event;
+	}
+	if (event->others > inversion_stats.others_max)
+	{
+		inversion_stats.others_max = event->others;
+	}
+
+	active->object = NULL;
+	inversion_stats.active--;
+}
+
+
+
+/*	DETECTOR FUNCTIONALITY	*/
+
+
+/**
+ * @brief Clears the holds table and statistics. Called by EOS_Init(), before any task has run.
+ */
+void EOS_InversionInit(void)
+{
+	memset(inversion_holds, 0, sizeof(inversion_holds));
+	memset(inversion_active, 0, sizeof(inversion_active));
+	memset(inversion_log, 0, sizeof(inversion_log));
+	memset(&inversion_stats, 0, sizeof(inversion_stats));
+	inversion_log_next = 0;
+	inversion_last_switch = EOS_GetCycles();
+}
+
+
+/**
+ * @brief Called with interrupts disabled when a task acquires a semaphore. Ends the task's inversion if it was waiting
+ * 			on this semaphore, and records the task as a holder.
+ */
+void EOS_InversionAcquire(EOS_TCB_t* task, void* object)
+{
+	if (task->id < EOS_INVERSION_TASKS && inversion_active[task->id].object == object)
+	{
+		EOS_InversionEnd(task);
+	}
+
+	for (uint32_t i = 0; i < EOS_INVERSION_HOLDS; i++)
+	{
+		if (inversion_holds[i].object == NULL)
+		{
+			inversion_holds[i].object = object;
+			inversion_holds[i].task = task;
+			return;
+		}
+	}
+	inversion_stats.overflow++;
+}
+
+
+/**
+ * @brief Called with interrupts disabled when a semaphore is released. Frees a count held by the releasing task, or
+ * 			the oldest count held on the semaphore if the task holds none (a signalling release).
+ */
+void EOS_InversionRelease(EOS_TCB_t* task, void* object)
+{
+	EOS_inversion_hold_t* oldest = NULL;
+
+	for (uint32_t i = 0; i < EOS_INVERSION_HOLDS; i++)
+	{
+		if (inversion_holds[i].object != object)
+		{
+			continue;
+		}
+		if (inversion_holds[i].task == task)
+		{
+			inversion_holds[i].object = NULL;
+			return;
+		}
+		if (oldest == NULL)
+		{
+			oldest = &inversion_holds[i];
+		}
+	}
+
+	if (oldest != NULL)
+	{
+		oldest->object = NULL;
+	}
+}
+
+
+/**
+ * @brief Called with interrupts disabled when a task blocks on a semaphore. Starts an inversion if a lower priority
+ * 			task holds it. A task that is woken up but blocks again keeps its original inversion.
+ */
+void EOS_InversionBlock(EOS_TCB_t* task, void* object)
+{
+	if (task->id >= EOS_INVERSION_TASKS || inversion_active[task->id].object != NULL)
+	{
+		return;
+	}
+
+	EOS_TCB_t* holder = NULL;
+
+	for (uint32_t i = 0; i < EOS_INVERSION_HOLDS; i++)
+	{
+		EOS_TCB_t* candidate = inversion_holds[i].task;
+
+		if (inversion_holds[i].object == object && candidate->priority < task->priority &&
+				(holder == NULL || candidate->priority < holder->priority))
+		{
+			holder = candidate;
+		}
+	}
+
+	if (holder == NULL)
+	{
+		return;
+	}
+
+	EOS_inversion_active_t* active = &inversion_active[task->id];
+	active->object = object;
+	active->holder = holder;
+	active->waiter_priority = task->priority;
+	active->holder_priority = holder->priority;
+	active->start = EOS_GetCycles();
+	active->others = 0;
+	inversion_stats.active++;
+}
+
+
+/**
+ * @brief Called by the scheduler, with interrupts disabled, when it switches from one task to another. The time the
+ * 			outgoing task ran is added to every inversion in progress it is not the holder of.
+ */
+void EOS_InversionSwitch(EOS_TCB_t* out, EOS_TCB_t* in)
+{
+	uint32_t now = EOS_GetCycles();
+	uint32_t elapsed = now - inversion_last_switch;
+
+	inversion_last_switch = now;
+	(void)in;
+
+	if (inversion_stats.active == 0 || out->id == 0)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < EOS_INVERSION_TASKS; i++)
+	{
+		EOS_inversion_active_t* active = &inversion_active[i];
+
+		if (active->object != NULL && active->holder != out && out->id != i)
+		{
+			active->others += elapsed;
+		}
+	}
+}
+
+
+
+/*	REPORTING	*/
+
+
+/**
+ * @brief Returns the totals and worst case of all inversions since the last reset.
+ */
+const EOS_inversion_stats_t* EOS_InversionStats(void)
+{
+	return &inversion_stats;
+}
+
+
+/**
+ * @brief Copies the logged inversions, oldest first.
+ *
+ * @param events Array to copy into.
+ * @param max Size of the array.
+ *
+ * @return The number of inversions copied.
+ */
+uint32_t EOS_InversionRead(EOS_inversion_t* events, uint32_t max)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t logged = (inversion_stats.count < EOS_INVERSION_LOG) ? inversion_stats.count : EOS_INVERSION_LOG;
+	uint32_t first = (inversion_log_next + EOS_INVERSION_LOG - logged) % EOS_INVERSION_LOG;
+	uint32_t copied = 0;
+
+	if (logged > max)
+	{
+		first = (first + logged - max) % EOS_INVERSION_LOG;
+		logged = max;
+	}
+
+	for (; copied < logged; copied++)
+	{
+		events[copied] = inversion_log[(first + copied) % EOS_INVERSION_LOG];
+	}
+
+	EOS_PortRestoreInterrupts(state);
+	return copied;
+}
+
+
+/**
+ * @brief Clears the log and statistics. Holds, and inversions in progress, are kept.
+ */
+void EOS_InversionReset(void)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t active = inversion_stats.active;
+
+	memset(inversion_log, 0, sizeof(inversion_log));
+	memset(&inversion_stats, 0, sizeof(inversion_stats));
+	inversion_stats.active = active;
+	inversion_log_next = 0;
+
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+static void EOS_InversionPrint(const char* kind, const EOS_inversion_t* event)
+{
+	printf("{\"inversion\":\"%s\",\"object\":\"0x%08lx\",\"waiter\":%u,\"waiter_priority\":%u,\"holder\":%u,"
+			"\"holder_priority\":%u,\"unit\":\"cycles\",\"duration\":%lu,\"others\":%lu}\n", kind,
+			(unsigned long)(uintptr_t)event->object, event->waiter, event->waiter_priority, event->holder,
+			event->holder_priority, (unsigned long)event->duration, (unsigned long)event->others);
+}
+
+
+/**
+ * @brief Prints one JSON line per logged inversion (oldest first), one per inversion still in progress, then a summary
+ * 			line with the worst case.
+ */
+void EOS_InversionReport(void)
+{
+	EOS_inversion_t events[EOS_INVERSION_LOG];
+	uint32_t count = EOS_InversionRead(events, EOS_INVERSION_LOG);
+	uint32_t now = EOS_GetCycles();
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		EOS_InversionPrint("event", &events[i]);
+	}
+
+	for (uint32_t i = 0; i < EOS_INVERSION_TASKS; i++)
+	{
+		const EOS_inversion_active_t* active = &inversion_active[i];
+
+		if (active->object != NULL)
+		{
+			EOS_inversion_t event = {active->object, i, active->holder->id, active->waiter_priority,
+					active->holder_priority, now - active->start, active->others, 0};
+
+			EOS_InversionPrint("in_progress", &event);
+		}
+	}
+
+	printf("{\"inversion\":\"summary\",\"cycle_hz\":%lu,\"count\":%lu,\"total\":%llu,\"worst\":%lu,"
+			"\"worst_object\":\"0x%08lx\",\"worst_waiter\":%u,\"worst_holder\":%u,\"others_max\":%lu,\"active\":%lu,"
+			"\"overflow\":%lu}\n", (unsigned long)EOS_PORT_CYCLE_HZ, (unsigned long)inversion_stats.count,
+			(unsigned long long)inversion_stats.total, (unsigned long)inversion_stats.worst.duration,
+			(unsigned long)(uintptr_t)inversion_stats.worst.object, inversion_stats.worst.waiter,
+			inversion_stats.worst.holder, (unsigned long)inversion_stats.others_max,
+			(unsigned long)inversion_stats.active, (unsigned long)inversion_stats.overflow);
+}
+
+#endif
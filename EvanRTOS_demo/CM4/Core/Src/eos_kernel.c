@@ -0,0 +1,736 @@
+/*
+ * eos_kernel.c
+ *
+ *      Basic Functions for EvanRTOS, a basic, lightweight RTOS, custom built for the STM32h747 MCU. EvanRTOS contains functions inspired by the
+ *      CMSIS RTOSv2 API.
+ *
+ *      EvanRTOS operates as a single core, pre-emptive scheduler. Tasks can be given a priority of EOS_priority_t,
+ *      and will run based off these priorities. If a high priority task runs, and never blocks, a lower priority task will never be given cpu time.
+ *      Two tasks of the same priority will run equally. If a high priority task becomes unblocked while a low priority task is still running,
+ *      the high priority task will preempt the lower priority task in order to run.
+ *
+ *      In EvanRTOS, each task has a stack, that can be either dynamically or statically allocated. Passing NULL into the third field of EOS_ThreadNew()
+ *      will result in the kernel dynamically allocating space for that task, with the size in the fourth field of the function. Otherwise, the user
+ *      must create stack space and pass it into the function.
+ *
+ *
+ *      For a more thorough overview, please look at README.MD.
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "eos_kernel.h"
+#include "eos_port.h"
+#include "eos_trace.h"
+#include "eos_critical.h"
+#include "eos_profile.h"
+#include "eos_wait.h"
+#include "eos_inversion.h"
+#include "eos_smp.h"
+#include "eos_hal.h"
+#include <string.h>
+
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_HandleTimeout();
+static void idleTask();
+static void EOS_PaintStack(int32_t* stack, uint32_t stack_size);
+
+
+/*	GLOBAL VARIABLES*/
+uint32_t task_period = DEFAULT_TASK_PERIOD;
+uint8_t scheduler_enable = 0;
+uint16_t task_count = 0;
+#if EOS_TASK_STATS_ENABLE
+static uint32_t stats_since = 0;			//cycle count of the last switch
+static uint64_t stats_total = 0;			//cycles accounted to any task
+static uint64_t stats_snapshot_total = 0;	//stats_total at the last EOS_TaskSnapshot()
+#endif
+
+int32_t idle_stack[32];
+EOS_TCB_t idle_task = {
+		.blocked = 0,
+		.next = &idle_task,
+		.priority = PRIORITY_IDLE,
+		.sp = NULL, //set up by EOS_Init()
+		.timeOut = 0,
+		.paused = 0,
+		.id = 0,
+		.stack = idle_stack,
+		.stack_size = 32
+};
+
+#if !EOS_SMP_ENABLE
+EOS_TCB_t* run_ptr = &idle_task;
+#endif
+
+
+/*		EOS STARTUP		*/
+
+
+/**
+ * @brief Creates a new thread and adds it to the list of tasks.
+ *
+ * @details The task control block is always dynamically allocated. Stack space for the stack can either be
+ * 			statically or dynamically allocated.
+ *          If the provided task stack is NULL, it allocates memory for the stack dynamically. Otherwise,
+ *          the user must provide statically declared task space.
+ *
+ * @param function Pointer to the function of the new task.
+ * @param priority Priority level of the task. Must not exceed `PRIORITY_HIGH`.
+ * @param task_stack Pointer to the memory allocated for the task stack. If `NULL`, the stack will
+ *                   be allocated dynamically.
+ * @param stack_size Size of the stack in words. Must be at least 64 words.
+ * @param use_fpu Status indicating whether the task uses floating point operations.  EOS_USE_FPU implies the task contains
+ * 		  	floating point operations. EOS_NO_FPU is the default, when the task contains no floating point operations.
+ * 			This must be defined by the user.
+ *
+ * @return A pointer to the newly created task's TCB (as `EOS_task_id_t`), or `EOS_ERROR` on failure, which includes
+ * 			every call after 65535 tasks have been created (task ids are 16 bit).
+ *
+ */
+EOS_task_id_t EOS_ThreadNew(void* function, EOS_priority_t priority, int32_t* task_stack, uint32_t stack_size, EOS_status_t use_fpu){
+
+	if (stack_size < 64)
+	{
+		return EOS_ERROR;
+	}
+
+	if (priority > PRIORITY_HIGH)
+	{
+		return EOS_ERROR;
+	}
+
+	if (task_count == UINT16_MAX) //task ids are used up
+	{
+		return EOS_ERROR;
+	}
+	EOS_TCB_t* control_block = (EOS_TCB_t*)malloc(sizeof(EOS_TCB_t));
+
+	if (control_block == NULL)
+	{
+		return EOS_ERROR;
+	}
+
+	int32_t* stack = task_stack;
+
+	if (stack == NULL)
+	{
+		stack = (int32_t*)malloc(stack_size * sizeof(int32_t));
+
+		if(stack == NULL)
+		{
+			free(control_block);
+			return EOS_ERROR;
+		}
+	}
+
+	EOS_PaintStack(stack, stack_size);
+	int32_t* sp = EOS_PortInitStack(stack, stack_size, function, use_fpu);
+
+	if (sp == NULL)
+	{
+		if (task_stack == NULL)
+		{
+			free(stack);
+		}
+		free(control_block);
+		return EOS_ERROR;
+	}
+
+	control_block->sp = sp;
+	control_block->priority = priority;
+	control_block->blocked = 0;
+	control_block->timeOut = 0;
+	control_block->paused = 0;
+	control_block->stack = stack;
+	control_block->stack_size = stack_size;
+#if EOS_TASK_STATS_ENABLE
+	control_block->cycles = 0;
+	control_block->snapshot_cycles = 0;
+	control_block->switches = 0;
+#endif
+	EOS_WaitProfileCreate(control_block);
+
+#if EOS_SMP_ENABLE
+	EOS_SmpSetup();
+	EOS_EnterCritical(); //other cores may be scheduling already
+	EOS_SmpAssign(control_block);
+#endif
+	control_block->id = ++task_count;
+
+	EOS_TCB_t* temp = run_ptr;
+	while (temp->next != run_ptr)
+	{
+		temp = temp->next;
+	}
+
+	temp->next = control_block;
+	control_block->next = run_ptr;
+#if EOS_SMP_ENABLE
+	EOS_ExitCritical();
+#endif
+
+
+	return control_block;
+}
+
+
+/**
+ * @brief Initializes the RTOS and starts the scheduler.
+ *
+ * @param user_task_period The desired task period (in ms) specified by the user. Default is 1ms.
+ *
+ */
+void EOS_Init(uint32_t user_task_period){
+	EOS_EnterCritical();
+	scheduler_enable = 1;
+
+	EOS_PortInit();
+	EOS_PaintStack(idle_stack, 32);
+	idle_task.sp = EOS_PortInitStack(idle_stack, 32, idleTask, EOS_NO_FPU);
+#if EOS_SMP_ENABLE
+	EOS_SmpSetup();
+	for (uint32_t core = 1; core < EOS_SMP_CORES; core++)
+	{
+		EOS_TCB_t* idle = EOS_SmpIdleTask(core);
+		EOS_PaintStack(idle->stack, idle->stack_size);
+		idle->sp = EOS_PortInitStack(idle->stack, idle->stack_size, idleTask, EOS_NO_FPU);
+	}
+#endif
+#if EOS_TASK_STATS_ENABLE
+	stats_since = EOS_GetCycles();
+#endif
+	EOS_TraceInit();
+	EOS_CriticalProfileInit();
+	EOS_ProfileInit();
+	EOS_WaitProfileInit();
+	EOS_InversionInit();
+
+
+	if (user_task_period != task_period){
+		task_period = user_task_period;
+	}
+
+	EOS_PortStartScheduler();
+}
+
+
+
+
+/*		EOS CORE IMPLEMENTATION (CONTEXT SWITCHING)		*/
+
+
+/**
+ * @brief Priority-Based Round Robin Scheduler.
+ *
+ * The highest, unblocked task will run. Two tasks of equal priority running will timesplice, so that they both get
+ * equal running time. If there are no unblocked tasks, the idle task will run.
+ *
+ * @note Called by the port, with interrupts disabled, when switching context. With EOS_SMP_ENABLE, each core
+ * 		 schedules its own run queue (see eos_smp.c).
+ */
+void EOS_scheduler(void)
+{
+
+#if EOS_STACK_CHECK_ENABLE
+	for (uint32_t i = 0; i < EOS_STACK_GUARD_WORDS; i++)
+	{
+		if ((uint32_t)run_ptr->stack[i] != EOS_STACK_PAINT)
+		{
+			EOS_StackOverflow(run_ptr);
+		}
+	}
+#endif
+
+#if EOS_SMP_ENABLE
+	EOS_SmpLock();
+	EOS_TCB_t* best_pointer = EOS_SmpPick(run_ptr);
+#else
+	EOS_TCB_t* current_ptr = run_ptr->next;
+	EOS_TCB_t* best_pointer = run_ptr;
+    if (run_ptr->blocked != 0 || run_ptr->paused != 0)
+    {
+    	best_pointer = &idle_task; //every other task is still checked below
+    }
+
+	while (current_ptr != run_ptr){
+		if (current_ptr->blocked == 0 && current_ptr->paused == 0 && current_ptr->priority >= best_pointer->priority){
+			best_pointer = current_ptr;
+		}
+		current_ptr = current_ptr->next;
+	}
+#endif
+
+	if (best_pointer != run_ptr)
+	{
+		EOS_TRACE(EOS_TRACE_TASK_OUT, run_ptr, 0);
+		EOS_TRACE(EOS_TRACE_TASK_IN, best_pointer, 0);
+		EOS_WaitProfileSwitch(run_ptr, best_pointer);
+		EOS_InversionSwitch(run_ptr, best_pointer);
+#if EOS_TASK_STATS_ENABLE
+		uint32_t now = EOS_GetCycles();
+		run_ptr->cycles += now - stats_since;
+		stats_total += now - stats_since;
+		stats_since = now;
+		best_pointer->switches++;
+#endif
+	}
+#if EOS_SMP_ENABLE
+	eos_run_ptr[EOS_PortCoreId()] = best_pointer;
+	EOS_SmpUnlock();
+#else
+	run_ptr = best_pointer;
+#endif
+
+	return;
+}
+
+
+/**
+ * @brief Kernel tick, called by the port every 1ms (the Systick interrupt on Cortex-M).
+ *
+ * Triggers a context switch when it is time to perform one. Handles task timeout decrementing. With EOS_SMP_ENABLE,
+ * every core ticks, and core 0 handles the timeouts.
+ */
+void EOS_Tick(void)
+{
+	EOS_EnterCritical();
+	static uint32_t eos_tickCounter[EOS_CORES] = {0};
+	uint32_t core = EOS_CORE_ID();
+
+	eos_tickCounter[core]++;
+
+	if (eos_tickCounter[core] >= task_period && scheduler_enable == 1)
+	{
+		eos_tickCounter[core] = 0;
+		if (core == 0)
+		{
+			EOS_HandleTimeout();
+		}
+		EOS_PortYield();
+  	}
+
+	EOS_ExitCritical();
+
+#if EOS_HAL_ENABLE
+	if (core == 0)
+	{
+		EOS_HalTick(); //every tick, whatever the task period
+	}
+#endif
+}
+
+
+
+/*		BASIC RTOS OPERATIONS		*/
+
+
+/**
+ * @brief Suspends the currently running task for a specified timeout period.
+ *
+ * @param timeout The delay period in ms.
+ *                If the period is 0, the timeout will be 1ms.
+ *
+ * @return None.
+ *
+ */
+void EOS_Delay(uint32_t timeout){
+	EOS_EnterCritical();
+	if (timeout == 0){
+		timeout = 1;
+	}
+	run_ptr->blocked = EOS_TIMED_OUT;
+	run_ptr->timeOut = timeout;
+	EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, EOS_TIMED_OUT);
+	EOS_WaitProfileBlock(run_ptr, EOS_TIMED_OUT);
+	EOS_ExitCritical();
+	EOS_Suspend();
+
+}
+
+
+/**
+ * @brief Pauses the specified task, blocking it indefinitely.
+ *
+ * @param task ID of the task being paused.
+ *
+ * @return EOS_OK if the task was successfully paused.
+ *         EOS_ERROR if the task pointer is NULL.
+ *
+ * This function can be called from an interrupt, the task being paused, or another task.
+ */
+EOS_status_t EOS_Pause(EOS_task_id_t task)
+{
+	EOS_EnterCritical();
+
+	if (task == NULL)
+	{
+		EOS_ExitCritical();
+		return EOS_ERROR;
+	}
+
+	if(task->paused != 0)
+	{
+		EOS_ExitCritical();
+		return EOS_ERROR;
+	}
+
+	task->paused = EOS_PAUSED;
+#if EOS_SMP_ENABLE
+	EOS_SmpPreempt(task);
+#endif
+
+	if (task == run_ptr)
+	{
+		EOS_ExitCritical();
+		EOS_Suspend();
+	}
+
+	EOS_ExitCritical();
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Resumes a task that was previously paused using EOS_Pause.
+ *
+ * @param task ID of the task being resumed.
+ *
+ * @return EOS_OK if the task was successfully resumed.
+ *         EOS_ERROR if the task pointer is NULL or the task is not in a paused state.
+ *
+ * @note A task must be resumed by another task or an interrupt.
+ * 		 The paused state is different from the blocked state.
+ */
+EOS_status_t EOS_Resume(EOS_task_id_t task)
+{
+	EOS_EnterCritical();
+
+	if (task == NULL)
+	{
+		EOS_ExitCritical();
+		return EOS_ERROR;
+	}
+
+	if (task->paused != EOS_PAUSED)
+	{
+		EOS_ExitCritical();
+		return EOS_ERROR;
+	}
+
+	task->paused = 0;
+#if EOS_SMP_ENABLE
+	if (task->blocked == 0)
+	{
+		EOS_SmpWake(task); //like on a single core, the calling task is not preempted
+	}
+#endif
+	EOS_ExitCritical();
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Fills an array with the state of every task, starting with the idle task.
+ *
+ * @details Each task's state is read with interrupts masked, one task at a time, so the snapshot is consistent per task
+ * 			but not across tasks. With EOS_TASK_STATS_ENABLE, it also gives each task's stack high water mark (see
+ * 			EOS_StackHighWater(), found outside of the masked section), its cycles, switch count, and share of the CPU
+ * 			since the previous call. CPU shares are only meaningful if a single caller takes
+ * 			snapshots.
+ *
+ * @param tasks Array to fill in.
+ * @param max Size of the array.
+ *
+ * @return The number of tasks filled in.
+ */
+uint32_t EOS_TaskSnapshot(EOS_task_info_t* tasks, uint32_t max){
+
+	EOS_TCB_t* task = &idle_task;
+	uint32_t count = 0;
+
+#if EOS_TASK_STATS_ENABLE
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t now = EOS_GetCycles();
+	run_ptr->cycles += now - stats_since;
+	stats_total += now - stats_since;
+	stats_since = now;
+	uint64_t interval = stats_total - stats_snapshot_total;
+	stats_snapshot_total = stats_total;
+	EOS_PortRestoreInterrupts(state);
+#endif
+
+	do
+	{
+		if (count == max)
+		{
+			break;
+		}
+
+		EOS_task_info_t* info = &tasks[count++];
+		memset(info, 0, sizeof(EOS_task_info_t));
+
+		uint32_t mask = EOS_PortMaskInterrupts();
+
+		info->task = task;
+		info->id = task->id;
+		info->priority = task->priority;
+		info->stack_size = task->stack_size;
+
+		if (task->paused)
+		{
+			info->state = EOS_TASK_PAUSED;
+		}
+		else if (task->blocked == EOS_TIMED_OUT)
+		{
+			info->state = EOS_TASK_DELAYED;
+			info->timeout = task->timeOut;
+		}
+		else if (task->blocked != 0)
+		{
+			info->state = EOS_TASK_BLOCKED;
+			info->object = task->blocked;
+		}
+		else
+		{
+#if EOS_SMP_ENABLE
+			info->state = (task->running != EOS_SMP_NO_CORE) ? EOS_TASK_RUNNING : EOS_TASK_READY;
+#else
+			info->state = (task == run_ptr) ? EOS_TASK_RUNNING : EOS_TASK_READY;
+#endif
+		}
+
+#if EOS_TASK_STATS_ENABLE
+		info->cycles = task->cycles;
+		info->switches = task->switches;
+		if (interval != 0)
+		{
+			info->cpu = (uint16_t)((task->cycles - task->snapshot_cycles) * 1000 / interval);
+		}
+		task->snapshot_cycles = task->cycles;
+#endif
+
+		EOS_PortRestoreInterrupts(mask);
+
+		info->stack_used = EOS_StackHighWater(task);
+
+		task = task->next;
+	} while (task != &idle_task);
+
+	return count;
+}
+
+
+
+/**
+ * @brief Returns the most stack a task has ever used, in words.
+ *
+ * @details The stack is painted with EOS_STACK_PAINT when the task is created, and scanned up from its lowest address
+ * 			to the first word that was written, so the cost grows with the part of the stack that was never used, not
+ * 			with the stack size. It can miss use by a function that reserves stack space it never writes. Stacks are
+ * 			painted when EOS_STACK_CHECK_ENABLE or EOS_TASK_STATS_ENABLE is set, otherwise this returns 0. On the
+ * 			POSIX port, tasks run on host stacks, and this also returns 0. With EOS_MPU_GUARD_ENABLE, the scan starts
+ * 			above the guard region, which counts as used.
+ *
+ * @param task The task, or NULL for the calling task.
+ *
+ * @return Words of the stack used at most, so far.
+ */
+uint32_t EOS_StackHighWater(EOS_task_id_t task){
+#if EOS_STACK_PAINT_ENABLE
+	if (task == NULL)
+	{
+		task = run_ptr;
+	}
+
+	uint32_t untouched = 0;
+#if EOS_MPU_GUARD_ENABLE
+	//the running task's guard region can't be read, and a guard can't have been written to without a fault
+	uintptr_t guard_end = (((uintptr_t)task->stack + EOS_MPU_GUARD_SIZE - 1) & ~(uintptr_t)(EOS_MPU_GUARD_SIZE - 1)) +
+			EOS_MPU_GUARD_SIZE;
+	untouched = (uint32_t)((guard_end - (uintptr_t)task->stack) / sizeof(int32_t));
+	if (untouched > task->stack_size)
+	{
+		untouched = task->stack_size;
+	}
+#endif
+	while (untouched < task->stack_size && (uint32_t)task->stack[untouched] == EOS_STACK_PAINT)
+	{
+		untouched++;
+	}
+	return task->stack_size - untouched;
+#else
+	(void)task;
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief Called when a task has overflowed its stack: by the scheduler when EOS_STACK_CHECK_ENABLE finds the bottom
+ * 			of the outgoing task's stack written, or by the port's memory fault handler when the EOS_MPU_GUARD_ENABLE
+ * 			guard is hit. The stack and whatever lies below it can no longer be trusted, so the default stops
+ * 			everything, with the task in its argument for a debugger. Override it to log and reset instead.
+ */
+__attribute__((weak)) void EOS_StackOverflow(EOS_task_id_t task){
+	volatile EOS_task_id_t overflowed = task;
+	(void)overflowed;
+
+	EOS_PortDisableInterrupts();
+	while (1)
+	{
+	}
+}
+
+
+
+/*		HELPER FUNCTIONS		*/
+
+
+/**
+ * @brief Requests a context switch from the port (the PendSV interrupt on Cortex-M)
+ */
+void EOS_Suspend(){
+	EOS_PortYield();
+}
+
+
+#if !EOS_CRITICAL_PROFILE_ENABLE //replaced by the profiling versions in eos_critical.c
+
+/**
+ * @brief Disables interrupts to allow for critical sections to be run without worry of a context switch. With
+ * 			EOS_SMP_ENABLE, it also takes the kernel lock, to keep the other cores out.
+ */
+void EOS_EnterCritical(){
+	EOS_PortDisableInterrupts();
+#if EOS_SMP_ENABLE
+	EOS_SmpLock();
+#endif
+}
+
+
+/**
+ * @brief Enables interrupts after critical section code has finished running.
+ */
+void EOS_ExitCritical(){
+#if EOS_SMP_ENABLE
+	EOS_SmpUnlock();
+#endif
+	EOS_PortEnableInterrupts();
+}
+
+#endif
+
+
+
+/**
+ * @brief Returns the number of cycles counted by the port's cycle counter (the DWT cycle counter on Cortex-M). The
+ * 			counter is started by EOS_Init(), runs at EOS_PORT_CYCLE_HZ, and wraps around every 2^32 cycles, so
+ * 			differences between two readings should be taken as uint32_t.
+ */
+uint32_t EOS_GetCycles(void){
+	return EOS_PortGetCycles();
+}
+
+
+/**
+ * @brief Unblocks the highest-priority task waiting on the specified resource (queue or semaphore).
+ * 			If the priority of the task is higher than the current running task, it calls the scheduler.
+ *
+ * @param item Pointer to the resource (queue or semaphore) on which tasks may be blocked.
+ *             The function uses a `void*` to allow handling of multiple types of synchronization primitives.
+ */
+void EOS_TaskUnblock(void* item){
+    EOS_TCB_t* tmp_ptr = run_ptr->next;
+    EOS_TCB_t* start_ptr = run_ptr;
+    EOS_TCB_t* best_ptr = NULL;
+
+    do
+    {
+    	if (tmp_ptr->blocked == item)
+    	{
+            if (best_ptr == NULL || tmp_ptr->priority > best_ptr->priority)
+            {
+                best_ptr = tmp_ptr;
+            }
+        }
+
+        tmp_ptr = tmp_ptr->next;
+
+    } while (tmp_ptr != start_ptr);
+
+    if (best_ptr != NULL)
+    {
+        best_ptr->blocked = 0;
+        EOS_TRACE(EOS_TRACE_UNBLOCK, best_ptr, item);
+        EOS_WaitProfileUnblock(best_ptr);
+
+#if EOS_SMP_ENABLE
+        if (EOS_SmpWake(best_ptr))
+#else
+        if (best_ptr->priority > run_ptr->priority)
+#endif
+        {
+            EOS_ExitCritical();
+            EOS_Suspend();
+        }
+    }
+}
+
+/**
+ * @brief Handles task timeouts and unblocks tasks whose timeouts have expired.
+ */
+static void EOS_HandleTimeout(){
+	EOS_TCB_t* head = run_ptr;
+	EOS_TCB_t* current = run_ptr->next;
+
+	 while (current != head)
+	 {
+		 if (current->blocked == EOS_TIMED_OUT && current->paused == 0)
+		 {
+			 if (current->timeOut > 0)
+			 {
+				 current->timeOut--;
+
+				 if (current->timeOut == 0)
+				 {
+					 current->blocked = 0;
+					 EOS_TRACE(EOS_TRACE_UNBLOCK, current, EOS_TIMED_OUT);
+					 EOS_WaitProfileUnblock(current);
+#if EOS_SMP_ENABLE
+					 EOS_SmpWake(current); //the tick switches this core anyway
+#endif
+				 }
+			 }
+		 }
+		  current = current->next;
+	  }
+}
+
+
+/**
+ * @brief Fills a new task stack with EOS_STACK_PAINT, so EOS_StackHighWater() can find how much of it was used.
+ */
+static void EOS_PaintStack(int32_t* stack, uint32_t stack_size){
+#if EOS_STACK_PAINT_ENABLE
+	for (uint32_t i = 0; i < stack_size; i++)
+	{
+		stack[i] = (int32_t)EOS_STACK_PAINT;
+	}
+#else
+	(void)stack;
+	(void)stack_size;
+#endif
+}
+
+
+/*	IDLE TASK	*/
+void idleTask(){
+
+	while(1){
+		EOS_PortIdle();
+	}
+}
@@ -0,0 +1,215 @@
+/*
+ * eos_log.c
+ *
+ *      Deferred formatting log for EvanRTOS. printf() over the UART formats each message on the target, which costs
+ *      thousands of cycles, and then blocks until the UART has sent it. When EOS_LOG_ENABLE is set in eos_config.h,
+ *      EOS_LOG() (see eos_log.h) instead writes a few raw words to a ring:
+ *      	- the offset of the format string in the eos_log section, the number of arguments, and a sync byte
+ *      	- the cycle count (EOS_GetCycles())
+ *      	- one word per argument
+ *      and the low priority drain task started by EOS_LogStart() sends the ring out through EOS_LogOutput(), which the
+ *      application provides (the demo sends it over USART1). tools/eos_log_decode.py reads the format strings back from
+ *      the ELF file and prints the formatted messages, so a log call costs about as much as a few stores, and can be
+ *      left in hot paths of production builds.
+ *
+ *      The ring is lock free, and EOS_LOG() can be called from tasks and interrupts at any priority. A writer reserves
+ *      space by moving the head forward with a compare and swap, fills in the record, and writes the record's first
+ *      word last. The drain task is the only reader: it takes records in order for as long as their first word is
+ *      set, and clears them behind it. A record that does not fit is dropped and counted, the drain task reports the
+ *      number dropped in the stream. Nothing ever waits on the log.
+ *
+ *      Stream format, all words little endian:
+ *      	header:		EOS_LOG_MAGIC, EOS_LOG_VERSION, EOS_PORT_CYCLE_HZ, address of the eos_log section
+ *      	record:		EOS_LOG_SYNC | count << 16 | format offset, cycles, count argument words
+ *      The section address lets the decoder relocate the format and %s addresses of position independent builds.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_log.h"
+
+#if EOS_LOG_ENABLE
+
+#if (EOS_LOG_BUFFER_WORDS & (EOS_LOG_BUFFER_WORDS - 1)) != 0
+#error "EOS_LOG_BUFFER_WORDS must be a power of 2"
+#endif
+
+#define EOS_LOG_MASK (EOS_LOG_BUFFER_WORDS - 1)
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_LogTask(void);
+
+
+/*	GLOBAL VARIABLES	*/
+extern const char __start_eos_log[];			//start of the format strings, defined by the linker
+extern const char __stop_eos_log[];			//end of the format strings, defined by the linker
+
+static uint32_t log_buffer[EOS_LOG_BUFFER_WORDS];
+static uint32_t log_head = 0;					//words reserved by writers, wraps around
+static uint32_t log_tail = 0;					//words taken by the drain task, wraps around
+static EOS_log_stats_t log_stats;
+
+static int32_t log_stack[EOS_LOG_STACK_SIZE];
+static uint32_t log_drain[EOS_LOG_DRAIN_WORDS];
+
+
+
+/*	LOGGING FUNCTIONALITY	*/
+
+
+/**
+ * @brief Writes one record to the log ring. Called by EOS_LOG(), from tasks or interrupts.
+ *
+ * @param format Format string, in the eos_log section.
+ * @param count Number of arguments, at most EOS_LOG_MAX_ARGS (EOS_LOG() checks it when compiling).
+ * @param args Arguments, one word each.
+ */
+void EOS_LogRecord(const char* format, uint32_t count, const uint32_t* args)
+{
+	uint32_t now = EOS_GetCycles();
+	uint32_t length = count + 2;
+	uint32_t head = __atomic_load_n(&log_head, __ATOMIC_RELAXED);
+	uint32_t used;
+
+	do
+	{
+		used = head + length - __atomic_load_n(&log_tail, __ATOMIC_ACQUIRE);
+		if (used > EOS_LOG_BUFFER_WORDS)
+		{
+			__atomic_fetch_add(&log_stats.dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+	} while (!__atomic_compare_exchange_n(&log_head, &head, head + length, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+	log_buffer[(head + 1) & EOS_LOG_MASK] = now;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		log_buffer[(head + 2 + i) & EOS_LOG_MASK] = args[i];
+	}
+
+	//the first word goes in last, it is what tells the drain task the record is complete
+	__atomic_store_n(&log_buffer[head & EOS_LOG_MASK],
+			EOS_LOG_SYNC | (count << 16) | (uint32_t)((format - __start_eos_log) & 0xFFFF), __ATOMIC_RELEASE);
+
+	__atomic_fetch_add(&log_stats.written, 1, __ATOMIC_RELAXED);
+	if (used > log_stats.high_water)
+	{
+		log_stats.high_water = used; //a racing writer may lose an update, it is only a statistic
+	}
+}
+
+
+/**
+ * @brief Takes complete records out of the log ring, oldest first. Only the drain task may call it.
+ *
+ * @param words Array to copy the records into.
+ * @param max Size of the array, in words. Must be at least EOS_LOG_MAX_ARGS + 2.
+ *
+ * @return Number of words copied, always whole records.
+ */
+uint32_t EOS_LogRead(uint32_t* words, uint32_t max)
+{
+	uint32_t tail = log_tail;
+	uint32_t copied = 0;
+
+	while (1)
+	{
+		uint32_t first = __atomic_load_n(&log_buffer[tail & EOS_LOG_MASK], __ATOMIC_ACQUIRE);
+		uint32_t length = ((first >> 16) & 0xFF) + 2;
+
+		if (first == 0 || copied + length > max)
+		{
+			break;
+		}
+
+		//cleared as it is copied, so every word past the tail reads 0 until a writer fills it in
+		for (uint32_t i = 0; i < length; i++)
+		{
+			words[copied + i] = log_buffer[(tail + i) & EOS_LOG_MASK];
+			log_buffer[(tail + i) & EOS_LOG_MASK] = 0;
+		}
+
+		copied += length;
+		tail += length;
+		__atomic_store_n(&log_tail, tail, __ATOMIC_RELEASE);
+	}
+
+	return copied;
+}
+
+
+/**
+ * @brief Creates the drain task, at PRIORITY_LOW. Call it before EOS_Init(), like EOS_ThreadNew().
+ *
+ * @return ID of the drain task, or EOS_ERROR on failure, which includes format strings taking 64KB or more: their 16 bit
+ * 			ids would run into EOS_LOG_ID_DROPPED. The linker scripts check this at link time.
+ */
+EOS_task_id_t EOS_LogStart(void)
+{
+	if (__stop_eos_log - __start_eos_log >= EOS_LOG_ID_DROPPED)
+	{
+		return EOS_ERROR;
+	}
+	return EOS_ThreadNew(EOS_LogTask, PRIORITY_LOW, log_stack, EOS_LOG_STACK_SIZE, EOS_NO_FPU);
+}
+
+
+/**
+ * @brief Writes the log stream. Override this in your project (for example with HAL_UART_Transmit()). The default
+ * 			drops it.
+ */
+__attribute__((weak)) void EOS_LogOutput(const uint8_t* data, uint32_t length)
+{
+	(void)data;
+	(void)length;
+}
+
+
+/**
+ * @brief Returns the number of records written and dropped, and the ring high water mark.
+ */
+const EOS_log_stats_t* EOS_LogStats(void)
+{
+	return &log_stats;
+}
+
+
+
+/*	DRAIN TASK	*/
+
+
+static void EOS_LogTask(void)
+{
+	uint32_t header[4] = {EOS_LOG_MAGIC, EOS_LOG_VERSION, EOS_PORT_CYCLE_HZ, (uint32_t)(uintptr_t)__start_eos_log};
+	uint32_t reported = 0;
+
+	EOS_LogOutput((const uint8_t*)header, sizeof(header));
+
+	while (1)
+	{
+		uint32_t count = EOS_LogRead(log_drain, EOS_LOG_DRAIN_WORDS);
+		uint32_t dropped = __atomic_load_n(&log_stats.dropped, __ATOMIC_RELAXED);
+
+		if (count > 0)
+		{
+			EOS_LogOutput((const uint8_t*)log_drain, count * sizeof(uint32_t));
+		}
+
+		if (dropped != reported)
+		{
+			uint32_t record[3] = {EOS_LOG_SYNC | (1u << 16) | EOS_LOG_ID_DROPPED, EOS_GetCycles(), dropped - reported};
+
+			EOS_LogOutput((const uint8_t*)record, sizeof(record));
+			reported = dropped;
+		}
+
+		if (count < EOS_LOG_DRAIN_WORDS - (EOS_LOG_MAX_ARGS + 2))
+		{
+			EOS_Delay(EOS_LOG_DRAIN_MS); //the ring is drained, otherwise go again straight away
+		}
+	}
+}
+
+#endif
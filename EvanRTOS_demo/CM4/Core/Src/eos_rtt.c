@@ -0,0 +1,267 @@
+/*
+ * eos_rtt.c
+ *
+ *      In-memory console channels for EvanRTOS, in the style of SEGGER RTT. When EOS_RTT_ENABLE is set in
+ *      eos_config.h, the console is a set of ring buffers in RAM, described by a control block (_SEGGER_RTT) that a
+ *      debug probe finds and reads through the debug port while the target keeps running:
+ *      	- up channels carry data from the target to the host: 0 is stdout, 1 is stderr
+ *      	- down channels carry data from the host to the target: 0 is stdin
+ *
+ *      syscalls.c routes _write() and _read() here, so printf() costs a memcpy into RAM instead of busy waiting on
+ *      the UART, and neither ever blocks: a write to a full up channel is trimmed (or skipped, see EOS_RTT_UP_MODE) and
+ *      the dropped bytes are counted, and a read with nothing in the down channel returns straight away. Without a
+ *      probe, a low priority drain task can take the output with EOS_RttReadUp() and send it anywhere.
+ *
+ *      Target side writers and readers may run in tasks and interrupts, and are serialized by masking interrupts for
+ *      the length of the copy. The host side (the probe, a drain task, or the host build's stand-in reader in
+ *      EvanRTOS_host/eos_rtt_reader.c) needs no lock: it only ever moves the other end of each ring.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_rtt.h"
+
+#if EOS_RTT_ENABLE
+
+/*	GLOBAL VARIABLES	*/
+EOS_rtt_control_t _SEGGER_RTT;						//the name probes look for
+
+static char rtt_up_buffers[EOS_RTT_UP_CHANNELS][EOS_RTT_UP_SIZE];
+static char rtt_down_buffers[EOS_RTT_DOWN_CHANNELS][EOS_RTT_DOWN_SIZE];
+static uint32_t rtt_dropped[EOS_RTT_UP_CHANNELS];
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Returns the free space in a ring. One byte is always left free, so a full ring is not mistaken for empty.
+ */
+static uint32_t EOS_RttSpace(const EOS_rtt_buffer_t* ring)
+{
+	uint32_t read = ring->read;
+	uint32_t write = ring->write;
+
+	return (read > write) ? read - write - 1 : ring->size - (write - read) - 1;
+}
+
+
+/**
+ * @brief Copies into a ring, and publishes the new write offset once the data is in place.
+ *
+ * @return Bytes copied, at most the free space in the ring.
+ */
+static uint32_t EOS_RttPut(EOS_rtt_buffer_t* ring, const char* data, uint32_t length)
+{
+	uint32_t write = ring->write;
+	uint32_t space = EOS_RttSpace(ring);
+
+	if (length > space)
+	{
+		length = space;
+	}
+
+	uint32_t first = ring->size - write;
+	if (first > length)
+	{
+		first = length;
+	}
+
+	memcpy(&ring->buffer[write], data, first);
+	memcpy(ring->buffer, data + first, length - first);
+
+	write += length;
+	if (write >= ring->size)
+	{
+		write -= ring->size;
+	}
+	__atomic_store_n(&ring->write, write, __ATOMIC_RELEASE);
+
+	return length;
+}
+
+
+/**
+ * @brief Copies out of a ring, and frees the space once the data has been taken.
+ *
+ * @return Bytes copied, at most what the ring holds.
+ */
+static uint32_t EOS_RttTake(EOS_rtt_buffer_t* ring, char* data, uint32_t size)
+{
+	uint32_t write = __atomic_load_n(&ring->write, __ATOMIC_ACQUIRE);
+	uint32_t read = ring->read;
+	uint32_t length = (write >= read) ? write - read : ring->size - read + write;
+
+	if (length > size)
+	{
+		length = size;
+	}
+
+	uint32_t first = ring->size - read;
+	if (first > length)
+	{
+		first = length;
+	}
+
+	memcpy(data, &ring->buffer[read], first);
+	memcpy(data + first, ring->buffer, length - first);
+
+	read += length;
+	if (read >= ring->size)
+	{
+		read -= ring->size;
+	}
+	__atomic_store_n(&ring->read, read, __ATOMIC_RELEASE);
+
+	return length;
+}
+
+
+
+/*	RTT FUNCTIONALITY	*/
+
+
+/**
+ * @brief Sets up the control block. Called by the first write or read, so output works before EOS_Init().
+ */
+void EOS_RttInit(void)
+{
+	static const char* const up_names[] = {"stdout", "stderr"};
+	uint32_t state = EOS_PortMaskInterrupts();
+
+	if (_SEGGER_RTT.id[0] != '\0')
+	{
+		EOS_PortRestoreInterrupts(state);
+		return;
+	}
+
+	_SEGGER_RTT.up_count = EOS_RTT_UP_CHANNELS;
+	_SEGGER_RTT.down_count = EOS_RTT_DOWN_CHANNELS;
+
+	for (uint32_t i = 0; i < EOS_RTT_UP_CHANNELS; i++)
+	{
+		_SEGGER_RTT.up[i] = (EOS_rtt_buffer_t){i < 2 ? up_names[i] : NULL, rtt_up_buffers[i], EOS_RTT_UP_SIZE, 0, 0,
+				EOS_RTT_UP_MODE};
+	}
+	for (uint32_t i = 0; i < EOS_RTT_DOWN_CHANNELS; i++)
+	{
+		_SEGGER_RTT.down[i] = (EOS_rtt_buffer_t){i == 0 ? "stdin" : NULL, rtt_down_buffers[i], EOS_RTT_DOWN_SIZE, 0,
+				0, 0};
+	}
+
+	//the id goes in last, in two pieces, so a probe searching memory never finds a half built block or a copy of
+	//the id in flash
+	memcpy(&_SEGGER_RTT.id[7], "RTT", 4);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(_SEGGER_RTT.id, "SEGGER", 6);
+	_SEGGER_RTT.id[6] = ' ';
+
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+/**
+ * @brief Writes to an up channel, without blocking. Safe from tasks and interrupts.
+ *
+ * @param channel Up channel, EOS_RTT_STDOUT or EOS_RTT_STDERR.
+ * @param data Bytes to write.
+ * @param length Number of bytes.
+ *
+ * @return Bytes written. When the channel is full, the rest are dropped and counted (see EOS_RttDropped()).
+ */
+uint32_t EOS_RttWrite(uint32_t channel, const void* data, uint32_t length)
+{
+	if (_SEGGER_RTT.id[0] == '\0')
+	{
+		EOS_RttInit();
+	}
+	if (channel >= EOS_RTT_UP_CHANNELS)
+	{
+		return 0;
+	}
+
+	EOS_rtt_buffer_t* ring = &_SEGGER_RTT.up[channel];
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t written = 0;
+
+	if (ring->flags == EOS_RTT_MODE_TRIM || length <= EOS_RttSpace(ring))
+	{
+		written = EOS_RttPut(ring, data, length);
+	}
+	rtt_dropped[channel] += length - written;
+
+	EOS_PortRestoreInterrupts(state);
+	return written;
+}
+
+
+/**
+ * @brief Reads from a down channel, without blocking. Safe from tasks and interrupts.
+ *
+ * @param channel Down channel, EOS_RTT_STDIN.
+ * @param data Buffer to read into.
+ * @param size Size of the buffer.
+ *
+ * @return Bytes read, 0 when the host has sent nothing.
+ */
+uint32_t EOS_RttRead(uint32_t channel, void* data, uint32_t size)
+{
+	if (_SEGGER_RTT.id[0] == '\0')
+	{
+		EOS_RttInit();
+	}
+	if (channel >= EOS_RTT_DOWN_CHANNELS)
+	{
+		return 0;
+	}
+
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t count = EOS_RttTake(&_SEGGER_RTT.down[channel], data, size);
+
+	EOS_PortRestoreInterrupts(state);
+	return count;
+}
+
+
+/**
+ * @brief Returns the number of bytes dropped on an up channel because it was full.
+ */
+uint32_t EOS_RttDropped(uint32_t channel)
+{
+	return (channel < EOS_RTT_UP_CHANNELS) ? rtt_dropped[channel] : 0;
+}
+
+
+/**
+ * @brief Takes the data waiting in an up channel, like a debug probe would. For a drain task that sends the console
+ * 			somewhere (a UART, a file), or the host build's stand-in reader.
+ *
+ * @return Bytes read.
+ */
+uint32_t EOS_RttReadUp(uint32_t channel, void* data, uint32_t size)
+{
+	if (_SEGGER_RTT.id[0] == '\0' || channel >= EOS_RTT_UP_CHANNELS)
+	{
+		return 0;
+	}
+	return EOS_RttTake(&_SEGGER_RTT.up[channel], data, size);
+}
+
+
+/**
+ * @brief Puts data into a down channel, like a debug probe would.
+ *
+ * @return Bytes written, at most the free space in the channel.
+ */
+uint32_t EOS_RttWriteDown(uint32_t channel, const void* data, uint32_t length)
+{
+	if (_SEGGER_RTT.id[0] == '\0' || channel >= EOS_RTT_DOWN_CHANNELS)
+	{
+		return 0;
+	}
+	return EOS_RttPut(&_SEGGER_RTT.down[channel], data, length);
+}
+
+#endif
@@ -0,0 +1,328 @@
+/*
+ * eos_wait.c
+ *
+ *      Off-CPU wait profiler for EvanRTOS. When EOS_WAIT_PROFILE_ENABLE is set in eos_config.h, the kernel reports
+ *      every state change of a task here, and the time between them is measured with EOS_GetCycles():
+ *      	- EOS_WaitProfileBlock() when a task sets its blocked field (EOS_Delay(), queues and semaphores)
+ *      	- EOS_WaitProfileUnblock() when EOS_TaskUnblock() or the tick timeout handling clears it
+ *      	- EOS_WaitProfileSwitch() when the scheduler switches from one task to another
+ *
+ *      For each task, this gives the time spent sleeping, blocked on queues/semaphores, ready but not running, and
+ *      running. Blocked time is also kept per (task, object) pair. Together these separate a task that is slow because
+ *      it waits on a contended object, from one that is starved by higher priority tasks (ready time), and from one
+ *      that is simply sleeping.
+ *
+ *      Waits are measured as 32 bit cycle differences, so a single wait longer than 2^32 cycles (~8.9s at 480 MHz) is
+ *      recorded modulo 2^32. Paused tasks are not tracked separately, their time shows up as ready time.
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "eos_port.h"
+#include "eos_wait.h"
+
+#if EOS_WAIT_PROFILE_ENABLE
+
+/*	GLOBAL VARIABLES	*/
+static EOS_wait_task_t wait_tasks[EOS_WAIT_PROFILE_TASKS];
+static EOS_wait_object_t wait_objects[EOS_WAIT_PROFILE_OBJECTS];
+static uint32_t wait_object_count = 0;
+static uint32_t wait_overflow = 0;
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+static void EOS_WaitAdd(EOS_wait_stat_t* stat, uint32_t cycles)
+{
+	stat->count++;
+	stat->total += cycles;
+	if (cycles > stat->max)
+	{
+		stat->max = cycles;
+	}
+}
+
+
+/**
+ * @brief Finds the wait statistics of a (task, object) pair, adding it if it is new. Returns NULL if the table is full.
+ */
+static EOS_wait_object_t* EOS_WaitFindObject(uint16_t task, void* object)
+{
+	for (uint32_t i = 0; i < wait_object_count; i++)
+	{
+		if (wait_objects[i].object == object && wait_objects[i].task == task)
+		{
+			return &wait_objects[i];
+		}
+	}
+
+	if (wait_object_count == EOS_WAIT_PROFILE_OBJECTS)
+	{
+		return NULL;
+	}
+
+	EOS_wait_object_t* entry = &wait_objects[wait_object_count++];
+	entry->object = object;
+	entry->task = task;
+	return entry;
+}
+
+
+
+/*	PROFILER FUNCTIONALITY	*/
+
+
+/**
+ * @brief Starts timing every task from now. Called by EOS_Init() once the cycle counter is running; run_ptr is the
+ * 			task about to be started.
+ */
+void EOS_WaitProfileInit(void)
+{
+	uint32_t now = EOS_GetCycles();
+	EOS_TCB_t* task = run_ptr;
+
+	do
+	{
+		if (task->id < EOS_WAIT_PROFILE_TASKS)
+		{
+			EOS_wait_task_t* stats = &wait_tasks[task->id];
+			stats->state = task->blocked ? EOS_WAIT_BLOCKED : (task == run_ptr ? EOS_WAIT_RUNNING : EOS_WAIT_READY);
+			stats->object = task->blocked;
+			stats->since = now;
+		}
+		task = task->next;
+	} while (task != run_ptr);
+}
+
+
+/**
+ * @brief Called by EOS_ThreadNew(), tasks start out ready.
+ */
+void EOS_WaitProfileCreate(EOS_TCB_t* task)
+{
+	if (task->id >= EOS_WAIT_PROFILE_TASKS)
+	{
+		return;
+	}
+
+	EOS_wait_task_t* stats = &wait_tasks[task->id];
+	stats->state = EOS_WAIT_READY;
+	stats->object = NULL;
+	stats->since = EOS_GetCycles();
+}
+
+
+/**
+ * @brief Called with interrupts disabled when a task blocks on an object.
+ *
+ * @param task The task, normally run_ptr.
+ * @param object The queue or semaphore, or EOS_TIMED_OUT for EOS_Delay().
+ */
+void EOS_WaitProfileBlock(EOS_TCB_t* task, void* object)
+{
+	if (task->id >= EOS_WAIT_PROFILE_TASKS)
+	{
+		return;
+	}
+
+	EOS_wait_task_t* stats = &wait_tasks[task->id];
+	uint32_t now = EOS_GetCycles();
+
+	if (stats->state == EOS_WAIT_RUNNING)
+	{
+		stats->running += now - stats->since;
+	}
+
+	stats->state = EOS_WAIT_BLOCKED;
+	stats->object = object;
+	stats->since = now;
+}
+
+
+/**
+ * @brief Called with interrupts disabled when a blocked task is made ready again.
+ */
+void EOS_WaitProfileUnblock(EOS_TCB_t* task)
+{
+	if (task->id >= EOS_WAIT_PROFILE_TASKS)
+	{
+		return;
+	}
+
+	EOS_wait_task_t* stats = &wait_tasks[task->id];
+	uint32_t now = EOS_GetCycles();
+
+	if (stats->state != EOS_WAIT_BLOCKED)
+	{
+		return;
+	}
+
+	uint32_t waited = now - stats->since;
+	EOS_WaitAdd(stats->object == EOS_TIMED_OUT ? &stats->sleep : &stats->blocked, waited);
+
+	EOS_wait_object_t* entry = EOS_WaitFindObject(task->id, stats->object);
+	if (entry != NULL)
+	{
+		EOS_WaitAdd(&entry->wait, waited);
+	}
+	else
+	{
+		wait_overflow++;
+	}
+
+	//unblocked before the context switch away from it happened, so it never stopped running
+	stats->state = (task == run_ptr) ? EOS_WAIT_RUNNING : EOS_WAIT_READY;
+	stats->object = NULL;
+	stats->since = now;
+}
+
+
+/**
+ * @brief Called by the scheduler, with interrupts disabled, when it switches from one task to another.
+ */
+void EOS_WaitProfileSwitch(EOS_TCB_t* out, EOS_TCB_t* in)
+{
+	uint32_t now = EOS_GetCycles();
+
+	if (out->id < EOS_WAIT_PROFILE_TASKS)
+	{
+		EOS_wait_task_t* stats = &wait_tasks[out->id];
+
+		if (stats->state == EOS_WAIT_RUNNING)
+		{
+			stats->running += now - stats->since;
+			stats->state = EOS_WAIT_READY; //preempted, or yielded while still ready
+			stats->since = now;
+		}
+	}
+
+	if (in->id < EOS_WAIT_PROFILE_TASKS)
+	{
+		EOS_wait_task_t* stats = &wait_tasks[in->id];
+
+		if (stats->state == EOS_WAIT_READY)
+		{
+			EOS_WaitAdd(&stats->ready, now - stats->since);
+		}
+		stats->state = EOS_WAIT_RUNNING;
+		stats->since = now;
+	}
+}
+
+
+
+/*	REPORTING	*/
+
+
+/**
+ * @brief Gives access to the statistics of every task, indexed by task id.
+ *
+ * @param count Set to the number of entries in the returned array.
+ */
+const EOS_wait_task_t* EOS_WaitProfileTasks(uint32_t* count)
+{
+	*count = EOS_WAIT_PROFILE_TASKS;
+	return wait_tasks;
+}
+
+
+/**
+ * @brief Gives access to the per (task, object) wait statistics.
+ *
+ * @param count Set to the number of entries in the returned array.
+ */
+const EOS_wait_object_t* EOS_WaitProfileObjects(uint32_t* count)
+{
+	*count = wait_object_count;
+	return wait_objects;
+}
+
+
+/**
+ * @brief Clears all totals. Tasks keep their current state, and are timed from now.
+ */
+void EOS_WaitProfileReset(void)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t now = EOS_GetCycles();
+
+	for (uint32_t i = 0; i < EOS_WAIT_PROFILE_TASKS; i++)
+	{
+		memset(&wait_tasks[i].sleep, 0, sizeof(EOS_wait_stat_t));
+		memset(&wait_tasks[i].blocked, 0, sizeof(EOS_wait_stat_t));
+		memset(&wait_tasks[i].ready, 0, sizeof(EOS_wait_stat_t));
+		wait_tasks[i].running = 0;
+		wait_tasks[i].since = now;
+	}
+	memset(wait_objects, 0, sizeof(wait_objects));
+	wait_object_count = 0;
+	wait_overflow = 0;
+
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+static void EOS_WaitPrintStat(const char* name, const EOS_wait_stat_t* stat)
+{
+	printf(",\"%s\":{\"n\":%lu,\"total\":%llu,\"max\":%lu}", name, (unsigned long)stat->count,
+			(unsigned long long)stat->total, (unsigned long)stat->max);
+}
+
+
+/**
+ * @brief Prints one JSON line per task that has run, then one per (task, object) pair, then a summary line.
+ * 			Task lines also give the current state, and the cycles spent in it so far (in_state), which shows waits
+ * 			that have not ended yet.
+ */
+void EOS_WaitProfileReport(void)
+{
+	static const char* const state_names[] = {"ready", "running", "blocked"};
+	uint32_t now = EOS_GetCycles();
+
+	for (uint32_t i = 0; i < EOS_WAIT_PROFILE_TASKS; i++)
+	{
+		const EOS_wait_task_t* stats = &wait_tasks[i];
+
+		if (stats->running == 0 && stats->ready.count == 0 && stats->sleep.count == 0 && stats->blocked.count == 0)
+		{
+			continue;
+		}
+
+		printf("{\"wait_task\":%lu,\"unit\":\"cycles\",\"running\":%llu", (unsigned long)i,
+				(unsigned long long)stats->running);
+		EOS_WaitPrintStat("sleep", &stats->sleep);
+		EOS_WaitPrintStat("blocked", &stats->blocked);
+		EOS_WaitPrintStat("ready", &stats->ready);
+		printf(",\"state\":\"%s\",\"in_state\":%lu", state_names[stats->state], (unsigned long)(now - stats->since));
+		if (stats->state == EOS_WAIT_BLOCKED)
+		{
+			printf(",\"object\":\"0x%08lx\"", (unsigned long)(uintptr_t)stats->object);
+		}
+		printf("}\n");
+	}
+
+	for (uint32_t i = 0; i < wait_object_count; i++)
+	{
+		const EOS_wait_object_t* entry = &wait_objects[i];
+
+		if (entry->object == EOS_TIMED_OUT)
+		{
+			printf("{\"wait_object\":\"delay\"");
+		}
+		else
+		{
+			printf("{\"wait_object\":\"0x%08lx\"", (unsigned long)(uintptr_t)entry->object);
+		}
+		printf(",\"task\":%u,\"unit\":\"cycles\",\"n\":%lu,\"total\":%llu,\"max\":%lu}\n", entry->task,
+				(unsigned long)entry->wait.count, (unsigned long long)entry->wait.total,
+				(unsigned long)entry->wait.max);
+	}
+
+	printf("{\"wait\":\"summary\",\"cycle_hz\":%lu,\"objects\":%lu,\"overflow\":%lu}\n",
+			(unsigned long)EOS_PORT_CYCLE_HZ, (unsigned long)wait_object_count, (unsigned long)wait_overflow);
+}
+
+#endif
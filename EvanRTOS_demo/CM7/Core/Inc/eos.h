@@ -5,8 +5,8 @@
  *      Author: EO12
  */
 
-#ifndef INC_EOS_H_
-#define INC_EOS_H_
+#ifndef INC_EOS_APP_H_
+#define INC_EOS_APP_H_
 
 /*	INCLUDES	*/
 #include <stdint.h>
@@ -16,4 +16,4 @@
 /*	FUNCTION PROTOTYPES		*/
 void EvanRTOS_Init();
 
-#endif /* INC_EOS_H_ */
+#endif /* INC_EOS_APP_H_ */
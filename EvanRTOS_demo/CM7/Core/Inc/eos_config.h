@@ -0,0 +1,457 @@
+/*
+ * eos_config.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Compile time configuration for EvanRTOS. Every option here can be overridden by defining it before this file
+ *      is included (for example with -DEOS_TRACE_ENABLE=1 on the compiler command line).
+ */
+
+#ifndef INC_EOS_CONFIG_H_
+#define INC_EOS_CONFIG_H_
+
+
+/*		TRACE RECORDER		*/
+
+/* Set to 1 to record scheduler, IPC and ISR events into a RAM ring buffer (see eos_trace.h) */
+#ifndef EOS_TRACE_ENABLE
+#define EOS_TRACE_ENABLE 0
+#endif
+
+/* Number of 8 byte records held by the trace ring buffer */
+#ifndef EOS_TRACE_BUFFER_RECORDS
+#define EOS_TRACE_BUFFER_RECORDS 512
+#endif
+
+/* Trace timestamps are core cycles shifted right by this amount (4 -> 30 MHz resolution at 480 MHz) */
+#ifndef EOS_TRACE_TS_SHIFT
+#define EOS_TRACE_TS_SHIFT 4
+#endif
+
+
+
+/*		CRITICAL SECTION PROFILER		*/
+
+/* Set to 1 to measure how long interrupts stay masked, per critical section call site (see eos_critical.h) */
+#ifndef EOS_CRITICAL_PROFILE_ENABLE
+#define EOS_CRITICAL_PROFILE_ENABLE 0
+#endif
+
+/* Number of call sites that can be tracked, sites past this are only counted in the overflow total */
+#ifndef EOS_CRITICAL_PROFILE_SITES
+#define EOS_CRITICAL_PROFILE_SITES 32
+#endif
+
+/* Number of histogram buckets per site. Bucket 0 holds sections under 32 cycles, and each bucket after that
+ * doubles the range, with the last bucket holding everything longer */
+#ifndef EOS_CRITICAL_PROFILE_BUCKETS
+#define EOS_CRITICAL_PROFILE_BUCKETS 16
+#endif
+
+
+
+/*		SAMPLING PROFILER		*/
+
+/* Set to 1 to sample the interrupted program counter from a timer interrupt (see eos_profile.h) */
+#ifndef EOS_PROFILE_ENABLE
+#define EOS_PROFILE_ENABLE 0
+#endif
+
+/* Samples per second taken once EOS_Init() runs. Keep it away from multiples of the 1 kHz tick, so samples do not
+ * always land at the same point of the tick */
+#ifndef EOS_PROFILE_HZ
+#define EOS_PROFILE_HZ 997
+#endif
+
+/* Number of 8 byte (task, PC bucket) counters, must be a power of 2 */
+#ifndef EOS_PROFILE_ENTRIES
+#define EOS_PROFILE_ENTRIES 1024
+#endif
+
+/* Samples are counted per PC bucket of 2^EOS_PROFILE_PC_SHIFT bytes */
+#ifndef EOS_PROFILE_PC_SHIFT
+#define EOS_PROFILE_PC_SHIFT 2
+#endif
+
+
+
+/*		OFF-CPU WAIT PROFILER		*/
+
+/* Set to 1 to measure how long each task spends sleeping, blocked on each queue/semaphore, and ready but not
+ * running (see eos_wait.h) */
+#ifndef EOS_WAIT_PROFILE_ENABLE
+#define EOS_WAIT_PROFILE_ENABLE 0
+#endif
+
+/* Tasks with an id below this are profiled (the idle task is id 0) */
+#ifndef EOS_WAIT_PROFILE_TASKS
+#define EOS_WAIT_PROFILE_TASKS 32
+#endif
+
+/* Number of (task, object) pairs whose waits are tracked separately */
+#ifndef EOS_WAIT_PROFILE_OBJECTS
+#define EOS_WAIT_PROFILE_OBJECTS 64
+#endif
+
+
+
+/*		CONTENTION PROFILER		*/
+
+/* Set to 1 to keep usage and contention counters in every queue and semaphore (see eos_contention.h) */
+#ifndef EOS_CONTENTION_PROFILE_ENABLE
+#define EOS_CONTENTION_PROFILE_ENABLE 0
+#endif
+
+
+
+/*		PRIORITY INVERSION DETECTOR		*/
+
+/* Set to 1 to track which tasks hold each semaphore, and record every time a task waits on a semaphore held by a
+ * lower priority task (see eos_inversion.h) */
+#ifndef EOS_INVERSION_DETECT_ENABLE
+#define EOS_INVERSION_DETECT_ENABLE 0
+#endif
+
+/* Tasks with an id below this are checked (the idle task is id 0) */
+#ifndef EOS_INVERSION_TASKS
+#define EOS_INVERSION_TASKS 32
+#endif
+
+/* Number of semaphore counts that can be held at once across all tasks */
+#ifndef EOS_INVERSION_HOLDS
+#define EOS_INVERSION_HOLDS 32
+#endif
+
+/* Number of finished inversions kept in the log, the oldest is overwritten first */
+#ifndef EOS_INVERSION_LOG
+#define EOS_INVERSION_LOG 16
+#endif
+
+
+
+/*		TASK STATISTICS AND MONITOR		*/
+
+/* Set to 1 to paint task stacks and count CPU time and context switches per task, for EOS_TaskSnapshot() */
+#ifndef EOS_TASK_STATS_ENABLE
+#define EOS_TASK_STATS_ENABLE 0
+#endif
+
+
+/* Set to 1 to build the monitor task, which streams EOS_TaskSnapshot() as CSV through EOS_MonitorWrite() (see
+ * eos_monitor.h). Needs EOS_TASK_STATS_ENABLE for stack and CPU figures */
+#ifndef EOS_MONITOR_ENABLE
+#define EOS_MONITOR_ENABLE 0
+#endif
+
+/* Most tasks in one monitor snapshot */
+#ifndef EOS_MONITOR_TASKS
+#define EOS_MONITOR_TASKS 32
+#endif
+
+/* Stack of the monitor task, in words */
+#ifndef EOS_MONITOR_STACK_SIZE
+#define EOS_MONITOR_STACK_SIZE 512
+#endif
+
+/*		DEFERRED FORMATTING LOG		*/
+
+/* Set to 1 to build EOS_LOG() and its drain task (see eos_log.h). When 0, EOS_LOG() calls compile to nothing */
+#ifndef EOS_LOG_ENABLE
+#define EOS_LOG_ENABLE 0
+#endif
+
+/* Size of the log ring, in words (a power of 2). A record takes 2 words plus one per argument */
+#ifndef EOS_LOG_BUFFER_WORDS
+#define EOS_LOG_BUFFER_WORDS 1024
+#endif
+
+/* Words the drain task takes from the ring and hands to EOS_LogOutput() at a time */
+#ifndef EOS_LOG_DRAIN_WORDS
+#define EOS_LOG_DRAIN_WORDS 128
+#endif
+
+/* Time the drain task sleeps once the ring is empty, in ms */
+#ifndef EOS_LOG_DRAIN_MS
+#define EOS_LOG_DRAIN_MS 10
+#endif
+
+/* Stack of the drain task, in words */
+#ifndef EOS_LOG_STACK_SIZE
+#define EOS_LOG_STACK_SIZE 256
+#endif
+
+/*		RTT CONSOLE		*/
+
+/* Set to 1 to build the in-memory console channels (see eos_rtt.h), and route _write()/_read() in syscalls.c
+ * through them instead of the UART */
+#ifndef EOS_RTT_ENABLE
+#define EOS_RTT_ENABLE 0
+#endif
+
+/* Number and size (bytes) of the up channels, target to host. Channel 0 is stdout, 1 is stderr */
+#ifndef EOS_RTT_UP_CHANNELS
+#define EOS_RTT_UP_CHANNELS 2
+#endif
+
+#ifndef EOS_RTT_UP_SIZE
+#define EOS_RTT_UP_SIZE 1024
+#endif
+
+/* Number and size (bytes) of the down channels, host to target. Channel 0 is stdin */
+#ifndef EOS_RTT_DOWN_CHANNELS
+#define EOS_RTT_DOWN_CHANNELS 1
+#endif
+
+#ifndef EOS_RTT_DOWN_SIZE
+#define EOS_RTT_DOWN_SIZE 64
+#endif
+
+/* What a write to a full up channel does: EOS_RTT_MODE_TRIM (1) writes what fits, EOS_RTT_MODE_SKIP (0) drops the
+ * whole write, so lines are never cut. Neither blocks */
+#ifndef EOS_RTT_UP_MODE
+#define EOS_RTT_UP_MODE 1
+#endif
+
+/*		STACK CHECKING		*/
+
+/* Set to 1 to paint task stacks for EOS_StackHighWater(), and check on every context switch that the lowest
+ * EOS_STACK_GUARD_WORDS words of the outgoing task's stack are still painted. A task that went past them is passed to
+ * EOS_StackOverflow() */
+#ifndef EOS_STACK_CHECK_ENABLE
+#define EOS_STACK_CHECK_ENABLE 0
+#endif
+
+/* Words at the bottom of each stack checked by EOS_STACK_CHECK_ENABLE */
+#ifndef EOS_STACK_GUARD_WORDS
+#define EOS_STACK_GUARD_WORDS 4
+#endif
+
+/* Word written over every task stack when it is created, so the stack high water mark can be found later */
+#ifndef EOS_STACK_PAINT
+#define EOS_STACK_PAINT 0xA5A5A5A5u
+#endif
+
+/* Stacks are painted when either the task statistics or stack checking need it */
+#define EOS_STACK_PAINT_ENABLE (EOS_TASK_STATS_ENABLE || EOS_STACK_CHECK_ENABLE)
+
+/* Set to 1, on ports with an MPU (ARM_CM7), to make the lowest EOS_MPU_GUARD_SIZE bytes of the running task's stack
+ * inaccessible, so an overflow faults (MemManage) on the access that overflows, before it corrupts anything. The guard
+ * region is moved on every context switch. It takes up to 2 * EOS_MPU_GUARD_SIZE - 4 bytes of each stack, as it has
+ * to be aligned to its size */
+#ifndef EOS_MPU_GUARD_ENABLE
+#define EOS_MPU_GUARD_ENABLE 0
+#endif
+
+/* Size of the guard, in bytes: a power of 2, at least 32 */
+#ifndef EOS_MPU_GUARD_SIZE
+#define EOS_MPU_GUARD_SIZE 32
+#endif
+
+/* MPU region used for the guard. Higher numbered regions take priority, so it should be the highest one. Every
+ * ARMv7-M MPU has at least 8 */
+#ifndef EOS_MPU_GUARD_REGION
+#define EOS_MPU_GUARD_REGION 7
+#endif
+
+
+/*		DUAL CORE		*/
+
+/* Set to 1 to run a second EvanRTOS instance on another core (the Cortex-M4 of the STM32H747), sharing semaphores and
+ * queues with this one through memory both cores can reach (see eos_dual_core.h). The port provides the cross-core
+ * lock and the interrupt that wakes the other core's waiters (HSEM on the STM32H7) */
+#ifndef EOS_DUAL_CORE_ENABLE
+#define EOS_DUAL_CORE_ENABLE 0
+#endif
+
+/* Number of shared semaphores and queues, each at most 16 */
+#ifndef EOS_DUAL_CORE_SEMAPHORES
+#define EOS_DUAL_CORE_SEMAPHORES 4
+#endif
+
+#ifndef EOS_DUAL_CORE_QUEUES
+#define EOS_DUAL_CORE_QUEUES 4
+#endif
+
+/* Bytes of shared memory the queue buffers are taken from */
+#ifndef EOS_DUAL_CORE_POOL_SIZE
+#define EOS_DUAL_CORE_POOL_SIZE 1024
+#endif
+
+/* Hardware semaphores used on the STM32H7: one guards the shared objects, and each core has one it is notified
+ * through (EOS_DUAL_CORE_NOTIFY_HSEM + core). HSEM 0 is used by the boot handshake in main.c */
+#ifndef EOS_DUAL_CORE_LOCK_HSEM
+#define EOS_DUAL_CORE_LOCK_HSEM 1
+#endif
+
+#ifndef EOS_DUAL_CORE_NOTIFY_HSEM
+#define EOS_DUAL_CORE_NOTIFY_HSEM 2
+#endif
+
+
+/*		INTER-CORE RPC		*/
+
+/* Set to 1 to build the remote procedure calls between the two cores (see eos_rpc.h). Needs EOS_DUAL_CORE_ENABLE */
+#ifndef EOS_RPC_ENABLE
+#define EOS_RPC_ENABLE 0
+#endif
+
+/* Number of named endpoints, over both cores, and the longest name, including the terminating 0 */
+#ifndef EOS_RPC_ENDPOINTS
+#define EOS_RPC_ENDPOINTS 8
+#endif
+
+#ifndef EOS_RPC_NAME_SIZE
+#define EOS_RPC_NAME_SIZE 16
+#endif
+
+/* Calls in flight at once, over both cores, and the largest request or response, in bytes */
+#ifndef EOS_RPC_SLOTS
+#define EOS_RPC_SLOTS 16
+#endif
+
+#ifndef EOS_RPC_MESSAGE_SIZE
+#define EOS_RPC_MESSAGE_SIZE 64
+#endif
+
+/* The first of the two shared queues (EOS_DUAL_CORE_QUEUES) used as the cores' inboxes, the last two by default */
+#ifndef EOS_RPC_QUEUE
+#define EOS_RPC_QUEUE (EOS_DUAL_CORE_QUEUES - 2)
+#endif
+
+/* Stack of the service task that runs the handlers, in words, and whether it may use the FPU */
+#ifndef EOS_RPC_STACK_SIZE
+#define EOS_RPC_STACK_SIZE 256
+#endif
+
+#ifndef EOS_RPC_USE_FPU
+#define EOS_RPC_USE_FPU 0
+#endif
+
+
+/*		SMP		*/
+
+/* Set to 1 to run one EvanRTOS instance across several cores sharing memory (see eos_smp.h), with a run queue and an
+ * idle task per core, idle cores stealing ready tasks from busy ones, and kernel state guarded by a spinlock. Needs an
+ * SMP port (port/POSIX_SMP, where pthreads play the cores) */
+#ifndef EOS_SMP_ENABLE
+#define EOS_SMP_ENABLE 0
+#endif
+
+/* Number of cores, at least 2 */
+#ifndef EOS_SMP_CORES
+#define EOS_SMP_CORES 2
+#endif
+
+
+/*		RING BUFFERS		*/
+
+/* Set to 1 to build the cache coherent ring buffers (see eos_ring.h), for streaming data between cores, or to and
+ * from DMA, through D2 or D3 SRAM. The port provides the data cache maintenance, and an MPU helper to make a region
+ * non-cacheable instead */
+#ifndef EOS_RING_ENABLE
+#define EOS_RING_ENABLE 0
+#endif
+
+/* Data cache line size in bytes, 32 on the Cortex-M7. Ring slots and indices are aligned to it */
+#ifndef EOS_CACHE_LINE
+#define EOS_CACHE_LINE 32
+#endif
+
+
+/*		FORK/JOIN JOBS		*/
+
+/* Set to 1 to build the fork/join job system (see eos_job.h), that splits work into chunks run by worker tasks on both
+ * cores. Needs EOS_DUAL_CORE_ENABLE and EOS_RING_ENABLE */
+#ifndef EOS_JOB_ENABLE
+#define EOS_JOB_ENABLE 0
+#endif
+
+/* Number of kernels that can be registered, and of forks each core can have in flight */
+#ifndef EOS_JOB_KERNELS
+#define EOS_JOB_KERNELS 8
+#endif
+
+#ifndef EOS_JOB_GROUPS
+#define EOS_JOB_GROUPS 4
+#endif
+
+/* Chunks each job ring holds, a power of 2. Chunks that do not fit wait in the fork until the rings drain */
+#ifndef EOS_JOB_RING_SIZE
+#define EOS_JOB_RING_SIZE 16
+#endif
+
+/* The first of the two shared semaphores (EOS_DUAL_CORE_SEMAPHORES) that wake each core's workers, the last two by
+ * default */
+#ifndef EOS_JOB_SEMAPHORE
+#define EOS_JOB_SEMAPHORE (EOS_DUAL_CORE_SEMAPHORES - 2)
+#endif
+
+/* Worker tasks per core, their stack in words, and whether they may use the FPU, as signal processing kernels do */
+#ifndef EOS_JOB_WORKERS
+#define EOS_JOB_WORKERS 1
+#endif
+
+#ifndef EOS_JOB_STACK_SIZE
+#define EOS_JOB_STACK_SIZE 256
+#endif
+
+#ifndef EOS_JOB_USE_FPU
+#define EOS_JOB_USE_FPU 1
+#endif
+
+
+/*		UART DRIVER		*/
+
+/* Set to 1 to build the DMA driven UART driver (see eos_uart.h). The port moves the data: the ARM_CM7 port with the
+ * HAL's DMA and idle line reception, the POSIX port with helper threads on a file descriptor (a pty) */
+#ifndef EOS_UART_ENABLE
+#define EOS_UART_ENABLE 0
+#endif
+
+/* Number of UARTs the driver serves, numbered from 0 */
+#ifndef EOS_UART_COUNT
+#define EOS_UART_COUNT 1
+#endif
+
+/* Bytes of each UART's circular receive buffer, a multiple of EOS_CACHE_LINE, at most 65535 (the DMA count). The DMA
+ * interrupts at each half of it and on an idle line, so readers should keep less than half of it unread */
+#ifndef EOS_UART_RX_SIZE
+#define EOS_UART_RX_SIZE 512
+#endif
+
+
+/*		HAL SHIM		*/
+
+/* Set to 1 to let tasks call the vendor HAL without busy-waiting (see eos_hal.c). On the ARM_CM7 port, the HAL's
+ * timebase moves to a timer of its own (EOS_PORT_HAL_TIM), HAL_Delay() sleeps with EOS_Delay() when called from a
+ * task, and the EOS_Hal...() calls in eos_hal.h sleep until their interrupt driven transfer completes */
+#ifndef EOS_HAL_ENABLE
+#define EOS_HAL_ENABLE 0
+#endif
+
+/*		I2C BUS MANAGER		*/
+
+/* Set to 1 to build the I2C bus manager (see eos_i2c.c), which queues transactions from any number of tasks and runs
+ * them back to back on interrupt driven transfers. It sleeps in the HAL shim's waits, so it needs EOS_HAL_ENABLE */
+#ifndef EOS_I2C_ENABLE
+#define EOS_I2C_ENABLE 0
+#endif
+
+/* Number of buses, numbered from 0, each with its own manager task */
+#ifndef EOS_I2C_COUNT
+#define EOS_I2C_COUNT 1
+#endif
+
+/* Stack of each manager task, in words. Completion callbacks run on it */
+#ifndef EOS_I2C_STACK_SIZE
+#define EOS_I2C_STACK_SIZE 256
+#endif
+
+/* Most ticks (ms) a transaction may stay on the bus. One still running after EOS_I2C_TIMEOUT_MS has hung the bus: the
+ * bus is reset, and the transaction fails with EOS_I2C_TIMEOUT. Raise it for long transfers on a slow bus */
+#ifndef EOS_I2C_TIMEOUT_MS
+#define EOS_I2C_TIMEOUT_MS 25
+#endif
+
+#endif /* INC_EOS_CONFIG_H_ */
@@ -0,0 +1,83 @@
+/*
+ * eos_job.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_JOB_H_
+#define INC_EOS_JOB_H_
+
+#include "eos_dual_core.h"
+#include "eos_ring.h"
+
+/*	CONSTANTS	*/
+
+/* Written to EOS_job_shared_t.magic by the primary core once the shared memory is ready */
+#define EOS_JOB_MAGIC 0x454A4F42u
+
+/* Count both cores' wake semaphores are created with, and the most wake ups they can owe */
+#define EOS_JOB_WAKE_MAX 255
+
+#if EOS_JOB_ENABLE && (!EOS_DUAL_CORE_ENABLE || !EOS_RING_ENABLE)
+#error "EOS_JOB_ENABLE needs EOS_DUAL_CORE_ENABLE and EOS_RING_ENABLE"
+#endif
+
+#if EOS_JOB_ENABLE && ((EOS_JOB_RING_SIZE & (EOS_JOB_RING_SIZE - 1)) != 0 || EOS_JOB_GROUPS > 255 || \
+		EOS_JOB_KERNELS > 65535 || EOS_JOB_WORKERS == 0)
+#error "EOS_JOB_RING_SIZE must be a power of 2, EOS_JOB_GROUPS at most 255, and EOS_JOB_WORKERS at least 1"
+#endif
+
+
+/*	DATATYPES	*/
+
+/* Runs one chunk of a fork, on whichever core took it. argument is the one passed to EOS_JobFork(), so it must point
+ * to memory both cores see at the same address (the shared memory), or be a plain number */
+typedef void (*EOS_job_fn_t)(void* argument, uint32_t chunk);
+
+/* One chunk, as it travels through a job ring */
+typedef struct {
+	uintptr_t argument;
+	uint32_t chunk;
+	uint16_t kernel;
+	uint8_t owner;				//core that forked it
+	uint8_t group;				//index in the owner's groups
+} EOS_job_t;
+
+/* A fork: count chunks of one kernel. Chunks not queued yet start at next, which only the owner uses. done counts
+ * finished chunks per core, each written by its own core only, so no cross-core lock is needed */
+typedef struct {
+	uint32_t count;
+	uint32_t next;
+	volatile uint32_t done[2];
+} EOS_job_group_t;
+
+/* Everything the two cores share, placed like EOS_dual_shared_t, non-cacheable. rings[to][from] carries the chunks
+ * core from gives core to, rings[n][n] those a core keeps. Each has one producer and one consumer side, each used by
+ * one core only, under its own critical section */
+typedef struct {
+	volatile uint32_t magic;
+	uint32_t workers[2];
+	volatile uint8_t registered[2][EOS_JOB_KERNELS];	//per core, the kernels it can run
+	EOS_job_group_t groups[2][EOS_JOB_GROUPS];		//per owner core
+	EOS_ring_t rings[2][2];
+	uint8_t slots[2][2][EOS_JOB_RING_SIZE * EOS_RING_SLOT_SIZE(sizeof(EOS_job_t))]
+			__attribute__((aligned(EOS_CACHE_LINE)));
+} EOS_job_shared_t;
+
+typedef EOS_job_group_t* EOS_job_group_id_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_JOB_ENABLE
+
+EOS_status_t EOS_JobInit(uint32_t core, EOS_job_shared_t* shared, EOS_priority_t priority);
+EOS_status_t EOS_JobRegister(uint32_t kernel, EOS_job_fn_t function);
+
+EOS_job_group_id_t EOS_JobFork(uint32_t kernel, void* argument, uint32_t count);
+void EOS_JobJoin(EOS_job_group_id_t group);
+EOS_status_t EOS_JobRun(uint32_t kernel, void* argument, uint32_t count);
+
+#endif
+
+#endif /* INC_EOS_JOB_H_ */
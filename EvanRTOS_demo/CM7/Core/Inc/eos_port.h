@@ -0,0 +1,110 @@
+/*
+ * eos_port.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Interface between the EvanRTOS kernel and the processor it runs on. Everything the kernel needs from the
+ *      hardware (context switching, stack framing, interrupt masking and the cycle counter) goes through here, so the
+ *      same kernel can run on different targets. Each port lives in port/<name>/ and provides:
+ *
+ *      	eos_portmacro.h, which must define:
+ *      		EOS_PortDisableInterrupts()			mask all interrupts that may call the kernel
+ *      		EOS_PortEnableInterrupts()			unmask them again
+ *      		EOS_PortMaskInterrupts()			mask interrupts, returning the previous state (nestable)
+ *      		EOS_PortRestoreInterrupts(state)	restore the state returned by EOS_PortMaskInterrupts()
+ *      		EOS_PortYield()						request a context switch, taken once interrupts are enabled
+ *      		EOS_PortGetCycles()					free running 32 bit cycle counter
+ *      		EOS_PortIdle()						called repeatedly by the idle task
+ *      		EOS_PORT_CYCLE_HZ					frequency of EOS_PortGetCycles()
+ *
+ *      	eos_port.c, which must implement the functions below, call EOS_scheduler() when switching context and
+ *      	call EOS_Tick() from its periodic (1ms) timer interrupt.
+ *
+ *      Ports that support the sampling profiler (eos_profile.c) also implement EOS_PortProfileStart()/Stop(), and call
+ *      EOS_ProfileSample() with the interrupted program counter from a timer interrupt.
+ *      Ports for multi-core chips may implement EOS_DUAL_CORE_ENABLE (eos_dual_core.c), with a lock both cores can take
+ *      (EOS_PortCoreLock()/Unlock(), spinning, with interrupts already masked), an interrupt one core can raise on the
+ *      other (EOS_PortCoreNotify()), and EOS_PortCoreListen() to enable it on this core. Its handler calls
+ *      EOS_DualCoreIsr().
+ *      Ports that run one kernel across several cores (EOS_SMP_ENABLE, eos_smp.c) define EOS_PortCoreId() in
+ *      eos_portmacro.h, giving the calling core's number from 0, and implement the same lock, which guards the kernel,
+ *      and EOS_PortCoreNotify(), whose handler calls EOS_SmpIsr(). Each core calls EOS_Tick() from a timer of its own.
+ *      Ports that support the ring buffers (EOS_RING_ENABLE, eos_ring.c) clean and invalidate the data cache over a
+ *      cache line aligned range (EOS_PortCacheClean()/Invalidate(), nothing to do on cores without one), and can make a
+ *      region non-cacheable and shareable with the MPU (EOS_PortMpuUncached()).
+ *      Ports with a UART backend (EOS_UART_ENABLE, eos_uart.c) start a UART's reception into a circular buffer, by DMA,
+ *      for good (EOS_PortUartStart()), and send one buffer at a time by DMA (EOS_PortUartSend()). They call
+ *      EOS_UartRxIsr() with the DMA's position at each half of the buffer, at its end and on an idle line, having
+ *      invalidated the data cache over what arrived, and EOS_UartTxIsr() once a send is done.
+ *      Ports for a vendor HAL (EOS_HAL_ENABLE, eos_hal.c) say whether the caller may sleep (EOS_PortCanBlock(), not in
+ *      an interrupt nor with interrupts disabled), and call EOS_HalComplete() from the HAL's transfer callbacks.
+ *      Ports with an I2C backend (EOS_I2C_ENABLE, eos_i2c.c) start one transaction at a time on a bus, without waiting
+ *      for it (EOS_PortI2cTransfer()), with a repeated start between its write and read phases, and call EOS_I2cIsr()
+ *      with its result once it ends. EOS_PortI2cRecover() stops whatever is on the bus and resets it, from a task.
+ *      Ports for cores with a stack limit register (ARM_CM33) check stacks in hardware instead, by loading the bottom of
+ *      the incoming task's stack into it on every context switch.
+ *      Ports with an MPU may implement EOS_MPU_GUARD_ENABLE, by moving a no access region to the bottom of the incoming
+ *      task's stack on every context switch, and calling EOS_StackOverflow() from their memory fault handler, and from
+ *      their HardFault handler for a fault escalated with interrupts disabled, when EOS_PortMpuGuardFault() says the
+ *      fault hit that region.
+ */
+
+#ifndef INC_EOS_PORT_H_
+#define INC_EOS_PORT_H_
+
+#include "eos_kernel.h"
+
+
+/*	PORT FUNCTIONS	*/
+void EOS_PortInit(void);
+int32_t* EOS_PortInitStack(int32_t* task_stack, uint32_t stack_size, void* function, EOS_status_t use_fpu);
+void EOS_PortStartScheduler(void);
+
+#if EOS_PROFILE_ENABLE
+void EOS_PortProfileStart(uint32_t sample_hz);
+void EOS_PortProfileStop(void);
+#endif
+
+#if EOS_DUAL_CORE_ENABLE || EOS_SMP_ENABLE
+void EOS_PortCoreLock(volatile uint32_t* lock);
+void EOS_PortCoreUnlock(volatile uint32_t* lock);
+void EOS_PortCoreNotify(uint32_t core);
+#endif
+
+#if EOS_DUAL_CORE_ENABLE
+void EOS_PortCoreListen(uint32_t core);
+#endif
+
+#if EOS_UART_ENABLE
+EOS_status_t EOS_PortUartStart(uint32_t uart, void* device, uint8_t* rx_buffer, uint32_t rx_size);
+EOS_status_t EOS_PortUartSend(uint32_t uart, const uint8_t* data, uint32_t length);
+#endif
+
+#if EOS_HAL_ENABLE
+uint32_t EOS_PortCanBlock(void);
+#endif
+
+#if EOS_I2C_ENABLE
+EOS_status_t EOS_PortI2cStart(uint32_t bus, void* device);
+EOS_status_t EOS_PortI2cTransfer(uint32_t bus, uint16_t address, const uint8_t* tx_data, uint16_t tx_length,
+		uint8_t* rx_data, uint16_t rx_length);
+void EOS_PortI2cRecover(uint32_t bus);
+#endif
+
+#if EOS_MPU_GUARD_ENABLE
+uint32_t EOS_PortMpuGuardFault(void);
+#endif
+
+#if EOS_RING_ENABLE
+void EOS_PortCacheClean(const void* address, uint32_t size);
+void EOS_PortCacheInvalidate(void* address, uint32_t size);
+EOS_status_t EOS_PortMpuUncached(uint32_t region, void* base, uint32_t size);
+#endif
+
+
+/*	KERNEL FUNCTIONS CALLED BY THE PORT	*/
+void EOS_scheduler(void);
+void EOS_Tick(void);
+
+#endif /* INC_EOS_PORT_H_ */
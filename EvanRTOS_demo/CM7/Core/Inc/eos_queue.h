@@ -9,6 +9,7 @@
 #define INC_EOS_QUEUE_H_
 
 #include "eos_kernel.h"
+#include "eos_contention.h"
 
 /*	DATATYPES	*/
 
@@ -19,6 +20,9 @@ typedef struct {
 	uint32_t size;
 	uint32_t item_size;
 	volatile uint32_t count;
+#if EOS_CONTENTION_PROFILE_ENABLE
+	EOS_contention_t contention;
+#endif
 } EOS_queue_t;
 
 typedef EOS_queue_t* EOS_queue_id_t;
@@ -9,12 +9,16 @@
 #define INC_EOS_SEMAPHORE_H_
 
 #include "eos_kernel.h"
+#include "eos_contention.h"
 
 /*	DATATYPES	*/
 
 typedef struct  {
 	volatile uint32_t count;
 	uint32_t max_count;
+#if EOS_CONTENTION_PROFILE_ENABLE
+	EOS_contention_t contention;
+#endif
 } EOS_semaphore_t;
 
 typedef EOS_semaphore_t *EOS_semaphore_id_t;
@@ -0,0 +1,72 @@
+/*
+ * eos_uart.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_UART_H_
+#define INC_EOS_UART_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* Most bytes one DMA transfer moves (the 16 bit DMA count). Longer transmit buffers are sent in pieces */
+#define EOS_UART_DMA_MAX 65535u
+
+#if EOS_UART_ENABLE && (EOS_UART_RX_SIZE % EOS_CACHE_LINE != 0 || EOS_UART_RX_SIZE > EOS_UART_DMA_MAX || \
+		EOS_UART_COUNT == 0)
+#error "EOS_UART_RX_SIZE must be a multiple of EOS_CACHE_LINE and at most 65535, and EOS_UART_COUNT at least 1"
+#endif
+
+
+/*	DATATYPES	*/
+
+/* One transmit buffer, queued by EOS_UartSend() until the DMA has sent all of it. The request and the data belong to
+ * the driver until EOS_UartWait() returns, so both must stay valid until then (EOS_UartWrite() keeps the request on
+ * the caller's stack). On the Cortex-M7 the data must be in memory the DMA can reach, not the DTCM */
+typedef struct EOS_uart_tx_t {
+	const uint8_t* data;
+	uint32_t length;
+	uint32_t sent;					//bytes handed to the DMA so far
+	volatile uint32_t done;
+	struct EOS_uart_tx_t* next;
+} EOS_uart_tx_t;
+
+/* Counters of one UART, see EOS_UartStats() */
+typedef struct {
+	uint32_t tx_bytes;
+	uint32_t tx_buffers;
+	uint32_t tx_transfers;			//DMA transfers started
+	uint32_t rx_bytes;
+	uint32_t rx_events;				//half, full and idle line interrupts that brought data
+	uint32_t rx_lost;				//bytes overwritten by the DMA, or dropped by a restart, before they were read
+	uint32_t errors;				//line and DMA errors reported by the port
+} EOS_uart_stats_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_UART_ENABLE
+
+EOS_status_t EOS_UartInit(uint32_t uart, void* device);
+
+/* Transmit */
+EOS_status_t EOS_UartSend(uint32_t uart, EOS_uart_tx_t* request, const void* data, uint32_t length);
+void EOS_UartWait(EOS_uart_tx_t* request);
+EOS_status_t EOS_UartWrite(uint32_t uart, const void* data, uint32_t length);
+
+/* Receive */
+uint32_t EOS_UartRead(uint32_t uart, void* data, uint32_t size, EOS_block_status_t block);
+uint32_t EOS_UartAvailable(uint32_t uart);
+
+EOS_status_t EOS_UartStats(uint32_t uart, EOS_uart_stats_t* stats);
+
+/* Called by the port, from the UART and DMA interrupts */
+void EOS_UartTxIsr(uint32_t uart);
+void EOS_UartRxIsr(uint32_t uart, uint32_t position);
+void EOS_UartErrorIsr(uint32_t uart, uint32_t restarted);
+
+#endif
+
+#endif /* INC_EOS_UART_H_ */
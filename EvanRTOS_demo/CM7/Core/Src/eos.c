@@ -16,6 +16,11 @@
 #include "eos_kernel.h"
 #include "eos_semaphore.h"
 #include "eos_queue.h"
+#include "eos_monitor.h"
+#include "eos_log.h"
+#if EOS_DUAL_CORE_ENABLE
+#include "eos_shared.h"
+#endif
 
 /* DEFINES	*/
 
@@ -66,6 +71,17 @@ EOS_priority_t task5_priority = PRIORITY_LOW;
 void task5(void);
 uint32_t task5_stack_size = 128;
 
+#if EOS_DUAL_CORE_ENABLE
+/*Task 6, talks to the EvanRTOS instance on the Cortex-M4*/
+EOS_task_id_t task6_handle;
+EOS_priority_t task6_priority = PRIORITY_LOW;
+void task6(void);
+uint32_t task6_stack_size = 128;
+
+EOS_dual_queue_id_t led_queue;
+EOS_dual_queue_id_t done_queue;
+#endif
+
 /*	USER VARIABLES	*/
 
 uint32_t t0count = 0;
@@ -76,6 +92,9 @@ uint32_t t4count = 0;
 
 uint32_t t5_queue_item = 0;
 
+uint32_t t6_requests = 0;
+uint32_t t6_done = 0;
+
 
 /*	USER CODE	*/
 
@@ -103,6 +122,16 @@ void EvanRTOS_Init(){
 	task4_handle = EOS_ThreadNew(task4, task4_priority, NULL, task4_stack_size, EOS_NO_FPU);
 	task5_handle = EOS_ThreadNew(task5, task5_priority, NULL, task5_stack_size, EOS_NO_FPU);
 
+#if EOS_DUAL_CORE_ENABLE
+	//the shared memory was set up in main.c, before the Cortex-M4 was released
+	led_queue = EOS_DualQueueCreate(EOS_SHARED_QUEUE_LED, 4, sizeof(uint32_t));
+	done_queue = EOS_DualQueueCreate(EOS_SHARED_QUEUE_DONE, 4, sizeof(uint32_t));
+	task6_handle = EOS_ThreadNew(task6, task6_priority, NULL, task6_stack_size, EOS_NO_FPU);
+#endif
+
+	EOS_MonitorStart(1000); //streams the task list over USART1 once a second, when EOS_MONITOR_ENABLE is set
+	EOS_LogStart(); //sends the EOS_LOG() messages over USART1, when EOS_LOG_ENABLE is set
+
 	EOS_Init(DEFAULT_TASK_PERIOD); //scheduler preempts every 1 ms
 
 
@@ -153,6 +182,7 @@ void task2(){
 		uint8_t value = 4;
 		EOS_QueuePut(queue1, &value, EOS_BLOCK);
 		t2count++;
+		EOS_LOG("task2: put %u in queue1, t2count=%lu", value, t2count); //costs a few stores, formatted on the host
 		EOS_Delay(1000);
 	}
 }
@@ -192,7 +222,25 @@ void task5(){
 		uint32_t recent = 0;
 		EOS_QueueGet(queue2, &recent, EOS_BLOCK);
 		t5_queue_item = recent;
+		EOS_LOG("task5: got %lu from queue2, t1count=%f", recent, t1count);
 		EOS_Delay(1000);
 	}
 }
 
+
+#if EOS_DUAL_CORE_ENABLE
+void task6(){
+
+	while(1)
+	{
+		uint32_t blinks = (t6_requests % 3) + 1;
+		EOS_DualQueuePut(led_queue, &blinks, EOS_BLOCK); //the Cortex-M4 blinks LED1 that many times
+		t6_requests++;
+
+		uint32_t done = 0;
+		EOS_DualQueueGet(done_queue, &done, EOS_BLOCK); //and answers when it has
+		t6_done += done;
+		EOS_Delay(2000);
+	}
+}
+#endif
@@ -0,0 +1,225 @@
+/*
+ * eos_hal.c
+ *
+ *      Lets tasks call the vendor HAL without spinning. The HAL's blocking calls busy-wait on HAL_GetTick(), so a task
+ *      in HAL_Delay() or HAL_UART_Transmit() keeps every lower priority task off the CPU for as long as it takes.
+ *      With EOS_HAL_ENABLE, the port moves the HAL's timebase off the Systick, onto a timer of its own, maps HAL_Delay()
+ *      to EOS_Delay() in tasks, and provides blocking versions of the HAL's interrupt driven transfers (see eos_hal.h)
+ *      that sleep until the transfer's completion callback, instead of polling.
+ *
+ *      This file is the part that does not depend on the HAL: a list of the transfers tasks are sleeping on. A blocking
+ *      call puts an EOS_hal_wait_t on it with EOS_HalPrepare() before starting the transfer, so a completion that comes
+ *      at once is not missed, then sleeps in EOS_HalWait(). The port's callbacks call EOS_HalComplete() with the HAL
+ *      handle and what finished, which wakes the task, and EOS_Tick() counts the timeouts down with EOS_HalTick().
+ *
+ *      A task can only sleep in thread mode with interrupts enabled, once the scheduler runs (EOS_HalCanBlock()).
+ *      Elsewhere, before EOS_Init() or in an interrupt, the port falls back to the HAL's own busy-waiting calls.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_hal.h"
+#include "eos_trace.h"
+#include "eos_wait.h"
+
+#if EOS_HAL_ENABLE
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static EOS_hal_wait_t* EOS_HalTake(EOS_hal_wait_t** link, EOS_hal_wait_t* finished, EOS_hal_result_t result);
+static void EOS_HalFinish(EOS_hal_wait_t* finished);
+
+
+/*	GLOBAL VARIABLES	*/
+extern uint8_t scheduler_enable; //see eos_kernel.c
+
+static EOS_hal_wait_t* hal_waits = NULL;
+
+
+
+/*	WAITING	*/
+
+
+/**
+ * @brief Returns 1 if the caller is a task that may sleep: the scheduler is running, and it is not called from an
+ * 			interrupt or with interrupts disabled.
+ */
+uint32_t EOS_HalCanBlock(void)
+{
+	return scheduler_enable && EOS_PortCanBlock();
+}
+
+
+/**
+ * @brief Puts a transfer on the list of those being waited on. Call it before starting the transfer, then
+ * 			EOS_HalWait(), or EOS_HalCancel() if the HAL refused to start it.
+ *
+ * @param wait The wait, owned by the list until EOS_HalWait() or EOS_HalCancel() returns.
+ * @param handle The HAL handle the transfer runs on, as the port's callbacks pass it to EOS_HalComplete().
+ * @param events What finishes the transfer: EOS_HAL_TX, EOS_HAL_RX, both, or EOS_HAL_ABORT.
+ * @param timeout Most ticks (ms) to wait, at least one full tick, or EOS_HAL_FOREVER.
+ */
+void EOS_HalPrepare(EOS_hal_wait_t* wait, void* handle, uint32_t events, uint32_t timeout)
+{
+	wait->handle = handle;
+	wait->events = events;
+	wait->timeout = (timeout == EOS_HAL_FOREVER) ? timeout : timeout + 1; //the next tick may be just about due
+	wait->done = 0;
+	wait->result = EOS_HAL_DONE;
+
+	EOS_EnterCritical();
+	wait->next = hal_waits;
+	hal_waits = wait;
+	EOS_ExitCritical();
+}
+
+
+/**
+ * @brief Takes a wait off the list without sleeping, for a transfer that did not start.
+ */
+void EOS_HalCancel(EOS_hal_wait_t* wait)
+{
+	EOS_EnterCritical();
+	EOS_hal_wait_t** link = &hal_waits;
+
+	while (*link != NULL && *link != wait)
+	{
+		link = &(*link)->next;
+	}
+	if (*link != NULL)
+	{
+		*link = wait->next;
+	}
+	EOS_ExitCritical();
+}
+
+
+/**
+ * @brief Sleeps until the transfer is completed by the port, fails, or times out. The wait is off the list once this
+ * 			returns. On EOS_HAL_TIMEOUT the transfer may still be running, and the caller should abort it.
+ *
+ * @return EOS_HAL_DONE, EOS_HAL_FAILED or EOS_HAL_TIMEOUT.
+ */
+EOS_hal_result_t EOS_HalWait(EOS_hal_wait_t* wait)
+{
+	EOS_EnterCritical();
+	while (wait->done == 0)
+	{
+		run_ptr->blocked = wait;
+		EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, wait);
+		EOS_WaitProfileBlock(run_ptr, wait);
+		EOS_ExitCritical();
+		EOS_Suspend();
+		EOS_EnterCritical();
+	}
+	EOS_ExitCritical();
+
+	return wait->result;
+}
+
+
+
+/*	CALLED BY THE PORT AND THE KERNEL	*/
+
+
+/**
+ * @brief Completes every transfer waiting on a handle for one of the events, and wakes their tasks. Transfers nobody
+ * 			waits on are ignored, so the port can call it from every callback.
+ *
+ * @param handle The HAL handle.
+ * @param events The events that happened, EOS_HAL_ANY on an error that stops every transfer on the handle.
+ * @param result EOS_HAL_DONE, or EOS_HAL_FAILED.
+ */
+void EOS_HalComplete(void* handle, uint32_t events, EOS_hal_result_t result)
+{
+	EOS_hal_wait_t* finished = NULL;
+
+	EOS_EnterCritical();
+	EOS_hal_wait_t** link = &hal_waits;
+
+	while (*link != NULL)
+	{
+		if ((*link)->handle == handle && ((*link)->events & events) != 0)
+		{
+			finished = EOS_HalTake(link, finished, result);
+		}
+		else
+		{
+			link = &(*link)->next;
+		}
+	}
+	EOS_ExitCritical();
+
+	EOS_HalFinish(finished);
+}
+
+
+/**
+ * @brief Counts down the timeouts of the waiting transfers, once per tick, and wakes the tasks of those that ran out.
+ * 			Called by EOS_Tick(), outside its critical section.
+ */
+void EOS_HalTick(void)
+{
+	EOS_hal_wait_t* finished = NULL;
+
+	EOS_EnterCritical();
+	EOS_hal_wait_t** link = &hal_waits;
+
+	while (*link != NULL)
+	{
+		EOS_hal_wait_t* wait = *link;
+
+		if (wait->timeout != EOS_HAL_FOREVER && --wait->timeout == 0)
+		{
+			finished = EOS_HalTake(link, finished, EOS_HAL_TIMEOUT);
+		}
+		else
+		{
+			link = &wait->next;
+		}
+	}
+	EOS_ExitCritical();
+
+	EOS_HalFinish(finished);
+}
+
+
+
+/*	HELPER FUNCTIONS	*/
+
+
+/**
+ * @brief Moves the wait at link from the list onto the finished chain, with its result. Called in a critical section.
+ *
+ * @return The new head of the finished chain.
+ */
+static EOS_hal_wait_t* EOS_HalTake(EOS_hal_wait_t** link, EOS_hal_wait_t* finished, EOS_hal_result_t result)
+{
+	EOS_hal_wait_t* wait = *link;
+
+	*link = wait->next;
+	wait->result = result;
+	wait->next = finished;
+	return wait;
+}
+
+
+/**
+ * @brief Marks each wait of a finished chain done, and wakes its task, one critical section each, as waking a higher
+ * 			priority task may switch to it at once. next is read first: once done is set, the wait may be gone.
+ */
+static void EOS_HalFinish(EOS_hal_wait_t* finished)
+{
+	while (finished != NULL)
+	{
+		EOS_hal_wait_t* wait = finished;
+		finished = wait->next;
+
+		EOS_EnterCritical();
+		wait->done = 1;
+		EOS_TaskUnblock(wait);
+		EOS_ExitCritical();
+	}
+}
+
+#endif
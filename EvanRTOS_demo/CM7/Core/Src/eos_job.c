@@ -0,0 +1,429 @@
+/*
+ * eos_job.c
+ *
+ *      Fork/join jobs across the two EvanRTOS instances of a dual core chip, built on eos_dual_core.c and eos_ring.c,
+ *      for signal processing work that splits into equal chunks (blocks of samples, rows of a matrix). Enabled with
+ *      EOS_JOB_ENABLE in eos_config.h, on both cores.
+ *
+ *      A kernel is a function of (argument, chunk), registered under the same number on both cores
+ *      (EOS_JobRegister()), as each core has its own code. EOS_JobFork() submits count chunks of a kernel, and
+ *      EOS_JobJoin() waits until all of them have run. EOS_JobRun() does both.
+ *
+ *      The chunks travel through lock-free rings in shared memory (EOS_job_shared_t), one per pair of cores:
+ *      	- The forking core deals the chunks out to its own ring and the other core's, in turn, until both are
+ *      	  full, and keeps the rest in the fork. It then wakes as many workers on each core as it gave chunks, up to
+ *      	  EOS_JOB_WORKERS, by releasing that core's wake semaphore (one of the shared semaphores).
+ *      	- Each core has EOS_JOB_WORKERS worker tasks (created by EOS_JobInit()) that take chunks from both rings
+ *      	  into the core until they are empty, then block on the wake semaphore again.
+ *      	- The joining task helps: it tops the rings up with the chunks still held by the fork, and runs chunks
+ *      	  itself, from its own core's rings, any fork's. Only once its core has nothing left to run does it block,
+ *      	  until its fork is done. A faster core drains its ring sooner, and so gets more of the chunks.
+ *      	- Each core counts the chunks of a fork it has finished. The core that finishes the last one wakes the
+ *      	  joining task: directly on its own core, or on the other by releasing its wake semaphore, whose worker
+ *      	  then checks this core's forks.
+ *
+ *      Only the rings' two sides and the wake semaphores are shared, so chunks are passed without the cross-core lock.
+ *      Kernels must not fork or join themselves.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_job.h"
+#include "eos_trace.h"
+#include "eos_wait.h"
+
+#if EOS_JOB_ENABLE
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_JobWorkerTask(void);
+static void EOS_JobFeed(EOS_job_group_t* group, uint32_t kernel, uintptr_t argument);
+static void EOS_JobWake(uint32_t core, uint32_t count);
+static uint32_t EOS_JobTake(EOS_job_t* job);
+static void EOS_JobExecute(const EOS_job_t* job);
+static uint32_t EOS_JobComplete(const EOS_job_group_t* group);
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_job_shared_t* job_shared = NULL;
+static uint32_t job_core = EOS_CORE_PRIMARY;
+static EOS_dual_semaphore_id_t job_wake[2];
+static EOS_ring_id_t job_rings[2][2];						//[to][from], as in EOS_job_shared_t
+static EOS_job_fn_t job_kernels[EOS_JOB_KERNELS];			//this core's
+static uint8_t job_used[EOS_JOB_GROUPS];					//this core's forks in flight
+static uint16_t job_kernel_of[EOS_JOB_GROUPS];
+static uintptr_t job_argument_of[EOS_JOB_GROUPS];
+static int32_t job_stacks[EOS_JOB_WORKERS][EOS_JOB_STACK_SIZE];
+
+
+
+/*	SETUP	*/
+
+
+/**
+ * @brief Connects this core to the shared rings and forks, and creates its worker tasks. Call it on both cores, after
+ * 			EOS_DualCoreInit() and before EOS_Init(). The primary core clears the shared memory, and creates the rings
+ * 			and the two wake semaphores (EOS_JOB_SEMAPHORE and the one after it), the secondary core waits until it
+ * 			has.
+ *
+ * @param core EOS_CORE_PRIMARY or EOS_CORE_SECONDARY, as passed to EOS_DualCoreInit().
+ * @param shared The shared memory, at the same physical location on both cores, non-cacheable.
+ * @param priority Priority of the worker tasks, that kernels run at, unless a joining task runs them.
+ * @return EOS_OK, or EOS_ERROR if the semaphores, rings or workers could not be created.
+ */
+EOS_status_t EOS_JobInit(uint32_t core, EOS_job_shared_t* shared, EOS_priority_t priority)
+{
+	job_shared = shared;
+	job_core = core;
+
+	if (core == EOS_CORE_PRIMARY)
+	{
+		memset((void*)shared, 0, sizeof(EOS_job_shared_t));
+		job_wake[EOS_CORE_PRIMARY] = EOS_DualSemaphoreNew(EOS_JOB_SEMAPHORE, EOS_JOB_WAKE_MAX);
+		job_wake[EOS_CORE_SECONDARY] = EOS_DualSemaphoreNew(EOS_JOB_SEMAPHORE + 1, EOS_JOB_WAKE_MAX);
+
+		if (job_wake[EOS_CORE_PRIMARY] == NULL || job_wake[EOS_CORE_SECONDARY] == NULL)
+		{
+			return EOS_ERROR;
+		}
+
+		for (uint32_t to = 0; to < 2; to++)
+		{
+			for (uint32_t from = 0; from < 2; from++)
+			{
+				job_rings[to][from] = EOS_RingCreate(&shared->rings[to][from], shared->slots[to][from],
+						EOS_JOB_RING_SIZE, sizeof(EOS_job_t), EOS_RING_UNCACHED);
+				if (job_rings[to][from] == NULL)
+				{
+					return EOS_ERROR;
+				}
+			}
+		}
+		__atomic_store_n(&shared->magic, EOS_JOB_MAGIC, __ATOMIC_RELEASE);
+	}
+	else
+	{
+		while (__atomic_load_n(&shared->magic, __ATOMIC_ACQUIRE) != EOS_JOB_MAGIC)
+		{
+		}
+		job_wake[EOS_CORE_PRIMARY] = EOS_DualSemaphoreOpen(EOS_JOB_SEMAPHORE);
+		job_wake[EOS_CORE_SECONDARY] = EOS_DualSemaphoreOpen(EOS_JOB_SEMAPHORE + 1);
+
+		for (uint32_t to = 0; to < 2; to++)
+		{
+			for (uint32_t from = 0; from < 2; from++)
+			{
+				job_rings[to][from] = EOS_RingOpen(&shared->rings[to][from]);
+			}
+		}
+	}
+
+	//shared semaphores start at their maximum count, so this core's is emptied: each count is then a wake up owed
+	for (uint32_t i = 0; i < EOS_JOB_WAKE_MAX; i++)
+	{
+		EOS_DualSemaphoreAcquire(job_wake[core]);
+	}
+
+	for (uint32_t i = 0; i < EOS_JOB_WORKERS; i++)
+	{
+		EOS_task_id_t task = EOS_ThreadNew(EOS_JobWorkerTask, priority, job_stacks[i], EOS_JOB_STACK_SIZE,
+				EOS_JOB_USE_FPU ? EOS_USE_FPU : EOS_NO_FPU);
+		if (task == NULL)
+		{
+			return EOS_ERROR;
+		}
+	}
+	shared->workers[core] = EOS_JOB_WORKERS;
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Registers this core's code for a kernel. Register each kernel under the same number on both cores, a core
+ * 			that has not registered it is given none of its chunks.
+ *
+ * @param kernel Number of the kernel, below EOS_JOB_KERNELS.
+ * @return EOS_OK, or EOS_ERROR if the number is out of range or the function is NULL.
+ */
+EOS_status_t EOS_JobRegister(uint32_t kernel, EOS_job_fn_t function)
+{
+	if (kernel >= EOS_JOB_KERNELS || function == NULL)
+	{
+		return EOS_ERROR;
+	}
+
+	job_kernels[kernel] = function;
+	__atomic_store_n(&job_shared->registered[job_core][kernel], 1, __ATOMIC_RELEASE);
+	return EOS_OK;
+}
+
+
+
+/*	FORK AND JOIN	*/
+
+
+/**
+ * @brief Submits chunks 0 to count - 1 of a kernel, to be run on both cores, without waiting for them.
+ *
+ * @param kernel Number of a kernel this core has registered.
+ * @param argument Passed to every chunk, see EOS_job_fn_t.
+ * @param count Number of chunks.
+ * @return The fork, to wait on with EOS_JobJoin(), or NULL if the kernel is not registered, count is 0, or this
+ * 			core has EOS_JOB_GROUPS forks in flight already.
+ */
+EOS_job_group_id_t EOS_JobFork(uint32_t kernel, void* argument, uint32_t count)
+{
+	if (kernel >= EOS_JOB_KERNELS || job_kernels[kernel] == NULL || count == 0)
+	{
+		return NULL;
+	}
+
+	EOS_job_group_t* group = NULL;
+	uint32_t index = 0;
+
+	EOS_EnterCritical();
+	for (index = 0; index < EOS_JOB_GROUPS; index++)
+	{
+		if (job_used[index] == 0)
+		{
+			job_used[index] = 1;
+			group = &job_shared->groups[job_core][index];
+			break;
+		}
+	}
+	EOS_ExitCritical();
+
+	if (group == NULL)
+	{
+		return NULL;
+	}
+
+	//no chunk of the group's last fork is left anywhere, so its counters can be reset
+	job_kernel_of[index] = (uint16_t)kernel;
+	job_argument_of[index] = (uintptr_t)argument;
+	group->count = count;
+	group->next = 0;
+	group->done[EOS_CORE_PRIMARY] = 0;
+	group->done[EOS_CORE_SECONDARY] = 0;
+
+	EOS_JobFeed(group, kernel, (uintptr_t)argument);
+	return group;
+}
+
+
+/**
+ * @brief Waits until every chunk of a fork has run, running chunks in the meantime, then frees the fork.
+ *
+ * @param group Fork from EOS_JobFork() on this core. Every fork must be joined once.
+ */
+void EOS_JobJoin(EOS_job_group_id_t group)
+{
+	uint32_t index = (uint32_t)(group - job_shared->groups[job_core]);
+	EOS_job_t job;
+
+	while (1)
+	{
+		if (group->next < group->count)
+		{
+			EOS_JobFeed(group, job_kernel_of[index], job_argument_of[index]);
+		}
+
+		if (EOS_JobTake(&job))
+		{
+			EOS_JobExecute(&job);
+			continue;
+		}
+
+		//nothing left to run on this core. The workers may have emptied the rings since they were topped up, so any
+		//chunks the fork still holds are dealt again. Otherwise the rest are queued on the other core, or running
+		if (group->next < group->count)
+		{
+			continue;
+		}
+
+		EOS_EnterCritical();
+		if (EOS_JobComplete(group))
+		{
+			EOS_ExitCritical();
+			break;
+		}
+
+		run_ptr->blocked = group;
+		EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, group);
+		EOS_WaitProfileBlock(run_ptr, group);
+		EOS_ExitCritical();
+		EOS_Suspend();
+	}
+
+	EOS_EnterCritical();
+	job_used[index] = 0;
+	EOS_ExitCritical();
+}
+
+
+/**
+ * @brief Runs chunks 0 to count - 1 of a kernel on both cores, and waits for all of them.
+ *
+ * @return EOS_OK, or EOS_ERROR if the fork could not be made (see EOS_JobFork()).
+ */
+EOS_status_t EOS_JobRun(uint32_t kernel, void* argument, uint32_t count)
+{
+	EOS_job_group_id_t group = EOS_JobFork(kernel, argument, count);
+
+	if (group == NULL)
+	{
+		return EOS_ERROR;
+	}
+	EOS_JobJoin(group);
+	return EOS_OK;
+}
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief This core's worker task. Runs chunks until both rings into the core are empty, and wakes the joining tasks
+ * 			of this core's forks the other core has finished, each time it is woken.
+ */
+static void EOS_JobWorkerTask(void)
+{
+	EOS_job_t job;
+
+	while (1)
+	{
+		EOS_DualSemaphoreAcquire(job_wake[job_core]);
+
+		while (EOS_JobTake(&job))
+		{
+			EOS_JobExecute(&job);
+		}
+
+		for (uint32_t index = 0; index < EOS_JOB_GROUPS; index++)
+		{
+			EOS_job_group_t* group = &job_shared->groups[job_core][index];
+
+			EOS_EnterCritical();
+			if (job_used[index] && EOS_JobComplete(group))
+			{
+				EOS_TaskUnblock(group);
+			}
+			EOS_ExitCritical();
+		}
+	}
+}
+
+
+/**
+ * @brief Deals the chunks a fork still holds to this core's ring and the other core's in turn, until both are full,
+ * 			then wakes the workers of each core given chunks. The other core is skipped if it has not registered the
+ * 			kernel.
+ */
+static void EOS_JobFeed(EOS_job_group_t* group, uint32_t kernel, uintptr_t argument)
+{
+	uint32_t other = job_core ^ 1;
+	uint32_t remote = __atomic_load_n(&job_shared->registered[other][kernel], __ATOMIC_ACQUIRE);
+	uint32_t given[2] = {0, 0};
+	EOS_job_t job = {
+			.argument = argument,
+			.kernel = (uint16_t)kernel,
+			.owner = (uint8_t)job_core,
+			.group = (uint8_t)(group - job_shared->groups[job_core])
+	};
+
+	EOS_EnterCritical();
+	while (group->next < group->count)
+	{
+		uint32_t target = (remote && (group->next & 1) == 0) ? other : job_core;
+		job.chunk = group->next;
+
+		if (EOS_RingWrite(job_rings[target][job_core], &job, sizeof(job)) != EOS_OK)
+		{
+			target ^= 1;
+			if ((target == other && remote == 0) ||
+					EOS_RingWrite(job_rings[target][job_core], &job, sizeof(job)) != EOS_OK)
+			{
+				break;
+			}
+		}
+
+		given[target]++;
+		group->next++;
+	}
+	EOS_ExitCritical();
+
+	EOS_JobWake(other, given[other]);
+	EOS_JobWake(job_core, given[job_core]);
+}
+
+
+/**
+ * @brief Wakes as many of a core's workers as it was given chunks, at most all of them. A wake semaphore already at
+ * 			EOS_JOB_WAKE_MAX owes enough wake ups, and refuses more.
+ */
+static void EOS_JobWake(uint32_t core, uint32_t count)
+{
+	uint32_t workers = job_shared->workers[core];
+
+	for (uint32_t i = 0; i < count && i < workers; i++)
+	{
+		EOS_DualSemaphoreRelease(job_wake[core]);
+	}
+}
+
+
+/**
+ * @brief Takes a chunk from the rings into this core, the other core's first, as its forking task cannot run them.
+ *
+ * @return 1 if a chunk was taken, 0 if both rings are empty.
+ */
+static uint32_t EOS_JobTake(EOS_job_t* job)
+{
+	uint32_t other = job_core ^ 1;
+
+	EOS_EnterCritical();
+	uint32_t taken = EOS_RingRead(job_rings[job_core][other], job, sizeof(EOS_job_t)) == EOS_OK ||
+			EOS_RingRead(job_rings[job_core][job_core], job, sizeof(EOS_job_t)) == EOS_OK;
+	EOS_ExitCritical();
+	return taken;
+}
+
+
+/**
+ * @brief Runs a chunk, counts it as done by this core, and wakes the joining task if it was the fork's last. A chunk
+ * 			finished late by the other core may see the fork reused, and wakes its owner for nothing, which is harmless.
+ */
+static void EOS_JobExecute(const EOS_job_t* job)
+{
+	EOS_job_group_t* group = &job_shared->groups[job->owner][job->group];
+
+	job_kernels[job->kernel]((void*)job->argument, job->chunk);
+
+	EOS_EnterCritical();
+	__atomic_store_n(&group->done[job_core], group->done[job_core] + 1, __ATOMIC_RELEASE);
+	uint32_t complete = EOS_JobComplete(group);
+
+	if (complete && job->owner == job_core)
+	{
+		EOS_TaskUnblock(group);
+	}
+	EOS_ExitCritical();
+
+	if (complete && job->owner != job_core)
+	{
+		EOS_DualSemaphoreRelease(job_wake[job->owner]);
+	}
+}
+
+
+/**
+ * @brief Checks whether every chunk of a fork has run, on either core.
+ */
+static uint32_t EOS_JobComplete(const EOS_job_group_t* group)
+{
+	return __atomic_load_n(&group->done[EOS_CORE_PRIMARY], __ATOMIC_ACQUIRE) +
+			__atomic_load_n(&group->done[EOS_CORE_SECONDARY], __ATOMIC_ACQUIRE) == group->count;
+}
+
+#endif
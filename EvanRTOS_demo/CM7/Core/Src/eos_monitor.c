@@ -0,0 +1,118 @@
+/*
+ * eos_monitor.c
+ *
+ *      "top" style monitor task for EvanRTOS. When EOS_MONITOR_ENABLE is set in eos_config.h, EOS_MonitorStart()
+ *      creates a low priority task that takes an EOS_TaskSnapshot() every period, and writes it out as CSV through
+ *      EOS_MonitorWrite(), which the application provides (the demo sends it over USART1). Being low priority, the
+ *      monitor only uses time the rest of the system leaves, so it can stay on in units under load, and a starved
+ *      monitor is itself a sign of overload.
+ *
+ *      The stream starts with a header line, followed by one line per task for every snapshot:
+ *      	seq,id,state,priority,cpu,switches,stack_used,stack_size,object
+ *      	12,3,B,1,4,1530,96,128,200004c0
+ *
+ *      	seq:			snapshot number, shared by every task of a snapshot
+ *      	state:			R running, r ready, B blocked (object is the queue/semaphore), D delayed, P paused
+ *      	cpu:			per mille of the CPU since the previous snapshot
+ *      	switches:		times the task was switched in since it was created
+ *      	stack_used:		stack high water mark, in words (stack_size is in words too)
+ *
+ *      cpu, switches and stack_used are 0 unless EOS_TASK_STATS_ENABLE is set. tools/eos_top.py shows the stream as a
+ *      live table.
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "eos_monitor.h"
+
+#if EOS_MONITOR_ENABLE
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_MonitorTask(void);
+
+
+/*	GLOBAL VARIABLES	*/
+static int32_t monitor_stack[EOS_MONITOR_STACK_SIZE];
+static EOS_task_info_t monitor_tasks[EOS_MONITOR_TASKS];
+static uint32_t monitor_period = 1000; //ticks
+
+
+
+/*	MONITOR FUNCTIONALITY	*/
+
+
+/**
+ * @brief Creates the monitor task, at PRIORITY_LOW. Call it before EOS_Init(), like EOS_ThreadNew().
+ *
+ * @param period_ticks Time between two snapshots, in kernel ticks as for EOS_Delay(): one task period (set with
+ * 			EOS_Init(), 1ms by default) each.
+ *
+ * @return ID of the monitor task, or EOS_ERROR on failure.
+ */
+EOS_task_id_t EOS_MonitorStart(uint32_t period_ticks){
+	monitor_period = period_ticks;
+	return EOS_ThreadNew(EOS_MonitorTask, PRIORITY_LOW, monitor_stack, EOS_MONITOR_STACK_SIZE, EOS_NO_FPU);
+}
+
+
+/**
+ * @brief Formats one task of a snapshot as a CSV line.
+ *
+ * @return The length of the line, not counting the terminating null.
+ */
+uint32_t EOS_MonitorFormat(char* buffer, uint32_t size, uint32_t sequence, const EOS_task_info_t* info){
+
+	static const char state_names[] = "RrBDP";
+
+	int length = snprintf(buffer, size, "%lu,%u,%c,%u,%u,%lu,%lu,%lu,%lx\r\n", (unsigned long)sequence, info->id,
+			state_names[info->state], info->priority, info->cpu, (unsigned long)info->switches,
+			(unsigned long)info->stack_used, (unsigned long)info->stack_size, (unsigned long)(uintptr_t)info->object);
+
+	if (length < 0)
+	{
+		return 0;
+	}
+	return ((uint32_t)length < size) ? (uint32_t)length : size - 1;
+}
+
+
+/**
+ * @brief Writes the monitor output. Override this in your project (for example with HAL_UART_Transmit()). The default
+ * 			drops it.
+ */
+__attribute__((weak)) void EOS_MonitorWrite(const char* data, uint32_t length){
+	(void)data;
+	(void)length;
+}
+
+
+
+/*	MONITOR TASK	*/
+
+
+static void EOS_MonitorTask(void){
+
+	static const char header[] = "seq,id,state,priority,cpu,switches,stack_used,stack_size,object\r\n";
+	char line[80];
+	uint32_t sequence = 0;
+
+	EOS_MonitorWrite(header, sizeof(header) - 1);
+	EOS_TaskSnapshot(monitor_tasks, EOS_MONITOR_TASKS); //starts the first CPU interval
+
+	while (1)
+	{
+		EOS_Delay(monitor_period);
+
+		uint32_t count = EOS_TaskSnapshot(monitor_tasks, EOS_MONITOR_TASKS);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t length = EOS_MonitorFormat(line, sizeof(line), sequence, &monitor_tasks[i]);
+			EOS_MonitorWrite(line, length);
+		}
+		sequence++;
+	}
+}
+
+#endif
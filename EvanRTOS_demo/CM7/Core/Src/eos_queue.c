@@ -31,6 +31,8 @@
 
 /*	INCLUDES	*/
 #include "eos_queue.h"
+#include "eos_trace.h"
+#include "eos_wait.h"
 
 
 
@@ -64,6 +66,7 @@ EOS_queue_id_t EOS_QueueCreate(uint32_t size, uint32_t item_size){
 	queue->size = size;
 	queue->item_size = item_size;
 	queue->count = 0;
+	EOS_ContentionRegister(&queue->contention, queue, EOS_CONTENTION_QUEUE);
 	return queue;
 
 }
@@ -85,13 +88,19 @@ EOS_queue_id_t EOS_QueueCreate(uint32_t size, uint32_t item_size){
  */
 EOS_status_t EOS_QueueGet(EOS_queue_id_t queue, void *item, EOS_block_status_t block){
 
+	EOS_CONTENTION_WAIT(wait);
 	EOS_EnterCritical();
 
 	if (queue->count == 0)
 	{
+		EOS_ContentionEmpty(&queue->contention);
+
 		if(block == EOS_BLOCK)
 		{
 		run_ptr->blocked = (void *)queue;
+		EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, queue);
+		EOS_WaitProfileBlock(run_ptr, queue);
+		EOS_ContentionBlock(&queue->contention, &wait);
 		EOS_ExitCritical();
 		EOS_Suspend();
 		EOS_EnterCritical();
@@ -114,6 +123,8 @@ EOS_status_t EOS_QueueGet(EOS_queue_id_t queue, void *item, EOS_block_status_t b
 	memcpy(item, src, queue->item_size);
 	queue->head = (queue->head + 1) % queue->size;
 	queue->count--;
+	EOS_TRACE(EOS_TRACE_QUEUE_GET, run_ptr, queue);
+	EOS_ContentionAcquire(&queue->contention, &wait);
 
 	EOS_TaskUnblock(queue);
 
@@ -138,13 +149,19 @@ EOS_status_t EOS_QueueGet(EOS_queue_id_t queue, void *item, EOS_block_status_t b
  * @todo Improve the task unblocking method.
  */
 EOS_status_t EOS_QueuePut(EOS_queue_id_t queue, const void *item, EOS_block_status_t block){
+	EOS_CONTENTION_WAIT(wait);
 	EOS_EnterCritical();
 
 	if (queue->count == queue->size)
 	{
+		EOS_ContentionFull(&queue->contention);
+
 		if (block == EOS_BLOCK)
 		{
 			run_ptr->blocked = (void *)queue;
+			EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, queue);
+			EOS_WaitProfileBlock(run_ptr, queue);
+			EOS_ContentionBlock(&queue->contention, &wait);
 			EOS_ExitCritical();
 			EOS_Suspend();
 			EOS_EnterCritical();
@@ -167,6 +184,9 @@ EOS_status_t EOS_QueuePut(EOS_queue_id_t queue, const void *item, EOS_block_stat
 	memcpy(dest, item, queue->item_size);
 	queue->tail = (queue->tail + 1) % queue->size;
 	queue->count++;
+	EOS_TRACE(EOS_TRACE_QUEUE_PUT, run_ptr, queue);
+	EOS_ContentionRelease(&queue->contention, &wait);
+	EOS_ContentionLevel(&queue->contention, queue->count);
 
 	EOS_TaskUnblock(queue);
 
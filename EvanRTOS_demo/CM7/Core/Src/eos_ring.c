@@ -0,0 +1,272 @@
+/*
+ * eos_ring.c
+ *
+ *      Cache coherent ring buffers, for streaming data between the cores of the STM32H747, or between a core and a
+ *      DMA master, through D2 or D3 SRAM. Enabled with EOS_RING_ENABLE in eos_config.h.
+ *
+ *      The Cortex-M7 data cache is write-back, and neither the Cortex-M4 nor the DMA masters see into it, so a ring in
+ *      cacheable memory is only coherent if each side cleans what it wrote and invalidates what it is about to read.
+ *      A ring (EOS_ring_t) is a power of 2 number of fixed size slots, each a whole number of cache lines and line
+ *      aligned, so maintaining one slot never touches another. The head index (written by the producer) and the tail
+ *      index (written by the consumer) each have a cache line of their own. On the producer side, EOS_RingReserve()
+ *      returns the free slots from the head onwards, the producer fills them in place, and EOS_RingCommit() cleans
+ *      them and then publishes the new head. On the consumer side, EOS_RingPeek() reads the head, invalidates the
+ *      filled slots and returns them, and EOS_RingConsume() publishes the new tail once they are read. Each side keeps
+ *      its last copy of the other's index, and only reads the other's cache line again when that copy says the ring
+ *      is full (or empty), so a stream of commits costs one clean of the data, and one of an index line per batch.
+ *      EOS_RingWrite() and EOS_RingRead() copy one item in or out, for small items.
+ *
+ *      Rings in memory made non-cacheable with the MPU (EOS_PortMpuUncached()), used only by cores without a data
+ *      cache, or with both sides on one core, are created with EOS_RING_UNCACHED and skip the maintenance. Both sides
+ *      may be tasks or interrupts, but each side must only have one user at a time. Nothing blocks: a full ring
+ *      reserves no slots, an empty ring peeks none, and the caller decides whether to wait (with EOS_Delay(), or a
+ *      semaphore given by the other side).
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_ring.h"
+
+#if EOS_RING_ENABLE
+
+#if (EOS_CACHE_LINE & (EOS_CACHE_LINE - 1)) != 0 || EOS_CACHE_LINE < 16
+#error "EOS_CACHE_LINE must be a power of 2, at least 16"
+#endif
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_RingClean(const EOS_ring_t* ring, const void* address, uint32_t size);
+static void EOS_RingInvalidate(const EOS_ring_t* ring, void* address, uint32_t size);
+
+
+
+/*	SETUP	*/
+
+
+/**
+ * @brief Creates a ring in memory the producer and the consumer can both reach, and discards anything this core has
+ * 			cached of it. Called by one side, before either uses it.
+ *
+ * @param ring The ring, cache line aligned (see EOS_RING_DEFINE()).
+ * @param slots Memory for count slots of EOS_RING_SLOT_SIZE(slot_size) bytes, cache line aligned.
+ * @param count Number of slots, a power of 2.
+ * @param slot_size Size of the largest item, in bytes.
+ * @param flags EOS_RING_CACHED or EOS_RING_UNCACHED.
+ * @return The ring, or NULL if the arguments are out of range or misaligned.
+ */
+EOS_ring_id_t EOS_RingCreate(EOS_ring_t* ring, void* slots, uint32_t count, uint32_t slot_size, uint32_t flags)
+{
+	if (ring == NULL || slots == NULL || count == 0 || (count & (count - 1)) != 0 || slot_size == 0 ||
+			((uintptr_t)ring | (uintptr_t)slots) & (EOS_CACHE_LINE - 1))
+	{
+		return NULL;
+	}
+
+	ring->count = 0; //not ready until the rest is in memory
+	ring->slots = slots;
+	ring->slot_size = EOS_RING_SLOT_SIZE(slot_size);
+	ring->flags = flags;
+
+	//dirty lines left over from earlier use would be written over the other side's data when evicted
+	EOS_RingInvalidate(ring, slots, count * ring->slot_size);
+
+	ring->head = 0;
+	ring->producer_tail = 0;
+	ring->tail = 0;
+	ring->consumer_head = 0;
+	EOS_RingClean(ring, (const void*)&ring->head, 2 * EOS_CACHE_LINE);
+
+	__atomic_store_n(&ring->count, count, __ATOMIC_RELEASE);
+	EOS_RingClean(ring, ring, EOS_CACHE_LINE);
+	return ring;
+}
+
+
+/**
+ * @brief Connects the side that did not create the ring, discarding anything this core has cached of it.
+ *
+ * @param ring The ring created by the other side.
+ * @return The ring, or NULL if it has not been created yet.
+ */
+EOS_ring_id_t EOS_RingOpen(EOS_ring_t* ring)
+{
+	EOS_PortCacheInvalidate(ring, sizeof(EOS_ring_t));
+
+	if (__atomic_load_n(&ring->count, __ATOMIC_ACQUIRE) == 0)
+	{
+		return NULL;
+	}
+
+	EOS_RingInvalidate(ring, ring->slots, ring->count * ring->slot_size);
+	return ring;
+}
+
+
+
+/*	PRODUCER SIDE	*/
+
+
+/**
+ * @brief Finds the free slots from the head of the ring onwards, up to the end of the slot memory, for the producer to
+ * 			fill in place.
+ *
+ * @param ring The ring.
+ * @param slot Set to the first free slot. The next ones follow it, EOS_RING_SLOT_SIZE() bytes apart.
+ * @return The number of free slots at *slot, 0 if the ring is full.
+ */
+uint32_t EOS_RingReserve(EOS_ring_id_t ring, void** slot)
+{
+	uint32_t head = ring->head;
+	uint32_t free = ring->count - (head - ring->producer_tail);
+
+	if (free == 0)
+	{
+		//only read the consumer's line when the last copy of the tail says the ring is full
+		EOS_RingInvalidate(ring, (void*)&ring->tail, EOS_CACHE_LINE);
+		ring->producer_tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		free = ring->count - (head - ring->producer_tail);
+	}
+
+	uint32_t index = head & (ring->count - 1);
+	uint32_t contiguous = ring->count - index;
+
+	*slot = &ring->slots[index * ring->slot_size];
+	return (free < contiguous) ? free : contiguous;
+}
+
+
+/**
+ * @brief Hands filled slots to the consumer: writes them back from the data cache, then publishes the new head.
+ *
+ * @param ring The ring.
+ * @param slots Number of slots filled, at most what EOS_RingReserve() returned.
+ */
+void EOS_RingCommit(EOS_ring_id_t ring, uint32_t slots)
+{
+	uint32_t head = ring->head;
+
+	EOS_RingClean(ring, &ring->slots[(head & (ring->count - 1)) * ring->slot_size], slots * ring->slot_size);
+	__atomic_store_n(&ring->head, head + slots, __ATOMIC_RELEASE);
+	EOS_RingClean(ring, (const void*)&ring->head, EOS_CACHE_LINE);
+}
+
+
+/**
+ * @brief Copies one item into the next slot, and commits it.
+ *
+ * @return EOS_OK, or EOS_ERROR if the ring is full or the item is larger than a slot.
+ */
+EOS_status_t EOS_RingWrite(EOS_ring_id_t ring, const void* item, uint32_t size)
+{
+	void* slot;
+
+	if (size > ring->slot_size || EOS_RingReserve(ring, &slot) == 0)
+	{
+		return EOS_ERROR;
+	}
+
+	memcpy(slot, item, size);
+	EOS_RingCommit(ring, 1);
+	return EOS_OK;
+}
+
+
+
+/*	CONSUMER SIDE	*/
+
+
+/**
+ * @brief Finds the filled slots from the tail of the ring onwards, up to the end of the slot memory, and invalidates
+ * 			them, so they are read from memory. The slots must only be read, and stay the consumer's until
+ * 			EOS_RingConsume().
+ *
+ * @param ring The ring.
+ * @param slot Set to the first filled slot. The next ones follow it, EOS_RING_SLOT_SIZE() bytes apart.
+ * @return The number of filled slots at *slot, 0 if the ring is empty.
+ */
+uint32_t EOS_RingPeek(EOS_ring_id_t ring, void** slot)
+{
+	uint32_t tail = ring->tail;
+	uint32_t filled = ring->consumer_head - tail;
+
+	if (filled == 0)
+	{
+		//only read the producer's line when the last copy of the head says the ring is empty
+		EOS_RingInvalidate(ring, (void*)&ring->head, EOS_CACHE_LINE);
+		ring->consumer_head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		filled = ring->consumer_head - tail;
+	}
+
+	uint32_t index = tail & (ring->count - 1);
+	uint32_t contiguous = ring->count - index;
+	filled = (filled < contiguous) ? filled : contiguous;
+
+	*slot = &ring->slots[index * ring->slot_size];
+	EOS_RingInvalidate(ring, *slot, filled * ring->slot_size);
+	return filled;
+}
+
+
+/**
+ * @brief Hands read slots back to the producer, by publishing the new tail.
+ *
+ * @param ring The ring.
+ * @param slots Number of slots read, at most what EOS_RingPeek() returned.
+ */
+void EOS_RingConsume(EOS_ring_id_t ring, uint32_t slots)
+{
+	__atomic_store_n(&ring->tail, ring->tail + slots, __ATOMIC_RELEASE);
+	EOS_RingClean(ring, (const void*)&ring->tail, EOS_CACHE_LINE);
+}
+
+
+/**
+ * @brief Copies the item in the next slot out, and consumes it.
+ *
+ * @param size Bytes to copy, at most the slot size.
+ * @return EOS_OK, or EOS_ERROR if the ring is empty.
+ */
+EOS_status_t EOS_RingRead(EOS_ring_id_t ring, void* item, uint32_t size)
+{
+	void* slot;
+
+	if (size > ring->slot_size || EOS_RingPeek(ring, &slot) == 0)
+	{
+		return EOS_ERROR;
+	}
+
+	memcpy(item, slot, size);
+	EOS_RingConsume(ring, 1);
+	return EOS_OK;
+}
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Writes a line aligned range back to memory, unless the ring is not cached.
+ */
+static void EOS_RingClean(const EOS_ring_t* ring, const void* address, uint32_t size)
+{
+	if (ring->flags != EOS_RING_UNCACHED && size != 0)
+	{
+		EOS_PortCacheClean(address, size);
+	}
+}
+
+
+/**
+ * @brief Discards this core's copy of a line aligned range, unless the ring is not cached.
+ */
+static void EOS_RingInvalidate(const EOS_ring_t* ring, void* address, uint32_t size)
+{
+	if (ring->flags != EOS_RING_UNCACHED && size != 0)
+	{
+		EOS_PortCacheInvalidate(address, size);
+	}
+}
+
+#endif
@@ -0,0 +1,412 @@
+/*
+ * eos_rpc.c
+ *
+ *      Remote procedure calls between the two EvanRTOS instances of a dual core chip, built on eos_dual_core.c, so work
+ *      can be split between the cores (compute heavy filters on one, I/O on the other) without hand made mailboxes.
+ *      Enabled with EOS_RPC_ENABLE in eos_config.h, on both cores.
+ *
+ *      A core serves a function by registering it under a name (EOS_RpcRegister()), and any task on either core
+ *      finds it with EOS_RpcLookup(). Calls live in a pool of slots in shared memory (EOS_rpc_shared_t), each holding
+ *      the request, then the response, of at most EOS_RPC_MESSAGE_SIZE bytes:
+ *      	- EOS_RpcCallAsync() copies the request into a free slot, and sends the slot to the serving core's inbox
+ *      	  (a shared queue). It returns a handle straight away, for the task to carry on and wait later.
+ *      	- EOS_RpcCallBatch() does the same for several requests at once. Slots for the same core are chained and
+ *      	  sent as one inbox item, so the batch costs one lock, one queue put and one interrupt per core, and comes
+ *      	  back the same way.
+ *      	- EOS_RpcWait() blocks the calling task until the response is back, copies it out, and frees the slot.
+ *      	  Every handle must be waited on once. EOS_RpcPoll() checks without blocking.
+ *      	- EOS_RpcCall() is a call and a wait.
+ *
+ *      Each core runs a service task (created by EOS_RpcInit()) that blocks on its inbox. For requests, it runs the
+ *      handler of each call in the chain, then sends the chain back to the calling core's inbox. For responses, it
+ *      marks each call returned and unblocks the task waiting on it. Handlers therefore run one at a time, at the
+ *      service task's priority, and must not wait on calls themselves.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_rpc.h"
+#include "eos_trace.h"
+#include "eos_wait.h"
+
+#if EOS_RPC_ENABLE
+
+/* Inbox items: the first call of a chain, with the top bit set for responses */
+#define EOS_RPC_RESPONSE 0x80000000u
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_RpcServiceTask(void);
+static void EOS_RpcServe(uint32_t first);
+static void EOS_RpcReturn(uint32_t first);
+static EOS_status_t EOS_RpcSubmit(const EOS_rpc_request_t* requests, uint32_t count, EOS_rpc_handle_t* handles);
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_rpc_shared_t* rpc_shared = NULL;
+static uint32_t rpc_core = EOS_CORE_PRIMARY;
+static EOS_dual_queue_id_t rpc_inbox[2];
+static EOS_rpc_handler_t rpc_handlers[EOS_RPC_ENDPOINTS];	//this core's, by endpoint
+static int32_t rpc_stack[EOS_RPC_STACK_SIZE];
+
+
+
+/*	SETUP	*/
+
+
+/**
+ * @brief Connects this core to the shared calls and endpoints, and creates its service task. Call it on both cores,
+ * 			after EOS_DualCoreInit() and before EOS_Init(). The primary core clears the shared memory and creates the
+ * 			two inbox queues (EOS_RPC_QUEUE and the one after it), the secondary core waits until it has.
+ *
+ * @param core EOS_CORE_PRIMARY or EOS_CORE_SECONDARY, as passed to EOS_DualCoreInit().
+ * @param shared The shared memory, at the same physical location on both cores.
+ * @param priority Priority of the service task, that handlers run at.
+ * @return EOS_OK, or EOS_ERROR if the inboxes or the service task could not be created.
+ */
+EOS_status_t EOS_RpcInit(uint32_t core, EOS_rpc_shared_t* shared, EOS_priority_t priority)
+{
+	rpc_shared = shared;
+	rpc_core = core;
+
+	if (core == EOS_CORE_PRIMARY)
+	{
+		memset((void*)shared, 0, sizeof(EOS_rpc_shared_t));
+		rpc_inbox[EOS_CORE_PRIMARY] = EOS_DualQueueCreate(EOS_RPC_QUEUE, EOS_RPC_SLOTS, sizeof(uint32_t));
+		rpc_inbox[EOS_CORE_SECONDARY] = EOS_DualQueueCreate(EOS_RPC_QUEUE + 1, EOS_RPC_SLOTS, sizeof(uint32_t));
+
+		if (rpc_inbox[EOS_CORE_PRIMARY] == NULL || rpc_inbox[EOS_CORE_SECONDARY] == NULL)
+		{
+			return EOS_ERROR;
+		}
+		__atomic_store_n(&shared->magic, EOS_RPC_MAGIC, __ATOMIC_RELEASE);
+	}
+	else
+	{
+		while (__atomic_load_n(&shared->magic, __ATOMIC_ACQUIRE) != EOS_RPC_MAGIC)
+		{
+		}
+		rpc_inbox[EOS_CORE_PRIMARY] = EOS_DualQueueOpen(EOS_RPC_QUEUE);
+		rpc_inbox[EOS_CORE_SECONDARY] = EOS_DualQueueOpen(EOS_RPC_QUEUE + 1);
+	}
+
+	EOS_task_id_t task = EOS_ThreadNew(EOS_RpcServiceTask, priority, rpc_stack, EOS_RPC_STACK_SIZE,
+			EOS_RPC_USE_FPU ? EOS_USE_FPU : EOS_NO_FPU);
+	return (task == NULL) ? EOS_ERROR : EOS_OK;
+}
+
+
+
+/*	ENDPOINTS	*/
+
+
+/**
+ * @brief Serves a function on this core under a name, for tasks on either core to call.
+ *
+ * @param name Name of the endpoint, shorter than EOS_RPC_NAME_SIZE.
+ * @param handler Function that runs each call, in this core's service task.
+ * @return EOS_OK, or EOS_ERROR if the name is too long or taken, or there is no free endpoint.
+ */
+EOS_status_t EOS_RpcRegister(const char* name, EOS_rpc_handler_t handler)
+{
+	if (strlen(name) >= EOS_RPC_NAME_SIZE || handler == NULL)
+	{
+		return EOS_ERROR;
+	}
+
+	EOS_status_t status = EOS_ERROR;
+	uint32_t state = EOS_PortMaskInterrupts();
+	EOS_PortCoreLock(&rpc_shared->lock);
+
+	if (EOS_RpcLookup(name) == EOS_RPC_NO_ENDPOINT)
+	{
+		for (uint32_t i = 0; i < EOS_RPC_ENDPOINTS; i++)
+		{
+			EOS_rpc_endpoint_entry_t* entry = &rpc_shared->endpoints[i];
+
+			if (entry->registered == 0)
+			{
+				strcpy(entry->name, name);
+				entry->core = rpc_core;
+				rpc_handlers[i] = handler;
+				__atomic_store_n(&entry->registered, 1, __ATOMIC_RELEASE);
+				status = EOS_OK;
+				break;
+			}
+		}
+	}
+
+	EOS_PortCoreUnlock(&rpc_shared->lock);
+	EOS_PortRestoreInterrupts(state);
+	return status;
+}
+
+
+/**
+ * @brief Finds an endpoint registered by either core.
+ *
+ * @return The endpoint, or EOS_RPC_NO_ENDPOINT if no core has registered the name (yet).
+ */
+EOS_rpc_endpoint_t EOS_RpcLookup(const char* name)
+{
+	for (uint32_t i = 0; i < EOS_RPC_ENDPOINTS; i++)
+	{
+		EOS_rpc_endpoint_entry_t* entry = &rpc_shared->endpoints[i];
+
+		if (__atomic_load_n(&entry->registered, __ATOMIC_ACQUIRE) &&
+				strncmp(entry->name, name, EOS_RPC_NAME_SIZE) == 0)
+		{
+			return i;
+		}
+	}
+	return EOS_RPC_NO_ENDPOINT;
+}
+
+
+
+/*	CALLS	*/
+
+
+/**
+ * @brief Starts a call, without waiting for it.
+ *
+ * @param endpoint Endpoint to call, from EOS_RpcLookup().
+ * @param request The request, size bytes.
+ * @param size Size of the request, at most EOS_RPC_MESSAGE_SIZE.
+ * @return A handle to wait on with EOS_RpcWait(), or NULL if the arguments are invalid or all slots are in use.
+ */
+EOS_rpc_handle_t EOS_RpcCallAsync(EOS_rpc_endpoint_t endpoint, const void* request, uint32_t size)
+{
+	EOS_rpc_request_t one = {endpoint, request, size};
+	EOS_rpc_handle_t handle = NULL;
+
+	EOS_RpcSubmit(&one, 1, &handle);
+	return handle;
+}
+
+
+/**
+ * @brief Starts several calls at once, without waiting for them. Either all of them are started, or none.
+ *
+ * @param requests The calls, to endpoints on either core.
+ * @param count Number of calls.
+ * @param handles Set to a handle for each call, to wait on with EOS_RpcWait().
+ * @return EOS_OK, or EOS_ERROR if a request is invalid or there are not enough free slots.
+ */
+EOS_status_t EOS_RpcCallBatch(const EOS_rpc_request_t* requests, uint32_t count, EOS_rpc_handle_t* handles)
+{
+	return EOS_RpcSubmit(requests, count, handles);
+}
+
+
+/**
+ * @brief Checks whether a call has returned, without blocking.
+ *
+ * @return EOS_OK if EOS_RpcWait() will return straight away, EOS_BLOCKED if not.
+ */
+EOS_status_t EOS_RpcPoll(EOS_rpc_handle_t handle)
+{
+	return (__atomic_load_n(&handle->state, __ATOMIC_ACQUIRE) == EOS_RPC_RETURNED) ? EOS_OK : EOS_BLOCKED;
+}
+
+
+/**
+ * @brief Blocks the current task until a call has returned, copies the response out, and frees the call.
+ *
+ * @param handle Handle from EOS_RpcCallAsync() or EOS_RpcCallBatch().
+ * @param response Where the response is copied to.
+ * @param size Size of the response buffer on entry, size of the response on return. The response is cut to fit.
+ * @return EOS_OK, or EOS_ERROR if the endpoint was not served by the core it was sent to.
+ */
+EOS_status_t EOS_RpcWait(EOS_rpc_handle_t handle, void* response, uint32_t* size)
+{
+	EOS_EnterCritical();
+
+	while (handle->state != EOS_RPC_RETURNED)
+	{
+		run_ptr->blocked = handle;
+		EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, handle);
+		EOS_WaitProfileBlock(run_ptr, handle);
+		EOS_ExitCritical();
+		EOS_Suspend();
+		EOS_EnterCritical();
+	}
+
+	EOS_ExitCritical();
+
+	uint32_t length = (handle->size < *size) ? handle->size : *size;
+	EOS_status_t status = handle->status;
+
+	memcpy(response, handle->message, length);
+	*size = handle->size;
+	__atomic_store_n(&handle->state, EOS_RPC_FREE, __ATOMIC_RELEASE);
+	return status;
+}
+
+
+/**
+ * @brief Calls an endpoint and waits for the response.
+ *
+ * @param response_size Size of the response buffer on entry, size of the response on return.
+ * @return EOS_OK, or EOS_ERROR if the call could not be started or was not served.
+ */
+EOS_status_t EOS_RpcCall(EOS_rpc_endpoint_t endpoint, const void* request, uint32_t size, void* response,
+		uint32_t* response_size)
+{
+	EOS_rpc_handle_t handle = EOS_RpcCallAsync(endpoint, request, size);
+
+	if (handle == NULL)
+	{
+		return EOS_ERROR;
+	}
+	return EOS_RpcWait(handle, response, response_size);
+}
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Takes a free slot for each request, under the cross-core lock, fills them in, chains them by serving core,
+ * 			and sends each chain to its core's inbox.
+ */
+static EOS_status_t EOS_RpcSubmit(const EOS_rpc_request_t* requests, uint32_t count, EOS_rpc_handle_t* handles)
+{
+	uint32_t first[2] = {EOS_RPC_SLOTS, EOS_RPC_SLOTS};
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (requests[i].endpoint >= EOS_RPC_ENDPOINTS || requests[i].size > EOS_RPC_MESSAGE_SIZE ||
+				rpc_shared->endpoints[requests[i].endpoint].registered == 0)
+		{
+			return EOS_ERROR;
+		}
+	}
+
+	uint32_t state = EOS_PortMaskInterrupts();
+	EOS_PortCoreLock(&rpc_shared->lock);
+
+	uint32_t taken = 0;
+	for (uint32_t slot = 0; slot < EOS_RPC_SLOTS && taken < count; slot++)
+	{
+		if (rpc_shared->calls[slot].state == EOS_RPC_FREE)
+		{
+			handles[taken++] = &rpc_shared->calls[slot];
+		}
+	}
+
+	if (taken == count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			handles[i]->state = EOS_RPC_QUEUED;
+		}
+	}
+
+	EOS_PortCoreUnlock(&rpc_shared->lock);
+	EOS_PortRestoreInterrupts(state);
+
+	if (taken < count)
+	{
+		return EOS_ERROR;
+	}
+
+	//the slots are this task's until they are sent, chains are built back to front so they keep the request order
+	for (uint32_t i = count; i-- > 0;)
+	{
+		EOS_rpc_call_t* call = handles[i];
+		uint32_t core = rpc_shared->endpoints[requests[i].endpoint].core;
+
+		call->endpoint = requests[i].endpoint;
+		call->caller = rpc_core;
+		call->size = requests[i].size;
+		call->status = EOS_ERROR;
+		memcpy(call->message, requests[i].data, requests[i].size);
+
+		call->next = first[core];
+		first[core] = (uint32_t)(call - rpc_shared->calls);
+	}
+
+	for (uint32_t core = 0; core < 2; core++)
+	{
+		if (first[core] != EOS_RPC_SLOTS)
+		{
+			EOS_DualQueuePut(rpc_inbox[core], &first[core], EOS_BLOCK); //never full, there are as many items as slots
+		}
+	}
+	return EOS_OK;
+}
+
+
+/**
+ * @brief This core's service task. Runs the calls sent to it, and returns the calls it sent.
+ */
+static void EOS_RpcServiceTask(void)
+{
+	while (1)
+	{
+		uint32_t item = 0;
+		EOS_DualQueueGet(rpc_inbox[rpc_core], &item, EOS_BLOCK);
+
+		if (item & EOS_RPC_RESPONSE)
+		{
+			EOS_RpcReturn(item & ~EOS_RPC_RESPONSE);
+		}
+		else
+		{
+			EOS_RpcServe(item);
+		}
+	}
+}
+
+
+/**
+ * @brief Runs the handler of each call in a chain, then sends the chain back to the core that made it.
+ */
+static void EOS_RpcServe(uint32_t first)
+{
+	for (uint32_t slot = first; slot != EOS_RPC_SLOTS;)
+	{
+		EOS_rpc_call_t* call = &rpc_shared->calls[slot];
+		EOS_rpc_handler_t handler = rpc_handlers[call->endpoint];
+		slot = call->next;
+
+		if (handler != NULL && rpc_shared->endpoints[call->endpoint].core == rpc_core)
+		{
+			uint32_t size = handler(call->message, call->size);
+			call->size = (size < EOS_RPC_MESSAGE_SIZE) ? size : EOS_RPC_MESSAGE_SIZE;
+			call->status = EOS_OK;
+		}
+		else
+		{
+			call->size = 0;
+		}
+		call->state = EOS_RPC_DONE;
+	}
+
+	uint32_t item = first | EOS_RPC_RESPONSE;
+	EOS_DualQueuePut(rpc_inbox[rpc_shared->calls[first].caller], &item, EOS_BLOCK);
+}
+
+
+/**
+ * @brief Marks each call of a chain that came back returned, and unblocks the task waiting on it. The next call is
+ * 			read first, as the waiter may free the call as soon as it is unblocked.
+ */
+static void EOS_RpcReturn(uint32_t first)
+{
+	for (uint32_t slot = first; slot != EOS_RPC_SLOTS;)
+	{
+		EOS_rpc_call_t* call = &rpc_shared->calls[slot];
+		slot = call->next;
+
+		EOS_EnterCritical();
+		__atomic_store_n(&call->state, EOS_RPC_RETURNED, __ATOMIC_RELEASE);
+		EOS_TaskUnblock(call);
+		EOS_ExitCritical();
+	}
+}
+
+#endif
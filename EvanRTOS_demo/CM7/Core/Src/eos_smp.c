@@ -0,0 +1,362 @@
+/*
+ * eos_smp.c
+ *
+ *      Symmetric multiprocessing for EvanRTOS: one kernel instance scheduling tasks across EOS_SMP_CORES cores that
+ *      share memory, unlike the dual core mode (eos_dual_core.c), where each core runs an instance of its own. Enabled
+ *      with EOS_SMP_ENABLE in eos_config.h, on an SMP port (port/POSIX_SMP, where pthreads play the cores, for now).
+ *
+ *      Each core has a run queue: a ring of the tasks it runs (linked by EOS_TCB_t.run_next), headed by its own idle
+ *      task, and its own entry in eos_run_ptr[], which run_ptr reads for the calling core. EOS_ThreadNew() puts a new
+ *      task in the run queue with the fewest tasks (EOS_SmpAssign()). The scheduler (EOS_SmpPick()) works like the
+ *      single core one, over the calling core's run queue only, so priorities are per core. When the core has nothing
+ *      but its idle task to run, it steals the highest priority ready task from the other cores' run queues, and keeps
+ *      it. A task is only ever run by the core whose run queue holds it, and only moves between run queues while no
+ *      core runs it (EOS_TCB_t.running), so a core never picks a task whose context another core is still saving.
+ *
+ *      When a task is woken (EOS_TaskUnblock(), or a delay running out), EOS_SmpWake() checks whether its core is
+ *      running something of lower priority. If not, it hands the task to the core running the lowest priority task
+ *      below it, idle cores first, if any. The chosen core is interrupted to reschedule (EOS_PortCoreNotify(), whose
+ *      handler calls EOS_SmpIsr()), unless it is the calling core, which switches itself. Each core's tick also makes
+ *      it reschedule, and only core 0's handles delays.
+ *
+ *      Kernel state is guarded by one spinlock (EOS_PortCoreLock()), taken by EOS_EnterCritical() after masking this
+ *      core's interrupts, and by the scheduler. Critical sections do not nest, as on a single core: entering while this
+ *      core holds the lock folds into the outer section, and exiting without it (after EOS_TaskUnblock() has already
+ *      exited) only unmasks interrupts. Queues and semaphores work unchanged.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_smp.h"
+
+#if EOS_SMP_ENABLE
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static EOS_TCB_t* EOS_SmpSteal(uint32_t core);
+static void EOS_SmpMove(EOS_TCB_t* task, uint32_t core);
+
+
+/*	GLOBAL VARIABLES	*/
+extern EOS_TCB_t idle_task; //core 0's, see eos_kernel.c
+
+EOS_TCB_t* eos_run_ptr[EOS_SMP_CORES] = {&idle_task};
+
+static EOS_TCB_t smp_idle_tasks[EOS_SMP_CORES - 1];
+static int32_t smp_idle_stacks[EOS_SMP_CORES - 1][32];
+static EOS_TCB_t* smp_idle[EOS_SMP_CORES];
+static EOS_smp_stats_t smp_stats[EOS_SMP_CORES];
+static uint8_t smp_setup = 0;
+
+static volatile uint32_t smp_lock = 0;
+static volatile uint32_t smp_owner = EOS_SMP_NO_CORE;
+
+
+
+/*	SETUP	*/
+
+
+/**
+ * @brief Creates the run queues and the idle tasks of the other cores. Called by EOS_ThreadNew() and EOS_Init(), the
+ * 			first call does the work.
+ */
+void EOS_SmpSetup(void)
+{
+	if (smp_setup)
+	{
+		return;
+	}
+	smp_setup = 1;
+
+	smp_idle[0] = &idle_task;
+	idle_task.run_next = &idle_task;
+	idle_task.core = 0;
+	idle_task.running = 0;
+
+	for (uint32_t core = 1; core < EOS_SMP_CORES; core++)
+	{
+		EOS_TCB_t* idle = &smp_idle_tasks[core - 1];
+
+		memset(idle, 0, sizeof(EOS_TCB_t));
+		idle->priority = PRIORITY_IDLE;
+		idle->stack = smp_idle_stacks[core - 1];
+		idle->stack_size = 32;
+		idle->run_next = idle;
+		idle->core = core;
+		idle->running = core;
+
+		idle->next = idle_task.next;
+		idle_task.next = idle;
+
+		smp_idle[core] = idle;
+		eos_run_ptr[core] = idle;
+	}
+}
+
+
+/**
+ * @brief Returns a core's idle task, whose stack EOS_Init() sets up.
+ */
+EOS_TCB_t* EOS_SmpIdleTask(uint32_t core)
+{
+	return smp_idle[core];
+}
+
+
+/**
+ * @brief Returns the task running on the calling core. run_ptr reads it, with interrupts masked, as the task could
+ * 			otherwise move to another core between finding the core and reading its entry.
+ */
+EOS_TCB_t* EOS_SmpRunning(void)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+	EOS_TCB_t* task = eos_run_ptr[EOS_PortCoreId()];
+	EOS_PortRestoreInterrupts(state);
+	return task;
+}
+
+
+
+/*	KERNEL LOCK	*/
+
+
+/**
+ * @brief Takes the kernel lock, unless the calling core already holds it. Interrupts must be masked.
+ */
+void EOS_SmpLock(void)
+{
+	uint32_t core = EOS_PortCoreId();
+
+	if (__atomic_load_n(&smp_owner, __ATOMIC_RELAXED) != core)
+	{
+		EOS_PortCoreLock(&smp_lock);
+		__atomic_store_n(&smp_owner, core, __ATOMIC_RELAXED);
+	}
+}
+
+
+/**
+ * @brief Gives the kernel lock back, if the calling core holds it.
+ */
+void EOS_SmpUnlock(void)
+{
+	if (__atomic_load_n(&smp_owner, __ATOMIC_RELAXED) == EOS_PortCoreId())
+	{
+		__atomic_store_n(&smp_owner, EOS_SMP_NO_CORE, __ATOMIC_RELAXED);
+		EOS_PortCoreUnlock(&smp_lock);
+	}
+}
+
+
+
+/*	SCHEDULING	*/
+
+
+/**
+ * @brief Puts a new task in the run queue with the fewest tasks. Called by EOS_ThreadNew(), with the kernel lock held.
+ */
+void EOS_SmpAssign(EOS_TCB_t* task)
+{
+	uint32_t core = 0;
+
+	for (uint32_t other = 1; other < EOS_SMP_CORES; other++)
+	{
+		if (smp_stats[other].tasks < smp_stats[core].tasks)
+		{
+			core = other;
+		}
+	}
+
+	task->running = EOS_SMP_NO_CORE;
+	task->run_next = smp_idle[core]->run_next;
+	smp_idle[core]->run_next = task;
+	task->core = core;
+	smp_stats[core].tasks++;
+}
+
+
+/**
+ * @brief Picks the task the calling core runs next: the highest priority ready task of its run queue, taking turns
+ * 			between tasks of the same priority, or failing that one stolen from another core. Called by
+ * 			EOS_scheduler(), with the kernel lock held, once the port has saved the context of the previous task.
+ *
+ * @param previous The task the core was running.
+ * @return The task to switch to, marked as running on this core. The scheduler then sets eos_run_ptr[].
+ */
+EOS_TCB_t* EOS_SmpPick(EOS_TCB_t* previous)
+{
+	uint32_t core = EOS_PortCoreId();
+	EOS_TCB_t* idle = smp_idle[core];
+	EOS_TCB_t* best = previous;
+
+	if (previous->blocked != 0 || previous->paused != 0)
+	{
+		best = idle;
+	}
+
+	for (EOS_TCB_t* task = previous->run_next; task != previous; task = task->run_next)
+	{
+		if (task->blocked == 0 && task->paused == 0 && task->priority >= best->priority)
+		{
+			best = task;
+		}
+	}
+
+	if (best == idle)
+	{
+		EOS_TCB_t* stolen = EOS_SmpSteal(core);
+		best = (stolen != NULL) ? stolen : idle;
+	}
+
+	if (best != previous)
+	{
+		previous->running = EOS_SMP_NO_CORE;
+		best->running = core;
+		smp_stats[core].switches++;
+	}
+	return best;
+}
+
+
+/**
+ * @brief Makes sure a task that has just become ready gets a core: its own if that runs something of lower priority,
+ * 			otherwise the core running the lowest priority task below it, if any, which it is handed to. Called with
+ * 			the kernel lock held.
+ *
+ * @return 1 if the calling core should switch to the task, 0 if another core has been interrupted to, or the task
+ * 			has to wait for its core.
+ */
+uint32_t EOS_SmpWake(EOS_TCB_t* task)
+{
+	uint32_t core = EOS_PortCoreId();
+	uint32_t target = task->core;
+
+	if (task->running != EOS_SMP_NO_CORE)
+	{
+		return 0; //its core is still switching it out, and will find it ready
+	}
+
+	if (task->priority <= eos_run_ptr[target]->priority)
+	{
+		for (uint32_t i = 0; i < EOS_SMP_CORES; i++)
+		{
+			uint32_t other = (core + i) % EOS_SMP_CORES; //the calling core first, as it needs no interrupt
+
+			if (eos_run_ptr[other]->priority < eos_run_ptr[target]->priority)
+			{
+				target = other;
+			}
+		}
+
+		if (task->priority <= eos_run_ptr[target]->priority)
+		{
+			return 0;
+		}
+		EOS_SmpMove(task, target);
+		smp_stats[target].migrations++;
+	}
+
+	if (target == core)
+	{
+		return 1;
+	}
+
+	EOS_PortCoreNotify(target);
+	return 0;
+}
+
+
+/**
+ * @brief Interrupts the core running a task, if it is not the calling one, so it reschedules (after the task has
+ * 			been paused). Called with the kernel lock held.
+ */
+void EOS_SmpPreempt(EOS_TCB_t* task)
+{
+	if (task->running != EOS_SMP_NO_CORE && task->running != EOS_PortCoreId())
+	{
+		EOS_PortCoreNotify(task->running);
+	}
+}
+
+
+/**
+ * @brief Reschedules the calling core. Called by the port's handler of the interrupt EOS_PortCoreNotify() raises.
+ */
+void EOS_SmpIsr(void)
+{
+	smp_stats[EOS_PortCoreId()].ipis++;
+	EOS_PortYield();
+}
+
+
+/**
+ * @brief Copies a core's scheduler counters.
+ */
+void EOS_SmpStats(uint32_t core, EOS_smp_stats_t* stats)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+	EOS_SmpLock();
+	*stats = smp_stats[core];
+	EOS_SmpUnlock();
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Takes the highest priority ready task no core is running from the other cores' run queues, searching from
+ * 			the next core on, and moves it to this core's.
+ *
+ * @return The task, or NULL if there is none.
+ */
+static EOS_TCB_t* EOS_SmpSteal(uint32_t core)
+{
+	EOS_TCB_t* best = NULL;
+
+	for (uint32_t i = 1; i < EOS_SMP_CORES; i++)
+	{
+		EOS_TCB_t* idle = smp_idle[(core + i) % EOS_SMP_CORES];
+
+		for (EOS_TCB_t* task = idle->run_next; task != idle; task = task->run_next)
+		{
+			if (task->blocked == 0 && task->paused == 0 && task->running == EOS_SMP_NO_CORE &&
+					(best == NULL || task->priority > best->priority))
+			{
+				best = task;
+			}
+		}
+	}
+
+	if (best != NULL)
+	{
+		EOS_SmpMove(best, core);
+		smp_stats[core].steals++;
+	}
+	return best;
+}
+
+
+/**
+ * @brief Moves a task no core is running from its run queue to the front of another core's.
+ */
+static void EOS_SmpMove(EOS_TCB_t* task, uint32_t core)
+{
+	EOS_TCB_t* previous = smp_idle[task->core];
+
+	while (previous->run_next != task)
+	{
+		previous = previous->run_next;
+	}
+	previous->run_next = task->run_next;
+	smp_stats[task->core].tasks--;
+
+	task->run_next = smp_idle[core]->run_next;
+	smp_idle[core]->run_next = task;
+	task->core = core;
+	smp_stats[core].tasks++;
+}
+
+#endif
@@ -0,0 +1,439 @@
+/*
+ * eos_uart.c
+ *
+ *      DMA driven UART driver for EvanRTOS, enabled with EOS_UART_ENABLE in eos_config.h. The HAL's blocking
+ *      HAL_UART_Transmit()/HAL_UART_Receive() keep the calling task spinning on the UART for every byte; here the DMA
+ *      moves the data, the CPU only takes an interrupt per buffer or per burst, and a task waiting on the UART sleeps.
+ *
+ *      Transmit: EOS_UartSend() queues a buffer (EOS_uart_tx_t) without copying it, and EOS_UartWait() sleeps until the
+ *      DMA has sent it. EOS_UartWrite() does both. Buffers from any number of tasks are sent one after the other, in
+ *      the order they were queued, each as a whole: the transmit complete interrupt starts the next one.
+ *
+ *      Receive: the DMA runs in circular mode over the UART's receive buffer, for good, and interrupts when it reaches
+ *      each half of it, and when the line goes idle after a burst (the STM32's idle line detection). Each interrupt
+ *      only moves the write index of the buffer up to the DMA's position, and wakes the reading task. The buffer is
+ *      the stream: EOS_UartRead() copies straight out of it. If the reader falls a whole buffer behind, the oldest
+ *      bytes are dropped and counted in rx_lost.
+ *
+ *      The port does the hardware part, behind EOS_PortUartStart() and EOS_PortUartSend() (see eos_port.h), and calls
+ *      EOS_UartTxIsr(), EOS_UartRxIsr() and EOS_UartErrorIsr() from its interrupts, having done the data cache
+ *      maintenance the DMA needs. Each UART should have one reading task; any number of tasks may write.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_uart.h"
+#include "eos_trace.h"
+#include "eos_wait.h"
+
+#if EOS_UART_ENABLE
+
+/*	DATATYPES	*/
+
+/* The driver's state of one UART. rx_written and rx_read count bytes from the start, and wrap */
+typedef struct {
+	uint32_t started;
+	EOS_uart_tx_t* tx_head;			//being sent
+	EOS_uart_tx_t* tx_tail;
+	uint32_t rx_position;			//DMA position last reported, in the buffer
+	uint32_t rx_offset;				//read position, in the buffer
+	volatile uint32_t rx_written;
+	uint32_t rx_read;
+	EOS_uart_stats_t stats;
+} EOS_uart_t;
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_UartFinishTx(uint32_t uart);
+static void EOS_UartStartTx(uint32_t uart);
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_uart_t uarts[EOS_UART_COUNT];
+static uint8_t uart_rx_buffers[EOS_UART_COUNT][EOS_UART_RX_SIZE] __attribute__((aligned(EOS_CACHE_LINE)));
+
+
+
+/*	SETUP	*/
+
+
+/**
+ * @brief Starts a UART's DMA reception, after which it receives into its buffer whether or not a task reads. Call it
+ * 			once per UART, before EOS_Init() or from a task.
+ *
+ * @param uart The UART's number, below EOS_UART_COUNT.
+ * @param device The port's handle for it: the UART_HandleTypeDef on the ARM_CM7 port, with its DMA streams linked,
+ * 			the receive one in circular mode, or a file descriptor, EOS_POSIX_UART_FD(fd), on the POSIX port.
+ * @return EOS_OK, or EOS_ERROR if the number is out of range, the UART is already started, or the port refused it.
+ */
+EOS_status_t EOS_UartInit(uint32_t uart, void* device)
+{
+	if (uart >= EOS_UART_COUNT || uarts[uart].started)
+	{
+		return EOS_ERROR;
+	}
+
+	memset(&uarts[uart], 0, sizeof(EOS_uart_t));
+	if (EOS_PortUartStart(uart, device, uart_rx_buffers[uart], EOS_UART_RX_SIZE) != EOS_OK)
+	{
+		return EOS_ERROR;
+	}
+
+	uarts[uart].started = 1;
+	return EOS_OK;
+}
+
+
+
+/*	TRANSMIT	*/
+
+
+/**
+ * @brief Takes the finished buffer off the head of the queue, and wakes the task waiting on it. Called in a critical
+ * 			section.
+ */
+static void EOS_UartFinishTx(uint32_t uart)
+{
+	EOS_uart_tx_t* request = uarts[uart].tx_head;
+
+	uarts[uart].tx_head = request->next;
+	if (uarts[uart].tx_head == NULL)
+	{
+		uarts[uart].tx_tail = NULL;
+	}
+
+	request->done = 1;
+	EOS_TaskUnblock(request);
+}
+
+
+/**
+ * @brief Hands the next piece of the buffer at the head of the queue to the DMA. A buffer the port refuses is dropped
+ * 			as a whole, as nothing would complete it, and the next one is tried. Called in a critical section.
+ */
+static void EOS_UartStartTx(uint32_t uart)
+{
+	while (uarts[uart].tx_head != NULL)
+	{
+		EOS_uart_tx_t* request = uarts[uart].tx_head;
+		uint32_t length = request->length - request->sent;
+
+		if (length > EOS_UART_DMA_MAX)
+		{
+			length = EOS_UART_DMA_MAX;
+		}
+
+		uarts[uart].stats.tx_transfers++;
+		if (EOS_PortUartSend(uart, &request->data[request->sent], length) == EOS_OK)
+		{
+			request->sent += length;
+			return;
+		}
+
+		uarts[uart].stats.errors++;
+		EOS_UartFinishTx(uart);
+	}
+}
+
+
+/**
+ * @brief Queues a buffer for transmission, and returns straight away. The DMA starts on it once the buffers queued
+ * 			before it are sent. Wait for it with EOS_UartWait() before reusing the request or the data.
+ *
+ * @param uart The UART's number.
+ * @param request The request to queue the buffer with, owned by the driver until EOS_UartWait() returns.
+ * @param data The bytes to send, in memory the DMA can reach.
+ * @param length Number of bytes. A buffer of 0 bytes is done straight away.
+ * @return EOS_OK, or EOS_ERROR if the UART is not started.
+ */
+EOS_status_t EOS_UartSend(uint32_t uart, EOS_uart_tx_t* request, const void* data, uint32_t length)
+{
+	if (uart >= EOS_UART_COUNT || uarts[uart].started == 0)
+	{
+		return EOS_ERROR;
+	}
+
+	request->data = (const uint8_t*)data;
+	request->length = length;
+	request->sent = 0;
+	request->done = (length == 0);
+	request->next = NULL;
+
+	if (length == 0)
+	{
+		return EOS_OK;
+	}
+
+	EOS_EnterCritical();
+	if (uarts[uart].tx_head == NULL)
+	{
+		uarts[uart].tx_head = request;
+		uarts[uart].tx_tail = request;
+		EOS_UartStartTx(uart);
+	}
+	else
+	{
+		uarts[uart].tx_tail->next = request;
+		uarts[uart].tx_tail = request;
+	}
+	EOS_ExitCritical();
+
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Sleeps until a buffer queued with EOS_UartSend() has been sent, and returns straight away if it has.
+ *
+ * @param request The request it was queued with.
+ */
+void EOS_UartWait(EOS_uart_tx_t* request)
+{
+	EOS_EnterCritical();
+	while (request->done == 0)
+	{
+		run_ptr->blocked = request;
+		EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, request);
+		EOS_WaitProfileBlock(run_ptr, request);
+		EOS_ExitCritical();
+		EOS_Suspend();
+		EOS_EnterCritical();
+	}
+	EOS_ExitCritical();
+}
+
+
+/**
+ * @brief Sends a buffer, sleeping until the DMA has sent it, after any buffers queued before it.
+ *
+ * @param uart The UART's number.
+ * @param data The bytes to send, in memory the DMA can reach.
+ * @param length Number of bytes.
+ * @return EOS_OK once sent, or EOS_ERROR if the UART is not started.
+ */
+EOS_status_t EOS_UartWrite(uint32_t uart, const void* data, uint32_t length)
+{
+	EOS_uart_tx_t request;
+
+	if (EOS_UartSend(uart, &request, data, length) != EOS_OK)
+	{
+		return EOS_ERROR;
+	}
+
+	EOS_UartWait(&request);
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Transmit complete interrupt, called by the port once the last transfer it was given has been sent. Starts
+ * 			the rest of the buffer, or the next one, and wakes the task waiting on a finished one.
+ */
+void EOS_UartTxIsr(uint32_t uart)
+{
+	EOS_EnterCritical();
+
+	EOS_uart_tx_t* request = uarts[uart].tx_head;
+	if (request == NULL)
+	{
+		EOS_ExitCritical();
+		return;
+	}
+
+	if (request->sent < request->length)
+	{
+		EOS_UartStartTx(uart);
+		EOS_ExitCritical();
+		return;
+	}
+
+	uarts[uart].stats.tx_bytes += request->length;
+	uarts[uart].stats.tx_buffers++;
+	EOS_UartFinishTx(uart);
+	EOS_UartStartTx(uart);
+
+	EOS_ExitCritical();
+}
+
+
+
+/*	RECEIVE	*/
+
+
+/**
+ * @brief Receive interrupt, called by the port when the DMA has reached half or the end of the buffer, or the line
+ * 			went idle. Moves the write index up to the DMA's position, drops what the DMA has overwritten, and wakes
+ * 			the reading task.
+ *
+ * @param uart The UART's number.
+ * @param position Bytes of the buffer the DMA has filled, from 1 to EOS_UART_RX_SIZE (at the end of the buffer),
+ * 			or the same position as last time if nothing arrived.
+ */
+void EOS_UartRxIsr(uint32_t uart, uint32_t position)
+{
+	EOS_uart_t* state = &uarts[uart];
+
+	EOS_EnterCritical();
+
+	uint32_t last = state->rx_position;
+	uint32_t count = (position >= last) ? position - last : EOS_UART_RX_SIZE - last + position;
+	state->rx_position = (position >= EOS_UART_RX_SIZE) ? 0 : position;
+
+	if (count == 0)
+	{
+		EOS_ExitCritical();
+		return;
+	}
+
+	state->rx_written += count;
+	state->stats.rx_bytes += count;
+	state->stats.rx_events++;
+
+	uint32_t unread = state->rx_written - state->rx_read;
+	if (unread > EOS_UART_RX_SIZE)
+	{
+		state->stats.rx_lost += unread - EOS_UART_RX_SIZE;
+		state->rx_read = state->rx_written - EOS_UART_RX_SIZE;
+		state->rx_offset = state->rx_position; //the oldest byte left is the one the DMA writes next
+	}
+
+	EOS_TaskUnblock((void*)&state->rx_written);
+	EOS_ExitCritical();
+}
+
+
+/**
+ * @brief Error interrupt, called by the port on a line error (overrun, framing, noise) or a DMA error.
+ *
+ * @param uart The UART's number.
+ * @param restarted 1 if the port had to restart the reception, at the start of the buffer. What the DMA received
+ * 			since the last receive interrupt is lost.
+ */
+void EOS_UartErrorIsr(uint32_t uart, uint32_t restarted)
+{
+	EOS_EnterCritical();
+	uarts[uart].stats.errors++;
+	if (restarted)
+	{
+		uarts[uart].rx_position = 0;
+		uarts[uart].rx_offset = 0;
+		uarts[uart].stats.rx_lost += uarts[uart].rx_written - uarts[uart].rx_read;
+		uarts[uart].rx_read = uarts[uart].rx_written; //what was left unread is overwritten from the start
+	}
+	EOS_ExitCritical();
+}
+
+
+/**
+ * @brief Reads received bytes, straight out of the DMA's buffer.
+ *
+ * @param uart The UART's number.
+ * @param data Where to copy them.
+ * @param size Most bytes to read.
+ * @param block EOS_BLOCK to sleep until at least one byte has arrived, EOS_NO_BLOCK to return 0 if none has.
+ * @return Bytes read, from 1 to size, or 0 if none were waiting with EOS_NO_BLOCK, or the UART is not started.
+ */
+uint32_t EOS_UartRead(uint32_t uart, void* data, uint32_t size, EOS_block_status_t block)
+{
+	if (uart >= EOS_UART_COUNT || uarts[uart].started == 0 || size == 0)
+	{
+		return 0;
+	}
+
+	EOS_uart_t* state = &uarts[uart];
+	uint32_t start, offset, count;
+	EOS_EnterCritical();
+
+	for (;;)
+	{
+		while (state->rx_written == state->rx_read)
+		{
+			if (block != EOS_BLOCK)
+			{
+				EOS_ExitCritical();
+				return 0;
+			}
+
+			run_ptr->blocked = (void*)&state->rx_written;
+			EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, &state->rx_written);
+			EOS_WaitProfileBlock(run_ptr, (void*)&state->rx_written);
+			EOS_ExitCritical();
+			EOS_Suspend();
+			EOS_EnterCritical();
+		}
+
+		start = state->rx_read;
+		offset = state->rx_offset;
+		count = state->rx_written - start;
+		EOS_ExitCritical();
+
+		if (count > size)
+		{
+			count = size;
+		}
+
+		//the DMA only writes ahead of rx_written, so the copy needs no lock, as long as the reader keeps up
+		uint32_t first = EOS_UART_RX_SIZE - offset;
+		if (first > count)
+		{
+			first = count;
+		}
+		memcpy(data, &uart_rx_buffers[uart][offset], first);
+		memcpy((uint8_t*)data + first, uart_rx_buffers[uart], count - first);
+
+		EOS_EnterCritical();
+		if (state->rx_read == start)
+		{
+			break;
+		}
+		//else an interrupt dropped bytes under the copy, which may have been overwritten, counted them in rx_lost
+		//and moved the index past them: the copy is thrown away, and read again from there
+	}
+
+	state->rx_read = start + count;
+	state->rx_offset = (offset + count < EOS_UART_RX_SIZE) ? offset + count : offset + count - EOS_UART_RX_SIZE;
+	EOS_ExitCritical();
+
+	return count;
+}
+
+
+/**
+ * @brief Returns the number of received bytes waiting to be read.
+ */
+uint32_t EOS_UartAvailable(uint32_t uart)
+{
+	if (uart >= EOS_UART_COUNT)
+	{
+		return 0;
+	}
+
+	EOS_EnterCritical();
+	uint32_t available = uarts[uart].rx_written - uarts[uart].rx_read;
+	EOS_ExitCritical();
+
+	return available;
+}
+
+
+/**
+ * @brief Copies a UART's counters.
+ *
+ * @return EOS_OK, or EOS_ERROR if the number is out of range.
+ */
+EOS_status_t EOS_UartStats(uint32_t uart, EOS_uart_stats_t* stats)
+{
+	if (uart >= EOS_UART_COUNT || stats == NULL)
+	{
+		return EOS_ERROR;
+	}
+
+	EOS_EnterCritical();
+	*stats = uarts[uart].stats;
+	EOS_ExitCritical();
+
+	return EOS_OK;
+}
+
+#endif
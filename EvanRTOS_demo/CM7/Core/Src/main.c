@@ -21,6 +21,13 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "eos_monitor.h"
+#include "eos_log.h"
+#include "eos_rtt.h"
+#include "eos_uart.h"
+#if EOS_DUAL_CORE_ENABLE
+#include "eos_shared.h"
+#endif
 
 /* USER CODE END Includes */
 
@@ -48,6 +55,10 @@
 UART_HandleTypeDef huart1;
 
 /* USER CODE BEGIN PV */
+#if EOS_UART_ENABLE
+DMA_HandleTypeDef hdma_usart1_rx;
+DMA_HandleTypeDef hdma_usart1_tx;
+#endif
 
 /* USER CODE END PV */
 
@@ -107,6 +118,10 @@ int main(void)
 HSEM notification */
 /*HW semaphore Clock enable*/
 __HAL_RCC_HSEM_CLK_ENABLE();
+#if EOS_DUAL_CORE_ENABLE
+/* Set up the memory shared with the EvanRTOS instance on the Cortex-M4 before it runs */
+EOS_DualCoreInit(EOS_CORE_PRIMARY, &eos_shared);
+#endif
 /*Take HSEM */
 HAL_HSEM_FastTake(HSEM_ID_0);
 /*Release HSEM in order to notify the CPU2(CM4)*/
@@ -121,6 +136,15 @@ Error_Handler();
 /* USER CODE END Boot_Mode_Sequence_2 */
 
   /* USER CODE BEGIN SysInit */
+#if EOS_UART_ENABLE
+  /* DMA1 streams 0 and 1 carry USART1's reception and transmission for the EvanRTOS UART driver, linked to huart1
+     in HAL_UART_MspInit(). Their interrupts call the kernel, so they run at the Systick priority */
+  __HAL_RCC_DMA1_CLK_ENABLE();
+  HAL_NVIC_SetPriority(DMA1_Stream0_IRQn, TICK_INT_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream0_IRQn);
+  HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, TICK_INT_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Stream1_IRQn);
+#endif
 
   /* USER CODE END SysInit */
 
@@ -128,6 +152,12 @@ Error_Handler();
   MX_GPIO_Init();
   MX_USART1_UART_Init();
   /* USER CODE BEGIN 2 */
+#if EOS_UART_ENABLE
+  if (EOS_UartInit(0, &huart1) != EOS_OK)
+  {
+    Error_Handler();
+  }
+#endif
   EvanRTOS_Init(); //pass control to EvanRTOS
   /* USER CODE END 2 */
 
@@ -326,6 +356,38 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
+#if EOS_MONITOR_ENABLE
+/**
+  * @brief  Sends the EvanRTOS monitor output over USART1, or to the RTT stdout channel when EOS_RTT_ENABLE is set
+  *         (read it with the debug probe). Called from the low priority monitor task, so the blocking transmit only
+  *         takes time no other task wants.
+  */
+void EOS_MonitorWrite(const char* data, uint32_t length)
+{
+#if EOS_RTT_ENABLE
+  EOS_RttWrite(EOS_RTT_STDOUT, data, length);
+#elif EOS_UART_ENABLE
+  EOS_UartWrite(0, data, length); //sleeps while the DMA sends it
+#else
+  HAL_UART_Transmit(&huart1, (const uint8_t*)data, length, HAL_MAX_DELAY);
+#endif
+}
+#endif
+
+#if EOS_LOG_ENABLE
+/**
+  * @brief  Sends the EvanRTOS log stream over USART1, for tools/eos_log_decode.py. Called from the low priority drain
+  *         task. Use either the log or the monitor on USART1, not both, as their streams would be mixed.
+  */
+void EOS_LogOutput(const uint8_t* data, uint32_t length)
+{
+#if EOS_UART_ENABLE
+  EOS_UartWrite(0, data, length);
+#else
+  HAL_UART_Transmit(&huart1, data, length, HAL_MAX_DELAY);
+#endif
+}
+#endif
 
 /* USER CODE END 4 */
 
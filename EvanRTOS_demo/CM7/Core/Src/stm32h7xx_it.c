@@ -22,6 +22,8 @@
 #include "stm32h7xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "eos_kernel.h"
+#include "eos_port.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -57,6 +59,11 @@
 /* External variables --------------------------------------------------------*/
 
 /* USER CODE BEGIN EV */
+#if EOS_UART_ENABLE
+extern UART_HandleTypeDef huart1;
+extern DMA_HandleTypeDef hdma_usart1_rx;
+extern DMA_HandleTypeDef hdma_usart1_tx;
+#endif
 
 /* USER CODE END EV */
 
@@ -84,7 +91,12 @@ void NMI_Handler(void)
 void HardFault_Handler(void)
 {
   /* USER CODE BEGIN HardFault_IRQn 0 */
-
+#if EOS_MPU_GUARD_ENABLE
+  if (EOS_PortMpuGuardFault())
+  {
+    EOS_StackOverflow(run_ptr); /* a guard hit with PRIMASK set, escalated from MemManage */
+  }
+#endif
   /* USER CODE END HardFault_IRQn 0 */
   while (1)
   {
@@ -99,7 +111,12 @@ void HardFault_Handler(void)
 void MemManage_Handler(void)
 {
   /* USER CODE BEGIN MemoryManagement_IRQn 0 */
-
+#if EOS_MPU_GUARD_ENABLE
+  if (EOS_PortMpuGuardFault())
+  {
+    EOS_StackOverflow(run_ptr); /* the running task hit its EvanRTOS stack guard */
+  }
+#endif
   /* USER CODE END MemoryManagement_IRQn 0 */
   while (1)
   {
@@ -172,5 +189,30 @@ void DebugMon_Handler(void)
 /******************************************************************************/
 
 /* USER CODE BEGIN 1 */
+#if EOS_UART_ENABLE
+/**
+  * @brief USART1 reception DMA, for the EvanRTOS UART driver (half and full buffer).
+  */
+void DMA1_Stream0_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_rx);
+}
+
+/**
+  * @brief USART1 transmission DMA, for the EvanRTOS UART driver.
+  */
+void DMA1_Stream1_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+}
+
+/**
+  * @brief USART1, for the EvanRTOS UART driver (idle line, transmission complete, errors).
+  */
+void USART1_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&huart1);
+}
+#endif
 
 /* USER CODE END 1 */
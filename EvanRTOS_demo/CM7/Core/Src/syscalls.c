@@ -29,6 +29,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "eos_rtt.h"
 
 
 /* Variables */
@@ -64,6 +65,29 @@ void _exit (int status)
   while (1) {}    /* Make sure we hang here */
 }
 
+#if EOS_RTT_ENABLE
+/* Console on the EvanRTOS in-memory channels (eos_rtt.c): never blocks, a read with no input fails with EAGAIN */
+__attribute__((weak)) int _read(int file, char *ptr, int len)
+{
+  (void)file;
+  uint32_t count = EOS_RttRead(EOS_RTT_STDIN, ptr, (uint32_t)len);
+
+  if (count == 0)
+  {
+    errno = EAGAIN;
+    return -1;
+  }
+  return (int)count;
+}
+
+/* Output that does not fit in the channel is dropped and counted (EOS_RttDropped()), and reported as written so
+ * stdio does not retry */
+__attribute__((weak)) int _write(int file, char *ptr, int len)
+{
+  EOS_RttWrite((file == 2) ? EOS_RTT_STDERR : EOS_RTT_STDOUT, ptr, (uint32_t)len);
+  return len;
+}
+#else
 __attribute__((weak)) int _read(int file, char *ptr, int len)
 {
   (void)file;
@@ -88,6 +112,7 @@ __attribute__((weak)) int _write(int file, char *ptr, int len)
   }
   return len;
 }
+#endif
 
 int _close(int file)
 {
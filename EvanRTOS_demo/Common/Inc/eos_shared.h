@@ -0,0 +1,25 @@
+/*
+ * eos_shared.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Objects shared by the EvanRTOS instances on the Cortex-M7 and the Cortex-M4 (EOS_DUAL_CORE_ENABLE). Both
+ *      projects build Common/Src/eos_shared.c, and both linker scripts put its .shared_memory section at the start of
+ *      D3 SRAM, so the two cores find it at the same address.
+ */
+
+#ifndef INC_EOS_SHARED_H_
+#define INC_EOS_SHARED_H_
+
+#include "eos_dual_core.h"
+
+/*	SHARED OBJECTS	*/
+#define EOS_SHARED_QUEUE_LED 0		//Cortex-M7 to Cortex-M4: number of LED1 blinks to do
+#define EOS_SHARED_QUEUE_DONE 1		//Cortex-M4 to Cortex-M7: blinks done
+
+
+/*	SHARED MEMORY	*/
+extern EOS_dual_shared_t eos_shared;
+
+#endif /* INC_EOS_SHARED_H_ */
@@ -0,0 +1,16 @@
+/*
+ * eos_shared.c
+ *
+ *      The memory shared by the EvanRTOS instances on the two cores, see eos_shared.h. It is cleared by the Cortex-M7
+ *      in main.c, before it releases the Cortex-M4.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_shared.h"
+
+#if EOS_DUAL_CORE_ENABLE
+
+EOS_dual_shared_t eos_shared __attribute__((section(".shared_memory")));
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * main.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: EO12
+ *
+ *      Stand-in for a Cortex-M33 board's main.h, so "make cm33" can compile the ARM_CM33 port with the host compiler.
+ *      That checks its C, and its static asserts on the task frame layout, not its assembly. The device configuration
+ *      is that of QEMU's mps2-an505 machine: a Cortex-M33 with the FPU and the DSP extension.
+ */
+
+#ifndef INC_MAIN_H_
+#define INC_MAIN_H_
+
+#include <stdint.h>
+
+
+/*	DEVICE CONFIGURATION	*/
+#define __CM33_REV 0x0000U
+#define __SAUREGION_PRESENT 0U
+#define __MPU_PRESENT 1U
+#define __VTOR_PRESENT 1U
+#define __NVIC_PRIO_BITS 3U
+#define __Vendor_SysTickConfig 0U
+#define __FPU_PRESENT 1U
+#define __DSP_PRESENT 1U
+
+typedef enum IRQn
+{
+	NonMaskableInt_IRQn = -14,
+	HardFault_IRQn = -13,
+	MemoryManagement_IRQn = -12,
+	BusFault_IRQn = -11,
+	UsageFault_IRQn = -10,
+	SecureFault_IRQn = -9,
+	SVCall_IRQn = -5,
+	DebugMonitor_IRQn = -4,
+	PendSV_IRQn = -2,
+	SysTick_IRQn = -1,
+} IRQn_Type;
+
+#include "core_cm33.h"
+
+
+/*	FUNCTION DECLARATIONS	*/
+extern uint32_t SystemCoreClock;
+
+void HAL_IncTick(void);
+
+#endif /* INC_MAIN_H_ */
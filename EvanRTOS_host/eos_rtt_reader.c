@@ -0,0 +1,159 @@
+/*
+ * eos_rtt_reader.c
+ *
+ *      Stand-in for a debug probe reading the EvanRTOS in-memory console (EvanRTOS_kernel/eos_rtt.c), for host builds.
+ *      EOS_RttReaderStart() starts a host thread that does what J-Link or OpenOCD would do through the debug port:
+ *      waits for the control block's id to appear, then every millisecond copies the up channels out (stdout and
+ *      stderr) and whatever arrives on the input into the down channel (stdin), moving only the probe's end of each
+ *      ring. It works on the control block directly, not through eos_rtt.c, so it also checks the layout a probe sees.
+ *
+ *      The thread runs alongside the kernel thread, like a probe runs alongside the core, so the rings are exercised
+ *      with real concurrency. Start it with every signal blocked, so the simulated interrupts stay on the kernel thread.
+ */
+
+
+/*	INCLUDES	*/
+#include <poll.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include "eos_rtt_reader.h"
+
+#if EOS_RTT_ENABLE
+
+/*	GLOBAL VARIABLES	*/
+static FILE* reader_files[2];
+static FILE* reader_in;
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Copies what an up channel holds to a file, and frees it.
+ */
+static void EOS_RttReaderUp(EOS_rtt_buffer_t* ring, FILE* file)
+{
+	uint32_t write = __atomic_load_n(&ring->write, __ATOMIC_ACQUIRE);
+	uint32_t read = ring->read;
+
+	if (write == read)
+	{
+		return;
+	}
+
+	if (write < read)
+	{
+		fwrite(&ring->buffer[read], 1, ring->size - read, file);
+		read = 0;
+	}
+	fwrite(&ring->buffer[read], 1, write - read, file);
+	fflush(file);
+
+	__atomic_store_n(&ring->read, write, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Copies input into a down channel, as far as it has room.
+ *
+ * @return Bytes copied, the rest is kept for the next round like a probe would.
+ */
+static uint32_t EOS_RttReaderDown(EOS_rtt_buffer_t* ring, const char* data, uint32_t length)
+{
+	uint32_t read = __atomic_load_n(&ring->read, __ATOMIC_ACQUIRE);
+	uint32_t write = ring->write;
+
+	uint32_t copied = 0;
+
+	for (; copied < length; copied++)
+	{
+		uint32_t next = (write + 1 == ring->size) ? 0 : write + 1;
+
+		if (next == read)
+		{
+			break;
+		}
+		ring->buffer[write] = data[copied];
+		write = next;
+	}
+
+	__atomic_store_n(&ring->write, write, __ATOMIC_RELEASE);
+	return copied;
+}
+
+
+static void* EOS_RttReaderThread(void* arg)
+{
+	(void)arg;
+
+	//a probe searches RAM for the id, here it only has to wait for the target to write it
+	while (memcmp((const char*)_SEGGER_RTT.id, "SEGGER RTT", 11) != 0)
+	{
+		usleep(1000);
+	}
+
+	struct pollfd input = {reader_in ? fileno(reader_in) : -1, POLLIN, 0};
+	char pending[64];
+	uint32_t pending_start = 0;
+	uint32_t pending_end = 0;
+
+	while (1)
+	{
+		for (int32_t i = 0; i < _SEGGER_RTT.up_count && i < 2; i++)
+		{
+			EOS_RttReaderUp(&_SEGGER_RTT.up[i], reader_files[i]);
+		}
+
+		if (pending_start < pending_end)
+		{
+			pending_start += EOS_RttReaderDown(&_SEGGER_RTT.down[EOS_RTT_STDIN], &pending[pending_start],
+					pending_end - pending_start);
+			usleep(1000);
+		}
+		else if (input.fd >= 0 && poll(&input, 1, 1) > 0)
+		{
+			ssize_t length = read(input.fd, pending, sizeof(pending));
+
+			if (length <= 0)
+			{
+				input.fd = -1; //end of the input
+				continue;
+			}
+			pending_start = 0;
+			pending_end = (uint32_t)length;
+		}
+		else if (input.fd < 0)
+		{
+			usleep(1000);
+		}
+	}
+	return NULL;
+}
+
+
+
+/*	READER FUNCTIONALITY	*/
+
+
+/**
+ * @brief Starts the reader thread.
+ *
+ * @param out File the stdout up channel is copied to.
+ * @param err File the stderr up channel is copied to.
+ * @param in File read into the stdin down channel, or NULL for no input.
+ *
+ * @return 0 on success, like pthread_create().
+ */
+int EOS_RttReaderStart(FILE* out, FILE* err, FILE* in)
+{
+	pthread_t thread;
+
+	reader_files[0] = out;
+	reader_files[1] = err;
+	reader_in = in;
+	return pthread_create(&thread, NULL, EOS_RttReaderThread, NULL);
+}
+
+#endif
@@ -0,0 +1,21 @@
+/*
+ * eos_rtt_reader.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_RTT_READER_H_
+#define INC_EOS_RTT_READER_H_
+
+#include <stdio.h>
+#include "eos_rtt.h"
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_RTT_ENABLE
+
+int EOS_RttReaderStart(FILE* out, FILE* err, FILE* in);
+
+#endif
+
+#endif /* INC_EOS_RTT_READER_H_ */
@@ -0,0 +1,568 @@
+/*
+ * eos_sim.c
+ *
+ *      Scheduler scaling simulator for EvanRTOS. A deterministic, discrete event harness that drives the real
+ *      kernel code (EOS_scheduler(), EOS_Tick() and its timeout handling, and the unblocking done by EOS_QueuePut()/
+ *      EOS_QueueGet()) with a synthetic workload, for a growing number of tasks. It is built against the SIM port,
+ *      so nothing actually runs on the tasks: the simulator plays each task when the kernel picks it.
+ *
+ *      Virtual time advances in microseconds, with a kernel tick every 1000us. The workload is made of:
+ *      	- periodic tasks: run a job, then EOS_Delay() a random period.
+ *      	- producers: run a job, put a timestamp into their group's queue, then EOS_Delay() a random period.
+ *      	- consumers: get an item from their group's queue, then run a job to process it.
+ *      Each queue group has --fanin producers and --fanout consumers. Job lengths are sized so that the whole system
+ *      has a utilization close to --util, whatever the number of tasks.
+ *
+ *      For every task count, one JSON line is printed with:
+ *      	sched_cycles:	host cycles (TSC on x86) spent in each EOS_scheduler() call
+ *      	wakeup_us:		virtual time from a task being unblocked (timeout expiry, or a queue put/get) to it running
+ *      	deadline_misses: jobs that finished later than one period after their release (item put time for consumers)
+ *
+ *      Every task count is simulated in its own child process, so each run starts from a fresh kernel. Runs with the
+ *      same arguments always make the same scheduling decisions; only sched_cycles depends on the host.
+ *
+ *      Usage: eos_sim [--tasks 8,16,...] [--ticks N] [--mix H:M:L] [--ipc FRACTION] [--fanin N] [--fanout N]
+ *                     [--delay MIN:MAX] [--util FRACTION] [--seed N]
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "eos_port.h"
+#include "eos_queue.h"
+
+
+/*	CONSTANTS	*/
+#define EOS_SIM_TICK_US 1000
+#define EOS_SIM_KERNEL_US 1			//virtual time charged for each queue/delay call
+#define EOS_SIM_QUEUE_SIZE 8
+#define EOS_SIM_MAX_RUNS 32
+
+
+/*	DATATYPES	*/
+typedef enum {
+	SIM_PERIODIC = 0,
+	SIM_PRODUCER = 1,
+	SIM_CONSUMER = 2
+} EOS_sim_role_t;
+
+typedef struct {
+	int32_t stack[64];			//passed to EOS_ThreadNew(), so TCB->sp points back here on the SIM port
+	EOS_task_id_t tcb;
+	EOS_sim_role_t role;
+	uint32_t group;				//index of the first task in this task's queue group
+	uint32_t period_us;
+	uint32_t work_us;
+	uint32_t remaining_us;		//work left in the current job
+	uint64_t release_us;
+	uint64_t ready_us;			//when the task last became ready
+	uint8_t in_job;
+	uint8_t waiting;			//blocked on a delay or a queue
+	uint8_t woken;				//unblocked, but has not run since
+	uint8_t retrying;			//woken from a queue, but the operation still cannot complete
+} EOS_sim_task_t;
+
+typedef struct {
+	uint32_t* data;
+	uint32_t count;
+	uint32_t capacity;
+} EOS_sim_samples_t;
+
+typedef struct {
+	uint32_t ticks;
+	uint32_t mix[3];			//weights of PRIORITY_HIGH, PRIORITY_MEDIUM and PRIORITY_LOW tasks
+	double ipc;
+	uint32_t fanin;
+	uint32_t fanout;
+	uint32_t delay_min_ms;
+	uint32_t delay_max_ms;
+	double util;
+	uint32_t seed;
+} EOS_sim_config_t;
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_sim_config_t config = {
+		.ticks = 1000,
+		.mix = {1, 2, 1},
+		.ipc = 0.5,
+		.fanin = 2,
+		.fanout = 1,
+		.delay_min_ms = 5,
+		.delay_max_ms = 50,
+		.util = 0.6,
+		.seed = 1
+};
+
+static EOS_sim_task_t* sim_tasks;
+static EOS_queue_id_t* sim_queues;
+static uint32_t sim_task_count;
+static uint32_t sim_group_size;
+static uint64_t sim_now_us;
+static uint32_t sim_random;
+
+static EOS_sim_samples_t sched_cycles;
+static EOS_sim_samples_t wakeup_us;
+static uint64_t sim_jobs;
+static uint64_t sim_misses;
+
+
+
+/*	HELPER FUNCTIONS	*/
+
+
+static uint32_t EOS_SimRandom(void){
+	sim_random ^= sim_random << 13;
+	sim_random ^= sim_random >> 17;
+	sim_random ^= sim_random << 5;
+	return sim_random;
+}
+
+
+static uint32_t EOS_SimUniform(uint32_t min, uint32_t max){
+	return min + EOS_SimRandom() % (max - min + 1);
+}
+
+
+static void EOS_SimAddSample(EOS_sim_samples_t* samples, uint32_t value){
+	if (samples->count == samples->capacity)
+	{
+		samples->capacity = samples->capacity ? samples->capacity * 2 : 1024;
+		samples->data = realloc(samples->data, samples->capacity * sizeof(uint32_t));
+		if (samples->data == NULL)
+		{
+			fprintf(stderr, "eos_sim: out of memory\n");
+			exit(1);
+		}
+	}
+	samples->data[samples->count++] = value;
+}
+
+
+static int EOS_SimCompare(const void* a, const void* b){
+	uint32_t x = *(const uint32_t*)a;
+	uint32_t y = *(const uint32_t*)b;
+	return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief Prints the distribution of a set of samples as a JSON object.
+ */
+static void EOS_SimPrintSamples(const char* name, EOS_sim_samples_t* samples){
+	uint32_t n = samples->count;
+
+	if (n == 0)
+	{
+		printf(",\"%s\":null", name);
+		return;
+	}
+
+	qsort(samples->data, n, sizeof(uint32_t), EOS_SimCompare);
+
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < n; i++)
+	{
+		sum += samples->data[i];
+	}
+
+	printf(",\"%s\":{\"n\":%u,\"min\":%u,\"avg\":%llu,\"p50\":%u,\"p90\":%u,\"p99\":%u,\"max\":%u}", name, n,
+			samples->data[0], (unsigned long long)(sum / n), samples->data[(n - 1) * 50 / 100],
+			samples->data[(n - 1) * 90 / 100], samples->data[(n - 1) * 99 / 100], samples->data[n - 1]);
+}
+
+
+
+/*	SIMULATION	*/
+
+
+/**
+ * @brief Task function given to the kernel. Never called, as the SIM port does not run tasks.
+ */
+static void EOS_SimTask(void){
+
+}
+
+
+/**
+ * @brief Runs the scheduler if the kernel asked for a context switch, timing the call.
+ */
+static void EOS_SimDecide(void){
+	if (eos_sim_switch_pending == 0)
+	{
+		return;
+	}
+	eos_sim_switch_pending = 0;
+
+	uint32_t start = EOS_GetCycles();
+	EOS_scheduler();
+	EOS_SimAddSample(&sched_cycles, EOS_GetCycles() - start);
+}
+
+
+/**
+ * @brief Marks tasks in [first, last) that the kernel has unblocked since they started waiting.
+ */
+static void EOS_SimFindWakeups(uint32_t first, uint32_t last){
+	for (uint32_t i = first; i < last; i++)
+	{
+		EOS_sim_task_t* task = &sim_tasks[i];
+
+		if (task->waiting && task->tcb->blocked == 0)
+		{
+			task->waiting = 0;
+			task->woken = 1;
+			task->ready_us = sim_now_us;
+		}
+	}
+}
+
+
+static void EOS_SimDelay(EOS_sim_task_t* task){
+	EOS_Delay(task->period_us / 1000);
+	sim_now_us += EOS_SIM_KERNEL_US;
+	task->waiting = 1;
+}
+
+
+/**
+ * @brief Blocks the running task on its group's queue, the same way EOS_QueuePut()/EOS_QueueGet() do with EOS_BLOCK.
+ * 			Like the kernel, a task that is woken but still cannot complete the operation just yields.
+ */
+static void EOS_SimBlockOnQueue(EOS_sim_task_t* task){
+	if (task->retrying == 0)
+	{
+		task->tcb->blocked = sim_queues[task->group / sim_group_size];
+		task->waiting = 1;
+		task->retrying = 1;
+	}
+	EOS_Suspend();
+}
+
+
+/**
+ * @brief Puts the current time into the producer's queue. Returns 1 on success.
+ */
+static uint8_t EOS_SimPut(EOS_sim_task_t* task){
+	uint64_t item = sim_now_us;
+	EOS_status_t status = EOS_QueuePut(sim_queues[task->group / sim_group_size], &item, EOS_NO_BLOCK);
+	sim_now_us += EOS_SIM_KERNEL_US;
+
+	if (status != EOS_OK)
+	{
+		return 0;
+	}
+
+	task->retrying = 0;
+	EOS_SimFindWakeups(task->group, task->group + sim_group_size);
+	return 1;
+}
+
+
+/**
+ * @brief Starts the next job of a task. Returns 0 if the task blocked or yielded instead.
+ */
+static uint8_t EOS_SimStartJob(EOS_sim_task_t* task){
+
+	if (task->role == SIM_PRODUCER && task->retrying)
+	{
+		if (EOS_SimPut(task) == 0)
+		{
+			EOS_SimBlockOnQueue(task);
+			return 0;
+		}
+		EOS_SimDelay(task);
+		return 0;
+	}
+
+	if (task->role == SIM_CONSUMER)
+	{
+		uint64_t item;
+		EOS_status_t status = EOS_QueueGet(sim_queues[task->group / sim_group_size], &item, EOS_NO_BLOCK);
+		sim_now_us += EOS_SIM_KERNEL_US;
+
+		if (status != EOS_OK)
+		{
+			EOS_SimBlockOnQueue(task);
+			return 0;
+		}
+
+		task->retrying = 0;
+		EOS_SimFindWakeups(task->group, task->group + sim_group_size);
+		task->release_us = item;
+	}
+	else
+	{
+		task->release_us = task->ready_us;
+	}
+
+	task->remaining_us = EOS_SimUniform(task->work_us / 2 + 1, task->work_us + task->work_us / 2 + 1);
+	task->in_job = 1;
+	return 1;
+}
+
+
+/**
+ * @brief Plays the running task until it blocks, yields, finishes a job, or end_us is reached.
+ */
+static void EOS_SimStep(EOS_sim_task_t* task, uint64_t end_us){
+
+	if (task->woken)
+	{
+		EOS_SimAddSample(&wakeup_us, (uint32_t)(sim_now_us - task->ready_us));
+		task->woken = 0;
+	}
+
+	if (task->in_job == 0 && EOS_SimStartJob(task) == 0)
+	{
+		return;
+	}
+
+	uint64_t run = end_us > sim_now_us ? end_us - sim_now_us : 0;
+	if (run > task->remaining_us)
+	{
+		run = task->remaining_us;
+	}
+	sim_now_us += run;
+	task->remaining_us -= run;
+
+	if (task->remaining_us > 0)
+	{
+		return;
+	}
+
+	task->in_job = 0;
+	sim_jobs++;
+	if (sim_now_us > task->release_us + task->period_us)
+	{
+		sim_misses++;
+	}
+
+	if (task->role == SIM_PERIODIC)
+	{
+		EOS_SimDelay(task);
+	}
+	else if (task->role == SIM_PRODUCER)
+	{
+		if (EOS_SimPut(task))
+		{
+			EOS_SimDelay(task);
+		}
+		else
+		{
+			EOS_SimBlockOnQueue(task);
+		}
+	}
+}
+
+
+/**
+ * @brief Creates the workload for task_count tasks.
+ */
+static void EOS_SimCreate(uint32_t task_count){
+	uint32_t mix_total = config.mix[0] + config.mix[1] + config.mix[2];
+	uint32_t mean_period_us = (config.delay_min_ms + config.delay_max_ms) * 1000 / 2;
+	uint32_t work_us = (uint32_t)(config.util * mean_period_us / task_count);
+
+	sim_group_size = config.fanin + config.fanout;
+	uint32_t groups = (uint32_t)(task_count * config.ipc) / sim_group_size;
+
+	sim_task_count = task_count;
+	sim_tasks = calloc(task_count, sizeof(EOS_sim_task_t));
+	sim_queues = calloc(groups + 1, sizeof(EOS_queue_id_t));
+
+	if (sim_tasks == NULL || sim_queues == NULL)
+	{
+		fprintf(stderr, "eos_sim: out of memory\n");
+		exit(1);
+	}
+
+	for (uint32_t g = 0; g < groups; g++)
+	{
+		sim_queues[g] = EOS_QueueCreate(EOS_SIM_QUEUE_SIZE, sizeof(uint64_t));
+	}
+
+	for (uint32_t i = 0; i < task_count; i++)
+	{
+		EOS_sim_task_t* task = &sim_tasks[i];
+		uint32_t pick = EOS_SimRandom() % mix_total;
+		EOS_priority_t priority = pick < config.mix[0] ? PRIORITY_HIGH :
+								  pick < config.mix[0] + config.mix[1] ? PRIORITY_MEDIUM : PRIORITY_LOW;
+
+		if (i < groups * sim_group_size)
+		{
+			task->group = i - i % sim_group_size;
+			task->role = (i % sim_group_size) < config.fanin ? SIM_PRODUCER : SIM_CONSUMER;
+		}
+		else
+		{
+			task->role = SIM_PERIODIC;
+		}
+
+		task->period_us = EOS_SimUniform(config.delay_min_ms, config.delay_max_ms) * 1000;
+		task->work_us = work_us > 0 ? work_us : 1;
+		task->tcb = EOS_ThreadNew(EOS_SimTask, priority, task->stack, 64, EOS_NO_FPU);
+
+		if (task->tcb == NULL)
+		{
+			fprintf(stderr, "eos_sim: could not create task %u\n", i);
+			exit(1);
+		}
+	}
+}
+
+
+/**
+ * @brief Simulates task_count tasks for the configured number of ticks, and prints the results.
+ */
+static void EOS_SimRun(uint32_t task_count){
+	sim_random = config.seed ? config.seed : 1;
+
+	EOS_SimCreate(task_count);
+	EOS_Init(DEFAULT_TASK_PERIOD); //returns on the SIM port
+
+	for (uint32_t tick = 0; tick < config.ticks; tick++)
+	{
+		uint64_t tick_end_us = (uint64_t)(tick + 1) * EOS_SIM_TICK_US;
+
+		EOS_Tick();
+		EOS_SimFindWakeups(0, sim_task_count);
+		EOS_SimDecide();
+
+		while (sim_now_us < tick_end_us)
+		{
+			EOS_sim_task_t* task = (EOS_sim_task_t*)run_ptr->sp;
+
+			if (task < sim_tasks || task >= sim_tasks + sim_task_count) //the idle task
+			{
+				sim_now_us = tick_end_us;
+				break;
+			}
+
+			EOS_SimStep(task, tick_end_us);
+			EOS_SimDecide();
+		}
+	}
+
+	printf("{\"tasks\":%u,\"ticks\":%u,\"decisions\":%u", task_count, config.ticks, sched_cycles.count);
+	EOS_SimPrintSamples("sched_cycles", &sched_cycles);
+	EOS_SimPrintSamples("wakeup_us", &wakeup_us);
+	printf(",\"jobs\":%llu,\"deadline_misses\":%llu}\n", (unsigned long long)sim_jobs, (unsigned long long)sim_misses);
+	fflush(stdout);
+}
+
+
+
+/*	COMMAND LINE	*/
+
+
+static void EOS_SimUsage(void){
+	fprintf(stderr, "usage: eos_sim [--tasks 8,16,...] [--ticks N] [--mix H:M:L] [--ipc FRACTION] [--fanin N] "
+					"[--fanout N] [--delay MIN:MAX] [--util FRACTION] [--seed N]\n");
+	exit(2);
+}
+
+
+int main(int argc, char** argv){
+	uint32_t counts[EOS_SIM_MAX_RUNS] = {8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+	uint32_t runs = 10;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+		if (value == NULL)
+		{
+			EOS_SimUsage();
+		}
+
+		if (strcmp(argv[i], "--tasks") == 0)
+		{
+			runs = 0;
+			char* list = strdup(value);
+			for (char* item = strtok(list, ","); item != NULL && runs < EOS_SIM_MAX_RUNS; item = strtok(NULL, ","))
+			{
+				counts[runs++] = (uint32_t)atoi(item);
+			}
+			free(list);
+		}
+		else if (strcmp(argv[i], "--ticks") == 0)
+		{
+			config.ticks = (uint32_t)atoi(value);
+		}
+		else if (strcmp(argv[i], "--mix") == 0)
+		{
+			if (sscanf(value, "%u:%u:%u", &config.mix[0], &config.mix[1], &config.mix[2]) != 3)
+			{
+				EOS_SimUsage();
+			}
+		}
+		else if (strcmp(argv[i], "--ipc") == 0)
+		{
+			config.ipc = atof(value);
+		}
+		else if (strcmp(argv[i], "--fanin") == 0)
+		{
+			config.fanin = (uint32_t)atoi(value);
+		}
+		else if (strcmp(argv[i], "--fanout") == 0)
+		{
+			config.fanout = (uint32_t)atoi(value);
+		}
+		else if (strcmp(argv[i], "--delay") == 0)
+		{
+			if (sscanf(value, "%u:%u", &config.delay_min_ms, &config.delay_max_ms) != 2)
+			{
+				EOS_SimUsage();
+			}
+		}
+		else if (strcmp(argv[i], "--util") == 0)
+		{
+			config.util = atof(value);
+		}
+		else if (strcmp(argv[i], "--seed") == 0)
+		{
+			config.seed = (uint32_t)strtoul(value, NULL, 0);
+		}
+		else
+		{
+			EOS_SimUsage();
+		}
+		i++;
+	}
+
+	if (config.fanin == 0 || config.fanout == 0 || config.delay_min_ms == 0 ||
+		config.delay_max_ms < config.delay_min_ms || config.mix[0] + config.mix[1] + config.mix[2] == 0)
+	{
+		EOS_SimUsage();
+	}
+
+	for (uint32_t r = 0; r < runs; r++)
+	{
+		if (counts[r] == 0)
+		{
+			continue;
+		}
+
+		pid_t child = fork();
+		if (child == 0)
+		{
+			EOS_SimRun(counts[r]);
+			exit(0);
+		}
+
+		int status = 0;
+		waitpid(child, &status, 0);
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			fprintf(stderr, "eos_sim: run with %u tasks failed\n", counts[r]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,29 @@
+/*
+ * main_bench.c
+ *
+ *      Host entry point for the EvanRTOS microbenchmarks. The isr_wakeup benchmark uses the POSIX port's simulated
+ *      user interrupt. Cycle counts on this port are nanoseconds of host time.
+ */
+
+
+/*	INCLUDES	*/
+#include <stdlib.h>
+#include "eos_bench.h"
+
+
+uint8_t EOS_BenchTriggerIsr(void){
+	EOS_PosixTriggerIsr();
+	return 1;
+}
+
+
+void EOS_BenchComplete(void){
+	exit(0);
+}
+
+
+int main(void){
+	EOS_PosixSetIsr(EOS_BenchIsr);
+	EOS_BenchInit(); //does not return
+	return 0;
+}
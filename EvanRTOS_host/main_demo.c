@@ -0,0 +1,149 @@
+/*
+ * main_demo.c
+ *
+ *      Host entry point for the EvanRTOS demo. Runs the unchanged demo application (EvanRTOS_demo/CM7/Core/Src/eos.c)
+ *      on the POSIX port for a number of seconds (default 5), then prints the demo's global counters and exits. When
+ *      built with EOS_CRITICAL_PROFILE_ENABLE, EOS_WAIT_PROFILE_ENABLE, EOS_CONTENTION_PROFILE_ENABLE or
+ *      EOS_INVERSION_DETECT_ENABLE, their reports are printed as well, and when built with EOS_PROFILE_ENABLE, the
+ *      sampling profile is written to eos_profile.bin (see tools/eos_profile2folded.py). When built with
+ *      EOS_MONITOR_ENABLE, the monitor task's CSV goes to stderr, so it can be piped into tools/eos_top.py. When built
+ *      with EOS_LOG_ENABLE, the log stream is written to eos_log.bin (see tools/eos_log_decode.py). When built with
+ *      EOS_RTT_ENABLE, the monitor writes to the RTT stderr channel instead, and the stand-in probe in eos_rtt_reader.c
+ *      copies the RTT channels to stdout and stderr.
+ */
+
+
+/*	INCLUDES	*/
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "eos_kernel.h"
+#include "eos_critical.h"
+#include "eos_profile.h"
+#include "eos_wait.h"
+#include "eos_contention.h"
+#include "eos_inversion.h"
+#include "eos_monitor.h"
+#include "eos_log.h"
+#include "eos_rtt_reader.h"
+
+
+/*	DEMO VARIABLES	(eos.c)	*/
+void EvanRTOS_Init();
+
+extern uint32_t t0count;
+extern double t1count;
+extern uint32_t t2count;
+extern uint32_t t3count;
+extern uint32_t t4count;
+extern uint32_t t5_queue_item;
+
+
+/*	GLOBAL VARIABLES	*/
+static unsigned int run_seconds = 5;
+#if EOS_LOG_ENABLE
+static FILE* log_file = NULL;
+#endif
+
+
+#if EOS_MONITOR_ENABLE
+/**
+ * @brief Plays the part of USART1 for the monitor task.
+ */
+void EOS_MonitorWrite(const char* data, uint32_t length){
+#if EOS_RTT_ENABLE
+	EOS_RttWrite(EOS_RTT_STDERR, data, length);
+#else
+	fwrite(data, 1, length, stderr);
+#endif
+}
+#endif
+
+
+#if EOS_LOG_ENABLE
+/**
+ * @brief Plays the part of USART1 for the log drain task.
+ */
+void EOS_LogOutput(const uint8_t* data, uint32_t length){
+	if (log_file != NULL)
+	{
+		fwrite(data, 1, length, log_file);
+	}
+}
+#endif
+
+
+/**
+ * @brief Stops the demo once run_seconds have passed. Runs on its own host thread, with every signal blocked so
+ * 			the simulated interrupts are always delivered to the kernel thread.
+ */
+static void* EOS_HostStop(void* arg){
+	(void)arg;
+	sleep(run_seconds);
+
+	printf("t0count=%u t1count=%f t2count=%u t3count=%u t4count=%u t5_queue_item=%u\n",
+			t0count, t1count, t2count, t3count, t4count, t5_queue_item);
+
+#if EOS_CRITICAL_PROFILE_ENABLE
+	EOS_CriticalProfileReport();
+#endif
+
+#if EOS_WAIT_PROFILE_ENABLE
+	EOS_WaitProfileReport();
+#endif
+
+#if EOS_CONTENTION_PROFILE_ENABLE
+	EOS_ContentionReport();
+#endif
+
+#if EOS_INVERSION_DETECT_ENABLE
+	EOS_InversionReport();
+#endif
+
+#if EOS_LOG_ENABLE
+	const EOS_log_stats_t* log_stats = EOS_LogStats();
+	printf("{\"log\":\"summary\",\"written\":%u,\"dropped\":%u,\"high_water\":%u,\"buffer\":%u}\n",
+			log_stats->written, log_stats->dropped, log_stats->high_water, EOS_LOG_BUFFER_WORDS);
+#endif
+
+#if EOS_PROFILE_ENABLE
+	EOS_ProfileStop();
+	FILE* dump = fopen("eos_profile.bin", "wb");
+	if (dump != NULL)
+	{
+		fwrite(&eos_profile, sizeof(eos_profile), 1, dump);
+		fclose(dump);
+	}
+#endif
+	exit(0);
+}
+
+
+int main(int argc, char** argv){
+
+	if (argc > 1)
+	{
+		run_seconds = (unsigned int)atoi(argv[1]);
+	}
+
+	sigset_t all;
+	sigset_t previous;
+	pthread_t stop_thread;
+
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, &previous);
+	pthread_create(&stop_thread, NULL, EOS_HostStop, NULL);
+#if EOS_RTT_ENABLE
+	EOS_RttReaderStart(stdout, stderr, NULL);
+#endif
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+#if EOS_LOG_ENABLE
+	log_file = fopen("eos_log.bin", "wb");
+#endif
+
+	EvanRTOS_Init(); //does not return
+	return 0;
+}
@@ -0,0 +1,469 @@
+/*
+ * main_dual.c
+ *
+ *      Host stand-in for the dual core mode (eos_dual_core.c). Two processes play the part of the two cores, each
+ *      running its own EvanRTOS instance on the POSIX port, like the Cortex-M7 and the Cortex-M4 of the STM32H747: the
+ *      kernel keeps its state in globals, so each instance needs a process of its own, and the shared memory is a
+ *      MAP_SHARED mapping made before the fork. The parent is the primary core, the child the secondary one.
+ *
+ *      ./eos_dual [rounds]
+ *
+ *      Runs three checks of the cross-core protocol, then prints a JSON summary, and exits with status 0 if all passed:
+ *      	- request/reply: a task on the primary core sends rounds requests to a server task on the secondary core
+ *      	  through one shared queue, and checks each reply from another, timing the round trips
+ *      	- burst: a task on the secondary core puts rounds numbered items into a 2 item queue, faster than a lower
+ *      	  priority task on the primary core takes them, so both sides block on it. The items must arrive in order
+ *      	- mutual exclusion: two tasks on each core increment a shared counter, each DUAL_COUNT times, under a shared
+ *      	  semaphore, delaying while holding it now and then. No increment may be lost
+ *      	- stream: once the others are done, a task on the secondary core streams rounds * DUAL_STREAM_PER_ROUND
+ *      	  slots through a ring buffer (eos_ring.c) to a task on the primary core, which checks that each slot holds
+ *      	  its own sequence number at both ends and copies it out. The throughput is printed next to that of a plain
+ *      	  memcpy() of the same data
+ */
+
+
+/*	INCLUDES	*/
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "eos_kernel.h"
+#include "eos_dual_core.h"
+#include "eos_ring.h"
+
+
+/*	CONSTANTS	*/
+#define DUAL_SEMAPHORE_COUNTER 0
+#define DUAL_QUEUE_REQUEST 0
+#define DUAL_QUEUE_REPLY 1
+#define DUAL_QUEUE_BURST 2
+
+#define DUAL_COUNT 200		//increments per counter task
+#define DUAL_STREAM_SLOTS 64
+#define DUAL_STREAM_SLOT 1024	//bytes
+#define DUAL_STREAM_PER_ROUND 16	//slots streamed per round
+#define DUAL_STACK 128
+
+
+/*	DATATYPES	*/
+
+/* Test state both processes see, next to the kernel's shared memory */
+typedef struct {
+	volatile uint32_t counter;
+	volatile uint32_t counters_done;
+	volatile uint32_t burst_done;
+	volatile uint32_t stream_done;
+	volatile uint32_t errors;
+} dual_test_t;
+
+/* Ring buffer of the stream check, in a mapping of its own */
+typedef struct {
+	EOS_ring_t ring;
+	uint8_t slots[DUAL_STREAM_SLOTS * DUAL_STREAM_SLOT];
+} dual_stream_t;
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_dual_shared_t* shared = NULL;
+static dual_test_t* test = NULL;
+static dual_stream_t* stream = NULL;
+static uint32_t rounds = 2000;
+
+static EOS_dual_semaphore_id_t counter_semaphore;
+static EOS_dual_queue_id_t request_queue;
+static EOS_dual_queue_id_t reply_queue;
+static EOS_dual_queue_id_t burst_queue;
+static EOS_ring_id_t stream_ring;
+
+static uint32_t client_done = 0;
+static uint32_t rtt_min = 0xFFFFFFFFu;
+static uint32_t rtt_max = 0;
+static uint64_t rtt_total = 0;
+static uint32_t stream_ns = 0;
+
+
+
+/*	BOTH CORES	*/
+
+
+/**
+ * @brief Increments the shared counter DUAL_COUNT times under the shared semaphore. Every eighth time, it holds the
+ * 			semaphore over a tick, so the other tasks, on both cores, block on it.
+ */
+static void counter_task(void){
+
+	for (uint32_t i = 0; i < DUAL_COUNT; i++)
+	{
+		EOS_DualSemaphoreAcquire(counter_semaphore);
+		uint32_t value = test->counter;
+
+		if ((i & 7) == 0)
+		{
+			EOS_Delay(1);
+		}
+
+		test->counter = value + 1;
+		EOS_DualSemaphoreRelease(counter_semaphore);
+	}
+
+	__atomic_add_fetch(&test->counters_done, 1, __ATOMIC_SEQ_CST);
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+
+/*	PRIMARY CORE	*/
+
+
+/**
+ * @brief Sends numbered requests to the server on the other core, and checks and times each reply.
+ */
+static void client_task(void){
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		uint32_t reply = 0;
+		uint32_t start = EOS_GetCycles();
+
+		EOS_DualQueuePut(request_queue, &i, EOS_BLOCK);
+		EOS_DualQueueGet(reply_queue, &reply, EOS_BLOCK);
+
+		uint32_t elapsed = EOS_GetCycles() - start;
+		rtt_total += elapsed;
+		rtt_min = (elapsed < rtt_min) ? elapsed : rtt_min;
+		rtt_max = (elapsed > rtt_max) ? elapsed : rtt_max;
+
+		if (reply != i * 2 + 1)
+		{
+			test->errors++;
+		}
+	}
+
+	client_done = 1;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Takes the burst items, slower than they are put, and checks they arrive in order.
+ */
+static void burst_consumer_task(void){
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		uint32_t item = 0;
+		EOS_DualQueueGet(burst_queue, &item, EOS_BLOCK);
+
+		if (item != i)
+		{
+			test->errors++;
+		}
+		if ((i & 63) == 0)
+		{
+			EOS_Delay(1);
+		}
+	}
+
+	test->burst_done = 1;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Takes the streamed slots as they are committed, in batches, checks the sequence number at both ends of each,
+ * 			and copies them out. Polls while the ring is empty, as yielding would idle until the next tick.
+ */
+static void stream_consumer_task(void){
+
+	static uint8_t copy[DUAL_STREAM_SLOT];
+	uint32_t total = rounds * DUAL_STREAM_PER_ROUND;
+	uint32_t sequence = 0;
+	uint32_t start = 0;
+
+	while (sequence < total)
+	{
+		void* slots;
+		uint32_t n = EOS_RingPeek(stream_ring, &slots);
+
+		if (n == 0)
+		{
+			sched_yield(); //poll, giving the host CPU to the other core's process in case they share one
+			continue;
+		}
+		if (sequence == 0)
+		{
+			start = EOS_GetCycles();
+		}
+
+		for (uint32_t i = 0; i < n; i++, sequence++)
+		{
+			const uint8_t* slot = (const uint8_t*)slots + i * DUAL_STREAM_SLOT;
+			uint32_t first, last;
+
+			memcpy(copy, slot, DUAL_STREAM_SLOT);
+			memcpy(&first, copy, sizeof(first));
+			memcpy(&last, &copy[DUAL_STREAM_SLOT - sizeof(last)], sizeof(last));
+			if (first != sequence || last != sequence)
+			{
+				test->errors++;
+			}
+		}
+		EOS_RingConsume(stream_ring, n);
+	}
+
+	stream_ns = EOS_GetCycles() - start;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Returns the MB/s of copying bytes through a buffer the size of the ring, for comparison with the stream.
+ */
+static uint32_t memcpy_rate(uint64_t bytes){
+
+	static uint8_t source[DUAL_STREAM_SLOT];
+	static uint8_t destination[DUAL_STREAM_SLOTS * DUAL_STREAM_SLOT];
+	static uint8_t copy[DUAL_STREAM_SLOT];
+	memset(source, 0x5A, sizeof(source));
+
+	uint32_t start = EOS_GetCycles();
+	for (uint64_t i = 0; i < bytes / DUAL_STREAM_SLOT; i++)
+	{
+		uint8_t* slot = &destination[(i % DUAL_STREAM_SLOTS) * DUAL_STREAM_SLOT];
+		memcpy(slot, source, DUAL_STREAM_SLOT);
+		__atomic_signal_fence(__ATOMIC_SEQ_CST);
+		memcpy(copy, slot, DUAL_STREAM_SLOT);
+		__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	}
+	uint32_t elapsed = EOS_GetCycles() - start;
+
+	return (uint32_t)(bytes * 1000 / (elapsed ? elapsed : 1));
+}
+
+
+/**
+ * @brief Waits for every check to finish on both cores, prints the summary, and ends both processes.
+ */
+static void report_task(void){
+
+	while (client_done == 0 || test->burst_done == 0 || test->counters_done < 4 || stream_ns == 0)
+	{
+		EOS_Delay(10);
+	}
+
+	uint64_t stream_bytes = (uint64_t)rounds * DUAL_STREAM_PER_ROUND * DUAL_STREAM_SLOT;
+	uint32_t stream_rate = (uint32_t)(stream_bytes * 1000 / stream_ns);
+	uint32_t memcpy_mb_s = memcpy_rate(stream_bytes);
+
+	uint32_t expected = 4 * DUAL_COUNT;
+	if (test->counter != expected)
+	{
+		test->errors++;
+	}
+
+	printf("{\"dual\":\"summary\",\"rounds\":%u,\"round_trip_ns\":{\"min\":%u,\"avg\":%u,\"max\":%u},"
+			"\"burst\":%u,\"counter\":%u,\"expected\":%u,\"stream_mb_s\":%u,\"memcpy_mb_s\":%u,\"errors\":%u}\n",
+			(unsigned int)rounds, (unsigned int)rtt_min, (unsigned int)(rtt_total / rounds), (unsigned int)rtt_max,
+			(unsigned int)rounds, (unsigned int)test->counter, (unsigned int)expected, (unsigned int)stream_rate,
+			(unsigned int)memcpy_mb_s, (unsigned int)test->errors);
+	fflush(stdout);
+
+	exit(test->errors == 0 ? 0 : 1);
+}
+
+
+static void primary_main(pid_t secondary){
+
+	EOS_PosixSetPeer(secondary);
+	EOS_DualCoreInit(EOS_CORE_PRIMARY, shared);
+
+	counter_semaphore = EOS_DualSemaphoreNew(DUAL_SEMAPHORE_COUNTER, 1);
+	request_queue = EOS_DualQueueCreate(DUAL_QUEUE_REQUEST, 4, sizeof(uint32_t));
+	reply_queue = EOS_DualQueueCreate(DUAL_QUEUE_REPLY, 4, sizeof(uint32_t));
+	burst_queue = EOS_DualQueueCreate(DUAL_QUEUE_BURST, 2, sizeof(uint32_t));
+	stream_ring = EOS_RingCreate(&stream->ring, stream->slots, DUAL_STREAM_SLOTS, DUAL_STREAM_SLOT, EOS_RING_CACHED);
+
+	if (counter_semaphore == NULL || request_queue == NULL || reply_queue == NULL || burst_queue == NULL ||
+			stream_ring == NULL)
+	{
+		fprintf(stderr, "eos_dual: could not create the shared objects\n");
+		exit(1);
+	}
+
+	EOS_ThreadNew(client_task, PRIORITY_HIGH, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(counter_task, PRIORITY_MEDIUM, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(counter_task, PRIORITY_LOW, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(burst_consumer_task, PRIORITY_LOW, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(stream_consumer_task, PRIORITY_LOW, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(report_task, PRIORITY_LOW, NULL, DUAL_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+}
+
+
+
+/*	SECONDARY CORE	*/
+
+
+/**
+ * @brief Answers each request with twice its number plus one.
+ */
+static void server_task(void){
+
+	while (1)
+	{
+		uint32_t request = 0;
+		EOS_DualQueueGet(request_queue, &request, EOS_BLOCK);
+
+		uint32_t reply = request * 2 + 1;
+		EOS_DualQueuePut(reply_queue, &reply, EOS_BLOCK);
+	}
+}
+
+
+/**
+ * @brief Puts numbered items into the burst queue as fast as it can.
+ */
+static void burst_producer_task(void){
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		EOS_DualQueuePut(burst_queue, &i, EOS_BLOCK);
+	}
+
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Once the other checks are done, fills the free slots of the ring in place with their sequence number at both
+ * 			ends, and commits them in batches. Polls while the ring is full.
+ */
+static void stream_producer_task(void){
+
+	static uint8_t source[DUAL_STREAM_SLOT];
+	uint32_t total = rounds * DUAL_STREAM_PER_ROUND;
+	uint32_t sequence = 0;
+
+	while (test->counters_done < 4 || test->burst_done == 0)
+	{
+		EOS_Delay(10);
+	}
+
+	memset(source, 0xA5, sizeof(source));
+	while (sequence < total)
+	{
+		void* slots;
+		uint32_t n = EOS_RingReserve(stream_ring, &slots);
+
+		if (n == 0)
+		{
+			sched_yield(); //poll, giving the host CPU to the other core's process in case they share one
+			continue;
+		}
+		if (n > total - sequence)
+		{
+			n = total - sequence;
+		}
+
+		for (uint32_t i = 0; i < n; i++, sequence++)
+		{
+			uint8_t* slot = (uint8_t*)slots + i * DUAL_STREAM_SLOT;
+
+			memcpy(source, &sequence, sizeof(sequence));
+			memcpy(&source[DUAL_STREAM_SLOT - sizeof(sequence)], &sequence, sizeof(sequence));
+			memcpy(slot, source, DUAL_STREAM_SLOT);
+		}
+		EOS_RingCommit(stream_ring, n);
+	}
+
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+static void secondary_main(pid_t primary){
+
+	prctl(PR_SET_PDEATHSIG, SIGTERM);
+	EOS_PosixSetPeer(primary);
+	EOS_DualCoreInit(EOS_CORE_SECONDARY, shared);
+
+	//the primary core creates the objects once the shared memory is ready
+	while ((counter_semaphore = EOS_DualSemaphoreOpen(DUAL_SEMAPHORE_COUNTER)) == NULL ||
+			(request_queue = EOS_DualQueueOpen(DUAL_QUEUE_REQUEST)) == NULL ||
+			(reply_queue = EOS_DualQueueOpen(DUAL_QUEUE_REPLY)) == NULL ||
+			(burst_queue = EOS_DualQueueOpen(DUAL_QUEUE_BURST)) == NULL ||
+			(stream_ring = EOS_RingOpen(&stream->ring)) == NULL)
+	{
+		usleep(100);
+	}
+
+	EOS_ThreadNew(server_task, PRIORITY_HIGH, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(burst_producer_task, PRIORITY_MEDIUM, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(stream_producer_task, PRIORITY_LOW, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(counter_task, PRIORITY_MEDIUM, NULL, DUAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(counter_task, PRIORITY_LOW, NULL, DUAL_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+}
+
+
+
+int main(int argc, char** argv){
+
+	if (argc > 1)
+	{
+		rounds = (uint32_t)strtoul(argv[1], NULL, 0);
+	}
+	if (rounds == 0)
+	{
+		rounds = 1;
+	}
+
+	shared = mmap(NULL, sizeof(EOS_dual_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	test = mmap(NULL, sizeof(dual_test_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	stream = mmap(NULL, sizeof(dual_stream_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED || test == MAP_FAILED || stream == MAP_FAILED)
+	{
+		perror("eos_dual: mmap");
+		return 1;
+	}
+
+	pid_t primary = getpid();
+	pid_t secondary = fork();
+
+	if (secondary < 0)
+	{
+		perror("eos_dual: fork");
+		return 1;
+	}
+	if (secondary == 0)
+	{
+		secondary_main(primary);
+	}
+
+	primary_main(secondary);
+	return 0;
+}
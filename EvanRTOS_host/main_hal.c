@@ -0,0 +1,340 @@
+/*
+ * main_hal.c
+ *
+ *      Host checks of the HAL shim's transfer waits (eos_hal.c), with a stand-in peripheral in place of a vendor HAL:
+ *      a helper thread per device "runs" each transfer it is given for a set time, then raises the user interrupt,
+ *      whose handler calls EOS_HalComplete(), as the ARM_CM7 port's HAL callbacks do.
+ *
+ *      ./eos_hal [transfers]
+ *
+ *      Runs these checks, then prints a JSON summary, and exits with status 0 if all passed:
+ *      	- cpu: a high priority task does transfers HAL_TRANSFER_US long, first polling for the end of each as the
+ *      	  HAL's blocking calls do, then sleeping in EOS_HalWait(). A low priority task counts meanwhile, and its
+ *      	  share of the CPU (per mille of what it gets with the high priority task asleep) must go from next to
+ *      	  nothing while polling to most of it while sleeping
+ *      	- wakeup: the time from the interrupt to the waiting task running again
+ *      	- timeout: a transfer that never completes must time out after its timeout, within a few ticks
+ *      	- results: a failed transfer, a full duplex device completing its receive before its transmit, and a
+ *      	  cancelled wait that must not be completed
+ *      	- EOS_HalCanBlock(): 1 in a task, 0 before EOS_Init(), in a critical section and in an interrupt
+ */
+
+
+/*	INCLUDES	*/
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "eos_kernel.h"
+#include "eos_hal.h"
+
+
+/*	CONSTANTS	*/
+#define HAL_DEVICES 2
+#define HAL_TRANSFER_US 500
+#define HAL_CALIBRATE_MS 100
+#define HAL_TIMEOUT_MS 20
+#define HAL_STACK 256
+
+
+/*	DATATYPES	*/
+
+/* One transfer handed to a device's thread */
+typedef struct {
+	uint32_t events;
+	uint32_t duration_us;
+	EOS_hal_result_t result;
+} hal_request_t;
+
+/* A stand-in peripheral. Its address is the handle the waits are on */
+typedef struct {
+	int pipe[2];					//requests, from the tasks to the thread
+	pthread_t thread;
+	volatile uint32_t done;			//events finished, not yet passed to EOS_HalComplete()
+	volatile uint32_t failed;
+	volatile uint32_t finished;		//transfers finished, which a polling task watches
+	volatile uint32_t raised;		//cycle count when the interrupt was raised
+} hal_device_t;
+
+
+/*	GLOBAL VARIABLES	*/
+static uint32_t transfers = 200;
+static hal_device_t devices[HAL_DEVICES];
+
+static volatile uint32_t low_count = 0;
+static volatile uint32_t errors = 0;
+static volatile int32_t isr_can_block = -1;
+static uint32_t main_can_block = 1;
+
+
+
+/*	STAND-IN PERIPHERAL	*/
+
+
+/**
+ * @brief A device's thread: waits out each transfer, then raises the user interrupt.
+ */
+static void* device_thread(void* argument){
+
+	hal_device_t* device = argument;
+	hal_request_t request;
+
+	while (read(device->pipe[0], &request, sizeof(request)) == sizeof(request))
+	{
+		struct timespec duration = {0, (long)request.duration_us * 1000};
+		nanosleep(&duration, NULL);
+
+		if (request.result == EOS_HAL_DONE)
+		{
+			__atomic_fetch_or(&device->done, request.events, __ATOMIC_SEQ_CST);
+		}
+		else
+		{
+			__atomic_fetch_or(&device->failed, request.events, __ATOMIC_SEQ_CST);
+		}
+		device->raised = EOS_GetCycles();
+		__atomic_fetch_add(&device->finished, 1, __ATOMIC_SEQ_CST);
+		kill(getpid(), SIGUSR1);
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief The user interrupt: passes what each device finished on to the waits.
+ */
+static void device_isr(void){
+
+	if (isr_can_block < 0)
+	{
+		isr_can_block = (int32_t)EOS_HalCanBlock();
+	}
+
+	for (uint32_t i = 0; i < HAL_DEVICES; i++)
+	{
+		uint32_t done = __atomic_exchange_n(&devices[i].done, 0, __ATOMIC_SEQ_CST);
+		uint32_t failed = __atomic_exchange_n(&devices[i].failed, 0, __ATOMIC_SEQ_CST);
+
+		if (done != 0)
+		{
+			EOS_HalComplete(&devices[i], done, EOS_HAL_DONE);
+		}
+		if (failed != 0)
+		{
+			EOS_HalComplete(&devices[i], failed, EOS_HAL_FAILED);
+		}
+	}
+}
+
+
+/**
+ * @brief Starts a transfer on a device, as a HAL ..._IT() call would.
+ */
+static void device_start(hal_device_t* device, uint32_t events, uint32_t duration_us, EOS_hal_result_t result){
+
+	hal_request_t request = {events, duration_us, result};
+
+	if (write(device->pipe[1], &request, sizeof(request)) != sizeof(request))
+	{
+		errors++;
+	}
+}
+
+
+
+/*	TASKS	*/
+
+
+/**
+ * @brief Counts, for as long as nothing of higher priority runs.
+ */
+static void low_task(void){
+
+	while (1)
+	{
+		low_count++;
+	}
+}
+
+
+/**
+ * @brief Runs transfers one after the other, polling or sleeping on each, and returns the low priority task's count
+ * 			meanwhile. elapsed is set to the cycles taken.
+ */
+static uint32_t run_transfers(uint32_t sleep, uint32_t* elapsed, uint64_t* wake_total, uint32_t* wake_max){
+
+	hal_device_t* device = &devices[0];
+	uint32_t count = low_count;
+	uint32_t start = EOS_GetCycles();
+
+	for (uint32_t i = 0; i < transfers; i++)
+	{
+		if (sleep)
+		{
+			EOS_hal_wait_t wait;
+
+			EOS_HalPrepare(&wait, device, EOS_HAL_TX, EOS_HAL_FOREVER);
+			device_start(device, EOS_HAL_TX, HAL_TRANSFER_US, EOS_HAL_DONE);
+			if (EOS_HalWait(&wait) != EOS_HAL_DONE)
+			{
+				errors++;
+			}
+
+			uint32_t wake = EOS_GetCycles() - device->raised;
+			*wake_total += wake;
+			*wake_max = (wake > *wake_max) ? wake : *wake_max;
+		}
+		else
+		{
+			uint32_t finished = device->finished;
+
+			device_start(device, EOS_HAL_TX, HAL_TRANSFER_US, EOS_HAL_DONE);
+			while (device->finished == finished)
+			{
+			}
+		}
+	}
+
+	*elapsed = EOS_GetCycles() - start;
+	return low_count - count;
+}
+
+
+/**
+ * @brief Runs the checks, prints the summary, and ends the process.
+ */
+static void control_task(void){
+
+	uint32_t elapsed = 0;
+	uint64_t wake_total = 0;
+	uint32_t wake_max = 0;
+
+	//cpu: what the low priority task counts per ms with the CPU to itself
+	uint32_t count = low_count;
+	uint32_t start = EOS_GetCycles();
+	EOS_Delay(HAL_CALIBRATE_MS);
+	double per_cycle = (double)(low_count - count) / (double)(EOS_GetCycles() - start);
+
+	uint32_t poll_count = run_transfers(0, &elapsed, &wake_total, &wake_max);
+	uint32_t poll_pm = (uint32_t)(1000.0 * poll_count / (per_cycle * elapsed));
+	uint32_t poll_us = elapsed / 1000;
+
+	uint32_t wait_count = run_transfers(1, &elapsed, &wake_total, &wake_max);
+	uint32_t wait_pm = (uint32_t)(1000.0 * wait_count / (per_cycle * elapsed));
+	uint32_t wait_us = elapsed / 1000;
+
+	if (poll_pm > 100 || wait_pm < 500)
+	{
+		errors++;
+	}
+
+	//timeout: the device is never started
+	EOS_hal_wait_t wait;
+	EOS_HalPrepare(&wait, &devices[1], EOS_HAL_RX, HAL_TIMEOUT_MS);
+	start = EOS_GetCycles();
+	EOS_hal_result_t result = EOS_HalWait(&wait);
+	uint32_t timeout_ms = (EOS_GetCycles() - start) / 1000000;
+	if (result != EOS_HAL_TIMEOUT || timeout_ms < HAL_TIMEOUT_MS || timeout_ms > HAL_TIMEOUT_MS + 10)
+	{
+		errors++;
+	}
+
+	//failure
+	EOS_HalPrepare(&wait, &devices[1], EOS_HAL_RX, 100);
+	device_start(&devices[1], EOS_HAL_RX, 100, EOS_HAL_FAILED);
+	if (EOS_HalWait(&wait) != EOS_HAL_FAILED)
+	{
+		errors++;
+	}
+
+	//full duplex: the receive ends first, and must not complete the transmit
+	EOS_hal_wait_t tx;
+	EOS_hal_wait_t rx;
+	EOS_HalPrepare(&tx, &devices[0], EOS_HAL_TX, 100);
+	EOS_HalPrepare(&rx, &devices[0], EOS_HAL_RX, 100);
+	device_start(&devices[0], EOS_HAL_RX, 100, EOS_HAL_DONE);
+	if (EOS_HalWait(&rx) != EOS_HAL_DONE || tx.done != 0)
+	{
+		errors++;
+	}
+	device_start(&devices[0], EOS_HAL_TX, 100, EOS_HAL_DONE);
+	if (EOS_HalWait(&tx) != EOS_HAL_DONE)
+	{
+		errors++;
+	}
+
+	//cancel: a completion after EOS_HalCancel() finds nobody waiting
+	EOS_HalPrepare(&wait, &devices[1], EOS_HAL_RX, 100);
+	EOS_HalCancel(&wait);
+	uint32_t finished = devices[1].finished;
+	device_start(&devices[1], EOS_HAL_RX, 100, EOS_HAL_DONE);
+	while (devices[1].finished == finished)
+	{
+		EOS_Delay(1);
+	}
+	EOS_Delay(2);
+	if (wait.done != 0)
+	{
+		errors++;
+	}
+
+	//EOS_HalCanBlock()
+	EOS_EnterCritical();
+	uint32_t critical_can_block = EOS_HalCanBlock();
+	EOS_ExitCritical();
+	if (EOS_HalCanBlock() != 1 || critical_can_block != 0 || isr_can_block != 0 || main_can_block != 0)
+	{
+		errors++;
+	}
+
+	printf("{\"hal\":\"summary\",\"transfers\":%u,\"transfer_us\":%u,\"poll\":{\"us\":%u,\"low_pm\":%u},"
+			"\"wait\":{\"us\":%u,\"low_pm\":%u},\"wake_us\":{\"avg\":%u,\"max\":%u},\"timeout_ms\":%u,\"errors\":%u}\n",
+			(unsigned int)transfers, (unsigned int)HAL_TRANSFER_US, (unsigned int)poll_us, (unsigned int)poll_pm,
+			(unsigned int)wait_us, (unsigned int)wait_pm, (unsigned int)(wake_total / transfers / 1000),
+			(unsigned int)(wake_max / 1000), (unsigned int)timeout_ms, (unsigned int)errors);
+	fflush(stdout);
+
+	exit(errors == 0 ? 0 : 1);
+}
+
+
+
+int main(int argc, char** argv){
+
+	if (argc > 1)
+	{
+		transfers = (uint32_t)strtoul(argv[1], NULL, 0);
+	}
+	if (transfers == 0)
+	{
+		transfers = 1;
+	}
+
+	main_can_block = EOS_HalCanBlock();
+
+	//the device threads leave every signal to the kernel's thread
+	sigset_t all;
+	sigset_t previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, &previous);
+	for (uint32_t i = 0; i < HAL_DEVICES; i++)
+	{
+		if (pipe(devices[i].pipe) != 0 || pthread_create(&devices[i].thread, NULL, device_thread, &devices[i]) != 0)
+		{
+			perror("eos_hal: device");
+			return 1;
+		}
+	}
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	EOS_PosixSetIsr(device_isr);
+
+	EOS_ThreadNew(low_task, PRIORITY_LOW, NULL, HAL_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(control_task, PRIORITY_HIGH, NULL, HAL_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+	return 0;
+}
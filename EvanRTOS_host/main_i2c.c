@@ -0,0 +1,310 @@
+/*
+ * main_i2c.c
+ *
+ *      Host checks of the I2C bus manager (eos_i2c.c), on the POSIX port's simulated bus: a 256 byte EEPROM-like
+ *      register file at I2C_EEPROM, clocked at EOS_POSIX_I2C_HZ.
+ *
+ *      ./eos_i2c [rounds]
+ *
+ *      Runs these checks, then prints a JSON summary, and exits with status 0 if all passed:
+ *      	- sharing: I2C_WORKERS tasks each write their own block of registers and read it back with a write then
+ *      	  read, rounds times, all on the one bus at once. Every read must return what its task wrote last
+ *      	- burst: I2C_BURST register reads are queued at once with callbacks, which must run in order. All but the
+ *      	  first must be started by the interrupt of the one before (chained), and the bus must be busy for most of
+ *      	  the burst: the summary gives its share (per mille) and the mean gap between transactions
+ *      	- slow callbacks: I2C_SLOW transactions are queued with a callback that keeps the manager busy until the next
+ *      	  one has ended. Each must still have its callback run, within I2C_SLOW_MS
+ *      	- faults: an address nobody answers ends in EOS_I2C_NACK, a bus error in EOS_I2C_ERROR, and a hung bus in
+ *      	  EOS_I2C_TIMEOUT after EOS_I2C_TIMEOUT_MS, within a few ticks. The bus must be reset after the last two, and
+ *      	  work again
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "eos_kernel.h"
+#include "eos_i2c.h"
+
+
+/*	CONSTANTS	*/
+#define I2C_EEPROM 0x50
+#define I2C_ABSENT 0x30
+#define I2C_WORKERS 3
+#define I2C_BLOCK 8
+#define I2C_BURST 64
+#define I2C_SLOW 4
+#define I2C_SLOW_MS 100
+#define I2C_STACK 256
+
+
+/*	GLOBAL VARIABLES	*/
+static uint32_t rounds = 200;
+
+static uint8_t eeprom[256];
+static EOS_posix_i2c_device_t devices[] = {
+	{.address = I2C_EEPROM, .memory = eeprom, .size = sizeof(eeprom)},
+};
+static EOS_posix_i2c_bus_t bus = {.devices = devices, .count = sizeof(devices) / sizeof(devices[0])};
+
+static volatile uint32_t workers_done = 0;
+static volatile uint32_t callbacks = 0;
+static volatile uint32_t callbacks_last = 0;
+static volatile uint32_t slow_callbacks = 0;
+static volatile uint32_t errors = 0;
+
+static EOS_i2c_txn_t slow[I2C_SLOW];
+
+
+
+/*	TASKS	*/
+
+
+/**
+ * @brief Writes its own block of registers, then reads it back, rounds times.
+ */
+static void worker_task(void){
+
+	static uint32_t next_worker = 0;
+	uint32_t worker = next_worker++;
+	uint8_t tx[1 + I2C_BLOCK];
+	uint8_t rx[I2C_BLOCK];
+
+	for (uint32_t round = 0; round < rounds; round++)
+	{
+		tx[0] = (uint8_t)(worker * 64);
+		for (uint32_t i = 0; i < I2C_BLOCK; i++)
+		{
+			tx[1 + i] = (uint8_t)(round * 7 + worker * 31 + i);
+		}
+
+		if (EOS_I2cWrite(0, I2C_EEPROM, tx, sizeof(tx)) != EOS_I2C_OK)
+		{
+			errors++;
+		}
+		if (EOS_I2cWriteRead(0, I2C_EEPROM, tx, 1, rx, sizeof(rx)) != EOS_I2C_OK || memcmp(rx, &tx[1], sizeof(rx)) != 0)
+		{
+			errors++;
+		}
+	}
+
+	workers_done++;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Spins, for as long as nothing of higher priority runs. A host left idle can lose ticks to its own scheduler,
+ * 			which would make the timeout look late.
+ */
+static void load_task(void){
+
+	while (1)
+	{
+	}
+}
+
+
+/**
+ * @brief Callback of the burst's transactions, run by the bus manager: checks the order and the result.
+ */
+static void burst_done(EOS_i2c_txn_t* txn){
+
+	if ((uint32_t)(uintptr_t)txn->context != callbacks || txn->result != EOS_I2C_OK)
+	{
+		errors++;
+	}
+	callbacks_last = EOS_GetCycles();
+	callbacks++;
+}
+
+
+/**
+ * @brief Callback of the slow callbacks check, run by the bus manager: returns only once the next transaction has
+ * 			ended, so that one ends while the manager is running callbacks.
+ */
+static void slow_done(EOS_i2c_txn_t* txn){
+
+	uint32_t i = (uint32_t)(uintptr_t)txn->context;
+	uint32_t start = EOS_GetCycles();
+
+	if (i + 1 < I2C_SLOW)
+	{
+		while (slow[i + 1].result == EOS_I2C_PENDING && EOS_GetCycles() - start < I2C_SLOW_MS * 1000000u)
+		{
+		}
+		if (slow[i + 1].result == EOS_I2C_PENDING)
+		{
+			errors++;
+		}
+	}
+	if (i != slow_callbacks || txn->result != EOS_I2C_OK)
+	{
+		errors++;
+	}
+	slow_callbacks++;
+}
+
+
+/**
+ * @brief Runs a transaction that must end in expected, and returns the ms it took.
+ */
+static uint32_t expect(uint16_t address, EOS_i2c_result_t expected){
+
+	uint8_t reg = 0;
+	uint32_t start = EOS_GetCycles();
+
+	if (EOS_I2cWrite(0, address, &reg, 1) != expected)
+	{
+		errors++;
+	}
+	return (EOS_GetCycles() - start) / 1000000;
+}
+
+
+/**
+ * @brief Runs the checks, prints the summary, and ends the process.
+ */
+static void control_task(void){
+
+	EOS_i2c_stats_t before;
+	EOS_i2c_stats_t after;
+
+	//sharing
+	uint32_t start = EOS_GetCycles();
+	while (workers_done < I2C_WORKERS)
+	{
+		EOS_Delay(1);
+	}
+	uint32_t share_ms = (EOS_GetCycles() - start) / 1000000;
+
+	//burst
+	static EOS_i2c_txn_t burst[I2C_BURST];
+	static uint8_t reads[I2C_BURST][I2C_BLOCK];
+	static const uint8_t reg = 0;
+
+	EOS_I2cStats(0, &before);
+	uint64_t busy = bus.busy_ns;
+	start = EOS_GetCycles();
+	for (uint32_t i = 0; i < I2C_BURST; i++)
+	{
+		burst[i] = (EOS_i2c_txn_t){0};
+		burst[i].address = I2C_EEPROM;
+		burst[i].tx_data = &reg;
+		burst[i].tx_length = 1;
+		burst[i].rx_data = reads[i];
+		burst[i].rx_length = I2C_BLOCK;
+		burst[i].callback = burst_done;
+		burst[i].context = (void*)(uintptr_t)i;
+		if (EOS_I2cSubmit(0, &burst[i]) != EOS_OK)
+		{
+			errors++;
+		}
+	}
+	while (callbacks < I2C_BURST)
+	{
+		EOS_Delay(1);
+	}
+	uint32_t elapsed = callbacks_last - start;
+	busy = bus.busy_ns - busy;
+	EOS_I2cStats(0, &after);
+
+	uint32_t chained = after.chained - before.chained;
+	uint32_t busy_pm = (uint32_t)(1000 * busy / elapsed);
+	uint32_t gap_us = (elapsed > busy) ? (uint32_t)((elapsed - busy) / I2C_BURST / 1000) : 0;
+	if (chained < I2C_BURST - 2 || busy_pm < 500 || memcmp(reads[0], reads[I2C_BURST - 1], I2C_BLOCK) != 0)
+	{
+		errors++;
+	}
+
+	//slow callbacks
+	static uint8_t slow_reads[I2C_SLOW][I2C_BLOCK];
+
+	for (uint32_t i = 0; i < I2C_SLOW; i++)
+	{
+		slow[i] = (EOS_i2c_txn_t){0};
+		slow[i].address = I2C_EEPROM;
+		slow[i].tx_data = &reg;
+		slow[i].tx_length = 1;
+		slow[i].rx_data = slow_reads[i];
+		slow[i].rx_length = I2C_BLOCK;
+		slow[i].callback = slow_done;
+		slow[i].context = (void*)(uintptr_t)i;
+		if (EOS_I2cSubmit(0, &slow[i]) != EOS_OK)
+		{
+			errors++;
+		}
+	}
+	start = EOS_GetCycles();
+	while (slow_callbacks < I2C_SLOW && EOS_GetCycles() - start < I2C_SLOW * I2C_SLOW_MS * 1000000u)
+	{
+		EOS_Delay(1);
+	}
+	if (slow_callbacks != I2C_SLOW)
+	{
+		errors++;
+	}
+
+	//faults
+	expect(I2C_ABSENT, EOS_I2C_NACK);
+
+	uint32_t resets = bus.resets;
+	bus.fault = EOS_POSIX_I2C_FAULT_ERROR;
+	expect(I2C_EEPROM, EOS_I2C_ERROR);
+	expect(I2C_EEPROM, EOS_I2C_OK);
+
+	bus.fault = EOS_POSIX_I2C_FAULT_HANG;
+	uint32_t timeout_ms = expect(I2C_EEPROM, EOS_I2C_TIMEOUT);
+	expect(I2C_EEPROM, EOS_I2C_OK);
+	if (bus.resets - resets != 2 || timeout_ms < EOS_I2C_TIMEOUT_MS || timeout_ms > EOS_I2C_TIMEOUT_MS + 10)
+	{
+		errors++;
+	}
+
+	EOS_I2cStats(0, &after);
+	if (after.nacks != 1 || after.errors != 1 || after.timeouts != 1)
+	{
+		errors++;
+	}
+
+	printf("{\"i2c\":\"summary\",\"hz\":%u,\"rounds\":%u,\"share_ms\":%u,\"burst\":{\"transactions\":%u,\"us\":%u,"
+			"\"chained\":%u,\"busy_pm\":%u,\"gap_us\":%u},\"slow_callbacks\":%u,\"transactions\":%u,\"idle_starts\":%u,"
+			"\"chained\":%u,\"timeout_ms\":%u,\"errors\":%u}\n",
+			(unsigned int)EOS_POSIX_I2C_HZ, (unsigned int)rounds, (unsigned int)share_ms, (unsigned int)I2C_BURST,
+			(unsigned int)(elapsed / 1000), (unsigned int)chained, (unsigned int)busy_pm, (unsigned int)gap_us,
+			(unsigned int)slow_callbacks, (unsigned int)after.transactions, (unsigned int)after.idle_starts,
+			(unsigned int)after.chained, (unsigned int)timeout_ms, (unsigned int)errors);
+	fflush(stdout);
+
+	exit(errors == 0 ? 0 : 1);
+}
+
+
+
+int main(int argc, char** argv){
+
+	if (argc > 1)
+	{
+		rounds = (uint32_t)strtoul(argv[1], NULL, 0);
+	}
+
+	if (EOS_I2cInit(0, &bus, PRIORITY_HIGH) != EOS_OK)
+	{
+		fprintf(stderr, "eos_i2c: bus\n");
+		return 1;
+	}
+
+	for (uint32_t i = 0; i < I2C_WORKERS; i++)
+	{
+		EOS_ThreadNew(worker_task, PRIORITY_MEDIUM, NULL, I2C_STACK, EOS_NO_FPU);
+	}
+	EOS_ThreadNew(control_task, PRIORITY_MEDIUM, NULL, I2C_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(load_task, PRIORITY_LOW, NULL, I2C_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+	return 0;
+}
@@ -0,0 +1,408 @@
+/*
+ * main_job.c
+ *
+ *      Host stand-in for the fork/join jobs (eos_job.c), with two processes as the two cores, as in main_dual.c. Both
+ *      cores register the same two kernels: "fir", a 32 tap FIR filter over one block of samples per chunk, and
+ *      "mark", which counts each chunk it is given.
+ *
+ *      ./eos_job [rounds]
+ *
+ *      Runs these checks, then prints a JSON summary, and exits with status 0 if all passed:
+ *      	- once: a task on the primary core runs "mark" forks of 1 up to 1000 chunks, more than the rings hold, and
+ *      	  checks that every chunk ran exactly once
+ *      	- nested: it forks two "mark" forks and joins them in reverse order, then forks until it runs out of
+ *      	  groups, which must refuse one more
+ *      	- errors: forks of an unknown kernel, or of no chunks, must be refused
+ *      	- reverse: meanwhile a task on the secondary core runs rounds "mark" forks of its own, so both cores fork
+ *      	  and serve each other at once
+ *      	- fir: the primary core filters JOB_SAMPLES samples in one task, then as a fork of one chunk per block, and
+ *      	  compares the outputs. The speedup is printed; on a host with one CPU it stays near 1
+ */
+
+
+/*	INCLUDES	*/
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+#include "eos_kernel.h"
+#include "eos_dual_core.h"
+#include "eos_job.h"
+
+
+/*	CONSTANTS	*/
+#define JOB_FIR 0				//kernel numbers
+#define JOB_MARK 1
+
+#define JOB_TAPS 32
+#define JOB_BLOCK 512			//samples per chunk
+#define JOB_SAMPLES (64 * JOB_BLOCK)
+#define JOB_PASSES 20			//filter runs timed each way
+#define JOB_MARKS 1024
+#define JOB_REVERSE_CHUNKS 50
+#define JOB_STACK 256
+
+
+/*	DATATYPES	*/
+
+/* Chunks to count, one counter per chunk */
+typedef struct {
+	volatile uint32_t marks[JOB_MARKS];
+} job_marks_t;
+
+/* Test state both processes see, next to the kernel's shared memory. Kernel arguments point in here */
+typedef struct {
+	float input[JOB_SAMPLES + JOB_TAPS - 1];
+	float taps[JOB_TAPS];
+	float serial[JOB_SAMPLES];
+	float parallel[JOB_SAMPLES];
+	job_marks_t primary_marks[2];
+	job_marks_t secondary_marks;
+	volatile uint32_t chunks[2];		//run by each core
+	volatile uint32_t secondary_ready;
+	volatile uint32_t reverse_done;
+	volatile uint32_t errors;
+} job_test_t;
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_dual_shared_t* shared = NULL;
+static EOS_job_shared_t* jobs = NULL;
+static job_test_t* test = NULL;
+static uint32_t rounds = 200;
+static uint32_t core = EOS_CORE_PRIMARY;
+
+static uint32_t client_done = 0;
+static uint32_t serial_ns = 0;
+static uint32_t parallel_ns = 0;
+
+
+
+/*	BOTH CORES	*/
+
+
+/**
+ * @brief Filters block chunk of the test input into the parallel output.
+ */
+static void fir_block(job_test_t* t, uint32_t chunk){
+
+	const float* in = &t->input[chunk * JOB_BLOCK];
+	float* out = &t->parallel[chunk * JOB_BLOCK];
+
+	for (uint32_t i = 0; i < JOB_BLOCK; i++)
+	{
+		float sum = 0.0f;
+		for (uint32_t k = 0; k < JOB_TAPS; k++)
+		{
+			sum += t->taps[k] * in[i + k];
+		}
+		out[i] = sum;
+	}
+}
+
+
+/**
+ * @brief "fir": filters one block.
+ */
+static void fir_kernel(void* argument, uint32_t chunk){
+
+	fir_block(argument, chunk);
+	__atomic_add_fetch(&test->chunks[core], 1, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * @brief "mark": counts chunk in the marks the argument points to.
+ */
+static void mark_kernel(void* argument, uint32_t chunk){
+
+	job_marks_t* marks = argument;
+
+	__atomic_add_fetch(&marks->marks[chunk], 1, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&test->chunks[core], 1, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * @brief Clears a set of marks.
+ */
+static void clear_marks(job_marks_t* marks){
+	memset((void*)marks, 0, sizeof(job_marks_t));
+}
+
+
+/**
+ * @brief Checks that chunks 0 to count - 1, and no others, were counted once each.
+ */
+static void check_marks(const job_marks_t* marks, uint32_t count){
+
+	for (uint32_t i = 0; i < JOB_MARKS; i++)
+	{
+		if (marks->marks[i] != (i < count ? 1u : 0u))
+		{
+			test->errors++;
+			return;
+		}
+	}
+}
+
+
+/**
+ * @brief Registers both kernels on this core.
+ */
+static void register_kernels(void){
+
+	if (EOS_JobRegister(JOB_FIR, fir_kernel) != EOS_OK || EOS_JobRegister(JOB_MARK, mark_kernel) != EOS_OK)
+	{
+		fprintf(stderr, "eos_job: could not register the kernels\n");
+		exit(1);
+	}
+}
+
+
+
+/*	PRIMARY CORE	*/
+
+
+/**
+ * @brief Runs the once, nested, errors and fir checks.
+ */
+static void client_task(void){
+
+	while (test->secondary_ready == 0)
+	{
+		EOS_Delay(1);
+	}
+
+	//once
+	static const uint32_t counts[] = {1, 2, 7, EOS_JOB_RING_SIZE, 2 * EOS_JOB_RING_SIZE + 1, 1000};
+	for (uint32_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+	{
+		clear_marks(&test->primary_marks[0]);
+		if (EOS_JobRun(JOB_MARK, &test->primary_marks[0], counts[i]) != EOS_OK)
+		{
+			test->errors++;
+		}
+		check_marks(&test->primary_marks[0], counts[i]);
+	}
+
+	//nested
+	clear_marks(&test->primary_marks[0]);
+	clear_marks(&test->primary_marks[1]);
+	EOS_job_group_id_t first = EOS_JobFork(JOB_MARK, &test->primary_marks[0], 300);
+	EOS_job_group_id_t second = EOS_JobFork(JOB_MARK, &test->primary_marks[1], 200);
+	if (first == NULL || second == NULL)
+	{
+		test->errors++;
+	}
+	else
+	{
+		EOS_JobJoin(second);
+		EOS_JobJoin(first);
+		check_marks(&test->primary_marks[0], 300);
+		check_marks(&test->primary_marks[1], 200);
+	}
+
+	EOS_job_group_id_t groups[EOS_JOB_GROUPS];
+	clear_marks(&test->primary_marks[0]);
+	for (uint32_t i = 0; i < EOS_JOB_GROUPS; i++)
+	{
+		groups[i] = EOS_JobFork(JOB_MARK, &test->primary_marks[0], 1);
+	}
+	if (EOS_JobFork(JOB_MARK, &test->primary_marks[0], 1) != NULL)
+	{
+		test->errors++;
+	}
+	for (uint32_t i = 0; i < EOS_JOB_GROUPS; i++)
+	{
+		if (groups[i] == NULL)
+		{
+			test->errors++;
+			continue;
+		}
+		EOS_JobJoin(groups[i]);
+	}
+	if (test->primary_marks[0].marks[0] != EOS_JOB_GROUPS)
+	{
+		test->errors++;
+	}
+
+	//errors
+	if (EOS_JobFork(EOS_JOB_KERNELS, NULL, 1) != NULL || EOS_JobFork(JOB_MARK + 1, NULL, 1) != NULL ||
+			EOS_JobFork(JOB_MARK, &test->primary_marks[0], 0) != NULL || EOS_JobRegister(0, NULL) != EOS_ERROR)
+	{
+		test->errors++;
+	}
+
+	//fir, in one task, then forked
+	uint32_t start = EOS_GetCycles();
+	for (uint32_t pass = 0; pass < JOB_PASSES; pass++)
+	{
+		for (uint32_t chunk = 0; chunk < JOB_SAMPLES / JOB_BLOCK; chunk++)
+		{
+			fir_block(test, chunk);
+		}
+	}
+	serial_ns = EOS_GetCycles() - start;
+	memcpy(test->serial, test->parallel, sizeof(test->serial));
+	memset(test->parallel, 0, sizeof(test->parallel));
+
+	start = EOS_GetCycles();
+	for (uint32_t pass = 0; pass < JOB_PASSES; pass++)
+	{
+		if (EOS_JobRun(JOB_FIR, test, JOB_SAMPLES / JOB_BLOCK) != EOS_OK)
+		{
+			test->errors++;
+		}
+	}
+	parallel_ns = EOS_GetCycles() - start;
+
+	if (memcmp(test->serial, test->parallel, sizeof(test->serial)) != 0)
+	{
+		test->errors++;
+	}
+
+	client_done = 1;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Waits for every check to finish on both cores, prints the summary, and ends both processes.
+ */
+static void report_task(void){
+
+	while (client_done == 0 || test->reverse_done == 0)
+	{
+		EOS_Delay(10);
+	}
+
+	printf("{\"job\":\"summary\",\"rounds\":%u,\"chunks\":{\"primary\":%u,\"secondary\":%u},\"serial_us\":%u,"
+			"\"parallel_us\":%u,\"speedup\":%.2f,\"errors\":%u}\n",
+			(unsigned int)rounds, (unsigned int)test->chunks[EOS_CORE_PRIMARY],
+			(unsigned int)test->chunks[EOS_CORE_SECONDARY], (unsigned int)(serial_ns / 1000),
+			(unsigned int)(parallel_ns / 1000), parallel_ns ? (double)serial_ns / parallel_ns : 0.0,
+			(unsigned int)test->errors);
+	fflush(stdout);
+
+	exit(test->errors == 0 ? 0 : 1);
+}
+
+
+static void primary_main(pid_t secondary){
+
+	EOS_PosixSetPeer(secondary);
+	EOS_DualCoreInit(EOS_CORE_PRIMARY, shared);
+
+	if (EOS_JobInit(EOS_CORE_PRIMARY, jobs, PRIORITY_MEDIUM) != EOS_OK)
+	{
+		fprintf(stderr, "eos_job: could not set up the primary core\n");
+		exit(1);
+	}
+	register_kernels();
+
+	EOS_ThreadNew(client_task, PRIORITY_MEDIUM, NULL, JOB_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(report_task, PRIORITY_LOW, NULL, JOB_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+}
+
+
+
+/*	SECONDARY CORE	*/
+
+
+/**
+ * @brief Runs rounds "mark" forks of its own, while the primary core forks to this one.
+ */
+static void reverse_task(void){
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		clear_marks(&test->secondary_marks);
+		if (EOS_JobRun(JOB_MARK, &test->secondary_marks, JOB_REVERSE_CHUNKS) != EOS_OK)
+		{
+			test->errors++;
+		}
+		check_marks(&test->secondary_marks, JOB_REVERSE_CHUNKS);
+	}
+
+	test->reverse_done = 1;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+static void secondary_main(pid_t primary){
+
+	prctl(PR_SET_PDEATHSIG, SIGTERM);
+	EOS_PosixSetPeer(primary);
+	EOS_DualCoreInit(EOS_CORE_SECONDARY, shared);
+	core = EOS_CORE_SECONDARY;
+
+	//waits for the primary core to set up the shared memory
+	if (EOS_JobInit(EOS_CORE_SECONDARY, jobs, PRIORITY_MEDIUM) != EOS_OK)
+	{
+		fprintf(stderr, "eos_job: could not set up the secondary core\n");
+		exit(1);
+	}
+	register_kernels();
+	test->secondary_ready = 1;
+
+	EOS_ThreadNew(reverse_task, PRIORITY_MEDIUM, NULL, JOB_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+}
+
+
+
+int main(int argc, char** argv){
+
+	if (argc > 1)
+	{
+		rounds = (uint32_t)strtoul(argv[1], NULL, 0);
+	}
+
+	shared = mmap(NULL, sizeof(EOS_dual_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	jobs = mmap(NULL, sizeof(EOS_job_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	test = mmap(NULL, sizeof(job_test_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED || jobs == MAP_FAILED || test == MAP_FAILED)
+	{
+		perror("eos_job: mmap");
+		return 1;
+	}
+
+	srand(1);
+	for (uint32_t i = 0; i < JOB_SAMPLES + JOB_TAPS - 1; i++)
+	{
+		test->input[i] = (float)(rand() % 2001 - 1000) / 1000.0f;
+	}
+	for (uint32_t k = 0; k < JOB_TAPS; k++)
+	{
+		test->taps[k] = 1.0f / (float)(k + 1);
+	}
+
+	pid_t primary = getpid();
+	pid_t secondary = fork();
+
+	if (secondary < 0)
+	{
+		perror("eos_job: fork");
+		return 1;
+	}
+	if (secondary == 0)
+	{
+		secondary_main(primary);
+	}
+
+	primary_main(secondary);
+	return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * main_latency.c
+ *
+ *      Host entry point for the EvanRTOS latency test (EvanRTOS_bench/eos_latency.c).
+ *
+ *      	./eos_latency [seconds] [load]
+ *
+ *      seconds defaults to 10 (0 runs forever), and load is a comma separated list of cpu, queue and isr, or all
+ *      (the default) or none. The test timer is a CLOCK_MONOTONIC POSIX timer raising the port's user interrupt
+ *      signal, and the cycles since it expired are read back with timer_gettime(), the way the counter of a hardware
+ *      timer would be. The interrupt flood shares the same simulated interrupt. Cycle counts on this port are
+ *      nanoseconds of host time.
+ */
+
+
+/*	INCLUDES	*/
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "eos_latency.h"
+
+
+/*	GLOBAL VARIABLES	*/
+static timer_t host_timer;
+static uint64_t host_timer_start = 0;
+static uint64_t host_timer_period = 0;
+static uint64_t host_timer_last = 0;
+static volatile sig_atomic_t host_flood_pending = 0;
+
+
+static uint64_t EOS_HostNanoseconds(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+
+/**
+ * @brief Handler of the simulated user interrupt. Signals do not queue, so one interrupt may stand for both the flood
+ * 			and the timer. The timer is only counted once per expiry.
+ */
+static void EOS_HostIsr(void){
+
+	if (host_flood_pending)
+	{
+		host_flood_pending = 0;
+		EOS_LatencyFloodIsr();
+	}
+
+	if (host_timer_period != 0)
+	{
+		struct itimerspec remaining;
+		timer_gettime(host_timer, &remaining);
+
+		uint64_t left = (uint64_t)remaining.it_value.tv_sec * 1000000000u + (uint64_t)remaining.it_value.tv_nsec;
+		uint64_t elapsed = host_timer_period - left;
+		uint64_t expiry = (EOS_HostNanoseconds() - elapsed - host_timer_start + host_timer_period / 2) / host_timer_period;
+
+		if (expiry != host_timer_last)
+		{
+			host_timer_last = expiry;
+			EOS_LatencyIsr((uint32_t)elapsed);
+		}
+	}
+}
+
+
+uint8_t EOS_LatencyTimerStart(uint32_t period_us){
+
+	struct sigevent event;
+	memset(&event, 0, sizeof(event));
+	event.sigev_notify = SIGEV_SIGNAL;
+	event.sigev_signo = SIGUSR1;
+
+	if (timer_create(CLOCK_MONOTONIC, &event, &host_timer) != 0)
+	{
+		return 0;
+	}
+
+	struct itimerspec period = {
+			.it_interval = {0, (long)period_us * 1000},
+			.it_value = {0, (long)period_us * 1000}
+	};
+
+	host_timer_period = (uint64_t)period_us * 1000u;
+	host_timer_start = EOS_HostNanoseconds();
+	timer_settime(host_timer, 0, &period, NULL);
+	return 1;
+}
+
+
+uint8_t EOS_LatencyTriggerFlood(void){
+	host_flood_pending = 1;
+	EOS_PosixTriggerIsr();
+	return 1;
+}
+
+
+void EOS_LatencyComplete(void){
+	exit(0);
+}
+
+
+static uint32_t EOS_HostParseLoad(const char* text){
+
+	uint32_t load = EOS_LATENCY_LOAD_NONE;
+	char buffer[64];
+
+	strncpy(buffer, text, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = '\0';
+
+	for (char* name = strtok(buffer, ","); name != NULL; name = strtok(NULL, ","))
+	{
+		if (strcmp(name, "cpu") == 0)
+		{
+			load |= EOS_LATENCY_LOAD_CPU;
+		}
+		else if (strcmp(name, "queue") == 0)
+		{
+			load |= EOS_LATENCY_LOAD_QUEUE;
+		}
+		else if (strcmp(name, "isr") == 0)
+		{
+			load |= EOS_LATENCY_LOAD_ISR;
+		}
+		else if (strcmp(name, "all") == 0)
+		{
+			load |= EOS_LATENCY_LOAD_ALL;
+		}
+		else if (strcmp(name, "none") != 0)
+		{
+			fprintf(stderr, "unknown load '%s' (cpu, queue, isr, all or none)\n", name);
+			exit(1);
+		}
+	}
+	return load;
+}
+
+
+int main(int argc, char** argv){
+
+	uint32_t seconds = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 10;
+	uint32_t load = (argc > 2) ? EOS_HostParseLoad(argv[2]) : EOS_LATENCY_LOAD_ALL;
+
+	EOS_PosixSetIsr(EOS_HostIsr);
+	EOS_LatencyInit(seconds, load); //does not return
+	return 0;
+}
@@ -0,0 +1,397 @@
+/*
+ * main_rpc.c
+ *
+ *      Host stand-in for the inter-core RPC (eos_rpc.c), with two processes as the two cores, as in main_dual.c. The
+ *      secondary core plays the compute core and serves "scale", the primary core plays the I/O core and serves "sum".
+ *
+ *      ./eos_rpc [rounds]
+ *
+ *      Runs these checks, then prints a JSON summary, and exits with status 0 if all passed:
+ *      	- call: a task on the primary core calls "scale" rounds times with EOS_RpcCall(), checks each response, and
+ *      	  times the round trips
+ *      	- batch: the same task makes rounds calls again, RPC_BATCH at a time, first as single calls, then as one
+ *      	  EOS_RpcCallBatch(), and compares the time per call
+ *      	- async: it starts RPC_BATCH calls with EOS_RpcCallAsync(), polls one, then waits on them in reverse order
+ *      	- reverse: meanwhile a task on the secondary core calls "sum" on the primary core rounds times, so both
+ *      	  service tasks handle requests and responses at once
+ *      	- errors: calls to an unknown endpoint, an oversized request, and a duplicate name must all be refused
+ */
+
+
+/*	INCLUDES	*/
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+#include "eos_kernel.h"
+#include "eos_dual_core.h"
+#include "eos_rpc.h"
+
+
+/*	CONSTANTS	*/
+#define RPC_BATCH 8
+#define RPC_WORDS 8			//uint32_t per request
+#define RPC_STACK 256
+
+
+/*	DATATYPES	*/
+
+/* Test state both processes see, next to the kernel's shared memory */
+typedef struct {
+	volatile uint32_t reverse_done;
+	volatile uint32_t errors;
+} rpc_test_t;
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_dual_shared_t* shared = NULL;
+static EOS_rpc_shared_t* rpc = NULL;
+static rpc_test_t* test = NULL;
+static uint32_t rounds = 2000;
+
+static uint32_t client_done = 0;
+static uint32_t rtt_min = 0xFFFFFFFFu;
+static uint32_t rtt_max = 0;
+static uint64_t rtt_total = 0;
+static uint64_t single_ns = 0;
+static uint64_t batch_ns = 0;
+
+
+
+/*	BOTH CORES	*/
+
+
+/**
+ * @brief Fills a request with words counting up from seed.
+ */
+static void fill(uint32_t* words, uint32_t seed){
+
+	for (uint32_t i = 0; i < RPC_WORDS; i++)
+	{
+		words[i] = seed + i;
+	}
+}
+
+
+/**
+ * @brief Looks up an endpoint, waiting until the other core has registered it.
+ */
+static EOS_rpc_endpoint_t lookup(const char* name){
+
+	EOS_rpc_endpoint_t endpoint;
+
+	while ((endpoint = EOS_RpcLookup(name)) == EOS_RPC_NO_ENDPOINT)
+	{
+		EOS_Delay(1);
+	}
+	return endpoint;
+}
+
+
+
+/*	PRIMARY CORE	*/
+
+
+/**
+ * @brief "sum": replaces the request words with their sum.
+ */
+static uint32_t sum_handler(void* message, uint32_t size){
+
+	uint32_t* words = message;
+	uint32_t sum = 0;
+
+	for (uint32_t i = 0; i < size / sizeof(uint32_t); i++)
+	{
+		sum += words[i];
+	}
+	words[0] = sum;
+	return sizeof(uint32_t);
+}
+
+
+/**
+ * @brief Checks a "scale" response against its request seed.
+ */
+static void check_scaled(const uint32_t* words, uint32_t size, uint32_t seed){
+
+	if (size != RPC_WORDS * sizeof(uint32_t))
+	{
+		test->errors++;
+		return;
+	}
+	for (uint32_t i = 0; i < RPC_WORDS; i++)
+	{
+		if (words[i] != (seed + i) * 3 + 1)
+		{
+			test->errors++;
+			return;
+		}
+	}
+}
+
+
+/**
+ * @brief Runs the call, batch, async and error checks against "scale", on the other core.
+ */
+static void client_task(void){
+
+	EOS_rpc_endpoint_t scale = lookup("scale");
+	uint32_t request[RPC_WORDS];
+	uint32_t response[RPC_WORDS];
+	uint32_t size;
+
+	//call
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		fill(request, i);
+		size = sizeof(response);
+
+		uint32_t start = EOS_GetCycles();
+		EOS_status_t status = EOS_RpcCall(scale, request, sizeof(request), response, &size);
+		uint32_t elapsed = EOS_GetCycles() - start;
+
+		rtt_total += elapsed;
+		rtt_min = (elapsed < rtt_min) ? elapsed : rtt_min;
+		rtt_max = (elapsed > rtt_max) ? elapsed : rtt_max;
+		if (status != EOS_OK)
+		{
+			test->errors++;
+		}
+		check_scaled(response, size, i);
+	}
+
+	//batch, against single calls
+	static uint32_t requests[RPC_BATCH][RPC_WORDS];
+	EOS_rpc_request_t batch[RPC_BATCH];
+	EOS_rpc_handle_t handles[RPC_BATCH];
+
+	for (uint32_t i = 0; i < RPC_BATCH; i++)
+	{
+		fill(requests[i], i * 100);
+		batch[i] = (EOS_rpc_request_t){scale, requests[i], sizeof(requests[i])};
+	}
+
+	uint32_t start = EOS_GetCycles();
+	for (uint32_t i = 0; i < rounds / RPC_BATCH; i++)
+	{
+		for (uint32_t j = 0; j < RPC_BATCH; j++)
+		{
+			size = sizeof(response);
+			if (EOS_RpcCall(scale, requests[j], sizeof(requests[j]), response, &size) != EOS_OK)
+			{
+				test->errors++;
+			}
+		}
+	}
+	single_ns = EOS_GetCycles() - start;
+
+	start = EOS_GetCycles();
+	for (uint32_t i = 0; i < rounds / RPC_BATCH; i++)
+	{
+		if (EOS_RpcCallBatch(batch, RPC_BATCH, handles) != EOS_OK)
+		{
+			test->errors++;
+			continue;
+		}
+		for (uint32_t j = 0; j < RPC_BATCH; j++)
+		{
+			size = sizeof(response);
+			if (EOS_RpcWait(handles[j], response, &size) != EOS_OK)
+			{
+				test->errors++;
+			}
+			check_scaled(response, size, j * 100);
+		}
+	}
+	batch_ns = EOS_GetCycles() - start;
+
+	//async, waited on in reverse
+	for (uint32_t i = 0; i < RPC_BATCH; i++)
+	{
+		handles[i] = EOS_RpcCallAsync(scale, requests[i], sizeof(requests[i]));
+		if (handles[i] == NULL)
+		{
+			test->errors++;
+		}
+	}
+	while (EOS_RpcPoll(handles[0]) != EOS_OK)
+	{
+		EOS_Delay(1);
+	}
+	for (uint32_t i = RPC_BATCH; i-- > 0;)
+	{
+		size = sizeof(response);
+		if (handles[i] != NULL)
+		{
+			EOS_RpcWait(handles[i], response, &size);
+			check_scaled(response, size, i * 100);
+		}
+	}
+
+	//errors
+	uint8_t large[EOS_RPC_MESSAGE_SIZE + 1] = {0};
+	size = sizeof(response);
+	if (EOS_RpcLookup("missing") != EOS_RPC_NO_ENDPOINT || EOS_RpcCallAsync(EOS_RPC_ENDPOINTS, request, 4) != NULL ||
+			EOS_RpcCall(scale, large, sizeof(large), response, &size) != EOS_ERROR ||
+			EOS_RpcRegister("scale", sum_handler) != EOS_ERROR)
+	{
+		test->errors++;
+	}
+
+	client_done = 1;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Waits for every check to finish on both cores, prints the summary, and ends both processes.
+ */
+static void report_task(void){
+
+	while (client_done == 0 || test->reverse_done == 0)
+	{
+		EOS_Delay(10);
+	}
+
+	uint32_t calls = (rounds / RPC_BATCH) * RPC_BATCH;
+	calls = calls ? calls : 1;
+
+	printf("{\"rpc\":\"summary\",\"rounds\":%u,\"round_trip_ns\":{\"min\":%u,\"avg\":%u,\"max\":%u},"
+			"\"single_ns_per_call\":%u,\"batch_ns_per_call\":%u,\"errors\":%u}\n",
+			(unsigned int)rounds, (unsigned int)rtt_min, (unsigned int)(rtt_total / rounds), (unsigned int)rtt_max,
+			(unsigned int)(single_ns / calls), (unsigned int)(batch_ns / calls), (unsigned int)test->errors);
+	fflush(stdout);
+
+	exit(test->errors == 0 ? 0 : 1);
+}
+
+
+static void primary_main(pid_t secondary){
+
+	EOS_PosixSetPeer(secondary);
+	EOS_DualCoreInit(EOS_CORE_PRIMARY, shared);
+
+	if (EOS_RpcInit(EOS_CORE_PRIMARY, rpc, PRIORITY_HIGH) != EOS_OK || EOS_RpcRegister("sum", sum_handler) != EOS_OK)
+	{
+		fprintf(stderr, "eos_rpc: could not set up the primary core\n");
+		exit(1);
+	}
+
+	EOS_ThreadNew(client_task, PRIORITY_MEDIUM, NULL, RPC_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(report_task, PRIORITY_LOW, NULL, RPC_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+}
+
+
+
+/*	SECONDARY CORE	*/
+
+
+/**
+ * @brief "scale": replaces each request word w with w * 3 + 1.
+ */
+static uint32_t scale_handler(void* message, uint32_t size){
+
+	uint32_t* words = message;
+
+	for (uint32_t i = 0; i < size / sizeof(uint32_t); i++)
+	{
+		words[i] = words[i] * 3 + 1;
+	}
+	return size;
+}
+
+
+/**
+ * @brief Calls "sum" on the other core rounds times, while it calls this core's "scale".
+ */
+static void reverse_task(void){
+
+	EOS_rpc_endpoint_t sum = lookup("sum");
+	uint32_t request[RPC_WORDS];
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		uint32_t response = 0;
+		uint32_t size = sizeof(response);
+
+		fill(request, i);
+		if (EOS_RpcCall(sum, request, sizeof(request), &response, &size) != EOS_OK || size != sizeof(response) ||
+				response != RPC_WORDS * i + RPC_WORDS * (RPC_WORDS - 1) / 2)
+		{
+			test->errors++;
+		}
+	}
+
+	test->reverse_done = 1;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+static void secondary_main(pid_t primary){
+
+	prctl(PR_SET_PDEATHSIG, SIGTERM);
+	EOS_PosixSetPeer(primary);
+	EOS_DualCoreInit(EOS_CORE_SECONDARY, shared);
+
+	//waits for the primary core to set up the shared memory
+	if (EOS_RpcInit(EOS_CORE_SECONDARY, rpc, PRIORITY_HIGH) != EOS_OK ||
+			EOS_RpcRegister("scale", scale_handler) != EOS_OK)
+	{
+		fprintf(stderr, "eos_rpc: could not set up the secondary core\n");
+		exit(1);
+	}
+
+	EOS_ThreadNew(reverse_task, PRIORITY_MEDIUM, NULL, RPC_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+}
+
+
+
+int main(int argc, char** argv){
+
+	if (argc > 1)
+	{
+		rounds = (uint32_t)strtoul(argv[1], NULL, 0);
+	}
+	if (rounds == 0)
+	{
+		rounds = 1;
+	}
+
+	shared = mmap(NULL, sizeof(EOS_dual_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	rpc = mmap(NULL, sizeof(EOS_rpc_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	test = mmap(NULL, sizeof(rpc_test_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED || rpc == MAP_FAILED || test == MAP_FAILED)
+	{
+		perror("eos_rpc: mmap");
+		return 1;
+	}
+
+	pid_t primary = getpid();
+	pid_t secondary = fork();
+
+	if (secondary < 0)
+	{
+		perror("eos_rpc: fork");
+		return 1;
+	}
+	if (secondary == 0)
+	{
+		secondary_main(primary);
+	}
+
+	primary_main(secondary);
+	return 0;
+}
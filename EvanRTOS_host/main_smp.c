@@ -0,0 +1,328 @@
+/*
+ * main_smp.c
+ *
+ *      Host checks of the SMP scheduler (eos_smp.c), on the POSIX_SMP port, where EOS_SMP_CORES pthreads play the
+ *      cores of a single kernel instance.
+ *
+ *      ./eos_smp [rounds]
+ *
+ *      Runs these checks at once, then prints a JSON summary with the scheduler counters of every core, and exits with
+ *      status 0 if all passed:
+ *      	- mutual exclusion: two tasks per core increment a shared counter, each SMP_COUNT times, under a semaphore,
+ *      	  delaying while holding it now and then. No increment may be lost
+ *      	- queue: two producers put rounds numbered items each into a 4 item queue, and two consumers take rounds
+ *      	  items each. Every item must arrive once, and each consumer must see each producer's items in order
+ *      	- ping-pong: two high priority tasks hand two semaphores back and forth rounds times, timing the round trips
+ *      	- stealing: three low priority workers per core do unequal amounts of busy work. Cores whose workers finish
+ *      	  first go idle, and must steal the others' remaining workers
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "eos_kernel.h"
+#include "eos_semaphore.h"
+#include "eos_queue.h"
+#include "eos_smp.h"
+
+
+/*	CONSTANTS	*/
+#define SMP_COUNT 200		//increments per counter task
+#define SMP_PRODUCERS 2
+#define SMP_CONSUMERS 2
+#define SMP_WORKERS (3 * EOS_SMP_CORES)
+#define SMP_WORK 2000000	//busy loop iterations per unit of work
+#define SMP_STACK 128
+
+
+/*	GLOBAL VARIABLES	*/
+static uint32_t rounds = 2000;
+
+static EOS_semaphore_id_t counter_semaphore;
+static EOS_semaphore_id_t ping_semaphore;
+static EOS_semaphore_id_t pong_semaphore;
+static EOS_queue_id_t item_queue;
+
+static volatile uint32_t counter = 0;
+static volatile uint32_t counters_done = 0;
+static volatile uint32_t consumers_done = 0;
+static volatile uint32_t items_taken = 0;
+static volatile uint64_t items_sum = 0;
+static volatile uint32_t ping_done = 0;
+static volatile uint32_t workers_done = 0;
+static volatile uint32_t errors = 0;
+
+static uint32_t rtt_min = 0xFFFFFFFFu;
+static uint32_t rtt_max = 0;
+static uint64_t rtt_total = 0;
+static uint32_t work_start = 0;
+static uint32_t work_ns = 0;
+
+
+
+/*	TASKS	*/
+
+
+/**
+ * @brief Increments the shared counter SMP_COUNT times under the semaphore. Every eighth time, it holds the semaphore
+ * 			over a tick, so the other counter tasks, on every core, block on it.
+ */
+static void counter_task(void){
+
+	for (uint32_t i = 0; i < SMP_COUNT; i++)
+	{
+		EOS_SemaphoreAcquire(counter_semaphore);
+		uint32_t value = counter;
+
+		if ((i & 7) == 0)
+		{
+			EOS_Delay(1);
+		}
+
+		counter = value + 1;
+		EOS_SemaphoreRelease(counter_semaphore);
+	}
+
+	__atomic_add_fetch(&counters_done, 1, __ATOMIC_SEQ_CST);
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Puts rounds items, numbered by producer in the top byte and by sequence below.
+ */
+static void producer_task(void){
+
+	static uint32_t next_producer = 0;
+	uint32_t producer = __atomic_fetch_add(&next_producer, 1, __ATOMIC_SEQ_CST);
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		uint32_t item = (producer << 24) | i;
+		EOS_QueuePut(item_queue, &item, EOS_BLOCK);
+	}
+
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Takes its share of the items, checking that each producer's arrive in order.
+ */
+static void consumer_task(void){
+
+	int32_t last[SMP_PRODUCERS];
+	for (uint32_t i = 0; i < SMP_PRODUCERS; i++)
+	{
+		last[i] = -1;
+	}
+
+	for (uint32_t i = 0; i < SMP_PRODUCERS * rounds / SMP_CONSUMERS; i++)
+	{
+		uint32_t item = 0;
+		EOS_QueueGet(item_queue, &item, EOS_BLOCK);
+
+		uint32_t producer = item >> 24;
+		int32_t sequence = (int32_t)(item & 0xFFFFFF);
+		if (producer >= SMP_PRODUCERS || sequence <= last[producer])
+		{
+			__atomic_add_fetch(&errors, 1, __ATOMIC_SEQ_CST);
+		}
+		else
+		{
+			last[producer] = sequence;
+		}
+
+		__atomic_add_fetch(&items_sum, sequence, __ATOMIC_SEQ_CST);
+		__atomic_add_fetch(&items_taken, 1, __ATOMIC_SEQ_CST);
+	}
+
+	__atomic_add_fetch(&consumers_done, 1, __ATOMIC_SEQ_CST);
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Gives the ping semaphore and waits for the pong, rounds times, timing each round trip.
+ */
+static void ping_task(void){
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		uint32_t start = EOS_GetCycles();
+
+		EOS_SemaphoreRelease(ping_semaphore);
+		EOS_SemaphoreAcquire(pong_semaphore);
+
+		uint32_t elapsed = EOS_GetCycles() - start;
+		rtt_total += elapsed;
+		rtt_min = (elapsed < rtt_min) ? elapsed : rtt_min;
+		rtt_max = (elapsed > rtt_max) ? elapsed : rtt_max;
+	}
+
+	ping_done = 1;
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Answers each ping with a pong.
+ */
+static void pong_task(void){
+
+	while (1)
+	{
+		EOS_SemaphoreAcquire(ping_semaphore);
+		EOS_SemaphoreRelease(pong_semaphore);
+	}
+}
+
+
+/**
+ * @brief Does 1, 2 or 3 units of busy work, so some cores run out of work before others.
+ */
+static void worker_task(void){
+
+	static uint32_t next_worker = 0;
+	uint32_t worker = __atomic_fetch_add(&next_worker, 1, __ATOMIC_SEQ_CST);
+	uint32_t units = worker % 3 + 1;
+	volatile uint32_t sink = 0;
+
+	if (worker == 0)
+	{
+		work_start = EOS_GetCycles();
+	}
+
+	for (uint32_t i = 0; i < units * SMP_WORK; i++)
+	{
+		sink += i;
+	}
+
+	if (__atomic_add_fetch(&workers_done, 1, __ATOMIC_SEQ_CST) == SMP_WORKERS)
+	{
+		work_ns = EOS_GetCycles() - work_start;
+	}
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Waits for every check to finish, prints the summary, and ends the process.
+ */
+static void report_task(void){
+
+	while (counters_done < 2 * EOS_SMP_CORES || consumers_done < SMP_CONSUMERS || ping_done == 0 ||
+			workers_done < SMP_WORKERS)
+	{
+		EOS_Delay(10);
+	}
+
+	uint32_t expected = 2 * EOS_SMP_CORES * SMP_COUNT;
+	uint64_t expected_sum = (uint64_t)SMP_PRODUCERS * rounds * (rounds - 1) / 2;
+	if (counter != expected || items_taken != SMP_PRODUCERS * rounds || items_sum != expected_sum)
+	{
+		errors++;
+	}
+
+	EOS_smp_stats_t total = {0};
+	printf("{\"smp\":\"cores\",\"cores\":[");
+	for (uint32_t core = 0; core < EOS_SMP_CORES; core++)
+	{
+		EOS_smp_stats_t stats;
+		EOS_SmpStats(core, &stats);
+
+		printf("%s{\"switches\":%u,\"steals\":%u,\"migrations\":%u,\"ipis\":%u,\"tasks\":%u}", core ? "," : "",
+				(unsigned int)stats.switches, (unsigned int)stats.steals, (unsigned int)stats.migrations,
+				(unsigned int)stats.ipis, (unsigned int)stats.tasks);
+		total.switches += stats.switches;
+		total.steals += stats.steals;
+		total.migrations += stats.migrations;
+		total.ipis += stats.ipis;
+	}
+	printf("]}\n");
+
+	if (total.steals == 0 || total.ipis == 0)
+	{
+		errors++;
+	}
+
+	printf("{\"smp\":\"summary\",\"cores\":%u,\"rounds\":%u,\"counter\":%u,\"expected\":%u,\"items\":%u,"
+			"\"round_trip_ns\":{\"min\":%u,\"avg\":%u,\"max\":%u},\"work_ms\":%u,\"switches\":%u,\"steals\":%u,"
+			"\"migrations\":%u,\"ipis\":%u,\"errors\":%u}\n",
+			(unsigned int)EOS_SMP_CORES, (unsigned int)rounds, (unsigned int)counter, (unsigned int)expected,
+			(unsigned int)items_taken, (unsigned int)rtt_min, (unsigned int)(rtt_total / rounds),
+			(unsigned int)rtt_max, (unsigned int)(work_ns / 1000000), (unsigned int)total.switches,
+			(unsigned int)total.steals, (unsigned int)total.migrations, (unsigned int)total.ipis,
+			(unsigned int)errors);
+	fflush(stdout);
+
+	exit(errors == 0 ? 0 : 1);
+}
+
+
+
+int main(int argc, char** argv){
+
+	if (argc > 1)
+	{
+		rounds = (uint32_t)strtoul(argv[1], NULL, 0);
+	}
+	if (rounds == 0)
+	{
+		rounds = 1;
+	}
+
+	counter_semaphore = EOS_SemaphoreNew(1);
+	ping_semaphore = EOS_SemaphoreNew(1);
+	pong_semaphore = EOS_SemaphoreNew(1);
+	item_queue = EOS_QueueCreate(4, sizeof(uint32_t));
+	if (counter_semaphore == NULL || ping_semaphore == NULL || pong_semaphore == NULL || item_queue == NULL)
+	{
+		fprintf(stderr, "eos_smp: could not create the kernel objects\n");
+		return 1;
+	}
+
+	//ping and pong start taken
+	EOS_SemaphoreAcquire(ping_semaphore);
+	EOS_SemaphoreAcquire(pong_semaphore);
+
+	EOS_ThreadNew(ping_task, PRIORITY_HIGH, NULL, SMP_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(pong_task, PRIORITY_HIGH, NULL, SMP_STACK, EOS_NO_FPU);
+	for (uint32_t i = 0; i < 2 * EOS_SMP_CORES; i++)
+	{
+		EOS_ThreadNew(counter_task, (i & 1) ? PRIORITY_MEDIUM : PRIORITY_LOW, NULL, SMP_STACK, EOS_NO_FPU);
+	}
+	for (uint32_t i = 0; i < SMP_PRODUCERS; i++)
+	{
+		EOS_ThreadNew(producer_task, PRIORITY_MEDIUM, NULL, SMP_STACK, EOS_NO_FPU);
+	}
+	for (uint32_t i = 0; i < SMP_CONSUMERS; i++)
+	{
+		EOS_ThreadNew(consumer_task, PRIORITY_MEDIUM, NULL, SMP_STACK, EOS_NO_FPU);
+	}
+	for (uint32_t i = 0; i < SMP_WORKERS; i++)
+	{
+		EOS_ThreadNew(worker_task, PRIORITY_LOW, NULL, SMP_STACK, EOS_NO_FPU);
+	}
+	EOS_ThreadNew(report_task, PRIORITY_LOW, NULL, SMP_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+	return 0;
+}
@@ -0,0 +1,440 @@
+/*
+ * main_uart.c
+ *
+ *      Host checks of the DMA UART driver (eos_uart.c), on the POSIX port's stand-in backend. UART 0 is the slave end
+ *      of a pty, and a child process on the master end loops everything back, as a cable from TX to RX would.
+ *
+ *      ./eos_uart [rounds]
+ *
+ *      Runs these checks, then prints a JSON summary with the driver's counters, and exits with status 0 if all passed:
+ *      	- messages: UART_WRITERS tasks send rounds framed messages each, of 1 to UART_PAYLOAD bytes, two with
+ *      	  EOS_UartWrite() and one with two buffers in flight at once (EOS_UartSend()/EOS_UartWait()). The reading
+ *      	  task must get every message back whole, each writer's in order, with nothing lost
+ *      	- idle line: a task sends UART_PROBES short probes, a few ms apart, stamped with the time. Each is shorter
+ *      	  than half the receive buffer, so only the idle line interrupt brings it to the reader, which times it
+ *      	- bulk: one buffer of UART_BULK bytes, longer than one DMA transfer, timed from send to the last byte read
+ *      	- errors: calls on a UART out of range, and a second EOS_UartInit(), must be refused
+ *
+ *      The receive interrupts must come per half buffer or burst, not per byte: bytes_per_event in the summary shows
+ *      how much each moved. The stand-in line runs at EOS_POSIX_UART_BAUD, 200KB/s by default, which bulk_kb_s should
+ *      come close to, and the idle line takes 1ms to detect.
+ */
+
+
+/*	INCLUDES	*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE //posix_openpt() and cfmakeraw()
+#endif
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "eos_kernel.h"
+#include "eos_uart.h"
+
+
+/*	CONSTANTS	*/
+#define UART_WRITERS 3
+#define UART_PAYLOAD 120		//most payload bytes of a message
+#define UART_PROBES 50
+#define UART_BULK 100000
+#define UART_STACK 256
+
+/* First byte of each frame */
+#define UART_MESSAGE 0xA5		//writer, sequence (2 bytes), length (2 bytes), payload
+#define UART_PROBE 0x5A			//send time (4 bytes)
+#define UART_BULK_FRAME 0xB5	//length (4 bytes), payload
+
+
+/*	GLOBAL VARIABLES	*/
+static uint32_t rounds = 500;
+
+static volatile uint32_t messages_received = 0;
+static volatile uint32_t probes_received = 0;
+static volatile uint32_t bulk_received = 0;
+static volatile uint32_t errors = 0;
+static uint32_t next_sequence[UART_WRITERS];
+
+static uint32_t probe_min = 0xFFFFFFFFu;
+static uint32_t probe_max = 0;
+static uint64_t probe_total = 0;
+static uint32_t bulk_start = 0;
+static uint32_t bulk_ns = 0;
+
+static uint8_t bulk_buffer[UART_BULK + 5];
+
+
+
+/*	FRAMES	*/
+
+
+/**
+ * @brief Payload byte i of a writer's message.
+ */
+static uint8_t payload(uint32_t writer, uint32_t sequence, uint32_t i){
+	return (uint8_t)(writer * 31 + sequence + i * 7);
+}
+
+
+/**
+ * @brief Payload length of a writer's message, from 1 to UART_PAYLOAD.
+ */
+static uint32_t payload_length(uint32_t writer, uint32_t sequence){
+	return (sequence * 37 + writer * 11) % UART_PAYLOAD + 1;
+}
+
+
+/**
+ * @brief Builds a writer's message, returning its length.
+ */
+static uint32_t build_message(uint8_t* frame, uint32_t writer, uint32_t sequence){
+
+	uint32_t length = payload_length(writer, sequence);
+
+	frame[0] = UART_MESSAGE;
+	frame[1] = (uint8_t)writer;
+	frame[2] = (uint8_t)sequence;
+	frame[3] = (uint8_t)(sequence >> 8);
+	frame[4] = (uint8_t)length;
+	frame[5] = (uint8_t)(length >> 8);
+	for (uint32_t i = 0; i < length; i++)
+	{
+		frame[6 + i] = payload(writer, sequence, i);
+	}
+	return 6 + length;
+}
+
+
+
+/*	TASKS	*/
+
+
+/**
+ * @brief Sends rounds messages. Writers 0 and 1 wait for each with EOS_UartWrite(), the last writer keeps two
+ * 			buffers queued, building one while the DMA sends the other.
+ */
+static void writer_task(void){
+
+	static uint32_t next_writer = 0;
+	uint32_t writer = next_writer++;
+	static uint8_t frames[UART_WRITERS][2][6 + UART_PAYLOAD];
+
+	if (writer < UART_WRITERS - 1)
+	{
+		for (uint32_t i = 0; i < rounds; i++)
+		{
+			uint32_t length = build_message(frames[writer][0], writer, i);
+			if (EOS_UartWrite(0, frames[writer][0], length) != EOS_OK)
+			{
+				errors++;
+			}
+		}
+	}
+	else
+	{
+		EOS_uart_tx_t requests[2];
+
+		for (uint32_t i = 0; i < rounds; i++)
+		{
+			uint32_t buffer = i & 1;
+			if (i >= 2)
+			{
+				EOS_UartWait(&requests[buffer]);
+			}
+
+			uint32_t length = build_message(frames[writer][buffer], writer, i);
+			if (EOS_UartSend(0, &requests[buffer], frames[writer][buffer], length) != EOS_OK)
+			{
+				errors++;
+			}
+		}
+		EOS_UartWait(&requests[0]);
+		EOS_UartWait(&requests[1]);
+	}
+
+	while (1)
+	{
+		EOS_Delay(1000);
+	}
+}
+
+
+/**
+ * @brief Parses the looped back stream, a byte at a time, checking every frame.
+ */
+static void reader_task(void){
+
+	uint8_t chunk[256];
+	uint8_t header[6];
+	uint32_t have = 0;			//header bytes
+	uint32_t need = 0;			//header bytes of the current frame
+	uint32_t remaining = 0;		//payload bytes still to come
+	uint32_t position = 0;		//in the payload
+	uint32_t writer = 0;
+	uint32_t sequence = 0;
+
+	while (1)
+	{
+		uint32_t count = EOS_UartRead(0, chunk, sizeof(chunk), EOS_BLOCK);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint8_t byte = chunk[i];
+
+			if (remaining > 0)
+			{
+				uint8_t expected = (header[0] == UART_MESSAGE) ? payload(writer, sequence, position) :
+						(uint8_t)(position * 7);
+				if (byte != expected)
+				{
+					errors++;
+				}
+				position++;
+				remaining--;
+
+				if (remaining == 0 && header[0] == UART_BULK_FRAME)
+				{
+					bulk_ns = EOS_GetCycles() - bulk_start;
+					bulk_received = 1;
+				}
+				else if (remaining == 0)
+				{
+					messages_received++;
+				}
+				continue;
+			}
+
+			if (have == 0)
+			{
+				need = (byte == UART_MESSAGE) ? 6 : (byte == UART_PROBE || byte == UART_BULK_FRAME) ? 5 : 0;
+				if (need == 0)
+				{
+					errors++; //out of step: skip to the next byte
+					continue;
+				}
+			}
+
+			header[have++] = byte;
+			if (have < need)
+			{
+				continue;
+			}
+			have = 0;
+			position = 0;
+
+			if (header[0] == UART_MESSAGE)
+			{
+				writer = header[1];
+				sequence = header[2] | ((uint32_t)header[3] << 8);
+				remaining = header[4] | ((uint32_t)header[5] << 8);
+
+				if (writer >= UART_WRITERS || sequence != (next_sequence[writer] & 0xFFFF) ||
+						remaining != payload_length(writer, next_sequence[writer]))
+				{
+					errors++;
+				}
+				if (writer < UART_WRITERS)
+				{
+					next_sequence[writer]++;
+				}
+			}
+			else
+			{
+				uint32_t value = header[1] | ((uint32_t)header[2] << 8) | ((uint32_t)header[3] << 16) |
+						((uint32_t)header[4] << 24);
+
+				if (header[0] == UART_PROBE)
+				{
+					uint32_t latency = EOS_GetCycles() - value;
+					probe_total += latency;
+					probe_min = (latency < probe_min) ? latency : probe_min;
+					probe_max = (latency > probe_max) ? latency : probe_max;
+					probes_received++;
+				}
+				else
+				{
+					remaining = value;
+				}
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief Runs the idle line, bulk and error checks once the messages are back, prints the summary, and ends the
+ * 			process.
+ */
+static void control_task(void){
+
+	uint32_t expected = UART_WRITERS * rounds;
+	uint32_t waited = 0;
+
+	while (messages_received < expected && waited < 20000)
+	{
+		EOS_Delay(10);
+		waited += 10;
+	}
+
+	//idle line: each probe is 5 bytes, far from half the receive buffer
+	for (uint32_t i = 0; i < UART_PROBES; i++)
+	{
+		static uint8_t probe[5];
+		uint32_t now = EOS_GetCycles();
+
+		probe[0] = UART_PROBE;
+		memcpy(&probe[1], &now, sizeof(now));
+		EOS_UartWrite(0, probe, sizeof(probe));
+		EOS_Delay(3);
+	}
+	EOS_Delay(10);
+
+	//bulk: one buffer, sent in two DMA transfers
+	bulk_buffer[0] = UART_BULK_FRAME;
+	uint32_t length = UART_BULK;
+	memcpy(&bulk_buffer[1], &length, sizeof(length));
+	for (uint32_t i = 0; i < UART_BULK; i++)
+	{
+		bulk_buffer[5 + i] = (uint8_t)(i * 7);
+	}
+
+	EOS_uart_stats_t before;
+	EOS_UartStats(0, &before);
+	bulk_start = EOS_GetCycles();
+	EOS_UartWrite(0, bulk_buffer, sizeof(bulk_buffer));
+
+	waited = 0;
+	while (bulk_received == 0 && waited < 10000)
+	{
+		EOS_Delay(1);
+		waited++;
+	}
+
+	//errors
+	EOS_uart_stats_t stats;
+	uint8_t byte = 0;
+	if (EOS_UartWrite(EOS_UART_COUNT, &byte, 1) != EOS_ERROR || EOS_UartRead(EOS_UART_COUNT, &byte, 1, EOS_NO_BLOCK) != 0 ||
+			EOS_UartInit(0, EOS_POSIX_UART_FD(0)) != EOS_ERROR || EOS_UartStats(EOS_UART_COUNT, &stats) != EOS_ERROR)
+	{
+		errors++;
+	}
+
+	EOS_UartStats(0, &stats);
+	if (messages_received != expected || probes_received != UART_PROBES || bulk_received == 0 || stats.rx_lost != 0 ||
+			stats.errors != 0 || stats.tx_transfers - before.tx_transfers < 2 || stats.rx_bytes != stats.tx_bytes)
+	{
+		errors++;
+	}
+
+	uint32_t events = stats.rx_events ? stats.rx_events : 1;
+	uint32_t kb_s = bulk_ns ? (uint32_t)((uint64_t)UART_BULK * 1000000u / bulk_ns) : 0;
+
+	printf("{\"uart\":\"summary\",\"rounds\":%u,\"messages\":%u,\"tx_bytes\":%u,\"tx_buffers\":%u,\"tx_transfers\":%u,"
+			"\"rx_bytes\":%u,\"rx_events\":%u,\"bytes_per_event\":%u,\"rx_lost\":%u,"
+			"\"idle_latency_us\":{\"min\":%u,\"avg\":%u,\"max\":%u},\"bulk_kb_s\":%u,\"errors\":%u}\n",
+			(unsigned int)rounds, (unsigned int)messages_received, (unsigned int)stats.tx_bytes,
+			(unsigned int)stats.tx_buffers, (unsigned int)stats.tx_transfers, (unsigned int)stats.rx_bytes,
+			(unsigned int)stats.rx_events, (unsigned int)(stats.rx_bytes / events), (unsigned int)stats.rx_lost,
+			(unsigned int)(probe_min / 1000), (unsigned int)(probe_total / (probes_received ? probes_received : 1) / 1000),
+			(unsigned int)(probe_max / 1000), (unsigned int)kb_s, (unsigned int)(errors + stats.errors));
+	fflush(stdout);
+
+	exit(errors == 0 && stats.errors == 0 ? 0 : 1);
+}
+
+
+
+/*	LOOPBACK	*/
+
+
+/**
+ * @brief The far end of the line: sends back everything it receives, until the other end closes.
+ */
+static void loopback(int fd){
+
+	uint8_t buffer[4096];
+
+	prctl(PR_SET_PDEATHSIG, SIGTERM);
+	while (1)
+	{
+		ssize_t count = read(fd, buffer, sizeof(buffer));
+		if (count <= 0)
+		{
+			_exit(0);
+		}
+
+		for (ssize_t done = 0; done < count; )
+		{
+			ssize_t written = write(fd, buffer + done, (size_t)(count - done));
+			if (written <= 0)
+			{
+				_exit(0);
+			}
+			done += written;
+		}
+	}
+}
+
+
+
+int main(int argc, char** argv){
+
+	if (argc > 1)
+	{
+		rounds = (uint32_t)strtoul(argv[1], NULL, 0);
+	}
+	if (rounds == 0)
+	{
+		rounds = 1;
+	}
+
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+	{
+		perror("eos_uart: pty");
+		return 1;
+	}
+
+	int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	struct termios raw;
+	if (slave < 0 || tcgetattr(slave, &raw) != 0)
+	{
+		perror("eos_uart: pty");
+		return 1;
+	}
+	cfmakeraw(&raw);
+	tcsetattr(slave, TCSANOW, &raw);
+
+	pid_t child = fork();
+	if (child < 0)
+	{
+		perror("eos_uart: fork");
+		return 1;
+	}
+	if (child == 0)
+	{
+		close(slave);
+		loopback(master);
+	}
+	close(master);
+
+	if (EOS_UartInit(0, EOS_POSIX_UART_FD(slave)) != EOS_OK)
+	{
+		fprintf(stderr, "eos_uart: could not start the UART\n");
+		return 1;
+	}
+
+	for (uint32_t i = 0; i < UART_WRITERS; i++)
+	{
+		EOS_ThreadNew(writer_task, (i & 1) ? PRIORITY_LOW : PRIORITY_MEDIUM, NULL, UART_STACK, EOS_NO_FPU);
+	}
+	EOS_ThreadNew(reader_task, PRIORITY_HIGH, NULL, UART_STACK, EOS_NO_FPU);
+	EOS_ThreadNew(control_task, PRIORITY_LOW, NULL, UART_STACK, EOS_NO_FPU);
+
+	EOS_Init(DEFAULT_TASK_PERIOD); //does not return
+	return 0;
+}
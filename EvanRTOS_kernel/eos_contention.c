@@ -0,0 +1,253 @@
+/*
+ * eos_contention.c
+ *
+ *      Queue and semaphore contention profiler for EvanRTOS. When EOS_CONTENTION_PROFILE_ENABLE is set in
+ *      eos_config.h, every queue and semaphore carries an EOS_contention_t, and is added to a registry when it is
+ *      created. The kernel updates the counters from inside its critical sections:
+ *      	- acquisitions/releases: semaphore acquires/releases, queue gets/puts
+ *      	- contended: operations that had to block, with the total and longest time from blocking to completing
+ *      	- waiters: tasks blocked on the object now, and the most there have ever been at once
+ *      	- high_water, full, empty: the most items a queue has held, and how often it was found full or empty
+ *
+ *      A queue whose high water mark stays well under its size can be made smaller, while a queue that is often full
+ *      needs to be bigger, or its consumer needs to run sooner. Objects with a high contended count or wait time are
+ *      the hot locks of the application.
+ *
+ *      EOS_ContentionRegistry() returns the first registered object, and the rest can be walked through next.
+ *      EOS_ContentionReport() prints every object with printf. Objects can be given a name for the report with
+ *      EOS_ContentionName().
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "eos_port.h"
+#include "eos_queue.h"
+#include "eos_semaphore.h"
+
+#if EOS_CONTENTION_PROFILE_ENABLE
+
+/*	GLOBAL VARIABLES	*/
+static EOS_contention_t* contention_registry = NULL;
+static EOS_contention_t* contention_last = NULL;
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Ends the wait of an operation that blocked.
+ */
+static void EOS_ContentionEndWait(EOS_contention_t* stats, EOS_contention_wait_t* wait)
+{
+	if (wait == NULL || wait->blocked == 0)
+	{
+		return;
+	}
+
+	uint32_t waited = EOS_GetCycles() - wait->start;
+
+	stats->wait_total += waited;
+	if (waited > stats->wait_max)
+	{
+		stats->wait_max = waited;
+	}
+	if (stats->waiters > 0)
+	{
+		stats->waiters--;
+	}
+}
+
+
+
+/*	PROFILER FUNCTIONALITY	*/
+
+
+/**
+ * @brief Clears the counters of a new object, and adds it to the registry. Called by EOS_QueueCreate() and
+ * 			EOS_SemaphoreNew().
+ */
+void EOS_ContentionRegister(EOS_contention_t* stats, void* object, EOS_contention_type_t type)
+{
+	memset(stats, 0, sizeof(EOS_contention_t));
+	stats->object = object;
+	stats->type = type;
+
+	uint32_t state = EOS_PortMaskInterrupts();
+
+	if (contention_last == NULL)
+	{
+		contention_registry = stats;
+	}
+	else
+	{
+		contention_last->next = stats;
+	}
+	contention_last = stats;
+
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+/**
+ * @brief Called with interrupts disabled each time an operation is about to block. Only the first block of an
+ * 			operation is counted, a task that is woken up but still cannot complete keeps its original start time.
+ */
+void EOS_ContentionBlock(EOS_contention_t* stats, EOS_contention_wait_t* wait)
+{
+	if (wait->blocked)
+	{
+		return;
+	}
+
+	wait->blocked = 1;
+	wait->start = EOS_GetCycles();
+
+	stats->contended++;
+	stats->waiters++;
+	if (stats->waiters > stats->peak_waiters)
+	{
+		stats->peak_waiters = stats->waiters;
+	}
+}
+
+
+/**
+ * @brief Called with interrupts disabled when a semaphore is acquired, or an item is taken from a queue.
+ */
+void EOS_ContentionAcquire(EOS_contention_t* stats, EOS_contention_wait_t* wait)
+{
+	stats->acquisitions++;
+	EOS_ContentionEndWait(stats, wait);
+}
+
+
+/**
+ * @brief Called with interrupts disabled when a semaphore is released, or an item is put into a queue.
+ *
+ * @param wait The wait state of the operation, or NULL for operations that never block.
+ */
+void EOS_ContentionRelease(EOS_contention_t* stats, EOS_contention_wait_t* wait)
+{
+	stats->releases++;
+	EOS_ContentionEndWait(stats, wait);
+}
+
+
+/**
+ * @brief Called with interrupts disabled after an item is put into a queue, to track its high water mark.
+ */
+void EOS_ContentionLevel(EOS_contention_t* stats, uint32_t count)
+{
+	if (count > stats->high_water)
+	{
+		stats->high_water = count;
+	}
+}
+
+
+
+/*	REGISTRY	*/
+
+
+/**
+ * @brief Returns the first object in the registry, in order of creation. The others follow through next.
+ */
+const EOS_contention_t* EOS_ContentionRegistry(void)
+{
+	return contention_registry;
+}
+
+
+/**
+ * @brief Names a queue or semaphore in the contention report.
+ *
+ * @param object The queue or semaphore id.
+ * @param name A string that stays valid (for example a literal).
+ *
+ * @return EOS_OK, or EOS_ERROR if the object is not in the registry.
+ */
+EOS_status_t EOS_ContentionName(void* object, const char* name)
+{
+	for (EOS_contention_t* stats = contention_registry; stats != NULL; stats = stats->next)
+	{
+		if (stats->object == object)
+		{
+			stats->name = name;
+			return EOS_OK;
+		}
+	}
+	return EOS_ERROR;
+}
+
+
+/**
+ * @brief Clears the counters of every object. Tasks blocked right now are still counted as waiters, and the high
+ * 			water mark of a queue restarts from its current count.
+ */
+void EOS_ContentionReset(void)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+
+	for (EOS_contention_t* stats = contention_registry; stats != NULL; stats = stats->next)
+	{
+		stats->peak_waiters = stats->waiters;
+		stats->acquisitions = 0;
+		stats->releases = 0;
+		stats->contended = 0;
+		stats->wait_max = 0;
+		stats->wait_total = 0;
+		stats->high_water = (stats->type == EOS_CONTENTION_QUEUE) ? ((EOS_queue_t*)stats->object)->count : 0;
+		stats->full = 0;
+		stats->empty = 0;
+	}
+
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+/**
+ * @brief Prints one JSON line per registered object with printf, in order of creation, then a summary line.
+ */
+void EOS_ContentionReport(void)
+{
+	uint32_t objects = 0;
+
+	for (const EOS_contention_t* stats = contention_registry; stats != NULL; stats = stats->next)
+	{
+		objects++;
+
+		if (stats->type == EOS_CONTENTION_QUEUE)
+		{
+			const EOS_queue_t* queue = (const EOS_queue_t*)stats->object;
+
+			printf("{\"contention\":\"queue\",\"object\":\"0x%08lx\",\"name\":\"%s\",\"size\":%lu,\"item_size\":%lu,"
+					"\"count\":%lu,\"high_water\":%lu,\"gets\":%lu,\"puts\":%lu,\"full\":%lu,\"empty\":%lu",
+					(unsigned long)(uintptr_t)stats->object, stats->name ? stats->name : "",
+					(unsigned long)queue->size, (unsigned long)queue->item_size, (unsigned long)queue->count,
+					(unsigned long)stats->high_water, (unsigned long)stats->acquisitions,
+					(unsigned long)stats->releases, (unsigned long)stats->full, (unsigned long)stats->empty);
+		}
+		else
+		{
+			const EOS_semaphore_t* semaphore = (const EOS_semaphore_t*)stats->object;
+
+			printf("{\"contention\":\"semaphore\",\"object\":\"0x%08lx\",\"name\":\"%s\",\"max_count\":%lu,"
+					"\"count\":%lu,\"acquisitions\":%lu,\"releases\":%lu",
+					(unsigned long)(uintptr_t)stats->object, stats->name ? stats->name : "",
+					(unsigned long)semaphore->max_count, (unsigned long)semaphore->count,
+					(unsigned long)stats->acquisitions, (unsigned long)stats->releases);
+		}
+
+		printf(",\"contended\":%lu,\"wait_total\":%llu,\"wait_max\":%lu,\"waiters\":%u,\"peak_waiters\":%u,"
+				"\"unit\":\"cycles\"}\n",
+				(unsigned long)stats->contended, (unsigned long long)stats->wait_total,
+				(unsigned long)stats->wait_max, stats->waiters, stats->peak_waiters);
+	}
+
+	printf("{\"contention\":\"summary\",\"cycle_hz\":%lu,\"objects\":%lu}\n", (unsigned long)EOS_PORT_CYCLE_HZ,
+			(unsigned long)objects);
+}
+
+#endif
@@ -0,0 +1,250 @@
+/*
+ * eos_critical.c
+ *
+ *      Critical section profiler for EvanRTOS. When EOS_CRITICAL_PROFILE_ENABLE is set in eos_config.h,
+ *      EOS_EnterCritical() and EOS_ExitCritical() become macros that pass their call site to this file, and every
+ *      stretch of time spent with interrupts masked is measured with EOS_GetCycles(). The ports also mark the scheduler
+ *      call made by their context switch handler as the "PendSV_Handler" site. The masked part of the Systick handler
+ *      is the critical section of EOS_Tick(), and shows up under that name.
+ *
+ *      A section is charged to the site that masked interrupts. Sites are named by function and line, and keep a
+ *      count, total, maximum and a log2 histogram of their durations. Critical sections do not nest in EvanRTOS, so a
+ *      section entered while interrupts are already masked is folded into the outer one, and an EOS_ExitCritical()
+ *      with no matching enter (such as the one after EOS_TaskUnblock() has already exited) is ignored.
+ *
+ *      EOS_CriticalProfileWorst() gives the worst interrupt blackout seen so far, which bounds the latency added to
+ *      any interrupt that calls the kernel. EOS_CriticalProfileReport() prints every site with printf, longest first.
+ *
+ *      The profiler adds its own overhead to every section (one site lookup and two cycle counter reads).
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "eos_port.h"
+#include "eos_critical.h"
+
+#if EOS_CRITICAL_PROFILE_ENABLE
+
+/*	GLOBAL VARIABLES	*/
+static EOS_critical_site_t critical_sites[EOS_CRITICAL_PROFILE_SITES];
+static uint32_t critical_site_count = 0;
+static uint32_t critical_overflow = 0;
+static uint32_t critical_worst = 0;
+
+static uint32_t critical_depth = 0;
+static uint32_t critical_start = 0;
+static EOS_critical_site_t* critical_site = NULL;
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Finds the statistics of a call site, adding it if it is new. Returns NULL if the site table is full.
+ */
+static EOS_critical_site_t* EOS_CriticalFindSite(const char* function, uint32_t line)
+{
+	for (uint32_t i = 0; i < critical_site_count; i++)
+	{
+		if (critical_sites[i].function == function && critical_sites[i].line == line)
+		{
+			return &critical_sites[i];
+		}
+	}
+
+	if (critical_site_count == EOS_CRITICAL_PROFILE_SITES)
+	{
+		return NULL;
+	}
+
+	EOS_critical_site_t* site = &critical_sites[critical_site_count++];
+	site->function = function;
+	site->line = line;
+	return site;
+}
+
+
+
+/*	PROFILER FUNCTIONALITY	*/
+
+
+/**
+ * @brief Disables interrupts, and starts timing the critical section. Called through EOS_EnterCritical().
+ */
+void EOS_CriticalEnter(const char* function, uint32_t line)
+{
+	EOS_PortDisableInterrupts();
+	EOS_CriticalProfileBegin(function, line);
+}
+
+
+/**
+ * @brief Stops timing the critical section, and enables interrupts. Called through EOS_ExitCritical().
+ */
+void EOS_CriticalExit(void)
+{
+	EOS_CriticalProfileEnd();
+	EOS_PortEnableInterrupts();
+}
+
+
+/**
+ * @brief Resets the profiler. Called by EOS_Init() once the cycle counter is running, which also drops the critical
+ * 			section EOS_Init() leaves open for the port to close when starting the first task.
+ */
+void EOS_CriticalProfileInit(void)
+{
+	critical_depth = 0;
+	EOS_CriticalProfileReset();
+}
+
+
+/**
+ * @brief Marks the start of a stretch of code running with interrupts masked. Must be called with interrupts masked.
+ *
+ * @param function Name of the site, normally __func__.
+ * @param line Line of the site, or 0 for whole handlers.
+ */
+void EOS_CriticalProfileBegin(const char* function, uint32_t line)
+{
+	if (critical_depth++ != 0)
+	{
+		return;
+	}
+
+	critical_site = EOS_CriticalFindSite(function, line);
+	critical_start = EOS_GetCycles();
+}
+
+
+/**
+ * @brief Marks the end of a stretch of code started with EOS_CriticalProfileBegin(). Must be called before
+ * 			interrupts are unmasked.
+ */
+void EOS_CriticalProfileEnd(void)
+{
+	uint32_t cycles = EOS_GetCycles() - critical_start;
+
+	if (critical_depth == 0 || --critical_depth != 0)
+	{
+		return;
+	}
+
+	if (cycles > critical_worst)
+	{
+		critical_worst = cycles;
+	}
+
+	if (critical_site == NULL)
+	{
+		critical_overflow++;
+		return;
+	}
+
+	uint32_t bucket = 0;
+	if ((cycles >> EOS_CRITICAL_HIST_BASE) != 0)
+	{
+		bucket = 32 - __builtin_clz(cycles >> EOS_CRITICAL_HIST_BASE);
+	}
+	if (bucket >= EOS_CRITICAL_PROFILE_BUCKETS)
+	{
+		bucket = EOS_CRITICAL_PROFILE_BUCKETS - 1;
+	}
+
+	critical_site->count++;
+	critical_site->total += cycles;
+	critical_site->histogram[bucket]++;
+	if (cycles > critical_site->max)
+	{
+		critical_site->max = cycles;
+	}
+}
+
+
+
+/*	REPORTING	*/
+
+
+/**
+ * @brief Gives access to the statistics of every call site seen so far.
+ *
+ * @param count Set to the number of sites in the returned array.
+ *
+ * @return The site table. Entries keep being updated while the kernel runs.
+ */
+const EOS_critical_site_t* EOS_CriticalProfileSites(uint32_t* count)
+{
+	*count = critical_site_count;
+	return critical_sites;
+}
+
+
+/**
+ * @brief Returns the longest time interrupts were masked for, in cycles, across all sites.
+ */
+uint32_t EOS_CriticalProfileWorst(void)
+{
+	return critical_worst;
+}
+
+
+/**
+ * @brief Clears the statistics of every site, for example to profile a single phase of the application.
+ */
+void EOS_CriticalProfileReset(void)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+
+	memset(critical_sites, 0, sizeof(critical_sites));
+	critical_site_count = 0;
+	critical_overflow = 0;
+	critical_worst = 0;
+	critical_site = NULL; //a section in progress is counted as overflow
+
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+/**
+ * @brief Prints one JSON line per site with printf, longest section first, then a summary line.
+ * 			Histogram bucket 0 counts sections under 32 cycles, and bucket n sections of [2^(n+4), 2^(n+5)) cycles.
+ */
+void EOS_CriticalProfileReport(void)
+{
+	uint16_t order[EOS_CRITICAL_PROFILE_SITES];
+	uint32_t count = critical_site_count;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		uint32_t j = i;
+		while (j > 0 && critical_sites[order[j - 1]].max < critical_sites[i].max)
+		{
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = (uint16_t)i;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const EOS_critical_site_t* site = &critical_sites[order[i]];
+
+		printf("{\"critical\":\"%s\",\"line\":%lu,\"unit\":\"cycles\",\"n\":%lu,\"avg\":%lu,\"max\":%lu,\"hist\":[",
+				site->function, (unsigned long)site->line, (unsigned long)site->count,
+				(unsigned long)(site->count ? site->total / site->count : 0), (unsigned long)site->max);
+
+		for (uint32_t b = 0; b < EOS_CRITICAL_PROFILE_BUCKETS; b++)
+		{
+			printf(b ? ",%lu" : "%lu", (unsigned long)site->histogram[b]);
+		}
+		printf("]}\n");
+	}
+
+	printf("{\"critical\":\"summary\",\"worst\":%lu,\"cycle_hz\":%lu,\"sites\":%lu,\"overflow\":%lu}\n",
+			(unsigned long)critical_worst, (unsigned long)EOS_PORT_CYCLE_HZ, (unsigned long)count,
+			(unsigned long)critical_overflow);
+}
+
+#endif
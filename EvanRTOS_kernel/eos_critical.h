@@ -0,0 +1,50 @@
+/*
+ * eos_critical.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_CRITICAL_H_
+#define INC_EOS_CRITICAL_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+#define EOS_CRITICAL_HIST_BASE 5 //bucket 0 holds sections under 2^5 cycles
+
+
+/*	DATATYPES	*/
+
+/* Statistics of one critical section call site, named by the function and line of its EOS_EnterCritical() */
+typedef struct {
+	const char* function;
+	uint32_t line;
+	uint32_t count;
+	uint32_t max;		//longest time spent with interrupts masked, in cycles
+	uint64_t total;
+	uint32_t histogram[EOS_CRITICAL_PROFILE_BUCKETS];
+} EOS_critical_site_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_CRITICAL_PROFILE_ENABLE
+
+void EOS_CriticalProfileInit(void);
+void EOS_CriticalProfileBegin(const char* function, uint32_t line);
+void EOS_CriticalProfileEnd(void);
+
+const EOS_critical_site_t* EOS_CriticalProfileSites(uint32_t* count);
+uint32_t EOS_CriticalProfileWorst(void);
+void EOS_CriticalProfileReset(void);
+void EOS_CriticalProfileReport(void);
+
+#else
+
+#define EOS_CriticalProfileInit()
+#define EOS_CriticalProfileBegin(function, line)
+#define EOS_CriticalProfileEnd()
+
+#endif
+
+#endif /* INC_EOS_CRITICAL_H_ */
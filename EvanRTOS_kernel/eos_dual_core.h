@@ -0,0 +1,85 @@
+/*
+ * eos_dual_core.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_DUAL_CORE_H_
+#define INC_EOS_DUAL_CORE_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* Cores, passed to EOS_DualCoreInit(). The primary core sets up the shared memory, the secondary waits for it */
+#define EOS_CORE_PRIMARY 0		//the Cortex-M7 on the STM32H747
+#define EOS_CORE_SECONDARY 1	//the Cortex-M4
+
+/* Written to EOS_dual_shared_t.magic by the primary core once the shared memory is ready */
+#define EOS_DUAL_CORE_MAGIC 0x45445541u
+
+#if EOS_DUAL_CORE_SEMAPHORES > 16 || EOS_DUAL_CORE_QUEUES > 16
+#error "EOS_DUAL_CORE_SEMAPHORES and EOS_DUAL_CORE_QUEUES can be at most 16"
+#endif
+
+
+/*	DATATYPES	*/
+
+/* Counting semaphore both cores can take and give */
+typedef struct {
+	volatile uint32_t count;
+	uint32_t max_count;
+	volatile uint32_t created;
+} EOS_dual_semaphore_t;
+
+/* FIFO queue of fixed size items, like EOS_queue_t. The buffer is an offset into the shared pool, as the shared
+ * memory need not be at the same address on both cores */
+typedef struct {
+	uint32_t buffer;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t size;
+	uint32_t item_size;
+	volatile uint32_t count;
+	volatile uint32_t created;
+} EOS_dual_queue_t;
+
+/* Everything the two cores share. It has to be placed in memory both can reach, and that the primary core does not
+ * cache (D2 or D3 SRAM on the STM32H747, with the Cortex-M7 data cache off or the region made non-cacheable).
+ * Objects are identified by their index, so both cores' code can name them without passing pointers. Bit n of the
+ * waiting and pending masks is semaphore n, bit 16 + n is queue n */
+typedef struct {
+	volatile uint32_t magic;
+	volatile uint32_t lock;			//for ports with a software lock, see EOS_PortCoreLock()
+	volatile uint32_t waiting[2];	//per core, objects it has tasks blocked on
+	volatile uint32_t pending[2];	//per core, objects its waiters should look at again
+	uint32_t pool_used;
+	EOS_dual_semaphore_t semaphores[EOS_DUAL_CORE_SEMAPHORES];
+	EOS_dual_queue_t queues[EOS_DUAL_CORE_QUEUES];
+	uint8_t pool[EOS_DUAL_CORE_POOL_SIZE] __attribute__((aligned(4)));
+} EOS_dual_shared_t;
+
+typedef EOS_dual_semaphore_t* EOS_dual_semaphore_id_t;
+typedef EOS_dual_queue_t* EOS_dual_queue_id_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_DUAL_CORE_ENABLE
+
+void EOS_DualCoreInit(uint32_t core, EOS_dual_shared_t* shared);
+void EOS_DualCoreIsr(void);
+
+EOS_dual_semaphore_id_t EOS_DualSemaphoreNew(uint32_t index, uint8_t count);
+EOS_dual_semaphore_id_t EOS_DualSemaphoreOpen(uint32_t index);
+EOS_status_t EOS_DualSemaphoreAcquire(EOS_dual_semaphore_id_t semaphore);
+EOS_status_t EOS_DualSemaphoreRelease(EOS_dual_semaphore_id_t semaphore);
+
+EOS_dual_queue_id_t EOS_DualQueueCreate(uint32_t index, uint32_t size, uint32_t item_size);
+EOS_dual_queue_id_t EOS_DualQueueOpen(uint32_t index);
+EOS_status_t EOS_DualQueueGet(EOS_dual_queue_id_t queue, void* item, EOS_block_status_t block);
+EOS_status_t EOS_DualQueuePut(EOS_dual_queue_id_t queue, const void* item, EOS_block_status_t block);
+
+#endif
+
+#endif /* INC_EOS_DUAL_CORE_H_ */
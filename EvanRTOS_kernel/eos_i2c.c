@@ -0,0 +1,492 @@
+/*
+ * eos_i2c.c
+ *
+ *      I2C bus manager for EvanRTOS, enabled with EOS_I2C_ENABLE in eos_config.h. A bus can only carry one transaction
+ *      at a time, and the HAL's calls leave it to the caller to keep out of each other's way, so tasks sharing a bus
+ *      would each need to hold a mutex for the whole of their transfer. Here a manager task owns each bus, and tasks
+ *      hand it their transactions instead.
+ *
+ *      EOS_I2cSubmit() queues a transaction (EOS_i2c_txn_t): a write, a read, or a write then a read with a repeated
+ *      start, as register reads do. It returns straight away, and the transaction either wakes the task that waits on
+ *      it with EOS_I2cWait(), or has its callback run by the manager once done. EOS_I2cWrite(), EOS_I2cRead() and
+ *      EOS_I2cWriteRead() queue one and wait for it. Transactions run in the order they were queued, whichever task
+ *      queued them.
+ *
+ *      The manager starts a transaction on an idle bus. From then on, the interrupt that ends each transaction starts
+ *      the next queued one before anything else, so a busy bus goes from one to the next without waiting for a task
+ *      to run. The manager only wakes again to start on an idle bus, to run callbacks, and to reset the bus after a
+ *      bus error, or after a transaction that has not ended within EOS_I2C_TIMEOUT_MS, which a device holding the bus
+ *      low would cause. It sleeps in the HAL shim's waits (eos_hal.c), which is where its timeout comes from.
+ *
+ *      The port does the hardware part, behind EOS_PortI2cTransfer() (see eos_port.h), and calls EOS_I2cIsr() from
+ *      its interrupts: the ARM_CM7 port with the HAL's interrupt driven sequential transfers, the POSIX port with a
+ *      simulated bus of register file devices.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_i2c.h"
+#include "eos_hal.h"
+#include "eos_trace.h"
+#include "eos_wait.h"
+
+#if EOS_I2C_ENABLE
+
+/*	DATATYPES	*/
+
+/* The manager's state of one bus. Its address is the handle the manager sleeps on */
+typedef struct {
+	uint32_t started;
+	EOS_task_id_t manager;
+	EOS_i2c_txn_t* head;			//on the bus while active, then those queued behind it
+	EOS_i2c_txn_t* tail;
+	uint32_t active;				//the head is on the bus
+	uint32_t issued;				//transactions put on the bus, from the start
+	uint32_t recover;				//the bus must be reset before the next one
+	volatile uint32_t work;			//something for the manager, since it last looked
+	EOS_i2c_txn_t* done_head;		//done, with callbacks to run
+	EOS_i2c_txn_t* done_tail;
+	EOS_i2c_stats_t stats;
+} EOS_i2c_t;
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static uint32_t EOS_I2cStart(uint32_t bus);
+static EOS_i2c_txn_t* EOS_I2cTake(uint32_t bus, EOS_i2c_result_t result);
+static void EOS_I2cDone(uint32_t bus, EOS_i2c_txn_t* txn, EOS_i2c_result_t result);
+static void EOS_I2cManagerTask(void);
+
+
+/*	GLOBAL VARIABLES	*/
+static EOS_i2c_t i2c_buses[EOS_I2C_COUNT];
+static int32_t i2c_stacks[EOS_I2C_COUNT][EOS_I2C_STACK_SIZE];
+
+
+
+/*	SETUP	*/
+
+
+/**
+ * @brief Starts a bus, and creates its manager task. Call it once per bus, before EOS_Init().
+ *
+ * @param bus The bus's number, below EOS_I2C_COUNT.
+ * @param device The port's handle for it: the I2C_HandleTypeDef on the ARM_CM7 port, initialised as a master with its
+ * 			event and error interrupts enabled, or an EOS_posix_i2c_bus_t on the POSIX port.
+ * @param priority The manager's priority. Above the tasks using the bus, so a callback or an idle bus is seen to at
+ * 			once.
+ * @return EOS_OK, or EOS_ERROR if the number is out of range, the bus is already started, the port refused it, or the
+ * 			task could not be created.
+ */
+EOS_status_t EOS_I2cInit(uint32_t bus, void* device, EOS_priority_t priority)
+{
+	if (bus >= EOS_I2C_COUNT || i2c_buses[bus].started)
+	{
+		return EOS_ERROR;
+	}
+
+	memset(&i2c_buses[bus], 0, sizeof(EOS_i2c_t));
+	if (EOS_PortI2cStart(bus, device) != EOS_OK)
+	{
+		return EOS_ERROR;
+	}
+
+	i2c_buses[bus].manager = EOS_ThreadNew(EOS_I2cManagerTask, priority, i2c_stacks[bus], EOS_I2C_STACK_SIZE,
+			EOS_NO_FPU);
+	if (i2c_buses[bus].manager == NULL)
+	{
+		return EOS_ERROR;
+	}
+
+	i2c_buses[bus].started = 1;
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Copies a bus's counters.
+ *
+ * @return EOS_OK, or EOS_ERROR if the bus is not started.
+ */
+EOS_status_t EOS_I2cStats(uint32_t bus, EOS_i2c_stats_t* stats)
+{
+	if (bus >= EOS_I2C_COUNT || i2c_buses[bus].started == 0)
+	{
+		return EOS_ERROR;
+	}
+
+	EOS_EnterCritical();
+	*stats = i2c_buses[bus].stats;
+	EOS_ExitCritical();
+	return EOS_OK;
+}
+
+
+
+/*	TRANSACTIONS	*/
+
+
+/**
+ * @brief Queues a transaction, and returns straight away. It starts once those queued before it on the bus are done.
+ * 			Wait for it with EOS_I2cWait(), unless it has a callback, before reusing it or its buffers.
+ *
+ * @param bus The bus's number.
+ * @param txn The transaction, with its address, buffers, lengths, and callback and context set. Owned by the manager
+ * 			until it is done.
+ * @return EOS_OK, or EOS_ERROR if the bus is not started or the transaction has nothing to transfer.
+ */
+EOS_status_t EOS_I2cSubmit(uint32_t bus, EOS_i2c_txn_t* txn)
+{
+	if (bus >= EOS_I2C_COUNT || i2c_buses[bus].started == 0 || (txn->tx_length == 0 && txn->rx_length == 0))
+	{
+		return EOS_ERROR;
+	}
+
+	EOS_i2c_t* state = &i2c_buses[bus];
+
+	txn->result = EOS_I2C_PENDING;
+	txn->next = NULL;
+
+	EOS_EnterCritical();
+	uint32_t idle = (state->head == NULL);
+	if (idle)
+	{
+		state->head = txn;
+		state->work = 1;
+	}
+	else
+	{
+		state->tail->next = txn;
+	}
+	state->tail = txn;
+	EOS_ExitCritical();
+
+	if (idle)
+	{
+		EOS_HalComplete(state, EOS_HAL_ANY, EOS_HAL_DONE);
+	}
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Sleeps until a transaction queued with EOS_I2cSubmit(), without a callback, is done, and returns straight
+ * 			away if it is.
+ *
+ * @return Its result.
+ */
+EOS_i2c_result_t EOS_I2cWait(EOS_i2c_txn_t* txn)
+{
+	EOS_EnterCritical();
+	while (txn->result == EOS_I2C_PENDING)
+	{
+		run_ptr->blocked = txn;
+		EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, txn);
+		EOS_WaitProfileBlock(run_ptr, txn);
+		EOS_ExitCritical();
+		EOS_Suspend();
+		EOS_EnterCritical();
+	}
+	EOS_ExitCritical();
+
+	return txn->result;
+}
+
+
+/**
+ * @brief Writes to a device, sleeping until done.
+ *
+ * @param bus The bus's number.
+ * @param address The device's 7 bit address.
+ * @param data The bytes to write, usually a register address followed by its new contents.
+ * @param length Number of bytes, at least 1.
+ * @return The transaction's result, or EOS_I2C_ERROR if it could not be queued.
+ */
+EOS_i2c_result_t EOS_I2cWrite(uint32_t bus, uint16_t address, const void* data, uint16_t length)
+{
+	return EOS_I2cWriteRead(bus, address, data, length, NULL, 0);
+}
+
+
+/**
+ * @brief Reads from a device, sleeping until done.
+ *
+ * @param bus The bus's number.
+ * @param address The device's 7 bit address.
+ * @param data Where to put the bytes read.
+ * @param length Number of bytes, at least 1.
+ * @return The transaction's result, or EOS_I2C_ERROR if it could not be queued.
+ */
+EOS_i2c_result_t EOS_I2cRead(uint32_t bus, uint16_t address, void* data, uint16_t length)
+{
+	return EOS_I2cWriteRead(bus, address, NULL, 0, data, length);
+}
+
+
+/**
+ * @brief Writes to a device, then reads from it after a repeated start, sleeping until done. With tx_data a register
+ * 			address, this reads that register and those after it.
+ *
+ * @param bus The bus's number.
+ * @param address The device's 7 bit address.
+ * @return The transaction's result, or EOS_I2C_ERROR if it could not be queued.
+ */
+EOS_i2c_result_t EOS_I2cWriteRead(uint32_t bus, uint16_t address, const void* tx_data, uint16_t tx_length,
+		void* rx_data, uint16_t rx_length)
+{
+	EOS_i2c_txn_t txn = {0};
+
+	txn.address = address;
+	txn.tx_data = (const uint8_t*)tx_data;
+	txn.tx_length = tx_length;
+	txn.rx_data = (uint8_t*)rx_data;
+	txn.rx_length = rx_length;
+
+	if (EOS_I2cSubmit(bus, &txn) != EOS_OK)
+	{
+		return EOS_I2C_ERROR;
+	}
+	return EOS_I2cWait(&txn);
+}
+
+
+/**
+ * @brief Called by the port from the interrupt that ends the transaction on the bus, with its result. Starts the next
+ * 			queued transaction first, so the bus is not left idle, then wakes the task waiting on the one that ended,
+ * 			or the manager to run its callback. After a bus error, the next one waits for the manager to reset the bus.
+ */
+void EOS_I2cIsr(uint32_t bus, EOS_i2c_result_t result)
+{
+	EOS_i2c_t* state = &i2c_buses[bus];
+
+	EOS_EnterCritical();
+	if (state->active == 0) //ended after the manager timed it out
+	{
+		EOS_ExitCritical();
+		return;
+	}
+
+	EOS_i2c_txn_t* txn = EOS_I2cTake(bus, result);
+	if (result == EOS_I2C_ERROR)
+	{
+		state->recover = 1;
+	}
+	else if (EOS_I2cStart(bus))
+	{
+		state->stats.chained++;
+	}
+
+	uint32_t wake = (txn->callback != NULL || state->recover);
+	if (wake)
+	{
+		state->work = 1;
+	}
+	EOS_I2cDone(bus, txn, result);
+	EOS_ExitCritical();
+
+	if (wake)
+	{
+		EOS_HalComplete(state, EOS_HAL_ANY, EOS_HAL_DONE);
+	}
+}
+
+
+
+/*	MANAGER TASK	*/
+
+
+/**
+ * @brief A bus's manager: resets the bus when needed, runs callbacks, starts transactions on an idle bus, and sleeps
+ * 			until there is more to do, or until the transaction on the bus has taken EOS_I2C_TIMEOUT_MS.
+ */
+static void EOS_I2cManagerTask(void)
+{
+	uint32_t bus = 0;
+
+	while (i2c_buses[bus].manager != run_ptr)
+	{
+		bus++;
+	}
+
+	EOS_i2c_t* state = &i2c_buses[bus];
+	uint32_t reset = 0;
+
+	while (1)
+	{
+		EOS_hal_wait_t wait;
+
+		if (state->recover)
+		{
+			EOS_PortI2cRecover(bus);
+			EOS_EnterCritical();
+			state->recover = 0;
+			EOS_ExitCritical();
+			reset = 1;
+		}
+
+		//callbacks, in the order the transactions were done. Those done while they run set work again
+		EOS_EnterCritical();
+		EOS_i2c_txn_t* done = state->done_head;
+		state->done_head = NULL;
+		state->done_tail = NULL;
+		state->work = 0;
+		EOS_ExitCritical();
+
+		while (done != NULL)
+		{
+			EOS_i2c_txn_t* txn = done;
+			done = txn->next; //the callback may queue it again
+			txn->callback(txn);
+		}
+
+		//an idle bus
+		EOS_EnterCritical();
+		if (state->active == 0 && state->recover == 0 && state->head != NULL)
+		{
+			if (EOS_I2cStart(bus))
+			{
+				state->stats.idle_starts++;
+			}
+			else if (reset)
+			{
+				//refused by a bus that was just reset: the transaction goes, rather than the bus being reset forever
+				state->recover = 0;
+				EOS_I2cDone(bus, EOS_I2cTake(bus, EOS_I2C_ERROR), EOS_I2C_ERROR);
+				EOS_ExitCritical();
+				continue;
+			}
+		}
+		reset = 0;
+		uint32_t issued = state->issued;
+		uint32_t active = state->active;
+		EOS_ExitCritical();
+
+		EOS_HalPrepare(&wait, state, EOS_HAL_ANY, active ? EOS_I2C_TIMEOUT_MS : EOS_HAL_FOREVER);
+		if (state->work || state->recover)
+		{
+			EOS_HalCancel(&wait);
+			continue;
+		}
+		if (EOS_HalWait(&wait) != EOS_HAL_TIMEOUT)
+		{
+			continue;
+		}
+
+		//still on the transaction it slept on: the bus has hung
+		EOS_EnterCritical();
+		if (state->active == 0 || state->issued != issued)
+		{
+			EOS_ExitCritical();
+			continue;
+		}
+		EOS_i2c_txn_t* txn = EOS_I2cTake(bus, EOS_I2C_TIMEOUT); //its interrupt is ignored from here on
+		EOS_ExitCritical();
+
+		EOS_PortI2cRecover(bus); //stops the transfer: its result is only set, and its buffers given back, after that
+		EOS_EnterCritical();
+		EOS_I2cDone(bus, txn, EOS_I2C_TIMEOUT);
+		EOS_ExitCritical();
+	}
+}
+
+
+
+/*	HELPER FUNCTIONS	*/
+
+
+/**
+ * @brief Puts the transaction at the head of the queue on the bus, if the bus is free for it. If the port refuses it,
+ * 			the bus is marked for a reset. Called in a critical section.
+ *
+ * @return 1 if it was started.
+ */
+static uint32_t EOS_I2cStart(uint32_t bus)
+{
+	EOS_i2c_t* state = &i2c_buses[bus];
+	EOS_i2c_txn_t* txn = state->head;
+
+	if (txn == NULL || state->active || state->recover)
+	{
+		return 0;
+	}
+
+	if (EOS_PortI2cTransfer(bus, txn->address, txn->tx_data, txn->tx_length, txn->rx_data, txn->rx_length) != EOS_OK)
+	{
+		state->recover = 1; //the peripheral is stuck busy
+		return 0;
+	}
+
+	state->active = 1;
+	state->issued++;
+	return 1;
+}
+
+
+/**
+ * @brief Takes the transaction at the head of the queue off it, and counts it with its result. It stays
+ * 			EOS_I2C_PENDING until handed back with EOS_I2cDone(). Called in a critical section.
+ */
+static EOS_i2c_txn_t* EOS_I2cTake(uint32_t bus, EOS_i2c_result_t result)
+{
+	EOS_i2c_t* state = &i2c_buses[bus];
+	EOS_i2c_txn_t* txn = state->head;
+
+	state->head = txn->next;
+	if (state->head == NULL)
+	{
+		state->tail = NULL;
+	}
+	state->active = 0;
+	txn->next = NULL;
+
+	state->stats.transactions++;
+	switch (result)
+	{
+	case EOS_I2C_OK:
+		state->stats.tx_bytes += txn->tx_length;
+		state->stats.rx_bytes += txn->rx_length;
+		break;
+	case EOS_I2C_NACK:
+		state->stats.nacks++;
+		break;
+	case EOS_I2C_TIMEOUT:
+		state->stats.timeouts++;
+		break;
+	default:
+		state->stats.errors++;
+		break;
+	}
+
+	return txn;
+}
+
+
+/**
+ * @brief Hands a done transaction back with its result, once the bus is no longer using its buffers: onto the list of
+ * 			callbacks for the manager to run, or to the task waiting on it. Called in a critical section, as its last
+ * 			step, as waking a higher priority task may switch to it at once.
+ */
+static void EOS_I2cDone(uint32_t bus, EOS_i2c_txn_t* txn, EOS_i2c_result_t result)
+{
+	EOS_i2c_t* state = &i2c_buses[bus];
+
+	txn->result = result;
+
+	if (txn->callback == NULL)
+	{
+		EOS_TaskUnblock(txn);
+		return;
+	}
+
+	if (state->done_tail == NULL)
+	{
+		state->done_head = txn;
+	}
+	else
+	{
+		state->done_tail->next = txn;
+	}
+	state->done_tail = txn;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * eos_i2c.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_I2C_H_
+#define INC_EOS_I2C_H_
+
+#include "eos_kernel.h"
+
+#if EOS_I2C_ENABLE && !EOS_HAL_ENABLE
+#error "EOS_I2C_ENABLE needs EOS_HAL_ENABLE, whose timed waits the bus managers sleep in"
+#endif
+
+
+/*	ENUMERATIONS	*/
+typedef enum {
+	EOS_I2C_PENDING = 0,			//queued, or on the bus
+	EOS_I2C_OK = 1,
+	EOS_I2C_NACK = 2,				//the device did not acknowledge its address or a byte
+	EOS_I2C_ERROR = 3,				//bus error or lost arbitration, the bus was reset
+	EOS_I2C_TIMEOUT = 4				//not done within EOS_I2C_TIMEOUT_MS, the bus was reset
+} EOS_i2c_result_t;
+
+
+/*	DATATYPES	*/
+
+/* One transaction: a write (rx_length 0), a read (tx_length 0), or a write then a read with a repeated start between
+ * them (both), as register reads do. It and its buffers belong to the bus manager from EOS_I2cSubmit() until it is
+ * done, so they must stay valid until then */
+typedef struct EOS_i2c_txn_t {
+	uint16_t address;				//7 bit device address
+	uint16_t tx_length;
+	const uint8_t* tx_data;
+	uint16_t rx_length;
+	uint8_t* rx_data;
+	void (*callback)(struct EOS_i2c_txn_t* txn);	//run by the bus manager once done, or NULL to wait for it
+	void* context;					//for the callback
+	volatile EOS_i2c_result_t result;
+	struct EOS_i2c_txn_t* next;
+} EOS_i2c_txn_t;
+
+/* Counters of one bus, see EOS_I2cStats() */
+typedef struct {
+	uint32_t transactions;			//done, whatever the result
+	uint32_t tx_bytes;
+	uint32_t rx_bytes;
+	uint32_t chained;				//started by the interrupt that ended the one before, with no gap
+	uint32_t idle_starts;			//started by the manager on an idle bus
+	uint32_t nacks;
+	uint32_t errors;
+	uint32_t timeouts;
+} EOS_i2c_stats_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_I2C_ENABLE
+
+EOS_status_t EOS_I2cInit(uint32_t bus, void* device, EOS_priority_t priority);
+
+/* Transactions */
+EOS_status_t EOS_I2cSubmit(uint32_t bus, EOS_i2c_txn_t* txn);
+EOS_i2c_result_t EOS_I2cWait(EOS_i2c_txn_t* txn);
+EOS_i2c_result_t EOS_I2cWrite(uint32_t bus, uint16_t address, const void* data, uint16_t length);
+EOS_i2c_result_t EOS_I2cRead(uint32_t bus, uint16_t address, void* data, uint16_t length);
+EOS_i2c_result_t EOS_I2cWriteRead(uint32_t bus, uint16_t address, const void* tx_data, uint16_t tx_length,
+		void* rx_data, uint16_t rx_length);
+
+EOS_status_t EOS_I2cStats(uint32_t bus, EOS_i2c_stats_t* stats);
+
+/* Called by the port, from the I2C interrupts */
+void EOS_I2cIsr(uint32_t bus, EOS_i2c_result_t result);
+
+#endif
+
+#endif /* INC_EOS_I2C_H_ */
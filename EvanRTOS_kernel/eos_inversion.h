@@ -0,0 +1,61 @@
+/*
+ * eos_inversion.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_INVERSION_H_
+#define INC_EOS_INVERSION_H_
+
+#include "eos_kernel.h"
+
+/*	DATATYPES	*/
+
+/* One priority inversion: a task (waiter) blocked on a semaphore held by a lower priority task (holder) */
+typedef struct {
+	void* object;				//the semaphore
+	uint16_t waiter;			//task ids
+	uint16_t holder;
+	uint8_t waiter_priority;
+	uint8_t holder_priority;
+	uint32_t duration;			//cycles from blocking to acquiring the semaphore
+	uint32_t others;			//cycles of the duration spent running tasks other than the holder (and idle)
+	uint32_t end;				//cycle count when the waiter got the semaphore
+} EOS_inversion_t;
+
+typedef struct {
+	uint32_t count;				//finished inversions
+	uint64_t total;				//cycles, sum of their durations
+	EOS_inversion_t worst;		//the longest one
+	uint32_t others_max;		//most cycles any inversion spent running other tasks
+	uint32_t active;			//inversions in progress
+	uint32_t overflow;			//acquisitions not tracked because the holds table was full
+} EOS_inversion_stats_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_INVERSION_DETECT_ENABLE
+
+void EOS_InversionInit(void);
+void EOS_InversionAcquire(EOS_TCB_t* task, void* object);
+void EOS_InversionRelease(EOS_TCB_t* task, void* object);
+void EOS_InversionBlock(EOS_TCB_t* task, void* object);
+void EOS_InversionSwitch(EOS_TCB_t* out, EOS_TCB_t* in);
+
+const EOS_inversion_stats_t* EOS_InversionStats(void);
+uint32_t EOS_InversionRead(EOS_inversion_t* events, uint32_t max);
+void EOS_InversionReset(void);
+void EOS_InversionReport(void);
+
+#else
+
+#define EOS_InversionInit()
+#define EOS_InversionAcquire(task, object)
+#define EOS_InversionRelease(task, object)
+#define EOS_InversionBlock(task, object)
+#define EOS_InversionSwitch(out, in)
+
+#endif
+
+#endif /* INC_EOS_INVERSION_H_ */
@@ -21,35 +21,50 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include "eos_kernel.h"
-#include "main.h"
+#include "eos_port.h"
+#include "eos_trace.h"
+#include "eos_critical.h"
+#include "eos_profile.h"
+#include "eos_wait.h"
+#include "eos_inversion.h"
+#include "eos_smp.h"
+#include "eos_hal.h"
 #include <string.h>
 
 
 
 /*	LOCAL FUNCTION PROTOTYPES	*/
-static void EOS_scheduler(void);
 static void EOS_HandleTimeout();
-static void EOS_InitStack(int32_t* task_stack, uint32_t stack_size, void* function);
-static void EOS_InitFpuStack(int32_t* task_stack, uint32_t stack_size, void* function);
-static __attribute__((naked))void EOS_Start();
 static void idleTask();
+static void EOS_PaintStack(int32_t* stack, uint32_t stack_size);
 
 
 /*	GLOBAL VARIABLES*/
 uint32_t task_period = DEFAULT_TASK_PERIOD;
 uint8_t scheduler_enable = 0;
+uint16_t task_count = 0;
+#if EOS_TASK_STATS_ENABLE
+static uint32_t stats_since = 0;			//cycle count of the last switch
+static uint64_t stats_total = 0;			//cycles accounted to any task
+static uint64_t stats_snapshot_total = 0;	//stats_total at the last EOS_TaskSnapshot()
+#endif
 
 int32_t idle_stack[32];
 EOS_TCB_t idle_task = {
 		.blocked = 0,
 		.next = &idle_task,
 		.priority = PRIORITY_IDLE,
-		.sp = &idle_stack[15],
+		.sp = NULL, //set up by EOS_Init()
 		.timeOut = 0,
-		.paused = 0
+		.paused = 0,
+		.id = 0,
+		.stack = idle_stack,
+		.stack_size = 32
 };
 
+#if !EOS_SMP_ENABLE
 EOS_TCB_t* run_ptr = &idle_task;
+#endif
 
 
 /*		EOS STARTUP		*/
@@ -72,7 +87,8 @@ EOS_TCB_t* run_ptr = &idle_task;
  * 		  	floating point operations. EOS_NO_FPU is the default, when the task contains no floating point operations.
  * 			This must be defined by the user.
  *
- * @return A pointer to the newly created task's TCB (as `EOS_task_id_t`), or `EOS_ERROR` on failure.
+ * @return A pointer to the newly created task's TCB (as `EOS_task_id_t`), or `EOS_ERROR` on failure, which includes
+ * 			every call after 65535 tasks have been created (task ids are 16 bit).
  *
  */
 EOS_task_id_t EOS_ThreadNew(void* function, EOS_priority_t priority, int32_t* task_stack, uint32_t stack_size, EOS_status_t use_fpu){
@@ -86,51 +102,41 @@ EOS_task_id_t EOS_ThreadNew(void* function, EOS_priority_t priority, int32_t* ta
 	{
 		return EOS_ERROR;
 	}
+
+	if (task_count == UINT16_MAX) //task ids are used up
+	{
+		return EOS_ERROR;
+	}
 	EOS_TCB_t* control_block = (EOS_TCB_t*)malloc(sizeof(EOS_TCB_t));
 
-	int32_t* sp;
+	if (control_block == NULL)
+	{
+		return EOS_ERROR;
+	}
+
+	int32_t* stack = task_stack;
 
-	if (task_stack == NULL)
+	if (stack == NULL)
 	{
-		sp = (int32_t*)malloc(stack_size * sizeof(int32_t));
+		stack = (int32_t*)malloc(stack_size * sizeof(int32_t));
 
-		if(sp == NULL)
+		if(stack == NULL)
 		{
 			free(control_block);
 			return EOS_ERROR;
 		}
+	}
 
+	EOS_PaintStack(stack, stack_size);
+	int32_t* sp = EOS_PortInitStack(stack, stack_size, function, use_fpu);
 
-		if(use_fpu == EOS_USE_FPU)
-		{
-			EOS_InitFpuStack(sp, stack_size, function);
-			sp = &sp[stack_size - 51];
-		}
-		else
-		{
-			EOS_InitStack(sp, stack_size, function);
-			sp = &sp[stack_size - 17];
-		}
-
-
-	}
-	else
+	if (sp == NULL)
 	{
-		if(use_fpu == EOS_USE_FPU)
+		if (task_stack == NULL)
 		{
-			EOS_InitFpuStack(task_stack, stack_size, function);
-			sp = &task_stack[stack_size - 51];
+			free(stack);
 		}
-		else
-		{
-			EOS_InitStack(task_stack, stack_size, function);
-			sp = &task_stack[stack_size - 17];
-		}
-
-	}
-
-	if (control_block == NULL){
-		free(sp);
+		free(control_block);
 		return EOS_ERROR;
 	}
 
@@ -139,6 +145,21 @@ EOS_task_id_t EOS_ThreadNew(void* function, EOS_priority_t priority, int32_t* ta
 	control_block->blocked = 0;
 	control_block->timeOut = 0;
 	control_block->paused = 0;
+	control_block->stack = stack;
+	control_block->stack_size = stack_size;
+#if EOS_TASK_STATS_ENABLE
+	control_block->cycles = 0;
+	control_block->snapshot_cycles = 0;
+	control_block->switches = 0;
+#endif
+	EOS_WaitProfileCreate(control_block);
+
+#if EOS_SMP_ENABLE
+	EOS_SmpSetup();
+	EOS_EnterCritical(); //other cores may be scheduling already
+	EOS_SmpAssign(control_block);
+#endif
+	control_block->id = ++task_count;
 
 	EOS_TCB_t* temp = run_ptr;
 	while (temp->next != run_ptr)
@@ -148,6 +169,9 @@ EOS_task_id_t EOS_ThreadNew(void* function, EOS_priority_t priority, int32_t* ta
 
 	temp->next = control_block;
 	control_block->next = run_ptr;
+#if EOS_SMP_ENABLE
+	EOS_ExitCritical();
+#endif
 
 
 	return control_block;
@@ -164,44 +188,33 @@ void EOS_Init(uint32_t user_task_period){
 	EOS_EnterCritical();
 	scheduler_enable = 1;
 
-	EOS_InitStack(idle_stack, 32, idleTask);
+	EOS_PortInit();
+	EOS_PaintStack(idle_stack, 32);
+	idle_task.sp = EOS_PortInitStack(idle_stack, 32, idleTask, EOS_NO_FPU);
+#if EOS_SMP_ENABLE
+	EOS_SmpSetup();
+	for (uint32_t core = 1; core < EOS_SMP_CORES; core++)
+	{
+		EOS_TCB_t* idle = EOS_SmpIdleTask(core);
+		EOS_PaintStack(idle->stack, idle->stack_size);
+		idle->sp = EOS_PortInitStack(idle->stack, idle->stack_size, idleTask, EOS_NO_FPU);
+	}
+#endif
+#if EOS_TASK_STATS_ENABLE
+	stats_since = EOS_GetCycles();
+#endif
+	EOS_TraceInit();
+	EOS_CriticalProfileInit();
+	EOS_ProfileInit();
+	EOS_WaitProfileInit();
+	EOS_InversionInit();
 
 
 	if (user_task_period != task_period){
 		task_period = user_task_period;
 	}
 
-	__set_CONTROL(__get_CONTROL() | CONTROL_SPSEL_Msk); //enables PSP mode
-
-
-	EOS_Start();
-}
-
-
-/**
- * @brief Starts the first task by restoring its context and enabling execution.
- *
- * @details This function is called to launch the RTOS scheduler. It will run the task currently pointed to by run_ptr.
- *
- * @return None. This function does not return to the caller.
- */
-
-static __attribute__((naked))void EOS_Start(){
-
-	__asm volatile(
-			"LDR R0, =run_ptr      \n"
-			"LDR R1, [R0]          \n"
-			"LDR SP, [R1]          \n"
-			"ADD SP, SP, #4		   \n"
-			"POP {R4-R11}          \n"
-			"POP {R0-R3}           \n"
-			"POP {R12}             \n"
-			"ADD SP, SP, #4        \n"
-			"POP {LR}              \n"
-			"ADD SP, SP, #4        \n"
-			"CPSIE I               \n"
-			"BX LR                 \n"
-		);
+	EOS_PortStartScheduler();
 }
 
 
@@ -215,93 +228,99 @@ static __attribute__((naked))void EOS_Start(){
  *
  * The highest, unblocked task will run. Two tasks of equal priority running will timesplice, so that they both get
  * equal running time. If there are no unblocked tasks, the idle task will run.
+ *
+ * @note Called by the port, with interrupts disabled, when switching context. With EOS_SMP_ENABLE, each core
+ * 		 schedules its own run queue (see eos_smp.c).
  */
-static void EOS_scheduler(void)
+void EOS_scheduler(void)
 {
 
+#if EOS_STACK_CHECK_ENABLE
+	for (uint32_t i = 0; i < EOS_STACK_GUARD_WORDS; i++)
+	{
+		if ((uint32_t)run_ptr->stack[i] != EOS_STACK_PAINT)
+		{
+			EOS_StackOverflow(run_ptr);
+		}
+	}
+#endif
+
+#if EOS_SMP_ENABLE
+	EOS_SmpLock();
+	EOS_TCB_t* best_pointer = EOS_SmpPick(run_ptr);
+#else
 	EOS_TCB_t* current_ptr = run_ptr->next;
-	EOS_TCB_t* start_ptr = run_ptr;
+	EOS_TCB_t* best_pointer = run_ptr;
     if (run_ptr->blocked != 0 || run_ptr->paused != 0)
     {
-    	start_ptr = &idle_task;
-    	current_ptr = start_ptr->next;
+    	best_pointer = &idle_task; //every other task is still checked below
     }
 
-    EOS_TCB_t* best_pointer = start_ptr;
 	while (current_ptr != run_ptr){
 		if (current_ptr->blocked == 0 && current_ptr->paused == 0 && current_ptr->priority >= best_pointer->priority){
 			best_pointer = current_ptr;
 		}
 		current_ptr = current_ptr->next;
 	}
+#endif
+
+	if (best_pointer != run_ptr)
+	{
+		EOS_TRACE(EOS_TRACE_TASK_OUT, run_ptr, 0);
+		EOS_TRACE(EOS_TRACE_TASK_IN, best_pointer, 0);
+		EOS_WaitProfileSwitch(run_ptr, best_pointer);
+		EOS_InversionSwitch(run_ptr, best_pointer);
+#if EOS_TASK_STATS_ENABLE
+		uint32_t now = EOS_GetCycles();
+		run_ptr->cycles += now - stats_since;
+		stats_total += now - stats_since;
+		stats_since = now;
+		best_pointer->switches++;
+#endif
+	}
+#if EOS_SMP_ENABLE
+	eos_run_ptr[EOS_PortCoreId()] = best_pointer;
+	EOS_SmpUnlock();
+#else
 	run_ptr = best_pointer;
+#endif
 
 	return;
 }
 
 
 /**
- * @brief PendSV exception handler for context switching.
- *
- * This function draws inspiration from the FreeRTOS Kernel PendSV_Handler, and shares some similarities.
- * Credit here:	https://github.com/FreeRTOS/FreeRTOS-Kernel.
- */
-__attribute__((naked))void PendSV_Handler(void)
-{
-	 __asm volatile (
-	        "CPSID I\n"
-	        "MRS R2, PSP\n"
-	        "TST LR, #0x10\n" //check if in fpu mode
-	        "IT EQ\n"
-	        "VSTMDBEQ R2!, {S16-S31}\n" //save fpu registers
-			"STMDB R2!, {R4-R11}\n"
-			"STMDB R2!, {R14}\n"
-	        "LDR R0, =run_ptr\n"
-	        "LDR R1, [R0]\n"
-	        "STR R2, [R1]\n"
-	        "STMDB SP!, {R0}\n"
-	        "BL EOS_scheduler\n"
-	        "LDMIA SP!, {R0}\n"
-	        "LDR R1, [R0]\n"
-	        "LDR R2, [R1]\n"
-			"LDMIA R2!, {R14}\n"
-			"LDMIA R2!, {R4-R11}\n"
-	        "TST LR, #0x10\n"
-	        "IT EQ\n"
-	        "VLDMIAEQ R2!, {S16-S31}\n"
-	        "MSR PSP, R2\n"
-	        "CPSIE I\n"
-	        "BX LR\n"
-	        ".align 4\n"
-	    );
-}
-
-
-/**
- * @brief SysTick interrupt handler.
- *
- * Enables the PendSV interrupt when it is time to perform a context switch. Handles task timeout decrementing.
+ * @brief Kernel tick, called by the port every 1ms (the Systick interrupt on Cortex-M).
  *
- * @note HAL initalizes the systick to run at 1 ms intervals based off the clock speed of the processor.
- * If you are not using HAL, please do this yourself otherwise certain EvanRTOS features (ie EOS_Delay()) will not work.
+ * Triggers a context switch when it is time to perform one. Handles task timeout decrementing. With EOS_SMP_ENABLE,
+ * every core ticks, and core 0 handles the timeouts.
  */
-void SysTick_Handler(void)
+void EOS_Tick(void)
 {
 	EOS_EnterCritical();
-	static uint32_t eos_tickCounter = 0;
-	HAL_IncTick();
+	static uint32_t eos_tickCounter[EOS_CORES] = {0};
+	uint32_t core = EOS_CORE_ID();
 
-	eos_tickCounter++;
+	eos_tickCounter[core]++;
 
-	if (eos_tickCounter >= task_period && scheduler_enable == 1)
+	if (eos_tickCounter[core] >= task_period && scheduler_enable == 1)
 	{
-		eos_tickCounter = 0;
-		EOS_HandleTimeout();
-  		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+		eos_tickCounter[core] = 0;
+		if (core == 0)
+		{
+			EOS_HandleTimeout();
+		}
+		EOS_PortYield();
   	}
 
 	EOS_ExitCritical();
 
+#if EOS_HAL_ENABLE
+	if (core == 0)
+	{
+		EOS_HalTick(); //every tick, whatever the task period
+	}
+#endif
 }
 
 
@@ -325,6 +344,8 @@ void EOS_Delay(uint32_t timeout){
 	}
 	run_ptr->blocked = EOS_TIMED_OUT;
 	run_ptr->timeOut = timeout;
+	EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, EOS_TIMED_OUT);
+	EOS_WaitProfileBlock(run_ptr, EOS_TIMED_OUT);
 	EOS_ExitCritical();
 	EOS_Suspend();
 
@@ -347,15 +368,20 @@ EOS_status_t EOS_Pause(EOS_task_id_t task)
 
 	if (task == NULL)
 	{
+		EOS_ExitCritical();
 		return EOS_ERROR;
 	}
 
 	if(task->paused != 0)
 	{
+		EOS_ExitCritical();
 		return EOS_ERROR;
 	}
 
 	task->paused = EOS_PAUSED;
+#if EOS_SMP_ENABLE
+	EOS_SmpPreempt(task);
+#endif
 
 	if (task == run_ptr)
 	{
@@ -385,37 +411,204 @@ EOS_status_t EOS_Resume(EOS_task_id_t task)
 
 	if (task == NULL)
 	{
+		EOS_ExitCritical();
 		return EOS_ERROR;
 	}
 
 	if (task->paused != EOS_PAUSED)
 	{
+		EOS_ExitCritical();
 		return EOS_ERROR;
 	}
 
 	task->paused = 0;
+#if EOS_SMP_ENABLE
+	if (task->blocked == 0)
+	{
+		EOS_SmpWake(task); //like on a single core, the calling task is not preempted
+	}
+#endif
 	EOS_ExitCritical();
 	return EOS_OK;
 }
 
 
+/**
+ * @brief Fills an array with the state of every task, starting with the idle task.
+ *
+ * @details Each task's state is read with interrupts masked, one task at a time, so the snapshot is consistent per task
+ * 			but not across tasks. With EOS_TASK_STATS_ENABLE, it also gives each task's stack high water mark (see
+ * 			EOS_StackHighWater(), found outside of the masked section), its cycles, switch count, and share of the CPU
+ * 			since the previous call. CPU shares are only meaningful if a single caller takes
+ * 			snapshots.
+ *
+ * @param tasks Array to fill in.
+ * @param max Size of the array.
+ *
+ * @return The number of tasks filled in.
+ */
+uint32_t EOS_TaskSnapshot(EOS_task_info_t* tasks, uint32_t max){
+
+	EOS_TCB_t* task = &idle_task;
+	uint32_t count = 0;
+
+#if EOS_TASK_STATS_ENABLE
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t now = EOS_GetCycles();
+	run_ptr->cycles += now - stats_since;
+	stats_total += now - stats_since;
+	stats_since = now;
+	uint64_t interval = stats_total - stats_snapshot_total;
+	stats_snapshot_total = stats_total;
+	EOS_PortRestoreInterrupts(state);
+#endif
+
+	do
+	{
+		if (count == max)
+		{
+			break;
+		}
+
+		EOS_task_info_t* info = &tasks[count++];
+		memset(info, 0, sizeof(EOS_task_info_t));
+
+		uint32_t mask = EOS_PortMaskInterrupts();
+
+		info->task = task;
+		info->id = task->id;
+		info->priority = task->priority;
+		info->stack_size = task->stack_size;
+
+		if (task->paused)
+		{
+			info->state = EOS_TASK_PAUSED;
+		}
+		else if (task->blocked == EOS_TIMED_OUT)
+		{
+			info->state = EOS_TASK_DELAYED;
+			info->timeout = task->timeOut;
+		}
+		else if (task->blocked != 0)
+		{
+			info->state = EOS_TASK_BLOCKED;
+			info->object = task->blocked;
+		}
+		else
+		{
+#if EOS_SMP_ENABLE
+			info->state = (task->running != EOS_SMP_NO_CORE) ? EOS_TASK_RUNNING : EOS_TASK_READY;
+#else
+			info->state = (task == run_ptr) ? EOS_TASK_RUNNING : EOS_TASK_READY;
+#endif
+		}
+
+#if EOS_TASK_STATS_ENABLE
+		info->cycles = task->cycles;
+		info->switches = task->switches;
+		if (interval != 0)
+		{
+			info->cpu = (uint16_t)((task->cycles - task->snapshot_cycles) * 1000 / interval);
+		}
+		task->snapshot_cycles = task->cycles;
+#endif
+
+		EOS_PortRestoreInterrupts(mask);
+
+		info->stack_used = EOS_StackHighWater(task);
+
+		task = task->next;
+	} while (task != &idle_task);
+
+	return count;
+}
+
+
+
+/**
+ * @brief Returns the most stack a task has ever used, in words.
+ *
+ * @details The stack is painted with EOS_STACK_PAINT when the task is created, and scanned up from its lowest address
+ * 			to the first word that was written, so the cost grows with the part of the stack that was never used, not
+ * 			with the stack size. It can miss use by a function that reserves stack space it never writes. Stacks are
+ * 			painted when EOS_STACK_CHECK_ENABLE or EOS_TASK_STATS_ENABLE is set, otherwise this returns 0. On the
+ * 			POSIX port, tasks run on host stacks, and this also returns 0. With EOS_MPU_GUARD_ENABLE, the scan starts
+ * 			above the guard region, which counts as used.
+ *
+ * @param task The task, or NULL for the calling task.
+ *
+ * @return Words of the stack used at most, so far.
+ */
+uint32_t EOS_StackHighWater(EOS_task_id_t task){
+#if EOS_STACK_PAINT_ENABLE
+	if (task == NULL)
+	{
+		task = run_ptr;
+	}
+
+	uint32_t untouched = 0;
+#if EOS_MPU_GUARD_ENABLE
+	//the running task's guard region can't be read, and a guard can't have been written to without a fault
+	uintptr_t guard_end = (((uintptr_t)task->stack + EOS_MPU_GUARD_SIZE - 1) & ~(uintptr_t)(EOS_MPU_GUARD_SIZE - 1)) +
+			EOS_MPU_GUARD_SIZE;
+	untouched = (uint32_t)((guard_end - (uintptr_t)task->stack) / sizeof(int32_t));
+	if (untouched > task->stack_size)
+	{
+		untouched = task->stack_size;
+	}
+#endif
+	while (untouched < task->stack_size && (uint32_t)task->stack[untouched] == EOS_STACK_PAINT)
+	{
+		untouched++;
+	}
+	return task->stack_size - untouched;
+#else
+	(void)task;
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief Called when a task has overflowed its stack: by the scheduler when EOS_STACK_CHECK_ENABLE finds the bottom
+ * 			of the outgoing task's stack written, or by the port's memory fault handler when the EOS_MPU_GUARD_ENABLE
+ * 			guard is hit. The stack and whatever lies below it can no longer be trusted, so the default stops
+ * 			everything, with the task in its argument for a debugger. Override it to log and reset instead.
+ */
+__attribute__((weak)) void EOS_StackOverflow(EOS_task_id_t task){
+	volatile EOS_task_id_t overflowed = task;
+	(void)overflowed;
+
+	EOS_PortDisableInterrupts();
+	while (1)
+	{
+	}
+}
+
+
 
 /*		HELPER FUNCTIONS		*/
 
 
 /**
- * @brief Triggers the PendSV interrupt to handle context switching
+ * @brief Requests a context switch from the port (the PendSV interrupt on Cortex-M)
  */
 void EOS_Suspend(){
-	SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	EOS_PortYield();
 }
 
 
+#if !EOS_CRITICAL_PROFILE_ENABLE //replaced by the profiling versions in eos_critical.c
+
 /**
- * @brief Disables interrupts to allow for critical sections to be run without worry of a context switch.
+ * @brief Disables interrupts to allow for critical sections to be run without worry of a context switch. With
+ * 			EOS_SMP_ENABLE, it also takes the kernel lock, to keep the other cores out.
  */
 void EOS_EnterCritical(){
-	__disable_irq();
+	EOS_PortDisableInterrupts();
+#if EOS_SMP_ENABLE
+	EOS_SmpLock();
+#endif
 }
 
 
@@ -423,9 +616,24 @@ void EOS_EnterCritical(){
  * @brief Enables interrupts after critical section code has finished running.
  */
 void EOS_ExitCritical(){
-	__enable_irq();
+#if EOS_SMP_ENABLE
+	EOS_SmpUnlock();
+#endif
+	EOS_PortEnableInterrupts();
 }
 
+#endif
+
+
+
+/**
+ * @brief Returns the number of cycles counted by the port's cycle counter (the DWT cycle counter on Cortex-M). The
+ * 			counter is started by EOS_Init(), runs at EOS_PORT_CYCLE_HZ, and wraps around every 2^32 cycles, so
+ * 			differences between two readings should be taken as uint32_t.
+ */
+uint32_t EOS_GetCycles(void){
+	return EOS_PortGetCycles();
+}
 
 
 /**
@@ -457,8 +665,14 @@ void EOS_TaskUnblock(void* item){
     if (best_ptr != NULL)
     {
         best_ptr->blocked = 0;
+        EOS_TRACE(EOS_TRACE_UNBLOCK, best_ptr, item);
+        EOS_WaitProfileUnblock(best_ptr);
 
+#if EOS_SMP_ENABLE
+        if (EOS_SmpWake(best_ptr))
+#else
         if (best_ptr->priority > run_ptr->priority)
+#endif
         {
             EOS_ExitCritical();
             EOS_Suspend();
@@ -484,6 +698,11 @@ static void EOS_HandleTimeout(){
 				 if (current->timeOut == 0)
 				 {
 					 current->blocked = 0;
+					 EOS_TRACE(EOS_TRACE_UNBLOCK, current, EOS_TIMED_OUT);
+					 EOS_WaitProfileUnblock(current);
+#if EOS_SMP_ENABLE
+					 EOS_SmpWake(current); //the tick switches this core anyway
+#endif
 				 }
 			 }
 		 }
@@ -493,73 +712,18 @@ static void EOS_HandleTimeout(){
 
 
 /**
- * @brief Initializes the stack for a new task, that does not use the FPU.
- *
- * @param task_stack Pointer to the base of the task's stack memory
- * @param stack_size Size of the stack in 32-bit words.
- * @param function   Pointer to the task's function.
- *
- */
-static void EOS_InitStack(int32_t* task_stack, uint32_t stack_size, void* function){
-
-	task_stack[stack_size-1] = 0x01000000;  //xpsr
-	task_stack[stack_size-2] = (int32_t)function; //pc
-	task_stack[stack_size-3] = 0xFFFFFFFD; 	//lr
-	task_stack[stack_size-4] = 0xDEADBEEA;  //r12
-	task_stack[stack_size-5] = 0xDEADBEEB;  //r3
-	task_stack[stack_size-6] = 0xDEADBEEC;  //r2
-	task_stack[stack_size-7] = 0xDEADBEED;	//r1
-	task_stack[stack_size-8] = 0xDEADBEEF;	//r0
-	task_stack[stack_size-9] = 0xDEADBEEF;	//r11
-	task_stack[stack_size-10] = 0xDEADBEAA;	//r10
-	task_stack[stack_size-11] = 0xDEADBEDF; //r9
-	task_stack[stack_size-12] = 0xDEADBEBF; //r8
-	task_stack[stack_size-13] = 0xDEADBECF; //r7
-	task_stack[stack_size-14] = 0xDEADBECC; //r6
-	task_stack[stack_size-15] = 0xDEADBEDD; //r5
-	task_stack[stack_size-16] = 0xDEADBAAA; //r4
-	task_stack[stack_size-17] = 0xFFFFFFFD; //store LR in fixed place for ease of context switching
-
-
-}
-
-
-/**
- * @brief Initializes the stack for a new task, that uses the FPU.
- *
- * @param task_stack Pointer to the base of the task's stack memory
- * @param stack_size Size of the stack in 32-bit words.
- * @param function   Pointer to the task's function.
- *
+ * @brief Fills a new task stack with EOS_STACK_PAINT, so EOS_StackHighWater() can find how much of it was used.
  */
-static void EOS_InitFpuStack(int32_t* task_stack, uint32_t stack_size, void* function){
-	task_stack[stack_size-1] = 0xDEADBEEF;
-	task_stack[stack_size-2] = 0x00000000; //fpscr
-
-	for(int i = 3; i < 19; i++)
-	{
-		task_stack[stack_size-i] = 0x00000000; //S15->S0 fpu registers
-	}
-
-	task_stack[stack_size-19] = 0x01000000; //xPSR
-	task_stack[stack_size-20] = (int32_t)function;
-	task_stack[stack_size-21] = 0xFFFFFFED; //lr
-	task_stack[stack_size-22] = 0xDEADBEEA;  //r12
-	task_stack[stack_size-23] = 0xDEADBEEB;  //r3
-	task_stack[stack_size-24] = 0xDEADBEEC;  //r2
-	task_stack[stack_size-25] = 0xDEADBEED;	//r1
-	task_stack[stack_size-26] = 0xDEADBEEF;	//r0
-
-	for (int i = 27; i < 43; i++)
+static void EOS_PaintStack(int32_t* stack, uint32_t stack_size){
+#if EOS_STACK_PAINT_ENABLE
+	for (uint32_t i = 0; i < stack_size; i++)
 	{
-		task_stack[stack_size - i] = 0x00000000; //S31-s16 fpu registers
+		stack[i] = (int32_t)EOS_STACK_PAINT;
 	}
-	for(int i = 43; i < 51; i++)
-	{
-		task_stack[stack_size-i] = 0xDEADBEEF; //r11-r4
-	}
-
-	task_stack[stack_size-51] = 0xFFFFFFED; //store LR in fixed place for ease of context switching
+#else
+	(void)stack;
+	(void)stack_size;
+#endif
 }
 
 
@@ -567,6 +731,6 @@ static void EOS_InitFpuStack(int32_t* task_stack, uint32_t stack_size, void* fun
 void idleTask(){
 
 	while(1){
-
+		EOS_PortIdle();
 	}
 }
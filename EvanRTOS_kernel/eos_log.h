@@ -0,0 +1,131 @@
+/*
+ * eos_log.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_LOG_H_
+#define INC_EOS_LOG_H_
+
+#include <string.h>
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* Top byte of every record's first word, so a decoder joining a stream part way through can find the next record */
+#define EOS_LOG_SYNC 0xE0000000u
+
+/* Format id of the record the drain task sends when records were dropped, with the number dropped as its argument */
+#define EOS_LOG_ID_DROPPED 0xFFFFu
+
+/* First word of the stream header the drain task sends when it starts ("EOSL") */
+#define EOS_LOG_MAGIC 0x4C534F45u
+#define EOS_LOG_VERSION 1
+
+/* Most arguments of one EOS_LOG() call */
+#define EOS_LOG_MAX_ARGS 8
+
+
+/*	LOGGING MACRO	*/
+
+/*
+ * EOS_LOG("format", args...) records a log message from a task or an interrupt, without formatting it. The format
+ * string goes in the eos_log section, and only its offset in that section, a timestamp, and the arguments are written
+ * to the log ring (2 + number of arguments words). The host decoder (tools/eos_log_decode.py) reads the format strings
+ * back from the ELF file and does the formatting.
+ *
+ * 	- the format must be a string literal, with at most EOS_LOG_MAX_ARGS arguments
+ * 	- every argument is stored as one 32 bit word: integers are truncated to 32 bits, float and double are stored as
+ * 	  float, and pointers as their address
+ * 	- %s arguments must point to constant strings (string literals), which the decoder reads from the ELF file
+ *
+ * When EOS_LOG_ENABLE is 0 the macro expands to nothing, and its arguments are not evaluated.
+ */
+#if EOS_LOG_ENABLE
+
+#define EOS_LOG(format, ...) do { \
+	static const char eos_log_format[] __attribute__((section("eos_log"), used)) = format; \
+	EOS_LogRecord(eos_log_format, EOS_LOG_COUNT(__VA_ARGS__), \
+			(const uint32_t[EOS_LOG_COUNT(__VA_ARGS__) + 1]){ EOS_LOG_WORDS(__VA_ARGS__) 0 }); \
+	} while (0)
+
+#else
+
+#define EOS_LOG(format, ...) do { } while (0)
+
+#endif
+
+/* Number of arguments (0 to 8) */
+#define EOS_LOG_COUNT(...) EOS_LOG_COUNT_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define EOS_LOG_COUNT_(_0, _1, _2, _3, _4, _5, _6, _7, _8, count, ...) count
+
+/* Each argument converted to a word, followed by a comma */
+#define EOS_LOG_WORDS(...) EOS_LOG_WORDS_(EOS_LOG_COUNT(__VA_ARGS__), ##__VA_ARGS__)
+#define EOS_LOG_WORDS_(count, ...) EOS_LOG_WORDS__(count, ##__VA_ARGS__)
+#define EOS_LOG_WORDS__(count, ...) EOS_LOG_WORDS_##count(__VA_ARGS__)
+#define EOS_LOG_WORDS_0()
+#define EOS_LOG_WORDS_1(a) EOS_LOG_WORD(a),
+#define EOS_LOG_WORDS_2(a, ...) EOS_LOG_WORD(a), EOS_LOG_WORDS_1(__VA_ARGS__)
+#define EOS_LOG_WORDS_3(a, ...) EOS_LOG_WORD(a), EOS_LOG_WORDS_2(__VA_ARGS__)
+#define EOS_LOG_WORDS_4(a, ...) EOS_LOG_WORD(a), EOS_LOG_WORDS_3(__VA_ARGS__)
+#define EOS_LOG_WORDS_5(a, ...) EOS_LOG_WORD(a), EOS_LOG_WORDS_4(__VA_ARGS__)
+#define EOS_LOG_WORDS_6(a, ...) EOS_LOG_WORD(a), EOS_LOG_WORDS_5(__VA_ARGS__)
+#define EOS_LOG_WORDS_7(a, ...) EOS_LOG_WORD(a), EOS_LOG_WORDS_6(__VA_ARGS__)
+#define EOS_LOG_WORDS_8(a, ...) EOS_LOG_WORD(a), EOS_LOG_WORDS_7(__VA_ARGS__)
+
+#define EOS_LOG_WORD(value) _Generic((value), \
+	float: EOS_LogFloatWord, \
+	double: EOS_LogFloatWord, \
+	char*: EOS_LogPointerWord, \
+	const char*: EOS_LogPointerWord, \
+	void*: EOS_LogPointerWord, \
+	const void*: EOS_LogPointerWord, \
+	default: EOS_LogIntegerWord)(value)
+
+
+static inline uint32_t EOS_LogIntegerWord(uint32_t value)
+{
+	return value;
+}
+
+static inline uint32_t EOS_LogFloatWord(double value)
+{
+	float single = (float)value;
+	uint32_t word;
+
+	memcpy(&word, &single, sizeof(word));
+	return word;
+}
+
+static inline uint32_t EOS_LogPointerWord(const void* value)
+{
+	return (uint32_t)(uintptr_t)value;
+}
+
+
+/*	DATATYPES	*/
+
+typedef struct {
+	uint32_t written;			//records written to the ring
+	uint32_t dropped;			//records dropped because the ring was full
+	uint32_t high_water;		//most words the ring has held at once
+} EOS_log_stats_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_LOG_ENABLE
+
+void EOS_LogRecord(const char* format, uint32_t count, const uint32_t* args);
+uint32_t EOS_LogRead(uint32_t* words, uint32_t max);
+EOS_task_id_t EOS_LogStart(void);
+void EOS_LogOutput(const uint8_t* data, uint32_t length);
+const EOS_log_stats_t* EOS_LogStats(void);
+
+#else
+
+#define EOS_LogStart()
+
+#endif
+
+#endif /* INC_EOS_LOG_H_ */
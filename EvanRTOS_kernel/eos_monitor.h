@@ -0,0 +1,27 @@
+/*
+ * eos_monitor.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_MONITOR_H_
+#define INC_EOS_MONITOR_H_
+
+#include "eos_kernel.h"
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_MONITOR_ENABLE
+
+EOS_task_id_t EOS_MonitorStart(uint32_t period_ticks);
+uint32_t EOS_MonitorFormat(char* buffer, uint32_t size, uint32_t sequence, const EOS_task_info_t* info);
+void EOS_MonitorWrite(const char* data, uint32_t length);
+
+#else
+
+#define EOS_MonitorStart(period_ticks)
+
+#endif
+
+#endif /* INC_EOS_MONITOR_H_ */
@@ -0,0 +1,128 @@
+/*
+ * eos_profile.c
+ *
+ *      Statistical sampling profiler for EvanRTOS. When EOS_PROFILE_ENABLE is set in eos_config.h, the port runs a
+ *      high priority timer interrupt (TIM7 on the ARM_CM7 port) that reads the program counter stacked by the
+ *      interrupted code, and passes it to EOS_ProfileSample(). Each sample is counted against the task in run_ptr, or
+ *      against EOS_PROFILE_ISR when another interrupt handler was running.
+ *
+ *      Counts are kept in a small open addressing hash table keyed by (task, PC bucket), so a profile takes a fixed
+ *      EOS_PROFILE_ENTRIES * 8 bytes of RAM however long it runs. Samples that find no free entry are counted in
+ *      eos_profile.dropped.
+ *
+ *      To get a profile off a unit, dump the eos_profile variable (for example with gdb:
+ *      "dump binary value profile.bin eos_profile"), and symbolize it with tools/eos_profile2folded.py against the
+ *      firmware ELF. The output is in the folded stack format used by flamegraph.pl and https://www.speedscope.app.
+ *
+ *      Note that the timer interrupt is masked inside critical sections, so time spent in them is charged to the
+ *      instruction that enables interrupts again.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_profile.h"
+
+#if EOS_PROFILE_ENABLE
+
+/*	GLOBAL VARIABLES	*/
+EOS_profile_buffer_t eos_profile = {
+		.magic = EOS_PROFILE_MAGIC,
+		.version = EOS_PROFILE_VERSION,
+		.entry_size = sizeof(EOS_profile_entry_t),
+		.capacity = EOS_PROFILE_ENTRIES,
+		.pc_shift = EOS_PROFILE_PC_SHIFT
+};
+
+#define EOS_PROFILE_PROBES 8 //entries tried before a sample is dropped
+
+
+
+/*	PROFILER FUNCTIONALITY	*/
+
+
+/**
+ * @brief Starts sampling at EOS_PROFILE_HZ. Called by EOS_Init(); samples start once the first task runs.
+ */
+void EOS_ProfileInit(void)
+{
+	eos_profile.anchor = (uint32_t)(uintptr_t)EOS_ProfileSample;
+	EOS_ProfileStart(EOS_PROFILE_HZ);
+}
+
+
+/**
+ * @brief Starts, or changes the rate of, the sampling timer. Samples already taken are kept.
+ *
+ * @param sample_hz Samples per second.
+ */
+void EOS_ProfileStart(uint32_t sample_hz)
+{
+	eos_profile.sample_hz = sample_hz;
+	EOS_PortProfileStart(sample_hz);
+}
+
+
+/**
+ * @brief Stops the sampling timer, for example before dumping the profile.
+ */
+void EOS_ProfileStop(void)
+{
+	EOS_PortProfileStop();
+}
+
+
+/**
+ * @brief Drops every sample taken so far.
+ */
+void EOS_ProfileClear(void)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+
+	memset(eos_profile.entries, 0, sizeof(eos_profile.entries));
+	eos_profile.samples = 0;
+	eos_profile.dropped = 0;
+
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+/**
+ * @brief Counts one sample. Called by the port's sampling interrupt.
+ *
+ * @param pc The program counter of the interrupted code.
+ * @param in_isr Non zero if the interrupted code was another interrupt handler.
+ */
+void EOS_ProfileSample(uint32_t pc, uint8_t in_isr)
+{
+	uint8_t task = in_isr ? EOS_PROFILE_ISR : EOS_TASK_ID_RECORD(run_ptr->id);
+	uint32_t bucket = (pc >> EOS_PROFILE_PC_SHIFT) << EOS_PROFILE_PC_SHIFT;
+	uint32_t index = ((bucket >> EOS_PROFILE_PC_SHIFT) * 2654435761u) ^ task; //Knuth multiplicative hash
+
+	eos_profile.samples++;
+
+	for (uint32_t probe = 0; probe < EOS_PROFILE_PROBES; probe++)
+	{
+		EOS_profile_entry_t* entry = &eos_profile.entries[(index + probe) & (EOS_PROFILE_ENTRIES - 1)];
+
+		if (entry->pc == 0)
+		{
+			entry->pc = bucket;
+			entry->task = task;
+		}
+
+		if (entry->pc == bucket && entry->task == task)
+		{
+			if (entry->count == UINT16_MAX)
+			{
+				break;
+			}
+			entry->count++;
+			return;
+		}
+	}
+
+	eos_profile.dropped++;
+}
+
+#endif
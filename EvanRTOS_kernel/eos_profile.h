@@ -0,0 +1,59 @@
+/*
+ * eos_profile.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_PROFILE_H_
+#define INC_EOS_PROFILE_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+#define EOS_PROFILE_MAGIC 0x50534F45 //"EOSP"
+#define EOS_PROFILE_VERSION 1
+#define EOS_PROFILE_ISR 0xFF //task id of samples taken while another interrupt handler was running
+
+/*	DATATYPES	*/
+
+typedef struct {
+	uint32_t pc;		//start address of the PC bucket, 0 if the entry is free
+	uint8_t task;		//task id, or EOS_PROFILE_ISR
+	uint8_t reserved;
+	uint16_t count;		//saturates at UINT16_MAX
+} EOS_profile_entry_t;
+
+/* The whole profile is kept in one block, so it can be dumped from a debugger or a task in one go */
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t entry_size;
+	uint32_t capacity;
+	uint32_t sample_hz;
+	uint32_t samples;
+	uint32_t dropped;	//samples lost because the table was full, or a counter saturated
+	uint32_t pc_shift;
+	uint32_t anchor;	//run time address of EOS_ProfileSample(), to relocate position independent (host) builds
+	EOS_profile_entry_t entries[EOS_PROFILE_ENTRIES];
+} EOS_profile_buffer_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_PROFILE_ENABLE
+
+extern EOS_profile_buffer_t eos_profile;
+
+void EOS_ProfileInit(void);
+void EOS_ProfileStart(uint32_t sample_hz);
+void EOS_ProfileStop(void);
+void EOS_ProfileClear(void);
+void EOS_ProfileSample(uint32_t pc, uint8_t in_isr);
+
+#else
+
+#define EOS_ProfileInit()
+
+#endif
+
+#endif /* INC_EOS_PROFILE_H_ */
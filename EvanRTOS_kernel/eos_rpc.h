@@ -0,0 +1,95 @@
+/*
+ * eos_rpc.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_RPC_H_
+#define INC_EOS_RPC_H_
+
+#include "eos_dual_core.h"
+
+/*	CONSTANTS	*/
+
+/* Returned by EOS_RpcLookup() for a name no core has registered */
+#define EOS_RPC_NO_ENDPOINT 0xFFFFFFFFu
+
+/* Written to EOS_rpc_shared_t.magic by the primary core once the shared memory is ready */
+#define EOS_RPC_MAGIC 0x45525043u
+
+#if EOS_RPC_ENABLE && !EOS_DUAL_CORE_ENABLE
+#error "EOS_RPC_ENABLE needs EOS_DUAL_CORE_ENABLE"
+#endif
+
+
+/*	DATATYPES	*/
+
+/* Runs a call on the core that registered the endpoint, in its service task. message holds the size byte request,
+ * and the handler writes its response over it, up to EOS_RPC_MESSAGE_SIZE bytes. Returns the response size */
+typedef uint32_t (*EOS_rpc_handler_t)(void* message, uint32_t size);
+
+/* A named endpoint, registered by the core that serves it */
+typedef struct {
+	char name[EOS_RPC_NAME_SIZE];
+	uint32_t core;
+	volatile uint32_t registered;
+} EOS_rpc_endpoint_entry_t;
+
+/* One call in flight. It goes from EOS_RPC_QUEUED to EOS_RPC_DONE on the serving core, then EOS_RPC_RETURNED on the
+ * calling core, whose EOS_RpcWait() frees it. Calls submitted together are chained through next */
+typedef struct {
+	volatile uint32_t state;
+	uint32_t endpoint;
+	uint32_t caller;			//core
+	uint32_t next;				//next call of the batch, or EOS_RPC_SLOTS at the end
+	uint32_t size;				//of the request, then of the response
+	EOS_status_t status;
+	uint8_t message[EOS_RPC_MESSAGE_SIZE] __attribute__((aligned(4)));
+} EOS_rpc_call_t;
+
+/* Everything the two cores share, placed like EOS_dual_shared_t */
+typedef struct {
+	volatile uint32_t magic;
+	volatile uint32_t lock;		//for ports with a software lock, see EOS_PortCoreLock()
+	EOS_rpc_endpoint_entry_t endpoints[EOS_RPC_ENDPOINTS];
+	EOS_rpc_call_t calls[EOS_RPC_SLOTS];
+} EOS_rpc_shared_t;
+
+/* One request of a batch, see EOS_RpcCallBatch() */
+typedef struct {
+	uint32_t endpoint;
+	const void* data;
+	uint32_t size;
+} EOS_rpc_request_t;
+
+typedef uint32_t EOS_rpc_endpoint_t;
+typedef EOS_rpc_call_t* EOS_rpc_handle_t;
+
+/* Call states */
+typedef enum {
+	EOS_RPC_FREE = 0,
+	EOS_RPC_QUEUED = 1,
+	EOS_RPC_DONE = 2,
+	EOS_RPC_RETURNED = 3
+} EOS_rpc_state_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_RPC_ENABLE
+
+EOS_status_t EOS_RpcInit(uint32_t core, EOS_rpc_shared_t* shared, EOS_priority_t priority);
+
+EOS_status_t EOS_RpcRegister(const char* name, EOS_rpc_handler_t handler);
+EOS_rpc_endpoint_t EOS_RpcLookup(const char* name);
+
+EOS_rpc_handle_t EOS_RpcCallAsync(EOS_rpc_endpoint_t endpoint, const void* request, uint32_t size);
+EOS_status_t EOS_RpcCallBatch(const EOS_rpc_request_t* requests, uint32_t count, EOS_rpc_handle_t* handles);
+EOS_status_t EOS_RpcPoll(EOS_rpc_handle_t handle);
+EOS_status_t EOS_RpcWait(EOS_rpc_handle_t handle, void* response, uint32_t* size);
+EOS_status_t EOS_RpcCall(EOS_rpc_endpoint_t endpoint, const void* request, uint32_t size, void* response,
+		uint32_t* response_size);
+
+#endif
+
+#endif /* INC_EOS_RPC_H_ */
@@ -0,0 +1,67 @@
+/*
+ * eos_rtt.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_RTT_H_
+#define INC_EOS_RTT_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+
+/* Up channels (target to host) used by _write() */
+#define EOS_RTT_STDOUT 0
+#define EOS_RTT_STDERR 1
+
+/* Down channel (host to target) used by _read() */
+#define EOS_RTT_STDIN 0
+
+/* What a write to a full up channel does, the mode is kept in the channel flags like other RTT implementations */
+#define EOS_RTT_MODE_SKIP 0			//drop the whole write
+#define EOS_RTT_MODE_TRIM 1			//write what fits, drop the rest
+
+
+/*	DATATYPES	*/
+
+/* One channel ring buffer. The writer only moves write, the reader only moves read, so a debug probe can read or
+ * write the ring through the debug port while the target runs. The ring is empty when read == write */
+typedef struct {
+	const char* name;
+	char* buffer;
+	uint32_t size;
+	volatile uint32_t write;
+	volatile uint32_t read;
+	uint32_t flags;
+} EOS_rtt_buffer_t;
+
+/* Control block, laid out like the SEGGER RTT one, so J-Link, OpenOCD ("rtt setup") and probe-rs find and read it as
+ * is: by its symbol name, or by searching RAM for the id string */
+typedef struct {
+	char id[16];
+	int32_t up_count;
+	int32_t down_count;
+	EOS_rtt_buffer_t up[EOS_RTT_UP_CHANNELS];
+	EOS_rtt_buffer_t down[EOS_RTT_DOWN_CHANNELS];
+} EOS_rtt_control_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_RTT_ENABLE
+
+extern EOS_rtt_control_t _SEGGER_RTT;
+
+void EOS_RttInit(void);
+uint32_t EOS_RttWrite(uint32_t channel, const void* data, uint32_t length);
+uint32_t EOS_RttRead(uint32_t channel, void* data, uint32_t size);
+uint32_t EOS_RttDropped(uint32_t channel);
+
+/* Host (probe) side, for a drain task or a stand-in reader. Each channel may only have one host side user */
+uint32_t EOS_RttReadUp(uint32_t channel, void* data, uint32_t size);
+uint32_t EOS_RttWriteDown(uint32_t channel, const void* data, uint32_t length);
+
+#endif
+
+#endif /* INC_EOS_RTT_H_ */
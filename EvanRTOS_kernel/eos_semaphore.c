@@ -24,6 +24,9 @@
 
 /*	INCLUDES	*/
 #include "eos_semaphore.h"
+#include "eos_trace.h"
+#include "eos_wait.h"
+#include "eos_inversion.h"
 
 
 /*	SEMAPHORE FUNCTIONALITY		*/
@@ -36,15 +39,23 @@
  * @return EOS_OK on successful acquisition.
  */
 EOS_status_t EOS_SemaphoreAcquire(EOS_semaphore_id_t semaphore) {
+    EOS_CONTENTION_WAIT(wait);
     EOS_EnterCritical();
 
     while (1) {
         if (semaphore->count > 0) {
             semaphore->count--;
+            EOS_TRACE(EOS_TRACE_SEM_ACQUIRE, run_ptr, semaphore);
+            EOS_ContentionAcquire(&semaphore->contention, &wait);
+            EOS_InversionAcquire(run_ptr, semaphore);
             EOS_ExitCritical();
             return EOS_OK;
         } else {
             run_ptr->blocked = semaphore;
+            EOS_TRACE(EOS_TRACE_BLOCK, run_ptr, semaphore);
+            EOS_WaitProfileBlock(run_ptr, semaphore);
+            EOS_ContentionBlock(&semaphore->contention, &wait);
+            EOS_InversionBlock(run_ptr, semaphore);
             EOS_ExitCritical();
             EOS_Suspend();
             EOS_EnterCritical();
@@ -71,6 +82,9 @@ EOS_status_t EOS_SemaphoreRelease(EOS_semaphore_id_t semaphore) {
       }
 
     semaphore->count++;
+    EOS_TRACE(EOS_TRACE_SEM_RELEASE, run_ptr, semaphore);
+    EOS_ContentionRelease(&semaphore->contention, NULL);
+    EOS_InversionRelease(run_ptr, semaphore);
 
     EOS_TaskUnblock(semaphore);
 
@@ -97,6 +111,7 @@ EOS_semaphore_id_t EOS_SemaphoreNew(uint8_t count){
 
 	semaphore->count = count;
 	semaphore->max_count = count;
+	EOS_ContentionRegister(&semaphore->contention, semaphore, EOS_CONTENTION_SEMAPHORE);
 
 	return semaphore;
 }
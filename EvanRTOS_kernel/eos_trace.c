@@ -0,0 +1,127 @@
+/*
+ * eos_trace.c
+ *
+ *      Binary trace recorder for EvanRTOS. When EOS_TRACE_ENABLE is set in eos_config.h, the kernel logs task switches,
+ *      blocking/unblocking, queue and semaphore operations into a RAM ring buffer. Interrupt handlers can also be
+ *      marked by the user with EOS_TraceIsrEnter()/EOS_TraceIsrExit().
+ *
+ *      Each record is 8 bytes, and holds the event, the task id (or isr id), the object involved and a 16 bit
+ *      timestamp delta from the previous record. Timestamps come from EOS_GetCycles(), scaled down by
+ *      EOS_TRACE_TS_SHIFT. When a delta does not fit in 16 bits, an EOS_TRACE_TIME record carrying the full delta
+ *      is written first. Once the buffer is full, the oldest records are overwritten.
+ *
+ *      To get a trace off a unit, dump the eos_trace variable (for example with gdb:
+ *      "dump binary value trace.bin eos_trace"), and convert it with tools/eos_trace2json.py. The output can be
+ *      loaded into chrome://tracing or https://ui.perfetto.dev.
+ *
+ *      Note that the delta of a record is only correct if the previous record was written less than 2^32 core cycles
+ *      before it (~8.9s at 480 MHz).
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_trace.h"
+
+#if EOS_TRACE_ENABLE
+
+/*	GLOBAL VARIABLES	*/
+EOS_trace_buffer_t eos_trace = {
+		.magic = EOS_TRACE_MAGIC,
+		.version = EOS_TRACE_VERSION,
+		.record_size = sizeof(EOS_trace_record_t),
+		.capacity = EOS_TRACE_BUFFER_RECORDS,
+		.head = 0,
+		.written = 0,
+		.ts_hz = 0
+};
+
+static uint32_t trace_last_cycles = 0;
+
+
+
+/*	LOCAL FUNCTIONS	*/
+
+
+/**
+ * @brief Writes a single record to the ring buffer. Must be called with interrupts disabled.
+ */
+static void EOS_TraceWrite(uint8_t event, uint8_t task, uint16_t delta, uint32_t object)
+{
+	EOS_trace_record_t* record = &eos_trace.records[eos_trace.head];
+
+	record->event = event;
+	record->task = task;
+	record->delta = delta;
+	record->object = object;
+
+	eos_trace.head = (eos_trace.head + 1) % EOS_TRACE_BUFFER_RECORDS;
+	eos_trace.written++;
+}
+
+
+
+/*	TRACE FUNCTIONALITY		*/
+
+
+/**
+ * @brief Resets the trace buffer. Called by EOS_Init() once the cycle counter is running.
+ */
+void EOS_TraceInit(void)
+{
+	eos_trace.head = 0;
+	eos_trace.written = 0;
+	eos_trace.ts_hz = EOS_PORT_CYCLE_HZ >> EOS_TRACE_TS_SHIFT;
+	trace_last_cycles = EOS_GetCycles();
+}
+
+
+/**
+ * @brief Records a trace event.
+ *
+ * @param event The type of event.
+ * @param task The id of the task the event belongs to, or the isr id for ISR events.
+ * @param object The queue/semaphore involved, or an event specific argument.
+ *
+ * @note Can be called from tasks, interrupts, and from inside critical sections.
+ */
+void EOS_TraceRecord(EOS_trace_event_t event, uint8_t task, uint32_t object)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+
+	uint32_t elapsed = (EOS_GetCycles() - trace_last_cycles) >> EOS_TRACE_TS_SHIFT;
+	trace_last_cycles += elapsed << EOS_TRACE_TS_SHIFT; //keep the remainder for the next record
+
+	if (elapsed > UINT16_MAX)
+	{
+		EOS_TraceWrite(EOS_TRACE_TIME, 0, 0, elapsed);
+		elapsed = 0;
+	}
+
+	EOS_TraceWrite(event, task, (uint16_t)elapsed, object);
+
+	EOS_PortRestoreInterrupts(state);
+}
+
+
+/**
+ * @brief Marks the start of an interrupt handler in the trace. Call it first thing in the handler.
+ *
+ * @param isr_id A user chosen id for the interrupt, shown in the decoded trace.
+ */
+void EOS_TraceIsrEnter(uint8_t isr_id)
+{
+	EOS_TraceRecord(EOS_TRACE_ISR_ENTER, isr_id, 0);
+}
+
+
+/**
+ * @brief Marks the end of an interrupt handler in the trace. Call it last thing in the handler.
+ *
+ * @param isr_id The id passed to EOS_TraceIsrEnter().
+ */
+void EOS_TraceIsrExit(uint8_t isr_id)
+{
+	EOS_TraceRecord(EOS_TRACE_ISR_EXIT, isr_id, 0);
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * eos_trace.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_TRACE_H_
+#define INC_EOS_TRACE_H_
+
+#include "eos_kernel.h"
+
+/*	CONSTANTS	*/
+#define EOS_TRACE_MAGIC 0x54534F45 //"EOST"
+#define EOS_TRACE_VERSION 1
+
+/*	ENUMERATIONS	*/
+typedef enum {
+	EOS_TRACE_TIME = 0,			//timestamp extension, object holds the full delta
+	EOS_TRACE_TASK_IN = 1,
+	EOS_TRACE_TASK_OUT = 2,
+	EOS_TRACE_BLOCK = 3,		//object is the queue/semaphore, or EOS_TIMED_OUT for EOS_Delay()
+	EOS_TRACE_UNBLOCK = 4,
+	EOS_TRACE_QUEUE_PUT = 5,
+	EOS_TRACE_QUEUE_GET = 6,
+	EOS_TRACE_SEM_ACQUIRE = 7,
+	EOS_TRACE_SEM_RELEASE = 8,
+	EOS_TRACE_ISR_ENTER = 9,	//task field holds the user supplied isr id
+	EOS_TRACE_ISR_EXIT = 10
+} EOS_trace_event_t;
+
+/*	DATATYPES	*/
+
+typedef struct {
+	uint8_t event;
+	uint8_t task;
+	uint16_t delta;		//timestamp units since the previous record
+	uint32_t object;
+} EOS_trace_record_t;
+
+/* The whole trace state is kept in one block, so it can be dumped from a debugger or a task in one go */
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+	uint32_t capacity;
+	uint32_t head;		//index of the next record to be written
+	uint32_t written;	//total records written, records are lost once this exceeds capacity
+	uint32_t ts_hz;		//timestamp frequency
+	EOS_trace_record_t records[EOS_TRACE_BUFFER_RECORDS];
+} EOS_trace_buffer_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_TRACE_ENABLE
+
+extern EOS_trace_buffer_t eos_trace;
+
+void EOS_TraceInit(void);
+void EOS_TraceRecord(EOS_trace_event_t event, uint8_t task, uint32_t object);
+void EOS_TraceIsrEnter(uint8_t isr_id);
+void EOS_TraceIsrExit(uint8_t isr_id);
+
+#define EOS_TRACE(event, tcb, object) EOS_TraceRecord((event), EOS_TASK_ID_RECORD((tcb)->id), (uint32_t)(uintptr_t)(object))
+
+#else
+
+#define EOS_TraceInit()
+#define EOS_TraceIsrEnter(isr_id)
+#define EOS_TraceIsrExit(isr_id)
+#define EOS_TRACE(event, tcb, object)
+
+#endif
+
+#endif /* INC_EOS_TRACE_H_ */
@@ -0,0 +1,73 @@
+/*
+ * eos_wait.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ */
+
+#ifndef INC_EOS_WAIT_H_
+#define INC_EOS_WAIT_H_
+
+#include "eos_kernel.h"
+
+/*	ENUMERATIONS	*/
+typedef enum {
+	EOS_WAIT_READY = 0,		//ready, but not running
+	EOS_WAIT_RUNNING = 1,
+	EOS_WAIT_BLOCKED = 2	//blocked on a queue, a semaphore or EOS_TIMED_OUT
+} EOS_wait_state_t;
+
+
+/*	DATATYPES	*/
+
+typedef struct {
+	uint32_t count;
+	uint32_t max;		//cycles
+	uint64_t total;		//cycles
+} EOS_wait_stat_t;
+
+/* Where one task's time went, indexed by task id */
+typedef struct {
+	EOS_wait_stat_t sleep;		//in EOS_Delay()
+	EOS_wait_stat_t blocked;	//waiting on a queue or semaphore
+	EOS_wait_stat_t ready;		//ready, while other tasks ran (preemption, or starvation)
+	uint64_t running;			//total cycles on the CPU
+
+	uint8_t state;				//EOS_wait_state_t
+	uint32_t since;				//cycle count of the last state change
+	void* object;				//what the task is blocked on
+} EOS_wait_task_t;
+
+/* Time one task spent blocked on one object */
+typedef struct {
+	void* object;		//queue, semaphore or EOS_TIMED_OUT
+	uint16_t task;
+	EOS_wait_stat_t wait;
+} EOS_wait_object_t;
+
+
+/*	FUNCTION DECLARATIONS	*/
+#if EOS_WAIT_PROFILE_ENABLE
+
+void EOS_WaitProfileInit(void);
+void EOS_WaitProfileCreate(EOS_TCB_t* task);
+void EOS_WaitProfileBlock(EOS_TCB_t* task, void* object);
+void EOS_WaitProfileUnblock(EOS_TCB_t* task);
+void EOS_WaitProfileSwitch(EOS_TCB_t* out, EOS_TCB_t* in);
+
+const EOS_wait_task_t* EOS_WaitProfileTasks(uint32_t* count);
+const EOS_wait_object_t* EOS_WaitProfileObjects(uint32_t* count);
+void EOS_WaitProfileReset(void);
+void EOS_WaitProfileReport(void);
+
+#else
+
+#define EOS_WaitProfileInit()
+#define EOS_WaitProfileCreate(task)
+#define EOS_WaitProfileBlock(task, object)
+#define EOS_WaitProfileUnblock(task)
+#define EOS_WaitProfileSwitch(out, in)
+
+#endif
+
+#endif /* INC_EOS_WAIT_H_ */
@@ -0,0 +1,292 @@
+/*
+ * eos_port.c
+ *
+ *      EvanRTOS port for ARMv6-M (Cortex-M0 and Cortex-M0+), built on CMSIS.
+ *
+ *      Works like the ARMv7E-M port: PendSV switches context, SysTick drives the kernel tick, tasks run on the process
+ *      stack pointer (PSP) and interrupts on the main stack pointer (MSP). The PendSV interrupt should be set to the
+ *      lowest priority, and the SysTick interrupt to the second lowest. The switch path is written for the smaller
+ *      instruction set:
+ *      	- STMDB/LDMIA can only move R0-R7, so R8-R11 are moved through R4-R7, and the frame is saved upwards from
+ *      	  the new stack pointer instead of pushed downwards
+ *      	- there is no FPU, so there is one frame layout (16 words, 8 saved by the hardware and 8 by PendSV), and no
+ *      	  EXC_RETURN to keep with it: every task returns to thread mode on the PSP. Creating an EOS_USE_FPU task fails
+ *      	- interrupts are masked with PRIMASK, as there is no BASEPRI
+ *
+ *      ARMv6-M has no DWT cycle counter, so EOS_GetCycles() counts SysTick periods and reads the SysTick counter in
+ *      between (EOS_PortSysTickCycles()), with the resolution of the core clock. It also has no exclusive access
+ *      instructions, so the __atomic read-modify-write operations some kernel modules use are implemented here, by
+ *      masking interrupts.
+ *
+ *      The MPU stack guard (EOS_MPU_GUARD_ENABLE) and the sampling profiler (EOS_PROFILE_ENABLE) are not supported.
+ */
+
+
+/*	INCLUDES	*/
+#include <stdbool.h>
+#include "eos_port.h"
+#include "eos_critical.h"
+
+
+#if EOS_MPU_GUARD_ENABLE
+#error "the ARMv6-M port does not support EOS_MPU_GUARD_ENABLE, use EOS_STACK_CHECK_ENABLE"
+#endif
+
+#if EOS_PROFILE_ENABLE
+#error "the ARMv6-M port does not support the sampling profiler (EOS_PROFILE_ENABLE)"
+#endif
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static __attribute__((naked))void EOS_Start();
+
+
+#if EOS_CRITICAL_PROFILE_ENABLE
+#define EOS_PORT_SCHEDULER "EOS_PortProfiledScheduler"
+#else
+#define EOS_PORT_SCHEDULER "EOS_scheduler"
+#endif
+
+/* Words in the frame of a task that is switched out: R4-R11, then the exception frame R0-R3, R12, LR, PC, xPSR */
+#define EOS_PORT_FRAME_WORDS 16
+
+
+/*	GLOBAL VARIABLES	*/
+static volatile uint32_t port_ticks = 0;
+
+
+
+/*		PORT STARTUP		*/
+
+
+/**
+ * @brief Nothing to set up, the cycle counter is the SysTick.
+ */
+void EOS_PortInit(void){
+}
+
+
+/**
+ * @brief Builds the initial stack frame of a task, so the first context switch into it starts the task function.
+ *
+ * @return The initial stack pointer of the task, or NULL for an EOS_USE_FPU task, as there is no FPU.
+ */
+int32_t* EOS_PortInitStack(int32_t* task_stack, uint32_t stack_size, void* function, EOS_status_t use_fpu){
+
+	if (use_fpu == EOS_USE_FPU || stack_size < EOS_PORT_FRAME_WORDS)
+	{
+		return NULL;
+	}
+
+	task_stack[stack_size-1] = 0x01000000;  //xpsr
+	task_stack[stack_size-2] = (int32_t)((uint32_t)function & ~1u); //pc, the exception return does not take the thumb bit
+	task_stack[stack_size-3] = 0xFFFFFFFD; 	//lr
+	task_stack[stack_size-4] = 0xDEADBEEA;  //r12
+	task_stack[stack_size-5] = 0xDEADBEEB;  //r3
+	task_stack[stack_size-6] = 0xDEADBEEC;  //r2
+	task_stack[stack_size-7] = 0xDEADBEED;	//r1
+	task_stack[stack_size-8] = 0xDEADBEEF;	//r0
+	task_stack[stack_size-9] = 0xDEADBEEF;	//r11
+	task_stack[stack_size-10] = 0xDEADBEAA;	//r10
+	task_stack[stack_size-11] = 0xDEADBEDF; //r9
+	task_stack[stack_size-12] = 0xDEADBEBF; //r8
+	task_stack[stack_size-13] = 0xDEADBECF; //r7
+	task_stack[stack_size-14] = 0xDEADBECC; //r6
+	task_stack[stack_size-15] = 0xDEADBEDD; //r5
+	task_stack[stack_size-16] = 0xDEADBAAA; //r4
+
+	return &task_stack[stack_size - EOS_PORT_FRAME_WORDS];
+}
+
+
+/**
+ * @brief Starts the task pointed to by run_ptr. Does not return.
+ */
+void EOS_PortStartScheduler(void){
+	EOS_Start();
+}
+
+
+/**
+ * @brief Starts the first task on an empty process stack, by branching straight to its function. The PSP is set
+ * 			before thread mode switches to it, so no C code ever runs on an unset stack pointer.
+ */
+static __attribute__((naked))void EOS_Start(){
+
+	__asm volatile(
+			".syntax unified       \n"
+			"LDR R0, =run_ptr      \n"
+			"LDR R1, [R0]          \n"
+			"LDR R0, [R1]          \n"
+			"LDR R2, [R0, #56]     \n" //pc of the initial frame
+			"ADDS R0, R0, #64      \n"
+			"MSR PSP, R0           \n"
+			"MOVS R0, #2           \n"
+			"MSR CONTROL, R0       \n" //thread mode uses the PSP
+			"ISB                   \n"
+			"MOVS R1, #1           \n"
+			"ORRS R2, R2, R1       \n" //thumb bit
+			"CPSIE I               \n"
+			"BX R2                 \n"
+			".align 4              \n"
+		);
+}
+
+
+
+/*		CONTEXT SWITCHING		*/
+
+
+/**
+ * @brief PendSV exception handler for context switching.
+ *
+ * The outgoing task's R4-R11 are stored below its exception frame, in the same order as the ARMv7E-M port, and its
+ * stack pointer saved in its TCB. The frame is written upwards from there, as ARMv6-M has no STMDB.
+ */
+__attribute__((naked))void PendSV_Handler(void)
+{
+	 __asm volatile (
+			".syntax unified\n"
+	        "CPSID I\n"
+	        "MRS R0, PSP\n"
+	        "SUBS R0, R0, #32\n"
+	        "LDR R3, =run_ptr\n"
+	        "LDR R1, [R3]\n"
+	        "STR R0, [R1]\n"
+	        "STMIA R0!, {R4-R7}\n"
+	        "MOV R4, R8\n"
+	        "MOV R5, R9\n"
+	        "MOV R6, R10\n"
+	        "MOV R7, R11\n"
+	        "STMIA R0!, {R4-R7}\n"
+	        "PUSH {R3, LR}\n"
+	        "BL " EOS_PORT_SCHEDULER "\n"
+	        "POP {R2, R3}\n" //R2 = &run_ptr, R3 = EXC_RETURN
+	        "LDR R1, [R2]\n"
+	        "LDR R0, [R1]\n"
+	        "ADDS R0, R0, #16\n"
+	        "LDMIA R0!, {R4-R7}\n"
+	        "MOV R8, R4\n"
+	        "MOV R9, R5\n"
+	        "MOV R10, R6\n"
+	        "MOV R11, R7\n"
+	        "MSR PSP, R0\n"
+	        "SUBS R0, R0, #32\n"
+	        "LDMIA R0!, {R4-R7}\n"
+	        "CPSIE I\n"
+	        "BX R3\n"
+	        ".align 4\n"
+	    );
+}
+
+
+#if EOS_CRITICAL_PROFILE_ENABLE
+/**
+ * @brief Called by PendSV_Handler instead of EOS_scheduler() when the critical section profiler is enabled, so the
+ * 			scheduling part of the context switch is profiled. The register save/restore around it is not included.
+ */
+static __attribute__((used)) void EOS_PortProfiledScheduler(void)
+{
+	EOS_CriticalProfileBegin("PendSV_Handler", 0);
+	EOS_scheduler();
+	EOS_CriticalProfileEnd();
+}
+#endif
+
+
+/**
+ * @brief SysTick interrupt handler.
+ *
+ * Counts the period for EOS_PortSysTickCycles(), increments the HAL tick, and runs the kernel tick.
+ *
+ * @note HAL initalizes the systick to run at 1 ms intervals based off the clock speed of the processor.
+ * If you are not using HAL, please do this yourself otherwise certain EvanRTOS features (ie EOS_Delay()) will not work.
+ */
+void SysTick_Handler(void)
+{
+	port_ticks++;
+	HAL_IncTick();
+	EOS_Tick();
+}
+
+
+
+/*		CYCLE COUNTER		*/
+
+
+/**
+ * @brief Returns the core clock cycles counted by the SysTick: whole periods counted by its handler, plus how far the
+ * 			counter is into the current one. A period that has ended, but whose handler has not run yet (because
+ * 			interrupts are masked), is counted from the pending flag.
+ */
+uint32_t EOS_PortSysTickCycles(void)
+{
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t ticks = port_ticks;
+	uint32_t value = SysTick->VAL;
+
+	if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		ticks++;
+		value = SysTick->VAL; //read again, in case the counter reloaded after the first read
+	}
+
+	uint32_t reload = SysTick->LOAD;
+	EOS_PortRestoreInterrupts(state);
+
+	return ticks * (reload + 1) + (reload - value);
+}
+
+
+
+/*		ATOMICS		*/
+
+/* GCC turns read-modify-write __atomic builtins into calls to these library functions on ARMv6-M (they are normally
+ * in libatomic, which bare metal toolchains do not ship). Masking interrupts makes them atomic on a single core. They
+ * are defined under other names, as their C names clash with the builtins */
+uint32_t EOS_PortAtomicFetchAdd4(volatile void* pointer, uint32_t value, int model) __asm__("__atomic_fetch_add_4");
+bool EOS_PortAtomicCompareExchange4(volatile void* pointer, void* expected, uint32_t desired, int success_model,
+		int failure_model) __asm__("__atomic_compare_exchange_4");
+
+
+/**
+ * @brief __atomic_fetch_add() on a 32 bit word.
+ */
+uint32_t EOS_PortAtomicFetchAdd4(volatile void* pointer, uint32_t value, int model)
+{
+	(void)model;
+	volatile uint32_t* word = pointer;
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t previous = *word;
+
+	*word = previous + value;
+	EOS_PortRestoreInterrupts(state);
+	return previous;
+}
+
+
+/**
+ * @brief __atomic_compare_exchange() on a 32 bit word (the library form has no weak argument).
+ */
+bool EOS_PortAtomicCompareExchange4(volatile void* pointer, void* expected, uint32_t desired, int success_model,
+		int failure_model)
+{
+	(void)success_model;
+	(void)failure_model;
+	volatile uint32_t* word = pointer;
+	uint32_t* compare = expected;
+	uint32_t state = EOS_PortMaskInterrupts();
+	uint32_t current = *word;
+	bool exchanged = (current == *compare);
+
+	if (exchanged)
+	{
+		*word = desired;
+	}
+	else
+	{
+		*compare = current;
+	}
+	EOS_PortRestoreInterrupts(state);
+	return exchanged;
+}
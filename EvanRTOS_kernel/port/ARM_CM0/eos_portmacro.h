@@ -0,0 +1,48 @@
+/*
+ * eos_portmacro.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Port macros for ARMv6-M (Cortex-M0/M0+) with CMSIS. See eos_port.h.
+ */
+
+#ifndef INC_EOS_PORTMACRO_H_
+#define INC_EOS_PORTMACRO_H_
+
+#include <stdint.h>
+#include "main.h"
+
+
+/*	CONSTANTS	*/
+
+/* Cycle counter. ARMv6-M has no DWT cycle counter, so the default one counts SysTick periods and reads the SysTick
+ * counter in between. Boards with a free running timer can define EOS_PortGetCycles() and EOS_PORT_CYCLE_HZ in main.h,
+ * and start their own counter before EOS_Init() */
+#ifndef EOS_PortGetCycles
+#define EOS_PortGetCycles() EOS_PortSysTickCycles()
+#endif
+
+#ifndef EOS_PORT_CYCLE_HZ
+#define EOS_PORT_CYCLE_HZ SystemCoreClock
+#endif
+
+
+/*	PORT MACROS	*/
+#define EOS_PortDisableInterrupts() __disable_irq()
+#define EOS_PortEnableInterrupts() __enable_irq()
+#define EOS_PortYield() (SCB->ICSR = SCB_ICSR_PENDSVSET_Msk)
+#define EOS_PortIdle()
+
+static inline uint32_t EOS_PortMaskInterrupts(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+#define EOS_PortRestoreInterrupts(state) __set_PRIMASK(state)
+
+uint32_t EOS_PortSysTickCycles(void);
+
+#endif /* INC_EOS_PORTMACRO_H_ */
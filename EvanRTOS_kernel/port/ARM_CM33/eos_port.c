@@ -0,0 +1,330 @@
+/*
+ * eos_port.c
+ *
+ *      EvanRTOS port for ARMv8-M Mainline (Cortex-M33, with or without the FPU), built on CMSIS. The kernel runs in a
+ *      single security state: on a core without TrustZone, or entirely in the Secure or the Non-secure state (see
+ *      EOS_PORT_EXC_RETURN in eos_portmacro.h).
+ *
+ *      Works like the ARMv7E-M port: PendSV switches context, SysTick drives the kernel tick, tasks run on the process
+ *      stack pointer (PSP) and interrupts on the main stack pointer (MSP), and task frames have the same layout. The
+ *      PendSV interrupt should be set to the lowest priority, and the SysTick interrupt to the second lowest.
+ *
+ *      ARMv8-M checks every push onto the PSP against the PSPLIM register, so PendSV sets PSPLIM to the bottom of the
+ *      incoming task's stack on every context switch. A task that overflows its stack takes a UsageFault (STKOF) before
+ *      it writes below its stack, at no cost to the switch and without using an MPU region. The UsageFault handler
+ *      should call EOS_StackOverflow(run_ptr) when SCB->CFSR has SCB_CFSR_STKOF_Msk set. Use EOS_STACK_CHECK_ENABLE
+ *      for the high water mark, EOS_MPU_GUARD_ENABLE is not needed and not supported.
+ *
+ *      The registers PendSV saves itself (EXC_RETURN, R4-R11, and S16-S31 for FPU tasks, up to 25 words) are stored
+ *      through R2, which PSPLIM does not check, so PendSV first checks that they fit above the limit, and calls
+ *      EOS_StackOverflow() with nothing written if they do not.
+ *
+ *      The sampling profiler (EOS_PROFILE_ENABLE) is not supported.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_critical.h"
+
+
+#if EOS_MPU_GUARD_ENABLE
+#error "the ARMv8-M port checks stacks with PSPLIM, EOS_MPU_GUARD_ENABLE is not supported"
+#endif
+
+#if EOS_PROFILE_ENABLE
+#error "the ARMv8-M port does not support the sampling profiler (EOS_PROFILE_ENABLE)"
+#endif
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_InitStack(int32_t* task_stack, uint32_t stack_size, void* function);
+static void EOS_InitFpuStack(int32_t* task_stack, uint32_t stack_size, void* function);
+static __attribute__((naked))void EOS_Start();
+static uint32_t EOS_PortStackLimit(EOS_TCB_t* task);
+
+
+/* Task frames, in words: what PendSV saves itself (EXC_RETURN and R4-R11, then S16-S31 for tasks that have used the
+ * FPU), and what exception entry stacks (the basic or the extended frame). The byte counts are the immediates of
+ * EOS_Start() and of PendSV's check of the first two against the stack limit */
+#define EOS_PORT_SAVED_WORDS 9
+#define EOS_PORT_SAVED_FPU_WORDS 16
+#define EOS_PORT_BASIC_FRAME_WORDS 8
+#define EOS_PORT_EXTENDED_FRAME_WORDS 26
+#define EOS_PORT_SAVED_BYTES 36
+#define EOS_PORT_SAVED_FPU_BYTES 64
+#define EOS_PORT_BASIC_FRAME_BYTES 32
+#define EOS_PORT_EXTENDED_FRAME_BYTES 104
+
+_Static_assert(EOS_PORT_SAVED_BYTES == EOS_PORT_SAVED_WORDS * 4, "EOS_PORT_SAVED_BYTES out of step");
+_Static_assert(EOS_PORT_SAVED_FPU_BYTES == EOS_PORT_SAVED_FPU_WORDS * 4, "EOS_PORT_SAVED_FPU_BYTES out of step");
+_Static_assert(EOS_PORT_BASIC_FRAME_BYTES == EOS_PORT_BASIC_FRAME_WORDS * 4, "EOS_PORT_BASIC_FRAME_BYTES out of step");
+_Static_assert(EOS_PORT_EXTENDED_FRAME_BYTES == EOS_PORT_EXTENDED_FRAME_WORDS * 4,
+		"EOS_PORT_EXTENDED_FRAME_BYTES out of step");
+
+#define EOS_PORT_STR(x) #x
+#define EOS_PORT_IMM(x) "#" EOS_PORT_STR(x)
+
+/* Saving and restoring S16-S31, for tasks that have used the FPU (EXC_RETURN bit 4 clear) */
+#if defined(__ARM_FP)
+#define EOS_PORT_SAVE_FPU "TST LR, #0x10\n" "IT EQ\n" "VSTMDBEQ R2!, {S16-S31}\n"
+#define EOS_PORT_RESTORE_FPU "TST LR, #0x10\n" "IT EQ\n" "VLDMIAEQ R2!, {S16-S31}\n"
+#define EOS_PORT_FPU_FRAME "TST LR, #0x10\n" "IT EQ\n" "SUBEQ R1, R1, " EOS_PORT_IMM(EOS_PORT_SAVED_FPU_BYTES) "\n"
+#else
+#define EOS_PORT_SAVE_FPU
+#define EOS_PORT_RESTORE_FPU
+#define EOS_PORT_FPU_FRAME
+#endif
+
+
+
+/*		PORT STARTUP		*/
+
+
+/**
+ * @brief Enables the DWT cycle counter used by EOS_GetCycles(), and the UsageFault a stack limit violation raises.
+ */
+void EOS_PortInit(void){
+#ifdef EOS_PORT_DWT_CYCLES
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+	SCB->SHCSR |= SCB_SHCSR_USGFAULTENA_Msk; //overflows fault as UsageFault, not HardFault
+}
+
+
+/**
+ * @brief Builds the initial stack frame of a task, so the first context switch into it starts the task function.
+ *
+ * @return The initial stack pointer of the task, or NULL for an EOS_USE_FPU task on a build without the FPU.
+ */
+int32_t* EOS_PortInitStack(int32_t* task_stack, uint32_t stack_size, void* function, EOS_status_t use_fpu){
+
+	if(use_fpu == EOS_USE_FPU)
+	{
+#if defined(__ARM_FP)
+		EOS_InitFpuStack(task_stack, stack_size, function);
+		return &task_stack[stack_size - (EOS_PORT_SAVED_WORDS + EOS_PORT_SAVED_FPU_WORDS + EOS_PORT_EXTENDED_FRAME_WORDS)];
+#else
+		return NULL;
+#endif
+	}
+
+	EOS_InitStack(task_stack, stack_size, function);
+	return &task_stack[stack_size - (EOS_PORT_SAVED_WORDS + EOS_PORT_BASIC_FRAME_WORDS)];
+}
+
+
+/**
+ * @brief Sets the stack limit of the task pointed to by run_ptr, and starts it. Does not return.
+ */
+void EOS_PortStartScheduler(void){
+	__set_PSPLIM(EOS_PortStackLimit(run_ptr));
+	EOS_Start();
+}
+
+
+/**
+ * @brief Starts the first task on an empty process stack, by branching straight to its function. Its initial frame
+ * 			can be either layout, EXC_RETURN bit 4 tells them apart. The PSP is set before thread mode switches to it,
+ * 			so no C code ever runs on an unset stack pointer.
+ */
+static __attribute__((naked))void EOS_Start(){
+
+	__asm volatile(
+			"LDR R0, =run_ptr      \n"
+			"LDR R1, [R0]          \n"
+			"LDR R0, [R1]          \n"
+			"LDR R2, [R0]          \n" //EXC_RETURN
+			"ADD R0, R0, " EOS_PORT_IMM(EOS_PORT_SAVED_BYTES) "\n" //past EXC_RETURN and R4-R11
+			"TST R2, #0x10         \n"
+			"IT EQ                 \n"
+			"ADDEQ R0, R0, " EOS_PORT_IMM(EOS_PORT_SAVED_FPU_BYTES) "\n" //past S16-S31
+			"LDR R1, [R0, #24]     \n" //pc of the exception frame
+			"TST R2, #0x10         \n"
+			"ITE EQ                \n"
+			"ADDEQ R0, R0, " EOS_PORT_IMM(EOS_PORT_EXTENDED_FRAME_BYTES) "\n" //past the extended frame
+			"ADDNE R0, R0, " EOS_PORT_IMM(EOS_PORT_BASIC_FRAME_BYTES) "\n" //past the basic frame
+			"MSR PSP, R0           \n"
+			"MRS R0, CONTROL       \n"
+			"ORR R0, R0, #2        \n"
+			"MSR CONTROL, R0       \n" //thread mode uses the PSP
+			"ISB                   \n"
+			"ORR R1, R1, #1        \n" //thumb bit
+			"CPSIE I               \n"
+			"BX R1                 \n"
+			".align 4              \n"
+		);
+}
+
+
+
+/*		CONTEXT SWITCHING		*/
+
+
+/**
+ * @brief PendSV exception handler for context switching. The same as the ARMv7E-M port, with the stack limit of the
+ * 			incoming task set by EOS_PortLimitedScheduler() before its stack pointer is, and the outgoing task's saved
+ * 			registers checked against its limit before they are written (EOS_PortFrameOverflow()).
+ *
+ * This function draws inspiration from the FreeRTOS Kernel PendSV_Handler, and shares some similarities.
+ * Credit here:	https://github.com/FreeRTOS/FreeRTOS-Kernel.
+ */
+__attribute__((naked))void PendSV_Handler(void)
+{
+	 __asm volatile (
+	        "CPSID I\n"
+	        "MRS R2, PSP\n"
+	        "MRS R3, PSPLIM\n"
+	        "SUB R1, R2, " EOS_PORT_IMM(EOS_PORT_SAVED_BYTES) "\n"
+	        EOS_PORT_FPU_FRAME
+	        "CMP R1, R3\n"
+	        "BLO EOS_PortFrameOverflow\n" //the saved registers would go below the stack
+	        EOS_PORT_SAVE_FPU
+			"STMDB R2!, {R4-R11}\n"
+			"STMDB R2!, {R14}\n"
+	        "LDR R0, =run_ptr\n"
+	        "LDR R1, [R0]\n"
+	        "STR R2, [R1]\n"
+	        "STMDB SP!, {R0}\n"
+	        "BL EOS_PortLimitedScheduler\n"
+	        "LDMIA SP!, {R0}\n"
+	        "LDR R1, [R0]\n"
+	        "LDR R2, [R1]\n"
+			"LDMIA R2!, {R14}\n"
+			"LDMIA R2!, {R4-R11}\n"
+	        EOS_PORT_RESTORE_FPU
+	        "MSR PSP, R2\n"
+	        "CPSIE I\n"
+	        "BX LR\n"
+	        ".align 4\n"
+	    );
+}
+
+
+/**
+ * @brief Called by PendSV_Handler to pick the next task, then moves the stack limit to the bottom of its stack before
+ * 			its context is restored. The scheduling part is profiled when the critical section profiler is enabled.
+ */
+static __attribute__((used)) void EOS_PortLimitedScheduler(void)
+{
+#if EOS_CRITICAL_PROFILE_ENABLE
+	EOS_CriticalProfileBegin("PendSV_Handler", 0);
+	EOS_scheduler();
+	EOS_CriticalProfileEnd();
+#else
+	EOS_scheduler();
+#endif
+	__set_PSPLIM(EOS_PortStackLimit(run_ptr));
+}
+
+
+/**
+ * @brief Branched to by PendSV_Handler, on the main stack, when the outgoing task's saved registers would not fit
+ * 			above its stack limit. Nothing below the stack has been written. Does not return.
+ */
+static __attribute__((used, noreturn)) void EOS_PortFrameOverflow(void)
+{
+	EOS_StackOverflow(run_ptr);
+	while (1)
+	{
+	}
+}
+
+
+/**
+ * @brief Returns the lowest address a task's stack pointer may reach, its stack base rounded up to the 8 bytes PSPLIM
+ * 			holds.
+ */
+static uint32_t EOS_PortStackLimit(EOS_TCB_t* task)
+{
+	return ((uint32_t)task->stack + 7u) & ~7u;
+}
+
+
+/**
+ * @brief SysTick interrupt handler.
+ *
+ * Increments the HAL tick, and runs the kernel tick.
+ *
+ * @note HAL initalizes the systick to run at 1 ms intervals based off the clock speed of the processor.
+ * If you are not using HAL, please do this yourself otherwise certain EvanRTOS features (ie EOS_Delay()) will not work.
+ */
+void SysTick_Handler(void)
+{
+	HAL_IncTick();
+	EOS_Tick();
+}
+
+
+
+/*		STACK FRAMES		*/
+
+
+/**
+ * @brief Initializes the stack for a new task, that does not use the FPU.
+ *
+ * @param task_stack Pointer to the base of the task's stack memory
+ * @param stack_size Size of the stack in 32-bit words.
+ * @param function   Pointer to the task's function.
+ *
+ */
+static void EOS_InitStack(int32_t* task_stack, uint32_t stack_size, void* function){
+
+	task_stack[stack_size-1] = 0x01000000;  //xpsr
+	task_stack[stack_size-2] = (int32_t)((uint32_t)function & ~1u); //pc, the exception return does not take the thumb bit
+	task_stack[stack_size-3] = 0xFFFFFFFD; 	//lr
+	task_stack[stack_size-4] = 0xDEADBEEA;  //r12
+	task_stack[stack_size-5] = 0xDEADBEEB;  //r3
+	task_stack[stack_size-6] = 0xDEADBEEC;  //r2
+	task_stack[stack_size-7] = 0xDEADBEED;	//r1
+	task_stack[stack_size-8] = 0xDEADBEEF;	//r0
+	task_stack[stack_size-9] = 0xDEADBEEF;	//r11
+	task_stack[stack_size-10] = 0xDEADBEAA;	//r10
+	task_stack[stack_size-11] = 0xDEADBEDF; //r9
+	task_stack[stack_size-12] = 0xDEADBEBF; //r8
+	task_stack[stack_size-13] = 0xDEADBECF; //r7
+	task_stack[stack_size-14] = 0xDEADBECC; //r6
+	task_stack[stack_size-15] = 0xDEADBEDD; //r5
+	task_stack[stack_size-16] = 0xDEADBAAA; //r4
+	task_stack[stack_size-17] = EOS_PORT_EXC_RETURN; //store LR in fixed place for ease of context switching
+}
+
+
+/**
+ * @brief Initializes the stack for a new task, that uses the FPU.
+ *
+ * @param task_stack Pointer to the base of the task's stack memory
+ * @param stack_size Size of the stack in 32-bit words.
+ * @param function   Pointer to the task's function.
+ *
+ */
+static void EOS_InitFpuStack(int32_t* task_stack, uint32_t stack_size, void* function){
+	task_stack[stack_size-1] = 0xDEADBEEF;
+	task_stack[stack_size-2] = 0x00000000; //fpscr
+
+	for(int i = 3; i < 19; i++)
+	{
+		task_stack[stack_size-i] = 0x00000000; //S15->S0 fpu registers
+	}
+
+	task_stack[stack_size-19] = 0x01000000; //xPSR
+	task_stack[stack_size-20] = (int32_t)((uint32_t)function & ~1u);
+	task_stack[stack_size-21] = 0xFFFFFFED; //lr
+	task_stack[stack_size-22] = 0xDEADBEEA;  //r12
+	task_stack[stack_size-23] = 0xDEADBEEB;  //r3
+	task_stack[stack_size-24] = 0xDEADBEEC;  //r2
+	task_stack[stack_size-25] = 0xDEADBEED;	//r1
+	task_stack[stack_size-26] = 0xDEADBEEF;	//r0
+
+	for (int i = 27; i < 43; i++)
+	{
+		task_stack[stack_size - i] = 0x00000000; //S31-s16 fpu registers
+	}
+	for(int i = 43; i < 51; i++)
+	{
+		task_stack[stack_size-i] = 0xDEADBEEF; //r11-r4
+	}
+
+	task_stack[stack_size-51] = EOS_PORT_EXC_RETURN & ~0x10u; //store LR in fixed place for ease of context switching
+}
@@ -0,0 +1,53 @@
+/*
+ * eos_portmacro.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Port macros for ARMv8-M Mainline (Cortex-M33) with CMSIS. See eos_port.h.
+ */
+
+#ifndef INC_EOS_PORTMACRO_H_
+#define INC_EOS_PORTMACRO_H_
+
+#include <stdint.h>
+#include "main.h"
+
+
+/*	CONSTANTS	*/
+
+/* EXC_RETURN a new task is started with: thread mode on the PSP, in the security state the kernel runs in. The default
+ * suits cores without TrustZone and kernels running in the Secure state. Define 0xFFFFFFBC in main.h for a kernel
+ * running in the Non-secure state */
+#ifndef EOS_PORT_EXC_RETURN
+#define EOS_PORT_EXC_RETURN 0xFFFFFFFDu
+#endif
+
+/* Cycle counter, the DWT one by default. Boards without a DWT cycle counter define EOS_PortGetCycles() and
+ * EOS_PORT_CYCLE_HZ in main.h, and start their own counter before EOS_Init() */
+#ifndef EOS_PortGetCycles
+#define EOS_PORT_DWT_CYCLES 1
+#define EOS_PortGetCycles() (DWT->CYCCNT)
+#endif
+
+#ifndef EOS_PORT_CYCLE_HZ
+#define EOS_PORT_CYCLE_HZ SystemCoreClock
+#endif
+
+
+/*	PORT MACROS	*/
+#define EOS_PortDisableInterrupts() __disable_irq()
+#define EOS_PortEnableInterrupts() __enable_irq()
+#define EOS_PortYield() (SCB->ICSR = SCB_ICSR_PENDSVSET_Msk)
+#define EOS_PortIdle()
+
+static inline uint32_t EOS_PortMaskInterrupts(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+#define EOS_PortRestoreInterrupts(state) __set_PRIMASK(state)
+
+#endif /* INC_EOS_PORTMACRO_H_ */
@@ -0,0 +1,1488 @@
+/*
+ * eos_port.c
+ *
+ *      EvanRTOS port for ARMv7E-M (Cortex-M7 and Cortex-M4, with or without the FPU in use), built on CMSIS.
+ *
+ *      Context switching is done in the PendSV interrupt, which is requested by EOS_PortYield(). The Systick interrupt
+ *      drives the kernel tick. Tasks run on the process stack pointer (PSP), while interrupts use the main stack
+ *      pointer (MSP).
+ *
+ *      The PendSV interrupt should be set to the lowest priority, and the Systick interrupt to the second lowest.
+ *      If you are using HAL and STM32CUBEIDE's code generation, disable code generation for both of these interrupts,
+ *      as they are defined here.
+ *
+ *      With EOS_MPU_GUARD_ENABLE, one MPU region (EOS_MPU_GUARD_REGION) makes the bottom of the running task's stack
+ *      inaccessible, and PendSV moves it to the incoming task on every context switch. The rest of the memory map is
+ *      left to the default map (PRIVDEFENA) and any regions the application sets up. A task that overflows takes a
+ *      MemManage fault, whose handler should call EOS_StackOverflow(run_ptr) (see the demo's stm32h7xx_it.c). With
+ *      PRIMASK set, as in a critical section or while PendSV saves a context, that fault escalates to a HardFault, so
+ *      the HardFault handler should make the same EOS_PortMpuGuardFault() check.
+ *
+ *      The same port runs on both cores of the STM32H747. With EOS_DUAL_CORE_ENABLE, the cross-core lock is a
+ *      hardware semaphore (EOS_DUAL_CORE_LOCK_HSEM), and a core is interrupted by taking and releasing the other's
+ *      notification semaphore, whose HSEM interrupt (HSEM1 on the Cortex-M7, HSEM2 on the Cortex-M4) is handled here.
+ *
+ *      With EOS_RING_ENABLE, the ring buffers clean and invalidate the Cortex-M7 data cache by address, while it is
+ *      enabled. EOS_PortMpuUncached() can instead make their memory non-cacheable with an MPU region.
+ *
+ *      With EOS_UART_ENABLE, the UART driver's DMA is done with the HAL: HAL_UART_Transmit_DMA() and, in circular mode,
+ *      HAL_UARTEx_ReceiveToIdle_DMA(). Its HAL_UART_TxCpltCallback(), HAL_UARTEx_RxEventCallback() and
+ *      HAL_UART_ErrorCallback() are defined here, so the application must not define them too, and must call
+ *      HAL_UART_IRQHandler() and HAL_DMA_IRQHandler() from the UART's and its DMA streams' interrupts.
+ *
+ *      With EOS_HAL_ENABLE, HAL_InitTick() is defined here: the Systick stays the kernel's 1ms tick, and the HAL's tick
+ *      moves to EOS_PORT_HAL_TIM, at EOS_PORT_HAL_PRIORITY. HAL_Delay() sleeps with EOS_Delay() when called from a
+ *      task. The blocking EOS_Hal...() transfers start the HAL's interrupt driven ones, and sleep until the completion
+ *      and error callbacks of the UART, I2C and SPI HALs, also defined here, wake them. The application must not define
+ *      those callbacks either, nor use the timer.
+ *
+ *      With EOS_I2C_ENABLE, the bus manager's transactions are the HAL's interrupt driven sequential transfers: a write
+ *      then a read is HAL_I2C_Master_Seq_Transmit_IT() without a STOP, and HAL_I2C_Master_Seq_Receive_IT() started from
+ *      its completion callback, with a repeated start. The I2C callbacks above pass the buses the manager owns to it.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+#include "eos_critical.h"
+#include "eos_profile.h"
+#include "eos_dual_core.h"
+#include "eos_uart.h"
+#include "eos_hal.h"
+#include "eos_i2c.h"
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_InitStack(int32_t* task_stack, uint32_t stack_size, void* function);
+static void EOS_InitFpuStack(int32_t* task_stack, uint32_t stack_size, void* function);
+static __attribute__((naked))void EOS_Start();
+
+#if EOS_MPU_GUARD_ENABLE
+static void EOS_PortMpuGuard(EOS_TCB_t* task);
+static uint32_t EOS_PortMpuGuardBase(EOS_TCB_t* task);
+#endif
+
+#if EOS_HAL_ENABLE && defined(HAL_UART_MODULE_ENABLED)
+static void EOS_PortHalUartTx(UART_HandleTypeDef* huart);
+static void EOS_PortHalUartError(UART_HandleTypeDef* huart);
+#endif
+
+
+#if EOS_MPU_GUARD_ENABLE
+#define EOS_PORT_SCHEDULER "EOS_PortGuardedScheduler"
+#elif EOS_CRITICAL_PROFILE_ENABLE
+#define EOS_PORT_SCHEDULER "EOS_PortProfiledScheduler"
+#else
+#define EOS_PORT_SCHEDULER "EOS_scheduler"
+#endif
+
+#if EOS_MPU_GUARD_ENABLE && ((EOS_MPU_GUARD_SIZE & (EOS_MPU_GUARD_SIZE - 1)) != 0 || EOS_MPU_GUARD_SIZE < 32)
+#error "EOS_MPU_GUARD_SIZE must be a power of 2, at least 32"
+#endif
+
+#define EOS_PORT_FRAME_MAX 104 //bytes in an exception frame with the FPU context
+
+#if EOS_I2C_ENABLE && !defined(HAL_I2C_MODULE_ENABLED)
+#error "EOS_I2C_ENABLE needs the HAL's I2C module (HAL_I2C_MODULE_ENABLED)"
+#endif
+
+
+
+/*		PORT STARTUP		*/
+
+
+/**
+ * @brief Enables the DWT cycle counter used by EOS_GetCycles(), and the MPU for the stack guard.
+ */
+void EOS_PortInit(void){
+#ifdef EOS_PORT_DWT_CYCLES
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+#if EOS_MPU_GUARD_ENABLE
+	SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk; //overflows fault as MemManage, not HardFault
+	MPU->CTRL |= MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+	__DSB();
+	__ISB();
+#endif
+}
+
+
+/**
+ * @brief Builds the initial stack frame of a task, so the first context switch into it starts the task function.
+ *
+ * @return The initial stack pointer of the task.
+ */
+int32_t* EOS_PortInitStack(int32_t* task_stack, uint32_t stack_size, void* function, EOS_status_t use_fpu){
+
+	if(use_fpu == EOS_USE_FPU)
+	{
+		EOS_InitFpuStack(task_stack, stack_size, function);
+		return &task_stack[stack_size - 51];
+	}
+
+	EOS_InitStack(task_stack, stack_size, function);
+	return &task_stack[stack_size - 17];
+}
+
+
+/**
+ * @brief Switches to the process stack pointer, and starts the task pointed to by run_ptr. Does not return.
+ */
+void EOS_PortStartScheduler(void){
+
+#if EOS_MPU_GUARD_ENABLE
+	EOS_PortMpuGuard(run_ptr);
+#endif
+	__set_CONTROL(__get_CONTROL() | CONTROL_SPSEL_Msk); //enables PSP mode
+
+	EOS_Start();
+}
+
+
+/**
+ * @brief Starts the first task by restoring its context and enabling execution.
+ *
+ * @details This function is called to launch the RTOS scheduler. It will run the task currently pointed to by run_ptr.
+ *
+ * @return None. This function does not return to the caller.
+ */
+
+static __attribute__((naked))void EOS_Start(){
+
+	__asm volatile(
+			"LDR R0, =run_ptr      \n"
+			"LDR R1, [R0]          \n"
+			"LDR SP, [R1]          \n"
+			"ADD SP, SP, #4		   \n"
+			"POP {R4-R11}          \n"
+			"POP {R0-R3}           \n"
+			"POP {R12}             \n"
+			"ADD SP, SP, #4        \n"
+			"POP {LR}              \n"
+			"ADD SP, SP, #4        \n"
+			"CPSIE I               \n"
+			"BX LR                 \n"
+		);
+}
+
+
+
+/*		CONTEXT SWITCHING		*/
+
+
+/**
+ * @brief PendSV exception handler for context switching.
+ *
+ * This function draws inspiration from the FreeRTOS Kernel PendSV_Handler, and shares some similarities.
+ * Credit here:	https://github.com/FreeRTOS/FreeRTOS-Kernel.
+ */
+__attribute__((naked))void PendSV_Handler(void)
+{
+	 __asm volatile (
+	        "CPSID I\n"
+	        "MRS R2, PSP\n"
+	        "TST LR, #0x10\n" //check if in fpu mode
+	        "IT EQ\n"
+	        "VSTMDBEQ R2!, {S16-S31}\n" //save fpu registers
+			"STMDB R2!, {R4-R11}\n"
+			"STMDB R2!, {R14}\n"
+	        "LDR R0, =run_ptr\n"
+	        "LDR R1, [R0]\n"
+	        "STR R2, [R1]\n"
+	        "STMDB SP!, {R0}\n"
+	        "BL " EOS_PORT_SCHEDULER "\n"
+	        "LDMIA SP!, {R0}\n"
+	        "LDR R1, [R0]\n"
+	        "LDR R2, [R1]\n"
+			"LDMIA R2!, {R14}\n"
+			"LDMIA R2!, {R4-R11}\n"
+	        "TST LR, #0x10\n"
+	        "IT EQ\n"
+	        "VLDMIAEQ R2!, {S16-S31}\n"
+	        "MSR PSP, R2\n"
+	        "CPSIE I\n"
+	        "BX LR\n"
+	        ".align 4\n"
+	    );
+}
+
+
+#if EOS_CRITICAL_PROFILE_ENABLE
+/**
+ * @brief Called by PendSV_Handler instead of EOS_scheduler() when the critical section profiler is enabled, so the
+ * 			scheduling part of the context switch is profiled. The register save/restore around it is not included.
+ */
+static __attribute__((used)) void EOS_PortProfiledScheduler(void)
+{
+	EOS_CriticalProfileBegin("PendSV_Handler", 0);
+	EOS_scheduler();
+	EOS_CriticalProfileEnd();
+}
+#endif
+
+
+#if EOS_MPU_GUARD_ENABLE
+/**
+ * @brief Called by PendSV_Handler instead of EOS_scheduler() when the MPU stack guard is enabled. Picks the next task,
+ * 			then moves the guard to the bottom of its stack before its context is restored. The guard is off while the
+ * 			scheduler runs, as EOS_STACK_CHECK_ENABLE reads the bottom of the outgoing task's stack.
+ */
+static __attribute__((used)) void EOS_PortGuardedScheduler(void)
+{
+	MPU->RNR = EOS_MPU_GUARD_REGION;
+	MPU->RASR = 0;
+	__DSB();
+	__ISB();
+
+#if EOS_CRITICAL_PROFILE_ENABLE
+	EOS_PortProfiledScheduler();
+#else
+	EOS_scheduler();
+#endif
+	EOS_PortMpuGuard(run_ptr);
+}
+
+
+/**
+ * @brief Places the guard region over the lowest EOS_MPU_GUARD_SIZE aligned bytes of a task's stack: no access from
+ * 			any mode, and never executable. The idle task's stack is too small to give up a guard, so the region is
+ * 			turned off while it runs.
+ */
+static void EOS_PortMpuGuard(EOS_TCB_t* task)
+{
+	uint32_t base = EOS_PortMpuGuardBase(task);
+
+	MPU->RNR = EOS_MPU_GUARD_REGION;
+	MPU->RASR = 0; //off while it moves
+	if (task->id != 0)
+	{
+		MPU->RBAR = base;
+		MPU->RASR = MPU_RASR_XN_Msk | ((31u - __CLZ(EOS_MPU_GUARD_SIZE) - 1u) << MPU_RASR_SIZE_Pos) |
+				MPU_RASR_ENABLE_Msk; //AP = 0, no access
+	}
+	__DSB();
+	__ISB();
+}
+
+
+/**
+ * @brief Returns the lowest EOS_MPU_GUARD_SIZE aligned address in a task's stack, where its guard region starts.
+ */
+static uint32_t EOS_PortMpuGuardBase(EOS_TCB_t* task)
+{
+	return ((uint32_t)task->stack + EOS_MPU_GUARD_SIZE - 1) & ~(uint32_t)(EOS_MPU_GUARD_SIZE - 1);
+}
+
+
+/**
+ * @brief Tells the memory fault handlers whether the fault is the running task hitting its stack guard: either a data
+ * 			access whose address the MPU recorded (MMARVALID), inside the guard region, or an exception frame that could
+ * 			not be stacked (MSTKERR, no address recorded) with the process stack pointer at the guard. That is, within
+ * 			one full exception frame of it, as how far the PSP has moved when stacking fails is not architected.
+ * 			Other memory faults, such as those of regions the application set up, return 0 and should not be
+ * 			reported as an overflow.
+ *
+ * 			Called from the HardFault handler too, as a MemManage fault escalates to a HardFault while PRIMASK is set:
+ * 			an overflow inside EOS_EnterCritical(), or by PendSV saving the outgoing task's registers. There it only
+ * 			reports a forced HardFault (FORCED), whose memory fault status is still in CFSR.
+ *
+ * @return 1 if the running task overflowed into its guard, 0 otherwise.
+ */
+uint32_t EOS_PortMpuGuardFault(void)
+{
+	uint32_t cfsr = SCB->CFSR;
+	uint32_t address = SCB->MMFAR; //read after CFSR, only valid while MMARVALID is set
+	uint32_t base;
+
+	if (run_ptr->id == 0 || ((__get_IPSR() & IPSR_ISR_Msk) == 3u && //in the HardFault handler
+			(SCB->HFSR & SCB_HFSR_FORCED_Msk) == 0))
+	{
+		return 0;
+	}
+
+	base = EOS_PortMpuGuardBase(run_ptr);
+	if (cfsr & SCB_CFSR_MMARVALID_Msk)
+	{
+		return (address - base < EOS_MPU_GUARD_SIZE) ? 1 : 0;
+	}
+	if (cfsr & SCB_CFSR_MSTKERR_Msk)
+	{
+		address = __get_PSP();
+		return (address + EOS_PORT_FRAME_MAX - base < EOS_MPU_GUARD_SIZE + 2 * EOS_PORT_FRAME_MAX) ? 1 : 0;
+	}
+	return 0;
+}
+#endif
+
+
+/**
+ * @brief SysTick interrupt handler.
+ *
+ * Increments the HAL tick, unless EOS_PORT_HAL_TIM does (EOS_HAL_ENABLE), and runs the kernel tick.
+ *
+ * @note HAL initalizes the systick to run at 1 ms intervals based off the clock speed of the processor.
+ * If you are not using HAL, please do this yourself otherwise certain EvanRTOS features (ie EOS_Delay()) will not work.
+ */
+void SysTick_Handler(void)
+{
+#if !EOS_HAL_ENABLE
+	HAL_IncTick();
+#endif
+	EOS_Tick();
+}
+
+
+#if EOS_PROFILE_ENABLE || EOS_HAL_ENABLE
+/**
+ * @brief Returns the input clock of the APB1 timers.
+ */
+static uint32_t EOS_PortTimerClock(void)
+{
+	uint32_t clock = HAL_RCC_GetPCLK1Freq();
+
+	if ((RCC->D2CFGR & RCC_D2CFGR_D2PPRE1) != RCC_APB1_DIV1)
+	{
+		clock *= 2; //APB1 timers run at twice PCLK1 when APB1 is divided
+	}
+	return clock;
+}
+#endif
+
+
+
+#if EOS_PROFILE_ENABLE
+/*		SAMPLING PROFILER		*/
+
+
+
+/**
+ * @brief Starts the profiler timer, with its interrupt at the highest priority so it can sample other handlers.
+ *
+ * @param sample_hz Samples per second.
+ */
+void EOS_PortProfileStart(uint32_t sample_hz)
+{
+	uint32_t ticks = EOS_PortTimerClock() / sample_hz;
+	uint32_t prescaler = ticks / 0x10000 + 1; //the auto reload register is 16 bits
+
+	EOS_PORT_PROFILE_CLK_ENABLE();
+
+	EOS_PORT_PROFILE_TIM->CR1 = 0;
+	EOS_PORT_PROFILE_TIM->PSC = prescaler - 1;
+	EOS_PORT_PROFILE_TIM->ARR = ticks / prescaler - 1;
+	EOS_PORT_PROFILE_TIM->EGR = TIM_EGR_UG; //load the prescaler
+	EOS_PORT_PROFILE_TIM->SR = 0;
+	EOS_PORT_PROFILE_TIM->DIER = TIM_DIER_UIE;
+
+	NVIC_SetPriority(EOS_PORT_PROFILE_IRQn, 0);
+	NVIC_EnableIRQ(EOS_PORT_PROFILE_IRQn);
+
+	EOS_PORT_PROFILE_TIM->CR1 = TIM_CR1_CEN;
+}
+
+
+/**
+ * @brief Stops the profiler timer.
+ */
+void EOS_PortProfileStop(void)
+{
+	EOS_PORT_PROFILE_TIM->CR1 = 0;
+	EOS_PORT_PROFILE_TIM->DIER = 0;
+	NVIC_DisableIRQ(EOS_PORT_PROFILE_IRQn);
+}
+
+
+/**
+ * @brief Counts the sample taken by the profiler timer interrupt.
+ *
+ * @param frame The exception frame stacked by the interrupted code (R0-R3, R12, LR, PC, xPSR).
+ */
+static __attribute__((used)) void EOS_PortProfileIsr(uint32_t* frame)
+{
+	EOS_PORT_PROFILE_TIM->SR = ~TIM_SR_UIF;
+	EOS_ProfileSample(frame[6], (frame[7] & 0x1FF) != 0); //xPSR holds an exception number if a handler was interrupted
+}
+
+
+/**
+ * @brief Profiler timer interrupt handler. Finds the exception frame on the stack that was in use when the interrupt
+ * 			was taken (PSP for tasks, MSP for handlers), and passes it to EOS_PortProfileIsr().
+ */
+__attribute__((naked)) void EOS_PORT_PROFILE_IRQHandler(void)
+{
+	__asm volatile(
+			"TST LR, #0x4\n"
+			"ITE EQ\n"
+			"MRSEQ R0, MSP\n"
+			"MRSNE R0, PSP\n"
+			"B EOS_PortProfileIsr\n"
+		);
+}
+#endif
+
+
+#if EOS_DUAL_CORE_ENABLE
+/*		CROSS-CORE (HSEM)		*/
+
+static uint32_t port_notify_mask = 0;	//this core's notification semaphore
+
+
+/**
+ * @brief Takes the hardware semaphore guarding the shared objects, spinning until the other core has released it.
+ * 			The lock word is only used by software locks.
+ */
+void EOS_PortCoreLock(volatile uint32_t* lock)
+{
+	(void)lock;
+	while (HAL_HSEM_FastTake(EOS_DUAL_CORE_LOCK_HSEM) != HAL_OK)
+	{
+	}
+}
+
+
+/**
+ * @brief Releases the hardware semaphore guarding the shared objects, once every write made under it has completed,
+ * 			so the other core never takes it and then reads stale shared memory.
+ */
+void EOS_PortCoreUnlock(volatile uint32_t* lock)
+{
+	(void)lock;
+	__DMB();
+	HAL_HSEM_Release(EOS_DUAL_CORE_LOCK_HSEM, 0);
+}
+
+
+/**
+ * @brief Raises the HSEM interrupt on a core, by taking and releasing the semaphore it listens to.
+ */
+void EOS_PortCoreNotify(uint32_t core)
+{
+	uint32_t semaphore = EOS_DUAL_CORE_NOTIFY_HSEM + core;
+
+	while (HAL_HSEM_FastTake(semaphore) != HAL_OK)
+	{
+	}
+	HAL_HSEM_Release(semaphore, 0);
+}
+
+
+/**
+ * @brief Enables the HSEM interrupt for this core's notification semaphore, at the Systick priority so it does not
+ * 			nest with the kernel tick.
+ */
+void EOS_PortCoreListen(uint32_t core)
+{
+	port_notify_mask = __HAL_HSEM_SEMID_TO_MASK(EOS_DUAL_CORE_NOTIFY_HSEM + core);
+
+	__HAL_RCC_HSEM_CLK_ENABLE();
+	HAL_HSEM_ActivateNotification(port_notify_mask);
+
+	NVIC_SetPriority(EOS_PORT_HSEM_IRQn, NVIC_GetPriority(SysTick_IRQn));
+	NVIC_EnableIRQ(EOS_PORT_HSEM_IRQn);
+}
+
+
+/**
+ * @brief HSEM interrupt handler. Clears the notification, leaving it enabled, and wakes the tasks the other core has
+ * 			made ready.
+ */
+void EOS_PORT_HSEM_IRQHandler(void)
+{
+	__HAL_HSEM_CLEAR_FLAG(port_notify_mask);
+	EOS_DualCoreIsr();
+}
+#endif
+
+
+#if EOS_RING_ENABLE
+/*		DATA CACHE AND MPU		*/
+
+
+/**
+ * @brief Writes a cache line aligned range back to memory, if the data cache is on. The Cortex-M4 has none.
+ */
+void EOS_PortCacheClean(const void* address, uint32_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+	{
+		SCB_CleanDCache_by_Addr((uint32_t*)address, (int32_t)size);
+	}
+#else
+	(void)address;
+	(void)size;
+#endif
+}
+
+
+/**
+ * @brief Discards the cached copy of a cache line aligned range, if the data cache is on, so it is next read from
+ * 			memory. Dirty lines in the range are lost.
+ */
+void EOS_PortCacheInvalidate(void* address, uint32_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+	{
+		SCB_InvalidateDCache_by_Addr((uint32_t*)address, (int32_t)size);
+	}
+#else
+	(void)address;
+	(void)size;
+#endif
+}
+
+
+/**
+ * @brief Makes a region normal, non-cacheable and shareable memory, read/write and not executable, with one MPU
+ * 			region, so buffers in it need no cache maintenance. The rest of the memory map is left to the default map.
+ * 			Call it before the region is used, with nothing of it in the data cache.
+ *
+ * @param region MPU region number, below EOS_MPU_GUARD_REGION if the stack guard is enabled (higher regions win).
+ * @param base Start of the region, aligned to its size.
+ * @param size Size of the region in bytes, a power of 2, at least 32.
+ * @return EOS_OK, or EOS_ERROR if the region does not exist, or the base or size is invalid.
+ */
+EOS_status_t EOS_PortMpuUncached(uint32_t region, void* base, uint32_t size)
+{
+	uint32_t regions = (MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos;
+
+	if (region >= regions || size < 32 || (size & (size - 1)) != 0 || ((uint32_t)base & (size - 1)) != 0)
+	{
+		return EOS_ERROR;
+	}
+
+	uint32_t state = EOS_PortMaskInterrupts();
+	__DMB();
+	MPU->RNR = region;
+	MPU->RASR = 0; //off while it changes
+	MPU->RBAR = (uint32_t)base;
+	MPU->RASR = MPU_RASR_XN_Msk | (3u << MPU_RASR_AP_Pos) | (1u << MPU_RASR_TEX_Pos) | MPU_RASR_S_Msk |
+			((31u - __CLZ(size) - 1u) << MPU_RASR_SIZE_Pos) | MPU_RASR_ENABLE_Msk; //TEX 1, C 0, B 0: non-cacheable
+	MPU->CTRL |= MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+	__DSB();
+	__ISB();
+	EOS_PortRestoreInterrupts(state);
+
+	return EOS_OK;
+}
+#endif
+
+
+#if EOS_UART_ENABLE
+/*		UART DMA		*/
+
+static UART_HandleTypeDef* port_uarts[EOS_UART_COUNT];
+static uint8_t* port_uart_rx_buffers[EOS_UART_COUNT];
+static uint32_t port_uart_rx_sizes[EOS_UART_COUNT];
+static uint32_t port_uart_rx_positions[EOS_UART_COUNT];
+static volatile uint32_t port_uart_tx_busy[EOS_UART_COUNT];
+
+
+/**
+ * @brief Returns the driver's number of a HAL UART handle, or EOS_UART_COUNT for a UART the driver does not own.
+ */
+static uint32_t EOS_PortUartNumber(UART_HandleTypeDef* huart)
+{
+	uint32_t uart = 0;
+
+	while (uart < EOS_UART_COUNT && port_uarts[uart] != huart)
+	{
+		uart++;
+	}
+	return uart;
+}
+
+
+/**
+ * @brief Discards the cached copy of the cache lines over a range, if the data cache is on, so what the DMA wrote
+ * 			there is read from memory. The driver never writes the receive buffer, so no dirty line is lost.
+ */
+static void EOS_PortUartInvalidate(uint8_t* address, uint32_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+	if (size != 0 && (SCB->CCR & SCB_CCR_DC_Msk))
+	{
+		uint32_t start = (uint32_t)address & ~(uint32_t)(EOS_CACHE_LINE - 1);
+		uint32_t end = ((uint32_t)address + size + EOS_CACHE_LINE - 1) & ~(uint32_t)(EOS_CACHE_LINE - 1);
+		SCB_InvalidateDCache_by_Addr((uint32_t*)start, (int32_t)(end - start));
+	}
+#else
+	(void)address;
+	(void)size;
+#endif
+}
+
+
+/**
+ * @brief Starts the circular DMA reception, with the idle line and half transfer interrupts.
+ *
+ * @param device The UART's HAL handle, initialized, with its hdmarx and hdmatx DMA streams linked, hdmarx in
+ * 			circular mode.
+ * @return EOS_OK, or EOS_ERROR if the handle is not set up so, or the HAL refused.
+ */
+EOS_status_t EOS_PortUartStart(uint32_t uart, void* device, uint8_t* rx_buffer, uint32_t rx_size)
+{
+	UART_HandleTypeDef* huart = (UART_HandleTypeDef*)device;
+
+	if (huart == NULL || huart->hdmatx == NULL || huart->hdmarx == NULL || huart->hdmarx->Init.Mode != DMA_CIRCULAR)
+	{
+		return EOS_ERROR;
+	}
+
+	port_uarts[uart] = huart;
+	port_uart_rx_buffers[uart] = rx_buffer;
+	port_uart_rx_sizes[uart] = rx_size;
+	port_uart_rx_positions[uart] = 0;
+	port_uart_tx_busy[uart] = 0;
+
+	EOS_PortUartInvalidate(rx_buffer, rx_size);
+	if (HAL_UARTEx_ReceiveToIdle_DMA(huart, rx_buffer, (uint16_t)rx_size) != HAL_OK)
+	{
+		port_uarts[uart] = NULL;
+		return EOS_ERROR;
+	}
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Writes the buffer's cache lines back to memory, and starts the transmit DMA on it.
+ */
+EOS_status_t EOS_PortUartSend(uint32_t uart, const uint8_t* data, uint32_t length)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+	if (SCB->CCR & SCB_CCR_DC_Msk)
+	{
+		uint32_t start = (uint32_t)data & ~(uint32_t)(EOS_CACHE_LINE - 1);
+		uint32_t end = ((uint32_t)data + length + EOS_CACHE_LINE - 1) & ~(uint32_t)(EOS_CACHE_LINE - 1);
+		SCB_CleanDCache_by_Addr((uint32_t*)start, (int32_t)(end - start));
+	}
+#endif
+
+	if (HAL_UART_Transmit_DMA(port_uarts[uart], data, (uint16_t)length) != HAL_OK)
+	{
+		return EOS_ERROR;
+	}
+	port_uart_tx_busy[uart] = 1;
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Transmit complete, from the UART's transmission complete interrupt, once the DMA's last byte is out.
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+	uint32_t uart = EOS_PortUartNumber(huart);
+
+	if (uart < EOS_UART_COUNT)
+	{
+		port_uart_tx_busy[uart] = 0;
+		EOS_UartTxIsr(uart);
+	}
+#if EOS_HAL_ENABLE
+	else
+	{
+		EOS_PortHalUartTx(huart);
+	}
+#endif
+}
+
+
+/**
+ * @brief Receive event, from the DMA's half and full transfer interrupts and the UART's idle line interrupt. size is
+ * 			the DMA's position in the buffer.
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t size)
+{
+	uint32_t uart = EOS_PortUartNumber(huart);
+
+	if (uart < EOS_UART_COUNT)
+	{
+		uint32_t last = port_uart_rx_positions[uart];
+		uint8_t* buffer = port_uart_rx_buffers[uart];
+
+		if (size >= last)
+		{
+			EOS_PortUartInvalidate(&buffer[last], size - last);
+		}
+		else
+		{
+			EOS_PortUartInvalidate(&buffer[last], port_uart_rx_sizes[uart] - last);
+			EOS_PortUartInvalidate(buffer, size);
+		}
+		port_uart_rx_positions[uart] = (size >= port_uart_rx_sizes[uart]) ? 0 : size;
+
+		EOS_UartRxIsr(uart, size);
+	}
+}
+
+
+/**
+ * @brief Line or DMA error. The HAL stops the reception on an overrun or a DMA error, so it is restarted, and ends a
+ * 			transmission the DMA failed, so the driver moves on to the next buffer.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
+{
+	uint32_t uart = EOS_PortUartNumber(huart);
+	uint32_t restarted = 0;
+
+	if (uart >= EOS_UART_COUNT)
+	{
+#if EOS_HAL_ENABLE
+		EOS_PortHalUartError(huart);
+#endif
+		return;
+	}
+
+	if (huart->RxState == HAL_UART_STATE_READY)
+	{
+		port_uart_rx_positions[uart] = 0;
+		EOS_PortUartInvalidate(port_uart_rx_buffers[uart], port_uart_rx_sizes[uart]);
+		HAL_UARTEx_ReceiveToIdle_DMA(huart, port_uart_rx_buffers[uart], (uint16_t)port_uart_rx_sizes[uart]);
+		restarted = 1;
+	}
+	EOS_UartErrorIsr(uart, restarted);
+
+	if (port_uart_tx_busy[uart] && huart->gState == HAL_UART_STATE_READY)
+	{
+		port_uart_tx_busy[uart] = 0;
+		EOS_UartTxIsr(uart);
+	}
+}
+#endif
+
+
+#if EOS_I2C_ENABLE
+/*		I2C BUS		*/
+
+static I2C_HandleTypeDef* port_i2cs[EOS_I2C_COUNT];
+static uint16_t port_i2c_addresses[EOS_I2C_COUNT];
+static uint8_t* port_i2c_rx_data[EOS_I2C_COUNT];
+static uint16_t port_i2c_rx_lengths[EOS_I2C_COUNT];		//read phase still to start after the write, or 0
+
+
+/**
+ * @brief Returns the manager's number of a HAL I2C handle, or EOS_I2C_COUNT for a bus the manager does not own.
+ */
+static uint32_t EOS_PortI2cNumber(I2C_HandleTypeDef* hi2c)
+{
+	uint32_t bus = 0;
+
+	while (bus < EOS_I2C_COUNT && port_i2cs[bus] != hi2c)
+	{
+		bus++;
+	}
+	return bus;
+}
+
+
+/**
+ * @brief Takes a bus for the manager.
+ *
+ * @param device The bus's HAL handle, initialized as a master, with its event and error interrupts enabled in the NVIC
+ * 			and calling HAL_I2C_EV_IRQHandler() and HAL_I2C_ER_IRQHandler().
+ * @return EOS_OK, or EOS_ERROR if the handle is not initialized.
+ */
+EOS_status_t EOS_PortI2cStart(uint32_t bus, void* device)
+{
+	I2C_HandleTypeDef* hi2c = (I2C_HandleTypeDef*)device;
+
+	if (hi2c == NULL || hi2c->State == HAL_I2C_STATE_RESET)
+	{
+		return EOS_ERROR;
+	}
+
+	port_i2cs[bus] = hi2c;
+	port_i2c_rx_lengths[bus] = 0;
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Starts a transaction: its write, ending without a STOP if a read follows, or its read.
+ */
+EOS_status_t EOS_PortI2cTransfer(uint32_t bus, uint16_t address, const uint8_t* tx_data, uint16_t tx_length,
+		uint8_t* rx_data, uint16_t rx_length)
+{
+	I2C_HandleTypeDef* hi2c = port_i2cs[bus];
+	HAL_StatusTypeDef status;
+
+	port_i2c_addresses[bus] = (uint16_t)(address << 1);
+	if (tx_length > 0)
+	{
+		port_i2c_rx_data[bus] = rx_data;
+		port_i2c_rx_lengths[bus] = rx_length;
+		status = HAL_I2C_Master_Seq_Transmit_IT(hi2c, port_i2c_addresses[bus], (uint8_t*)tx_data, tx_length,
+				(rx_length > 0) ? I2C_FIRST_FRAME : I2C_FIRST_AND_LAST_FRAME);
+	}
+	else
+	{
+		port_i2c_rx_lengths[bus] = 0;
+		status = HAL_I2C_Master_Seq_Receive_IT(hi2c, port_i2c_addresses[bus], rx_data, rx_length,
+				I2C_FIRST_AND_LAST_FRAME);
+	}
+	return (status == HAL_OK) ? EOS_OK : EOS_ERROR;
+}
+
+
+/**
+ * @brief Stops whatever is on the bus and resets the peripheral, from the manager task.
+ */
+void EOS_PortI2cRecover(uint32_t bus)
+{
+	I2C_HandleTypeDef* hi2c = port_i2cs[bus];
+
+	port_i2c_rx_lengths[bus] = 0;
+	HAL_I2C_DeInit(hi2c);
+	HAL_I2C_Init(hi2c);
+}
+
+
+/**
+ * @brief Write phase done, from HAL_I2C_MasterTxCpltCallback(): starts the read phase after a repeated start, or
+ * 			ends the transaction.
+ *
+ * @return 1 if the bus is the manager's.
+ */
+static uint32_t EOS_PortI2cTxDone(I2C_HandleTypeDef* hi2c)
+{
+	uint32_t bus = EOS_PortI2cNumber(hi2c);
+
+	if (bus >= EOS_I2C_COUNT)
+	{
+		return 0;
+	}
+
+	uint16_t rx_length = port_i2c_rx_lengths[bus];
+	if (rx_length == 0)
+	{
+		EOS_I2cIsr(bus, EOS_I2C_OK);
+	}
+	else
+	{
+		port_i2c_rx_lengths[bus] = 0;
+		if (HAL_I2C_Master_Seq_Receive_IT(hi2c, port_i2c_addresses[bus], port_i2c_rx_data[bus], rx_length,
+				I2C_LAST_FRAME) != HAL_OK)
+		{
+			EOS_I2cIsr(bus, EOS_I2C_ERROR);
+		}
+	}
+	return 1;
+}
+
+
+/**
+ * @brief Read phase done, from HAL_I2C_MasterRxCpltCallback().
+ *
+ * @return 1 if the bus is the manager's.
+ */
+static uint32_t EOS_PortI2cRxDone(I2C_HandleTypeDef* hi2c)
+{
+	uint32_t bus = EOS_PortI2cNumber(hi2c);
+
+	if (bus >= EOS_I2C_COUNT)
+	{
+		return 0;
+	}
+
+	EOS_I2cIsr(bus, EOS_I2C_OK);
+	return 1;
+}
+
+
+/**
+ * @brief The transaction failed, from HAL_I2C_ErrorCallback(). A NACK leaves the bus usable, anything else has the
+ * 			manager reset it.
+ *
+ * @return 1 if the bus is the manager's.
+ */
+static uint32_t EOS_PortI2cError(I2C_HandleTypeDef* hi2c)
+{
+	uint32_t bus = EOS_PortI2cNumber(hi2c);
+
+	if (bus >= EOS_I2C_COUNT)
+	{
+		return 0;
+	}
+
+	port_i2c_rx_lengths[bus] = 0;
+	EOS_I2cIsr(bus, (HAL_I2C_GetError(hi2c) == HAL_I2C_ERROR_AF) ? EOS_I2C_NACK : EOS_I2C_ERROR);
+	return 1;
+}
+#endif
+
+
+#if EOS_HAL_ENABLE
+/*		HAL TIMEBASE AND BLOCKING CALLS		*/
+
+/* Most ticks a blocking call waits for the HAL to finish aborting a transfer that timed out */
+#define EOS_PORT_HAL_ABORT_TIMEOUT 10
+
+
+/**
+ * @brief Returns 1 in thread mode with interrupts enabled, where a task may sleep.
+ */
+uint32_t EOS_PortCanBlock(void)
+{
+	return __get_IPSR() == 0 && __get_PRIMASK() == 0;
+}
+
+
+/**
+ * @brief Replaces the HAL's timebase, called by HAL_Init() and again whenever the clocks change. The Systick is set
+ * 			up as before, at 1ms, as the kernel's tick, and EOS_PORT_HAL_TIM interrupts at the HAL's tick frequency,
+ * 			at EOS_PORT_HAL_PRIORITY, to count the HAL tick.
+ *
+ * @param TickPriority Priority of the Systick, TICK_INT_PRIORITY from stm32h7xx_hal_conf.h.
+ * @return HAL_OK, or HAL_ERROR if the priority or tick frequency is invalid.
+ */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+	if ((uint32_t)uwTickFreq == 0 || TickPriority >= (1UL << __NVIC_PRIO_BITS))
+	{
+		return HAL_ERROR;
+	}
+
+	if (SysTick_Config(SystemCoreClock / 1000) != 0)
+	{
+		return HAL_ERROR;
+	}
+	HAL_NVIC_SetPriority(SysTick_IRQn, TickPriority, 0);
+	uwTickPrio = TickPriority;
+
+	uint32_t ticks = EOS_PortTimerClock() / (1000 / (uint32_t)uwTickFreq);
+	uint32_t prescaler = ticks / 0x10000 + 1; //the auto reload register may be 16 bits
+
+	EOS_PORT_HAL_CLK_ENABLE();
+
+	EOS_PORT_HAL_TIM->CR1 = 0;
+	EOS_PORT_HAL_TIM->PSC = prescaler - 1;
+	EOS_PORT_HAL_TIM->ARR = ticks / prescaler - 1;
+	EOS_PORT_HAL_TIM->EGR = TIM_EGR_UG; //load the prescaler
+	EOS_PORT_HAL_TIM->SR = 0;
+	EOS_PORT_HAL_TIM->DIER = TIM_DIER_UIE;
+
+	HAL_NVIC_SetPriority(EOS_PORT_HAL_IRQn, EOS_PORT_HAL_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(EOS_PORT_HAL_IRQn);
+
+	EOS_PORT_HAL_TIM->CR1 = TIM_CR1_CEN;
+	return HAL_OK;
+}
+
+
+/**
+ * @brief Stops the HAL tick, as the HAL does around low power modes. The kernel's tick is left running.
+ */
+void HAL_SuspendTick(void)
+{
+	EOS_PORT_HAL_TIM->DIER &= ~TIM_DIER_UIE;
+}
+
+
+/**
+ * @brief Restarts the HAL tick.
+ */
+void HAL_ResumeTick(void)
+{
+	EOS_PORT_HAL_TIM->DIER |= TIM_DIER_UIE;
+}
+
+
+/**
+ * @brief HAL timebase interrupt handler.
+ */
+void EOS_PORT_HAL_IRQHandler(void)
+{
+	EOS_PORT_HAL_TIM->SR = ~TIM_SR_UIF;
+	HAL_IncTick();
+}
+
+
+/**
+ * @brief Waits at least Delay ms. A task sleeps in EOS_Delay(), so lower priority tasks run meanwhile. Before the
+ * 			scheduler starts, and in interrupts, it busy-waits on the HAL tick, as the HAL's own does.
+ */
+void HAL_Delay(uint32_t Delay)
+{
+	uint32_t wait = Delay;
+
+	if (wait < HAL_MAX_DELAY)
+	{
+		wait += (uint32_t)uwTickFreq; //the next tick may be just about due
+	}
+
+	if (EOS_HalCanBlock())
+	{
+		EOS_Delay(wait);
+		return;
+	}
+
+	uint32_t start = HAL_GetTick();
+	while ((HAL_GetTick() - start) < wait)
+	{
+	}
+}
+
+
+/**
+ * @brief Sleeps until a prepared transfer is done, or takes its wait back if the HAL did not start it.
+ *
+ * @param started What the HAL's ..._IT() call returned.
+ * @return HAL_OK, HAL_ERROR or HAL_TIMEOUT, or what the HAL returned if it did not start the transfer.
+ */
+static HAL_StatusTypeDef EOS_PortHalWait(EOS_hal_wait_t* wait, HAL_StatusTypeDef started)
+{
+	if (started != HAL_OK)
+	{
+		EOS_HalCancel(wait);
+		return started;
+	}
+
+	switch (EOS_HalWait(wait))
+	{
+	case EOS_HAL_DONE:
+		return HAL_OK;
+	case EOS_HAL_TIMEOUT:
+		return HAL_TIMEOUT;
+	default:
+		return HAL_ERROR;
+	}
+}
+
+
+#ifdef HAL_UART_MODULE_ENABLED
+/**
+ * @brief Sends a buffer, sleeping until its last byte is out. Stands in for HAL_UART_Transmit().
+ */
+HAL_StatusTypeDef EOS_HalUartTransmit(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size, uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_UART_Transmit(huart, data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, huart, EOS_HAL_TX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait, HAL_UART_Transmit_IT(huart, data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		HAL_UART_AbortTransmit(huart);
+	}
+	return status;
+}
+
+
+/**
+ * @brief Receives size bytes, sleeping until they are all in. Stands in for HAL_UART_Receive().
+ */
+HAL_StatusTypeDef EOS_HalUartReceive(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size, uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_UART_Receive(huart, data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, huart, EOS_HAL_RX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait, HAL_UART_Receive_IT(huart, data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		HAL_UART_AbortReceive(huart);
+	}
+	return status;
+}
+
+
+/**
+ * @brief Transmit complete, for UARTs the UART driver does not own.
+ */
+static void EOS_PortHalUartTx(UART_HandleTypeDef* huart)
+{
+	EOS_HalComplete(huart, EOS_HAL_TX, EOS_HAL_DONE);
+}
+
+
+/**
+ * @brief Line error, for UARTs the UART driver does not own. The HAL stops a reception on an overrun or a blocking
+ * 			error, and leaves the others running, so only transfers it stopped fail.
+ */
+static void EOS_PortHalUartError(UART_HandleTypeDef* huart)
+{
+	if (huart->RxState == HAL_UART_STATE_READY)
+	{
+		EOS_HalComplete(huart, EOS_HAL_RX, EOS_HAL_FAILED);
+	}
+	if (huart->gState == HAL_UART_STATE_READY)
+	{
+		EOS_HalComplete(huart, EOS_HAL_TX, EOS_HAL_FAILED);
+	}
+}
+
+
+/**
+ * @brief Receive complete.
+ */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart)
+{
+	EOS_HalComplete(huart, EOS_HAL_RX, EOS_HAL_DONE);
+}
+
+
+#if !EOS_UART_ENABLE //the UART driver's callbacks pass on the UARTs it does not own
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)
+{
+	EOS_PortHalUartTx(huart);
+}
+
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
+{
+	EOS_PortHalUartError(huart);
+}
+#endif
+#endif
+
+
+#ifdef HAL_I2C_MODULE_ENABLED
+/**
+ * @brief Ends an I2C transfer that timed out. A master transfer is aborted with a STOP, which the HAL finishes in the
+ * 			interrupt. A memory transfer cannot be aborted so, and the peripheral is reinitialized instead, as it is if
+ * 			the abort does not finish either.
+ */
+static void EOS_PortHalI2cAbort(I2C_HandleTypeDef* hi2c, uint16_t address)
+{
+	EOS_hal_wait_t wait;
+
+	EOS_HalPrepare(&wait, hi2c, EOS_HAL_ABORT, EOS_PORT_HAL_ABORT_TIMEOUT);
+	if (EOS_PortHalWait(&wait, HAL_I2C_Master_Abort_IT(hi2c, address)) != HAL_OK)
+	{
+		HAL_I2C_DeInit(hi2c);
+		HAL_I2C_Init(hi2c);
+	}
+}
+
+
+/**
+ * @brief Sends to a device, sleeping until the STOP. Stands in for HAL_I2C_Master_Transmit().
+ */
+HAL_StatusTypeDef EOS_HalI2cMasterTransmit(I2C_HandleTypeDef* hi2c, uint16_t address, uint8_t* data, uint16_t size,
+		uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_I2C_Master_Transmit(hi2c, address, data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, hi2c, EOS_HAL_TX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait, HAL_I2C_Master_Transmit_IT(hi2c, address, data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		EOS_PortHalI2cAbort(hi2c, address);
+	}
+	return status;
+}
+
+
+/**
+ * @brief Reads from a device, sleeping until the STOP. Stands in for HAL_I2C_Master_Receive().
+ */
+HAL_StatusTypeDef EOS_HalI2cMasterReceive(I2C_HandleTypeDef* hi2c, uint16_t address, uint8_t* data, uint16_t size,
+		uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_I2C_Master_Receive(hi2c, address, data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, hi2c, EOS_HAL_RX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait, HAL_I2C_Master_Receive_IT(hi2c, address, data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		EOS_PortHalI2cAbort(hi2c, address);
+	}
+	return status;
+}
+
+
+/**
+ * @brief Writes to a device's registers or memory, sleeping until the STOP. Stands in for HAL_I2C_Mem_Write().
+ */
+HAL_StatusTypeDef EOS_HalI2cMemWrite(I2C_HandleTypeDef* hi2c, uint16_t address, uint16_t memory, uint16_t memory_size,
+		uint8_t* data, uint16_t size, uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_I2C_Mem_Write(hi2c, address, memory, memory_size, data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, hi2c, EOS_HAL_TX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait,
+			HAL_I2C_Mem_Write_IT(hi2c, address, memory, memory_size, data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		EOS_PortHalI2cAbort(hi2c, address);
+	}
+	return status;
+}
+
+
+/**
+ * @brief Reads a device's registers or memory, sleeping until the STOP. Stands in for HAL_I2C_Mem_Read().
+ */
+HAL_StatusTypeDef EOS_HalI2cMemRead(I2C_HandleTypeDef* hi2c, uint16_t address, uint16_t memory, uint16_t memory_size,
+		uint8_t* data, uint16_t size, uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_I2C_Mem_Read(hi2c, address, memory, memory_size, data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, hi2c, EOS_HAL_RX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait,
+			HAL_I2C_Mem_Read_IT(hi2c, address, memory, memory_size, data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		EOS_PortHalI2cAbort(hi2c, address);
+	}
+	return status;
+}
+
+
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c)
+{
+#if EOS_I2C_ENABLE
+	if (EOS_PortI2cTxDone(hi2c))
+	{
+		return;
+	}
+#endif
+	EOS_HalComplete(hi2c, EOS_HAL_TX, EOS_HAL_DONE);
+}
+
+
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef* hi2c)
+{
+#if EOS_I2C_ENABLE
+	if (EOS_PortI2cRxDone(hi2c))
+	{
+		return;
+	}
+#endif
+	EOS_HalComplete(hi2c, EOS_HAL_RX, EOS_HAL_DONE);
+}
+
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef* hi2c)
+{
+	EOS_HalComplete(hi2c, EOS_HAL_TX, EOS_HAL_DONE);
+}
+
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef* hi2c)
+{
+	EOS_HalComplete(hi2c, EOS_HAL_RX, EOS_HAL_DONE);
+}
+
+
+/**
+ * @brief A NACK, bus error or arbitration loss ends the transfer.
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c)
+{
+#if EOS_I2C_ENABLE
+	if (EOS_PortI2cError(hi2c))
+	{
+		return;
+	}
+#endif
+	EOS_HalComplete(hi2c, EOS_HAL_ANY, EOS_HAL_FAILED);
+}
+
+
+void HAL_I2C_AbortCpltCallback(I2C_HandleTypeDef* hi2c)
+{
+	EOS_HalComplete(hi2c, EOS_HAL_ABORT, EOS_HAL_DONE);
+}
+#endif
+
+
+#ifdef HAL_SPI_MODULE_ENABLED
+/**
+ * @brief Sends a buffer, sleeping until it is out. Stands in for HAL_SPI_Transmit().
+ */
+HAL_StatusTypeDef EOS_HalSpiTransmit(SPI_HandleTypeDef* hspi, const uint8_t* data, uint16_t size, uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_SPI_Transmit(hspi, data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, hspi, EOS_HAL_TX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait, HAL_SPI_Transmit_IT(hspi, data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		HAL_SPI_Abort(hspi);
+	}
+	return status;
+}
+
+
+/**
+ * @brief Receives size frames, sleeping until they are all in. Stands in for HAL_SPI_Receive().
+ */
+HAL_StatusTypeDef EOS_HalSpiReceive(SPI_HandleTypeDef* hspi, uint8_t* data, uint16_t size, uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_SPI_Receive(hspi, data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, hspi, EOS_HAL_RX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait, HAL_SPI_Receive_IT(hspi, data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		HAL_SPI_Abort(hspi);
+	}
+	return status;
+}
+
+
+/**
+ * @brief Full duplex transfer, sleeping until it is done. Stands in for HAL_SPI_TransmitReceive().
+ */
+HAL_StatusTypeDef EOS_HalSpiTransmitReceive(SPI_HandleTypeDef* hspi, const uint8_t* tx_data, uint8_t* rx_data,
+		uint16_t size, uint32_t timeout)
+{
+	EOS_hal_wait_t wait;
+
+	if (!EOS_HalCanBlock())
+	{
+		return HAL_SPI_TransmitReceive(hspi, tx_data, rx_data, size, timeout);
+	}
+
+	EOS_HalPrepare(&wait, hspi, EOS_HAL_TX | EOS_HAL_RX, timeout);
+	HAL_StatusTypeDef status = EOS_PortHalWait(&wait, HAL_SPI_TransmitReceive_IT(hspi, tx_data, rx_data, size));
+	if (status == HAL_TIMEOUT)
+	{
+		HAL_SPI_Abort(hspi);
+	}
+	return status;
+}
+
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+	EOS_HalComplete(hspi, EOS_HAL_TX, EOS_HAL_DONE);
+}
+
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+	EOS_HalComplete(hspi, EOS_HAL_RX, EOS_HAL_DONE);
+}
+
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+	EOS_HalComplete(hspi, EOS_HAL_TX | EOS_HAL_RX, EOS_HAL_DONE);
+}
+
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi)
+{
+	EOS_HalComplete(hspi, EOS_HAL_ANY, EOS_HAL_FAILED);
+}
+#endif
+#endif
+
+
+/*		STACK FRAMES		*/
+
+
+/**
+ * @brief Initializes the stack for a new task, that does not use the FPU.
+ *
+ * @param task_stack Pointer to the base of the task's stack memory
+ * @param stack_size Size of the stack in 32-bit words.
+ * @param function   Pointer to the task's function.
+ *
+ */
+static void EOS_InitStack(int32_t* task_stack, uint32_t stack_size, void* function){
+
+	task_stack[stack_size-1] = 0x01000000;  //xpsr
+	task_stack[stack_size-2] = (int32_t)function; //pc
+	task_stack[stack_size-3] = 0xFFFFFFFD; 	//lr
+	task_stack[stack_size-4] = 0xDEADBEEA;  //r12
+	task_stack[stack_size-5] = 0xDEADBEEB;  //r3
+	task_stack[stack_size-6] = 0xDEADBEEC;  //r2
+	task_stack[stack_size-7] = 0xDEADBEED;	//r1
+	task_stack[stack_size-8] = 0xDEADBEEF;	//r0
+	task_stack[stack_size-9] = 0xDEADBEEF;	//r11
+	task_stack[stack_size-10] = 0xDEADBEAA;	//r10
+	task_stack[stack_size-11] = 0xDEADBEDF; //r9
+	task_stack[stack_size-12] = 0xDEADBEBF; //r8
+	task_stack[stack_size-13] = 0xDEADBECF; //r7
+	task_stack[stack_size-14] = 0xDEADBECC; //r6
+	task_stack[stack_size-15] = 0xDEADBEDD; //r5
+	task_stack[stack_size-16] = 0xDEADBAAA; //r4
+	task_stack[stack_size-17] = 0xFFFFFFFD; //store LR in fixed place for ease of context switching
+
+
+}
+
+
+/**
+ * @brief Initializes the stack for a new task, that uses the FPU.
+ *
+ * @param task_stack Pointer to the base of the task's stack memory
+ * @param stack_size Size of the stack in 32-bit words.
+ * @param function   Pointer to the task's function.
+ *
+ */
+static void EOS_InitFpuStack(int32_t* task_stack, uint32_t stack_size, void* function){
+	task_stack[stack_size-1] = 0xDEADBEEF;
+	task_stack[stack_size-2] = 0x00000000; //fpscr
+
+	for(int i = 3; i < 19; i++)
+	{
+		task_stack[stack_size-i] = 0x00000000; //S15->S0 fpu registers
+	}
+
+	task_stack[stack_size-19] = 0x01000000; //xPSR
+	task_stack[stack_size-20] = (int32_t)function;
+	task_stack[stack_size-21] = 0xFFFFFFED; //lr
+	task_stack[stack_size-22] = 0xDEADBEEA;  //r12
+	task_stack[stack_size-23] = 0xDEADBEEB;  //r3
+	task_stack[stack_size-24] = 0xDEADBEEC;  //r2
+	task_stack[stack_size-25] = 0xDEADBEED;	//r1
+	task_stack[stack_size-26] = 0xDEADBEEF;	//r0
+
+	for (int i = 27; i < 43; i++)
+	{
+		task_stack[stack_size - i] = 0x00000000; //S31-s16 fpu registers
+	}
+	for(int i = 43; i < 51; i++)
+	{
+		task_stack[stack_size-i] = 0xDEADBEEF; //r11-r4
+	}
+
+	task_stack[stack_size-51] = 0xFFFFFFED; //store LR in fixed place for ease of context switching
+}
@@ -0,0 +1,1005 @@
+/*
+ * eos_port.c
+ *
+ *      EvanRTOS port for POSIX hosts (Linux). It lets the unchanged kernel and application code run as a normal
+ *      process, so it can be debugged, profiled with perf, and stress tested without a board.
+ *
+ *      The whole system runs on a single host thread:
+ *      	- Each task runs on its own ucontext, with a host sized stack (EOS_POSIX_STACK_SIZE).
+ *      	- Interrupts are signals. An interval timer raises SIGALRM every EOS_POSIX_TICK_US, which plays the
+ *      	  part of the Systick interrupt, and SIGUSR1 is a user interrupt (see EOS_PosixTriggerIsr()).
+ *      	- Disabling interrupts blocks these signals.
+ *      	- EOS_PortYield() plays the part of PendSV. The switch happens right away when called from a task with
+ *      	  interrupts enabled. Otherwise it is deferred until interrupts are enabled again, or until the end of the
+ *      	  signal handler when called from an interrupt.
+ *
+ *      Interrupts do not nest. While a signal handler runs, both signals stay blocked, and EOS_EnterCritical()/
+ *      EOS_ExitCritical() do nothing.
+ *
+ *      With EOS_DUAL_CORE_ENABLE, a second process plays the part of the other core (see EvanRTOS_host/main_dual.c).
+ *      The cross-core lock is a spinlock in the shared memory, and the other core is interrupted with SIGUSR2, which
+ *      is masked along with the other interrupt signals.
+ *
+ *      With EOS_RING_ENABLE, the cache maintenance the ring buffers ask for is not needed, as host caches are coherent.
+ *
+ *      With EOS_UART_ENABLE, a UART is a file descriptor (a pty or a socket), and two helper threads per UART play the
+ *      parts of its DMA streams: one writes each buffer it is given, the other reads into the circular receive buffer,
+ *      and treats 1ms without data as an idle line. Both keep to the line rate, EOS_POSIX_UART_BAUD. They interrupt the kernel's thread with
+ *      SIGIO, which is masked along with the other interrupt signals, and block every signal themselves.
+ *
+ *      With EOS_HAL_ENABLE, there is no vendor HAL to wrap, but the transfer waits of eos_hal.c work the same: a stand-in
+ *      peripheral completes them by calling EOS_HalComplete() from the user interrupt (see EvanRTOS_host/main_hal.c).
+ *
+ *      With EOS_I2C_ENABLE, a bus is a list of simulated register file devices (EOS_posix_i2c_bus_t), and a helper
+ *      thread per bus carries each transaction it is given, taking as long as it would at EOS_POSIX_I2C_HZ, then
+ *      interrupts the kernel's thread with SIGURG, which is masked along with the other interrupt signals. Faults can
+ *      be set for the next transaction, to try the manager's recovery.
+ *
+ *      When the sampling profiler is enabled, a CLOCK_MONOTONIC timer raises SIGPROF at the sample rate, and the
+ *      program counter is read from the signal context. SIGPROF is masked along with the other interrupt signals.
+ */
+
+
+/*	INCLUDES	*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE //REG_RIP/REG_EIP in ucontext.h
+#endif
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/prctl.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include "eos_port.h"
+#include "eos_critical.h"
+#include "eos_profile.h"
+#include "eos_dual_core.h"
+#include "eos_uart.h"
+#include "eos_i2c.h"
+
+
+/*	DATATYPES	*/
+
+/* TCB->sp points to one of these on this port */
+typedef struct {
+	ucontext_t context;
+	void (*function)(void);
+} EOS_posix_task_t;
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static void EOS_PosixSwitch(void);
+static void EOS_PosixTaskEntry(void);
+static void EOS_PosixInterrupt(int signal_number);
+static void EOS_PosixIrqSignals(sigset_t* signals);
+#if EOS_UART_ENABLE
+static void EOS_PosixUartIsr(void);
+#endif
+#if EOS_I2C_ENABLE
+static void EOS_PosixI2cIsr(void);
+#endif
+
+
+/*	GLOBAL VARIABLES	*/
+static sigset_t posix_irq_signals;
+static volatile sig_atomic_t posix_running = 0;
+static volatile sig_atomic_t posix_irq_disabled = 0;
+static volatile sig_atomic_t posix_in_isr = 0;
+static volatile sig_atomic_t posix_switch_pending = 0;
+static void (*posix_isr)(void) = NULL;
+
+
+
+/*		PORT STARTUP		*/
+
+
+/**
+ * @brief Sets up the set of signals that act as interrupts.
+ */
+void EOS_PortInit(void){
+	EOS_PosixIrqSignals(&posix_irq_signals);
+}
+
+
+/**
+ * @brief Creates the host context of a task. The stack passed in by the kernel is not used.
+ *
+ * @return Pointer to the task's host context, stored in its TCB in place of a stack pointer, or NULL on failure.
+ */
+int32_t* EOS_PortInitStack(int32_t* task_stack, uint32_t stack_size, void* function, EOS_status_t use_fpu){
+
+	EOS_posix_task_t* volatile task = (EOS_posix_task_t*)malloc(sizeof(EOS_posix_task_t)); //volatile, getcontext() returns twice
+	void* host_stack = malloc(EOS_POSIX_STACK_SIZE);
+
+	if (task == NULL || host_stack == NULL)
+	{
+		free(task);
+		free(host_stack);
+		return NULL;
+	}
+
+	getcontext(&task->context);
+	task->context.uc_stack.ss_sp = host_stack;
+	task->context.uc_stack.ss_size = EOS_POSIX_STACK_SIZE;
+	task->context.uc_link = NULL;
+	task->function = (void (*)(void))function;
+
+	//tasks start with interrupts disabled, EOS_PosixTaskEntry() enables them
+	EOS_PosixIrqSignals(&task->context.uc_sigmask);
+
+	makecontext(&task->context, EOS_PosixTaskEntry, 0);
+
+	return (int32_t*)task;
+}
+
+
+/**
+ * @brief Installs the interrupt handlers, starts the simulated Systick, and runs the task pointed to by run_ptr.
+ * 			Does not return.
+ */
+void EOS_PortStartScheduler(void){
+
+	struct sigaction action = {0};
+	action.sa_handler = EOS_PosixInterrupt;
+	action.sa_mask = posix_irq_signals;
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGALRM, &action, NULL);
+	sigaction(SIGUSR1, &action, NULL);
+
+	struct itimerval timer = {
+			.it_interval = {0, EOS_POSIX_TICK_US},
+			.it_value = {0, EOS_POSIX_TICK_US}
+	};
+	setitimer(ITIMER_REAL, &timer, NULL);
+
+	posix_running = 1;
+	setcontext(&((EOS_posix_task_t*)run_ptr->sp)->context);
+}
+
+
+
+/*		INTERRUPTS		*/
+
+
+/**
+ * @brief Fills in the set of signals that act as interrupts.
+ */
+static void EOS_PosixIrqSignals(sigset_t* signals){
+	sigemptyset(signals);
+	sigaddset(signals, SIGALRM);
+	sigaddset(signals, SIGUSR1);
+#if EOS_DUAL_CORE_ENABLE
+	sigaddset(signals, SIGUSR2);
+#endif
+#if EOS_PROFILE_ENABLE
+	sigaddset(signals, SIGPROF);
+#endif
+#if EOS_UART_ENABLE
+	sigaddset(signals, SIGIO);
+#endif
+#if EOS_I2C_ENABLE
+	sigaddset(signals, SIGURG);
+#endif
+}
+
+
+void EOS_PortDisableInterrupts(void){
+	if (posix_in_isr)
+	{
+		return;
+	}
+	sigprocmask(SIG_BLOCK, &posix_irq_signals, NULL);
+	posix_irq_disabled = 1;
+}
+
+
+void EOS_PortEnableInterrupts(void){
+	if (posix_in_isr)
+	{
+		return;
+	}
+	posix_irq_disabled = 0;
+	sigprocmask(SIG_UNBLOCK, &posix_irq_signals, NULL);
+
+	if (posix_switch_pending)
+	{
+		EOS_PortYield();
+	}
+}
+
+
+uint32_t EOS_PortMaskInterrupts(void){
+	uint32_t state = posix_irq_disabled | posix_in_isr;
+
+	if (state == 0)
+	{
+		EOS_PortDisableInterrupts();
+	}
+	return state;
+}
+
+
+void EOS_PortRestoreInterrupts(uint32_t state){
+	if (state == 0)
+	{
+		EOS_PortEnableInterrupts();
+	}
+}
+
+
+#if EOS_HAL_ENABLE
+/**
+ * @brief Returns 1 in a task with interrupts enabled, where it may sleep (EOS_HalCanBlock()).
+ */
+uint32_t EOS_PortCanBlock(void){
+	return posix_running && posix_in_isr == 0 && posix_irq_disabled == 0;
+}
+#endif
+
+
+/**
+ * @brief Raises the simulated user interrupt. The handler set with EOS_PosixSetIsr() runs before this returns,
+ * 			unless interrupts are disabled, in which case it runs once they are enabled.
+ */
+void EOS_PosixTriggerIsr(void){
+	raise(SIGUSR1);
+}
+
+
+/**
+ * @brief Sets the function run by the simulated user interrupt.
+ */
+void EOS_PosixSetIsr(void (*handler)(void)){
+	posix_isr = handler;
+}
+
+
+/**
+ * @brief Signal handler shared by all simulated interrupts.
+ */
+static void EOS_PosixInterrupt(int signal_number){
+	posix_in_isr = 1;
+
+	if (signal_number == SIGALRM)
+	{
+		EOS_Tick();
+	}
+#if EOS_DUAL_CORE_ENABLE
+	else if (signal_number == SIGUSR2)
+	{
+		EOS_DualCoreIsr();
+	}
+#endif
+#if EOS_UART_ENABLE
+	else if (signal_number == SIGIO)
+	{
+		EOS_PosixUartIsr();
+	}
+#endif
+#if EOS_I2C_ENABLE
+	else if (signal_number == SIGURG)
+	{
+		EOS_PosixI2cIsr();
+	}
+#endif
+	else if (posix_isr != NULL)
+	{
+		posix_isr();
+	}
+
+	if (posix_switch_pending)
+	{
+		posix_switch_pending = 0;
+		EOS_PosixSwitch(); //we return here once this task is switched back in
+	}
+
+	posix_in_isr = 0;
+	posix_irq_disabled = 0;
+}
+
+
+
+/*		CONTEXT SWITCHING		*/
+
+
+/**
+ * @brief Requests a context switch (the PendSV interrupt of the Cortex-M ports).
+ */
+void EOS_PortYield(void){
+	if (posix_running == 0 || posix_in_isr || posix_irq_disabled)
+	{
+		posix_switch_pending = 1;
+		return;
+	}
+
+	sigprocmask(SIG_BLOCK, &posix_irq_signals, NULL);
+	posix_irq_disabled = 1;
+	posix_switch_pending = 0;
+
+	EOS_PosixSwitch();
+
+	posix_in_isr = 0;
+	posix_irq_disabled = 0;
+	sigprocmask(SIG_UNBLOCK, &posix_irq_signals, NULL);
+}
+
+
+/**
+ * @brief Runs the scheduler, and switches to the task it picks. Must be called with interrupt signals blocked.
+ */
+static void EOS_PosixSwitch(void){
+	EOS_TCB_t* previous = run_ptr;
+
+	EOS_CriticalProfileBegin("PendSV_Handler", 0);
+	EOS_scheduler();
+	EOS_CriticalProfileEnd();
+
+	if (run_ptr != previous)
+	{
+		swapcontext(&((EOS_posix_task_t*)previous->sp)->context, &((EOS_posix_task_t*)run_ptr->sp)->context);
+	}
+}
+
+
+/**
+ * @brief First code run by every task. Enables interrupts and calls the task function.
+ */
+static void EOS_PosixTaskEntry(void){
+	EOS_posix_task_t* task = (EOS_posix_task_t*)run_ptr->sp;
+
+	posix_in_isr = 0;
+	posix_irq_disabled = 0;
+	sigprocmask(SIG_UNBLOCK, &posix_irq_signals, NULL);
+
+	task->function();
+
+	fprintf(stderr, "EvanRTOS: task %u returned\n", run_ptr->id);
+	abort();
+}
+
+
+
+#if EOS_DUAL_CORE_ENABLE
+/*		SIMULATED SECOND CORE		*/
+
+static pid_t posix_peer = 0;
+
+
+/**
+ * @brief Sets the process that plays the part of the other core. Must be called before EOS_DualCoreInit().
+ */
+void EOS_PosixSetPeer(pid_t peer){
+	posix_peer = peer;
+}
+
+
+/**
+ * @brief Takes the spinlock in the shared memory, giving up the host CPU while the other process holds it.
+ */
+void EOS_PortCoreLock(volatile uint32_t* lock){
+	while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) != 0)
+	{
+		sched_yield();
+	}
+}
+
+
+void EOS_PortCoreUnlock(volatile uint32_t* lock){
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Interrupts the other process with SIGUSR2.
+ */
+void EOS_PortCoreNotify(uint32_t core){
+	(void)core;
+	kill(posix_peer, SIGUSR2);
+}
+
+
+/**
+ * @brief Installs the SIGUSR2 handler. Done before the scheduler starts, as the other core may already be running.
+ */
+void EOS_PortCoreListen(uint32_t core){
+	(void)core;
+	struct sigaction action = {0};
+	action.sa_handler = EOS_PosixInterrupt;
+	EOS_PosixIrqSignals(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGUSR2, &action, NULL);
+}
+#endif
+
+
+#if EOS_RING_ENABLE
+/*		DATA CACHE AND MPU		*/
+
+
+/**
+ * @brief Host caches are coherent, so the ring buffers only need their indices ordered, which they do themselves.
+ */
+void EOS_PortCacheClean(const void* address, uint32_t size){
+	(void)address;
+	(void)size;
+}
+
+
+void EOS_PortCacheInvalidate(void* address, uint32_t size){
+	(void)address;
+	(void)size;
+}
+
+
+/**
+ * @brief There is no MPU. Checks the arguments like the ARM_CM7 port, so misuse shows up on the host.
+ */
+EOS_status_t EOS_PortMpuUncached(uint32_t region, void* base, uint32_t size){
+	if (region >= 8 || size < 32 || (size & (size - 1)) != 0 || ((uintptr_t)base & (size - 1)) != 0)
+	{
+		return EOS_ERROR;
+	}
+	return EOS_OK;
+}
+#endif
+
+
+#if EOS_UART_ENABLE
+/*		SIMULATED UART		*/
+
+/* One UART: its file descriptor, and the state its two DMA threads share with the interrupt */
+typedef struct {
+	int fd;
+	int tx_wake[2];						//pipe the transmit thread waits on for a buffer
+	const uint8_t* volatile tx_data;
+	volatile uint32_t tx_length;
+	volatile uint32_t tx_done;
+	uint8_t* rx_buffer;
+	uint32_t rx_size;
+	volatile uint64_t rx_received;		//bytes the receive thread has written, from the start
+	volatile uint64_t rx_flagged;		//bytes it has raised an interrupt for
+	uint64_t rx_reported;				//bytes passed to EOS_UartRxIsr()
+} EOS_posix_uart_t;
+
+static EOS_posix_uart_t posix_uarts[EOS_UART_COUNT];
+static uint32_t posix_uarts_started = 0;
+
+
+/**
+ * @brief Interrupts the kernel's thread. SIGIO is sent to the process, and only that thread leaves it unblocked.
+ */
+static void EOS_PosixUartInterrupt(void){
+	kill(getpid(), SIGIO);
+}
+
+
+#if EOS_POSIX_UART_BAUD != 0
+/**
+ * @brief Sleeps until the line has carried count more bytes, at EOS_POSIX_UART_BAUD. line_free is when it finished
+ * 			the last ones; an idle line starts again from now.
+ */
+static void EOS_PosixUartLine(struct timespec* line_free, uint32_t count){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	if (now.tv_sec > line_free->tv_sec || (now.tv_sec == line_free->tv_sec && now.tv_nsec > line_free->tv_nsec))
+	{
+		*line_free = now;
+	}
+
+	line_free->tv_nsec += (long)((uint64_t)count * 10u * 1000000000u / EOS_POSIX_UART_BAUD);
+	while (line_free->tv_nsec >= 1000000000L)
+	{
+		line_free->tv_nsec -= 1000000000L;
+		line_free->tv_sec++;
+	}
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, line_free, NULL);
+}
+#endif
+
+
+/**
+ * @brief Transmit DMA: writes each buffer it is given to the file descriptor, then raises the transmit complete
+ * 			interrupt.
+ */
+static void* EOS_PosixUartTxThread(void* argument){
+	EOS_posix_uart_t* uart = (EOS_posix_uart_t*)argument;
+#if EOS_POSIX_UART_BAUD != 0
+	struct timespec line_free = {0};
+#endif
+	uint8_t wake;
+
+	while (read(uart->tx_wake[0], &wake, 1) == 1)
+	{
+		const uint8_t* data = uart->tx_data;
+		uint32_t length = uart->tx_length;
+
+		while (length > 0)
+		{
+			uint32_t piece = (EOS_POSIX_UART_BAUD != 0 && length > 256) ? 256 : length;
+			ssize_t written = write(uart->fd, data, piece);
+			if (written < 0)
+			{
+				if (errno == EINTR || errno == EAGAIN)
+				{
+					continue;
+				}
+				break; //the other end is gone: the rest is lost on the line
+			}
+			data += written;
+			length -= (uint32_t)written;
+
+#if EOS_POSIX_UART_BAUD != 0
+			EOS_PosixUartLine(&line_free, (uint32_t)written);
+#endif
+		}
+
+		__atomic_store_n(&uart->tx_done, 1, __ATOMIC_RELEASE);
+		EOS_PosixUartInterrupt();
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief Receive DMA: reads into the circular buffer as data arrives, without regard for the reader, and raises the
+ * 			receive interrupt at each half of the buffer, and once the line has been idle for 1ms after a burst.
+ */
+static void* EOS_PosixUartRxThread(void* argument){
+	EOS_posix_uart_t* uart = (EOS_posix_uart_t*)argument;
+	struct pollfd wait = { .fd = uart->fd, .events = POLLIN };
+	uint32_t half = uart->rx_size / 2;
+#if EOS_POSIX_UART_BAUD != 0
+	struct timespec line_free = {0};
+#endif
+
+	while (1)
+	{
+		uint64_t received = uart->rx_received;
+		int ready = poll(&wait, 1, 1);
+
+		if (ready == 0)
+		{
+			if (uart->rx_flagged != received) //idle line
+			{
+				__atomic_store_n(&uart->rx_flagged, received, __ATOMIC_RELEASE);
+				EOS_PosixUartInterrupt();
+			}
+			continue;
+		}
+		if (ready < 0 || (wait.revents & POLLIN) == 0)
+		{
+			if (ready < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			return NULL; //the other end is gone
+		}
+
+		uint32_t position = (uint32_t)(received % uart->rx_size);
+		uint32_t limit = (position < half) ? half - position : uart->rx_size - position;
+		if (EOS_POSIX_UART_BAUD != 0 && limit > 256)
+		{
+			limit = 256;
+		}
+		ssize_t count = read(uart->fd, &uart->rx_buffer[position], limit);
+		if (count <= 0)
+		{
+			if (count < 0 && (errno == EINTR || errno == EAGAIN))
+			{
+				continue;
+			}
+			return NULL;
+		}
+
+#if EOS_POSIX_UART_BAUD != 0
+		//what the other end wrote at once still arrives at the line rate
+		EOS_PosixUartLine(&line_free, (uint32_t)count);
+#endif
+
+		received += (uint64_t)count;
+		__atomic_store_n(&uart->rx_received, received, __ATOMIC_RELEASE);
+		if ((uint32_t)(received % uart->rx_size) == 0 || (uint32_t)(received % uart->rx_size) == half)
+		{
+			__atomic_store_n(&uart->rx_flagged, received, __ATOMIC_RELEASE);
+			EOS_PosixUartInterrupt();
+		}
+	}
+}
+
+
+/**
+ * @brief UART interrupt: reports finished sends, and the data received, stepping through the half and end of the
+ * 			buffer as the hardware's separate interrupts would.
+ */
+static void EOS_PosixUartIsr(void){
+	for (uint32_t i = 0; i < posix_uarts_started; i++)
+	{
+		EOS_posix_uart_t* uart = &posix_uarts[i];
+
+		if (__atomic_exchange_n(&uart->tx_done, 0, __ATOMIC_ACQUIRE))
+		{
+			EOS_UartTxIsr(i);
+		}
+
+		uint64_t flagged = __atomic_load_n(&uart->rx_flagged, __ATOMIC_ACQUIRE);
+		while (uart->rx_reported != flagged)
+		{
+			uint32_t position = (uint32_t)(uart->rx_reported % uart->rx_size);
+			uint32_t boundary = (position < uart->rx_size / 2) ? uart->rx_size / 2 : uart->rx_size;
+			uint64_t step = boundary - position;
+
+			if (step > flagged - uart->rx_reported)
+			{
+				step = flagged - uart->rx_reported;
+			}
+			uart->rx_reported += step;
+			EOS_UartRxIsr(i, position + (uint32_t)step);
+		}
+	}
+}
+
+
+/**
+ * @brief Starts the two DMA threads of a UART, with every signal blocked, so the interrupt signals reach the kernel's
+ * 			thread only.
+ *
+ * @param device The file descriptor, as EOS_POSIX_UART_FD(fd), open for reading and writing.
+ */
+EOS_status_t EOS_PortUartStart(uint32_t uart, void* device, uint8_t* rx_buffer, uint32_t rx_size){
+	EOS_posix_uart_t* state = &posix_uarts[uart];
+	pthread_t tx_thread;
+	pthread_t rx_thread;
+	sigset_t all;
+	sigset_t previous;
+
+	state->fd = (int)(intptr_t)device;
+	state->rx_buffer = rx_buffer;
+	state->rx_size = rx_size;
+	state->rx_received = 0;
+	state->rx_flagged = 0;
+	state->rx_reported = 0;
+	state->tx_done = 0;
+	if (state->fd < 0 || pipe(state->tx_wake) != 0)
+	{
+		return EOS_ERROR;
+	}
+
+	struct sigaction action = {0};
+	action.sa_handler = EOS_PosixInterrupt;
+	EOS_PosixIrqSignals(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGIO, &action, NULL);
+
+	if (uart >= posix_uarts_started)
+	{
+		posix_uarts_started = uart + 1;
+	}
+
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, &previous);
+	int failed = pthread_create(&tx_thread, NULL, EOS_PosixUartTxThread, state) != 0 ||
+			pthread_create(&rx_thread, NULL, EOS_PosixUartRxThread, state) != 0;
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+	if (failed)
+	{
+		return EOS_ERROR;
+	}
+	pthread_detach(tx_thread);
+	pthread_detach(rx_thread);
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Hands a buffer to the transmit thread.
+ */
+EOS_status_t EOS_PortUartSend(uint32_t uart, const uint8_t* data, uint32_t length){
+	EOS_posix_uart_t* state = &posix_uarts[uart];
+	uint8_t wake = 1;
+
+	state->tx_data = data;
+	state->tx_length = length;
+	return (write(state->tx_wake[1], &wake, 1) == 1) ? EOS_OK : EOS_ERROR;
+}
+#endif
+
+
+#if EOS_I2C_ENABLE
+/*		SIMULATED I2C		*/
+
+/* One transaction handed to a bus's thread */
+typedef struct {
+	uint16_t address;
+	uint16_t tx_length;
+	const uint8_t* tx_data;
+	uint16_t rx_length;
+	uint8_t* rx_data;
+	uint32_t generation;
+} EOS_posix_i2c_request_t;
+
+/* One bus: the devices on it, and the state its thread shares with the interrupt */
+typedef struct {
+	EOS_posix_i2c_bus_t* bus;
+	int wake[2];						//pipe the thread waits on for a transaction
+	volatile uint32_t generation;		//bumped by each reset, which drops the transaction on the bus
+	volatile uint32_t result;			//of the transaction that ended, until passed to EOS_I2cIsr(), or 0
+	volatile uint32_t result_generation;
+} EOS_posix_i2c_t;
+
+static EOS_posix_i2c_t posix_i2cs[EOS_I2C_COUNT];
+static uint32_t posix_i2cs_started = 0;
+
+
+/**
+ * @brief A bus's thread: carries each transaction, taking as long as the bus would, moves its data to or from the
+ * 			device, then raises the I2C interrupt.
+ */
+static void* EOS_PosixI2cThread(void* argument){
+	EOS_posix_i2c_t* state = (EOS_posix_i2c_t*)argument;
+	EOS_posix_i2c_bus_t* bus = state->bus;
+	EOS_posix_i2c_request_t request;
+
+	prctl(PR_SET_TIMERSLACK, 1UL); //keeps to the bus clock closer than the default 50us
+
+	while (read(state->wake[0], &request, sizeof(request)) == sizeof(request))
+	{
+		EOS_posix_i2c_device_t* device = NULL;
+		uint32_t fault = __atomic_exchange_n(&bus->fault, 0, __ATOMIC_ACQUIRE);
+		uint64_t bits = 2 + 9; //start, stop and the first address
+		EOS_i2c_result_t result = EOS_I2C_OK;
+		struct timespec start;
+		struct timespec end;
+
+		for (uint32_t i = 0; i < bus->count; i++)
+		{
+			if (bus->devices[i].address == request.address)
+			{
+				device = &bus->devices[i];
+			}
+		}
+
+		if (fault == EOS_POSIX_I2C_FAULT_HANG)
+		{
+			continue; //nothing ends it but a reset
+		}
+		else if (fault == EOS_POSIX_I2C_FAULT_ERROR)
+		{
+			result = EOS_I2C_ERROR;
+		}
+		else if (device == NULL || device->size == 0)
+		{
+			result = EOS_I2C_NACK;
+		}
+		else
+		{
+			bits += 9u * request.tx_length;
+			if (request.rx_length > 0)
+			{
+				bits += (request.tx_length > 0 ? 1 + 9 : 0) + 9u * request.rx_length; //repeated start and address
+			}
+		}
+
+		uint64_t duration = bits * 1000000000u / EOS_POSIX_I2C_HZ;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		end = start;
+		end.tv_nsec += (long)duration;
+		while (end.tv_nsec >= 1000000000L)
+		{
+			end.tv_nsec -= 1000000000L;
+			end.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &end, NULL);
+
+		if (request.generation != __atomic_load_n(&state->generation, __ATOMIC_ACQUIRE))
+		{
+			continue;
+		}
+
+		if (result == EOS_I2C_OK)
+		{
+			for (uint32_t i = 0; i < request.tx_length; i++)
+			{
+				if (i == 0)
+				{
+					device->pointer = request.tx_data[0] % device->size;
+				}
+				else
+				{
+					device->memory[device->pointer] = request.tx_data[i];
+					device->pointer = (device->pointer + 1) % device->size;
+				}
+			}
+			for (uint32_t i = 0; i < request.rx_length; i++)
+			{
+				request.rx_data[i] = device->memory[device->pointer];
+				device->pointer = (device->pointer + 1) % device->size;
+			}
+		}
+
+		clock_gettime(CLOCK_MONOTONIC, &end); //the sleep's overshoot is time on the bus, not between transactions
+		bus->busy_ns += (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000u + (uint64_t)(end.tv_nsec - start.tv_nsec);
+		bus->transfers++;
+		state->result_generation = request.generation;
+		__atomic_store_n(&state->result, (uint32_t)result, __ATOMIC_RELEASE);
+		kill(getpid(), SIGURG);
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief I2C interrupt: reports the transactions that ended, unless the bus was reset since they started.
+ */
+static void EOS_PosixI2cIsr(void){
+	for (uint32_t i = 0; i < posix_i2cs_started; i++)
+	{
+		EOS_posix_i2c_t* state = &posix_i2cs[i];
+		uint32_t result = __atomic_exchange_n(&state->result, 0, __ATOMIC_ACQUIRE);
+
+		if (result != 0 && state->result_generation == state->generation)
+		{
+			EOS_I2cIsr(i, (EOS_i2c_result_t)result);
+		}
+	}
+}
+
+
+/**
+ * @brief Starts a bus's thread, with every signal blocked, so the interrupt signal reaches the kernel's thread only.
+ *
+ * @param device The bus, an EOS_posix_i2c_bus_t.
+ */
+EOS_status_t EOS_PortI2cStart(uint32_t bus, void* device){
+	EOS_posix_i2c_t* state = &posix_i2cs[bus];
+	pthread_t thread;
+	sigset_t all;
+	sigset_t previous;
+
+	state->bus = (EOS_posix_i2c_bus_t*)device;
+	state->generation = 0;
+	state->result = 0;
+	if (state->bus == NULL || pipe(state->wake) != 0)
+	{
+		return EOS_ERROR;
+	}
+
+	struct sigaction action = {0};
+	action.sa_handler = EOS_PosixInterrupt;
+	EOS_PosixIrqSignals(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGURG, &action, NULL);
+
+	if (bus >= posix_i2cs_started)
+	{
+		posix_i2cs_started = bus + 1;
+	}
+
+	sigfillset(&all);
+	pthread_sigmask(SIG_BLOCK, &all, &previous);
+	int failed = pthread_create(&thread, NULL, EOS_PosixI2cThread, state) != 0;
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+	if (failed)
+	{
+		return EOS_ERROR;
+	}
+	pthread_detach(thread);
+	return EOS_OK;
+}
+
+
+/**
+ * @brief Hands a transaction to the bus's thread.
+ */
+EOS_status_t EOS_PortI2cTransfer(uint32_t bus, uint16_t address, const uint8_t* tx_data, uint16_t tx_length,
+		uint8_t* rx_data, uint16_t rx_length){
+	EOS_posix_i2c_t* state = &posix_i2cs[bus];
+	EOS_posix_i2c_request_t request = {address, tx_length, tx_data, rx_length, rx_data, state->generation};
+
+	return (write(state->wake[1], &request, sizeof(request)) == sizeof(request)) ? EOS_OK : EOS_ERROR;
+}
+
+
+/**
+ * @brief Resets a bus: the transaction on it, if any, is dropped without an interrupt.
+ */
+void EOS_PortI2cRecover(uint32_t bus){
+	EOS_posix_i2c_t* state = &posix_i2cs[bus];
+
+	__atomic_add_fetch(&state->generation, 1, __ATOMIC_ACQ_REL);
+	__atomic_store_n(&state->result, 0, __ATOMIC_RELEASE);
+	state->bus->resets++;
+}
+#endif
+
+
+#if EOS_PROFILE_ENABLE
+/*		SAMPLING PROFILER		*/
+
+static timer_t posix_profile_timer;
+static uint8_t posix_profile_timer_created = 0;
+
+
+/**
+ * @brief SIGPROF handler, counts the program counter of the interrupted code.
+ */
+static void EOS_PosixProfileInterrupt(int signal_number, siginfo_t* info, void* context){
+	ucontext_t* interrupted = (ucontext_t*)context;
+	uintptr_t pc = 0;
+
+#if defined(__x86_64__)
+	pc = (uintptr_t)interrupted->uc_mcontext.gregs[REG_RIP];
+#elif defined(__i386__)
+	pc = (uintptr_t)interrupted->uc_mcontext.gregs[REG_EIP];
+#elif defined(__aarch64__)
+	pc = (uintptr_t)interrupted->uc_mcontext.pc;
+#else
+	(void)interrupted;
+#endif
+
+	EOS_ProfileSample((uint32_t)pc, posix_in_isr);
+}
+
+
+/**
+ * @brief Starts raising SIGPROF sample_hz times per second of wall clock time.
+ */
+void EOS_PortProfileStart(uint32_t sample_hz){
+
+	if (posix_profile_timer_created == 0)
+	{
+		struct sigaction action = {0};
+		action.sa_sigaction = EOS_PosixProfileInterrupt;
+		EOS_PosixIrqSignals(&action.sa_mask);
+		action.sa_flags = SA_RESTART | SA_SIGINFO;
+		sigaction(SIGPROF, &action, NULL);
+
+		struct sigevent event = {0};
+		event.sigev_notify = SIGEV_SIGNAL;
+		event.sigev_signo = SIGPROF;
+		if (timer_create(CLOCK_MONOTONIC, &event, &posix_profile_timer) != 0)
+		{
+			return;
+		}
+		posix_profile_timer_created = 1;
+	}
+
+	long period_ns = 1000000000L / (long)sample_hz;
+	struct itimerspec timer = {
+			.it_interval = {period_ns / 1000000000L, period_ns % 1000000000L},
+			.it_value = {period_ns / 1000000000L, period_ns % 1000000000L}
+	};
+	timer_settime(posix_profile_timer, 0, &timer, NULL);
+}
+
+
+/**
+ * @brief Stops raising SIGPROF.
+ */
+void EOS_PortProfileStop(void){
+	struct itimerspec timer = {0};
+
+	if (posix_profile_timer_created)
+	{
+		timer_settime(posix_profile_timer, 0, &timer, NULL);
+	}
+}
+#endif
+
+
+
+/*		CYCLE COUNTER		*/
+
+
+/**
+ * @brief Returns the host monotonic clock in nanoseconds, truncated to 32 bits.
+ */
+uint32_t EOS_PortGetCycles(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
@@ -0,0 +1,96 @@
+/*
+ * eos_portmacro.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Port macros for the POSIX (Linux host) simulation port. See eos_port.h and port/POSIX/eos_port.c.
+ */
+
+#ifndef INC_EOS_PORTMACRO_H_
+#define INC_EOS_PORTMACRO_H_
+
+#include <stdint.h>
+#include <unistd.h>
+
+
+/*	CONSTANTS	*/
+
+/* Host stack given to each task. The stack passed to EOS_ThreadNew() is too small for host code, and is not used */
+#ifndef EOS_POSIX_STACK_SIZE
+#define EOS_POSIX_STACK_SIZE (64 * 1024)
+#endif
+
+/* Period of the simulated Systick, in microseconds */
+#ifndef EOS_POSIX_TICK_US
+#define EOS_POSIX_TICK_US 1000
+#endif
+
+/* Line rate of the simulated UARTs (EOS_UART_ENABLE), in bits per second, 10 bits per byte. Their transmit threads
+ * keep to it, as a real line would, so data arrives at the pace the receive buffer is sized for. 0 sends at host speed */
+#ifndef EOS_POSIX_UART_BAUD
+#define EOS_POSIX_UART_BAUD 2000000
+#endif
+
+
+/* Clock of the simulated I2C buses (EOS_I2C_ENABLE), in Hz. Each transaction takes as long as its bits would, 9 per
+ * byte with the acknowledge, plus its address, start and stop */
+#ifndef EOS_POSIX_I2C_HZ
+#define EOS_POSIX_I2C_HZ 400000
+#endif
+
+
+/*	PORT MACROS	*/
+#define EOS_PORT_CYCLE_HZ 1000000000u //EOS_PortGetCycles() counts nanoseconds
+
+void EOS_PortDisableInterrupts(void);
+void EOS_PortEnableInterrupts(void);
+uint32_t EOS_PortMaskInterrupts(void);
+void EOS_PortRestoreInterrupts(uint32_t state);
+void EOS_PortYield(void);
+uint32_t EOS_PortGetCycles(void);
+
+#define EOS_PortIdle() pause()
+
+
+/*	SIMULATED INTERRUPTS	*/
+void EOS_PosixSetIsr(void (*handler)(void));
+void EOS_PosixTriggerIsr(void);
+
+
+/*	SIMULATED UART	*/
+
+/* Turns a file descriptor into the device passed to EOS_UartInit() */
+#define EOS_POSIX_UART_FD(fd) ((void*)(intptr_t)(fd))
+
+
+/*	SIMULATED I2C	*/
+
+/* A device on a simulated I2C bus: a register file, as EEPROMs and most sensors are. A write sets its register pointer
+ * from its first byte, and writes the rest from there on, a read reads on from the pointer. Both wrap at size */
+typedef struct {
+	uint16_t address;				//7 bit
+	uint8_t* memory;
+	uint32_t size;
+	uint32_t pointer;
+} EOS_posix_i2c_device_t;
+
+/* Faults a simulated bus can be given for its next transaction */
+#define EOS_POSIX_I2C_FAULT_ERROR 1		//ends in a bus error after the address
+#define EOS_POSIX_I2C_FAULT_HANG 2		//never ends, as with a device holding the clock low
+
+/* A simulated bus, the device passed to EOS_I2cInit(). An address no device answers to is not acknowledged */
+typedef struct {
+	EOS_posix_i2c_device_t* devices;
+	uint32_t count;
+	volatile uint32_t fault;		//EOS_POSIX_I2C_FAULT_..., cleared once its transaction starts
+	volatile uint64_t busy_ns;		//time the bus has spent carrying transactions
+	volatile uint32_t transfers;	//transactions ended
+	volatile uint32_t resets;		//EOS_PortI2cRecover() calls
+} EOS_posix_i2c_bus_t;
+
+
+/*	SIMULATED SECOND CORE	*/
+void EOS_PosixSetPeer(pid_t peer);
+
+#endif /* INC_EOS_PORTMACRO_H_ */
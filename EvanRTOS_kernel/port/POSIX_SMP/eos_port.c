@@ -0,0 +1,436 @@
+/*
+ * eos_port.c
+ *
+ *      EvanRTOS port for POSIX hosts (Linux) running the kernel in SMP mode (EOS_SMP_ENABLE, eos_smp.c), where each of
+ *      EOS_SMP_CORES pthreads plays the part of a core. It lets the SMP scheduler be developed and stress tested on a
+ *      workstation, ahead of multi-core microcontrollers (see EvanRTOS_host/main_smp.c).
+ *
+ *      It works like the single core POSIX port, one core per thread:
+ *      	- Each task runs on its own ucontext, with a host sized stack (EOS_POSIX_STACK_SIZE), and may be run by any
+ *      	  core thread, one at a time.
+ *      	- Each core thread has a scheduler context on its own stack. A task switches out by swapping to it, and the
+ *      	  core calls EOS_scheduler() there, once the task's context is saved, then swaps to the task it picks. This
+ *      	  way no core can resume a task another core is still switching out.
+ *      	- Interrupts are signals sent to one thread. A ticker thread sends SIGALRM to every core each
+ *      	  EOS_POSIX_TICK_US, playing the part of their Systick interrupts, and EOS_PortCoreNotify() sends SIGUSR2 to
+ *      	  one core, the reschedule interrupt. Disabling interrupts blocks these signals in the calling thread.
+ *      	- EOS_PortYield() plays the part of PendSV, as on the POSIX port.
+ *      	- The kernel lock is a spinlock, giving up the host CPU while another core holds it.
+ *
+ *      A task can be switched out by a signal handler on one core and resumed by another, so the handler finishes on
+ *      another thread. The calling core's state is therefore looked up again after every switch, through functions
+ *      the compiler cannot cache (EOS_PosixSmpCore(), EOS_PortCoreId()), and never kept in a thread local pointer.
+ */
+
+
+/*	INCLUDES	*/
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <time.h>
+#include <ucontext.h>
+#include "eos_port.h"
+#include "eos_smp.h"
+
+#if !EOS_SMP_ENABLE
+#error "port/POSIX_SMP needs EOS_SMP_ENABLE, use port/POSIX for single core builds"
+#endif
+
+
+/*	DATATYPES	*/
+
+/* TCB->sp points to one of these on this port */
+typedef struct {
+	ucontext_t context;
+	void (*function)(void);
+} EOS_posix_task_t;
+
+/* One simulated core */
+typedef struct {
+	pthread_t thread;
+	ucontext_t context;		//scheduler context, on the thread's own stack
+	volatile sig_atomic_t irq_disabled;
+	volatile sig_atomic_t in_isr;
+	volatile sig_atomic_t switch_pending;
+} EOS_posix_core_t;
+
+
+/*	LOCAL FUNCTION PROTOTYPES	*/
+static EOS_posix_core_t* EOS_PosixSmpCore(void);
+static void EOS_PosixSmpRun(void);
+static void* EOS_PosixSmpCoreThread(void* argument);
+static void* EOS_PosixSmpTicker(void* argument);
+static void EOS_PosixSmpSwitchOut(EOS_posix_core_t* core);
+static void EOS_PosixTaskEntry(void);
+static void EOS_PosixInterrupt(int signal_number);
+static void EOS_PosixIrqSignals(sigset_t* signals);
+
+
+/*	GLOBAL VARIABLES	*/
+static sigset_t posix_irq_signals;
+static volatile sig_atomic_t posix_running = 0;
+static EOS_posix_core_t posix_cores[EOS_SMP_CORES];
+static __thread uint32_t posix_core_id = 0;	//the thread calling EOS_Init() is core 0
+
+
+
+/*		PORT STARTUP		*/
+
+
+/**
+ * @brief Sets up the set of signals that act as interrupts.
+ */
+void EOS_PortInit(void){
+	EOS_PosixIrqSignals(&posix_irq_signals);
+}
+
+
+/**
+ * @brief Creates the host context of a task. The stack passed in by the kernel is not used.
+ *
+ * @return Pointer to the task's host context, stored in its TCB in place of a stack pointer, or NULL on failure.
+ */
+int32_t* EOS_PortInitStack(int32_t* task_stack, uint32_t stack_size, void* function, EOS_status_t use_fpu){
+
+	EOS_posix_task_t* volatile task = (EOS_posix_task_t*)malloc(sizeof(EOS_posix_task_t)); //volatile, getcontext() returns twice
+	void* host_stack = malloc(EOS_POSIX_STACK_SIZE);
+
+	if (task == NULL || host_stack == NULL)
+	{
+		free(task);
+		free(host_stack);
+		return NULL;
+	}
+
+	getcontext(&task->context);
+	task->context.uc_stack.ss_sp = host_stack;
+	task->context.uc_stack.ss_size = EOS_POSIX_STACK_SIZE;
+	task->context.uc_link = NULL;
+	task->function = (void (*)(void))function;
+
+	//tasks start with interrupts disabled, EOS_PosixTaskEntry() enables them
+	EOS_PosixIrqSignals(&task->context.uc_sigmask);
+
+	makecontext(&task->context, EOS_PosixTaskEntry, 0);
+
+	return (int32_t*)task;
+}
+
+
+/**
+ * @brief Installs the interrupt handlers, starts the other core threads and the ticker, and makes the calling thread
+ * 			core 0. Does not return.
+ */
+void EOS_PortStartScheduler(void){
+
+	//EOS_Init() disabled interrupts before EOS_PortInit() filled in the signal set. Block them now, so every thread
+	//starts with them blocked, as it inherits this one's mask
+	pthread_sigmask(SIG_BLOCK, &posix_irq_signals, NULL);
+
+	struct sigaction action = {0};
+	action.sa_handler = EOS_PosixInterrupt;
+	action.sa_mask = posix_irq_signals;
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGALRM, &action, NULL);
+	sigaction(SIGUSR2, &action, NULL);
+
+	posix_cores[0].thread = pthread_self();
+	posix_running = 1;
+
+	for (uintptr_t core = 1; core < EOS_SMP_CORES; core++)
+	{
+		if (pthread_create(&posix_cores[core].thread, NULL, EOS_PosixSmpCoreThread, (void*)core) != 0)
+		{
+			fprintf(stderr, "EvanRTOS: could not start core %u\n", (unsigned int)core);
+			abort();
+		}
+	}
+
+	pthread_t ticker;
+	if (pthread_create(&ticker, NULL, EOS_PosixSmpTicker, NULL) != 0)
+	{
+		fprintf(stderr, "EvanRTOS: could not start the ticker\n");
+		abort();
+	}
+
+	EOS_PosixSmpRun();
+}
+
+
+/**
+ * @brief Entry point of the threads of cores 1 and up.
+ */
+static void* EOS_PosixSmpCoreThread(void* argument){
+	posix_core_id = (uint32_t)(uintptr_t)argument;
+	EOS_PosixSmpRun();
+	return NULL;
+}
+
+
+/**
+ * @brief Sends every core its tick, every EOS_POSIX_TICK_US.
+ */
+static void* EOS_PosixSmpTicker(void* argument){
+	(void)argument;
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	while (1)
+	{
+		next.tv_nsec += EOS_POSIX_TICK_US * 1000L;
+		if (next.tv_nsec >= 1000000000L)
+		{
+			next.tv_nsec -= 1000000000L;
+			next.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+		for (uint32_t core = 0; core < EOS_SMP_CORES; core++)
+		{
+			pthread_kill(posix_cores[core].thread, SIGALRM);
+		}
+	}
+	return NULL;
+}
+
+
+
+/*		CORES		*/
+
+
+/**
+ * @brief Returns the calling core's number. Not inlined, so it is read again after every switch.
+ */
+__attribute__((noinline)) uint32_t EOS_PortCoreId(void){
+	return posix_core_id;
+}
+
+
+/**
+ * @brief Returns the calling core's state. Not inlined, so it is found again after every switch.
+ */
+__attribute__((noinline)) static EOS_posix_core_t* EOS_PosixSmpCore(void){
+	return &posix_cores[posix_core_id];
+}
+
+
+/**
+ * @brief The calling core's scheduler loop: picks a task, runs it until it switches out, and starts again. Runs with
+ * 			interrupts disabled. Does not return.
+ */
+static void EOS_PosixSmpRun(void){
+	EOS_posix_core_t* core = EOS_PosixSmpCore();
+
+	while (1)
+	{
+		core->in_isr = 0;
+		core->irq_disabled = 1;
+		core->switch_pending = 0;
+
+		EOS_scheduler();
+		swapcontext(&core->context, &((EOS_posix_task_t*)run_ptr->sp)->context);
+	}
+}
+
+
+/**
+ * @brief Takes the kernel lock, giving up the host CPU while another core holds it.
+ */
+void EOS_PortCoreLock(volatile uint32_t* lock){
+	while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) != 0)
+	{
+		sched_yield();
+	}
+}
+
+
+void EOS_PortCoreUnlock(volatile uint32_t* lock){
+	__atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Interrupts another core with SIGUSR2, so it reschedules.
+ */
+void EOS_PortCoreNotify(uint32_t core){
+	if (posix_running)
+	{
+		pthread_kill(posix_cores[core].thread, SIGUSR2);
+	}
+}
+
+
+
+/*		INTERRUPTS		*/
+
+
+/**
+ * @brief Fills in the set of signals that act as interrupts.
+ */
+static void EOS_PosixIrqSignals(sigset_t* signals){
+	sigemptyset(signals);
+	sigaddset(signals, SIGALRM);
+	sigaddset(signals, SIGUSR2);
+}
+
+
+/**
+ * @brief Disables interrupts on the calling core. The signals are blocked before the core is looked up, as until then
+ * 			a signal could switch the task out and resume it on another core.
+ */
+void EOS_PortDisableInterrupts(void){
+	pthread_sigmask(SIG_BLOCK, &posix_irq_signals, NULL);
+	EOS_posix_core_t* core = EOS_PosixSmpCore();
+
+	if (core->in_isr == 0)
+	{
+		core->irq_disabled = 1;
+	}
+}
+
+
+void EOS_PortEnableInterrupts(void){
+	EOS_posix_core_t* core = EOS_PosixSmpCore();
+
+	if (core->in_isr)
+	{
+		return;
+	}
+	core->irq_disabled = 0;
+	pthread_sigmask(SIG_UNBLOCK, &posix_irq_signals, NULL);
+
+	if (EOS_PosixSmpCore()->switch_pending) //a pending signal may have moved this task to another core
+	{
+		EOS_PortYield();
+	}
+}
+
+
+uint32_t EOS_PortMaskInterrupts(void){
+	pthread_sigmask(SIG_BLOCK, &posix_irq_signals, NULL);
+	EOS_posix_core_t* core = EOS_PosixSmpCore();
+	uint32_t state = core->irq_disabled | core->in_isr;
+
+	if (state == 0)
+	{
+		core->irq_disabled = 1;
+	}
+	return state;
+}
+
+
+void EOS_PortRestoreInterrupts(uint32_t state){
+	if (state == 0)
+	{
+		EOS_PortEnableInterrupts();
+	}
+}
+
+
+/**
+ * @brief Signal handler shared by the tick and the reschedule interrupt.
+ */
+static void EOS_PosixInterrupt(int signal_number){
+	EOS_posix_core_t* core = EOS_PosixSmpCore();
+	core->in_isr = 1;
+
+	if (signal_number == SIGALRM)
+	{
+		EOS_Tick();
+	}
+	else
+	{
+		EOS_SmpIsr();
+	}
+
+	if (core->switch_pending)
+	{
+		core->switch_pending = 0;
+		EOS_PosixSmpSwitchOut(core);
+		core = EOS_PosixSmpCore(); //possibly another core, once this task is switched back in
+	}
+
+	core->in_isr = 0;
+	core->irq_disabled = 0;
+}
+
+
+
+/*		CONTEXT SWITCHING		*/
+
+
+/**
+ * @brief Requests a context switch (the PendSV interrupt of the Cortex-M ports).
+ */
+void EOS_PortYield(void){
+	if (posix_running == 0)
+	{
+		EOS_PosixSmpCore()->switch_pending = 1;
+		return;
+	}
+
+	//block first, see EOS_PortDisableInterrupts(). The signals were already blocked if interrupts were disabled
+	pthread_sigmask(SIG_BLOCK, &posix_irq_signals, NULL);
+	EOS_posix_core_t* core = EOS_PosixSmpCore();
+
+	if (core->in_isr || core->irq_disabled)
+	{
+		core->switch_pending = 1;
+		return;
+	}
+
+	core->irq_disabled = 1;
+	core->switch_pending = 0;
+
+	EOS_PosixSmpSwitchOut(core);
+
+	core = EOS_PosixSmpCore();
+	core->in_isr = 0;
+	core->irq_disabled = 0;
+	pthread_sigmask(SIG_UNBLOCK, &posix_irq_signals, NULL);
+}
+
+
+/**
+ * @brief Saves the running task's context, and goes back to the core's scheduler loop. Returns once the task is
+ * 			switched back in, on whichever core. Must be called with interrupt signals blocked.
+ */
+static void EOS_PosixSmpSwitchOut(EOS_posix_core_t* core){
+	swapcontext(&((EOS_posix_task_t*)run_ptr->sp)->context, &core->context);
+}
+
+
+/**
+ * @brief First code run by every task. Enables interrupts and calls the task function.
+ */
+static void EOS_PosixTaskEntry(void){
+	EOS_posix_task_t* task = (EOS_posix_task_t*)run_ptr->sp;
+	EOS_posix_core_t* core = EOS_PosixSmpCore();
+
+	core->in_isr = 0;
+	core->irq_disabled = 0;
+	pthread_sigmask(SIG_UNBLOCK, &posix_irq_signals, NULL);
+
+	task->function();
+
+	fprintf(stderr, "EvanRTOS: task %u returned\n", run_ptr->id);
+	abort();
+}
+
+
+
+/*		CYCLE COUNTER		*/
+
+
+/**
+ * @brief Returns the host monotonic clock in nanoseconds, truncated to 32 bits.
+ */
+uint32_t EOS_PortGetCycles(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
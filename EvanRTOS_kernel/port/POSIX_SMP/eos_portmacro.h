@@ -0,0 +1,43 @@
+/*
+ * eos_portmacro.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Port macros for the POSIX SMP port, where pthreads play the cores. See eos_port.h and port/POSIX_SMP/eos_port.c.
+ */
+
+#ifndef INC_EOS_PORTMACRO_H_
+#define INC_EOS_PORTMACRO_H_
+
+#include <stdint.h>
+#include <unistd.h>
+
+
+/*	CONSTANTS	*/
+
+/* Host stack given to each task. The stack passed to EOS_ThreadNew() is too small for host code, and is not used */
+#ifndef EOS_POSIX_STACK_SIZE
+#define EOS_POSIX_STACK_SIZE (64 * 1024)
+#endif
+
+/* Period of the simulated Systick of every core, in microseconds */
+#ifndef EOS_POSIX_TICK_US
+#define EOS_POSIX_TICK_US 1000
+#endif
+
+
+/*	PORT MACROS	*/
+#define EOS_PORT_CYCLE_HZ 1000000000u //EOS_PortGetCycles() counts nanoseconds
+
+void EOS_PortDisableInterrupts(void);
+void EOS_PortEnableInterrupts(void);
+uint32_t EOS_PortMaskInterrupts(void);
+void EOS_PortRestoreInterrupts(uint32_t state);
+void EOS_PortYield(void);
+uint32_t EOS_PortGetCycles(void);
+uint32_t EOS_PortCoreId(void);
+
+#define EOS_PortIdle() pause()
+
+#endif /* INC_EOS_PORTMACRO_H_ */
@@ -0,0 +1,46 @@
+/*
+ * eos_port.c
+ *
+ *      EvanRTOS SIM port. There is no real context switching on this port: the simulator owns execution, and plays
+ *      the part of every task. It calls kernel functions on behalf of run_ptr, calls EOS_Tick() to advance time, and
+ *      calls EOS_scheduler() itself whenever eos_sim_switch_pending is set.
+ *
+ *      The stack passed to EOS_ThreadNew() is returned as the task's stack pointer untouched, which lets the simulator
+ *      find its own per-task state from a TCB. EOS_Init() returns on this port, instead of starting the first task.
+ */
+
+
+/*	INCLUDES	*/
+#include "eos_port.h"
+
+
+/*	GLOBAL VARIABLES	*/
+volatile uint8_t eos_sim_switch_pending = 0;
+
+
+
+/*		PORT FUNCTIONS		*/
+
+
+void EOS_PortInit(void){
+	eos_sim_switch_pending = 0;
+}
+
+
+int32_t* EOS_PortInitStack(int32_t* task_stack, uint32_t stack_size, void* function, EOS_status_t use_fpu){
+	return task_stack;
+}
+
+
+void EOS_PortStartScheduler(void){
+
+}
+
+
+#if EOS_PORT_CYCLE_HZ != 0
+uint32_t EOS_PortGetCycles(void){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+#endif
@@ -0,0 +1,36 @@
+/*
+ * eos_portmacro.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Port macros for the SIM port, used by the scheduler scaling simulator (EvanRTOS_host/eos_sim.c). See
+ *      port/SIM/eos_port.c.
+ */
+
+#ifndef INC_EOS_PORTMACRO_H_
+#define INC_EOS_PORTMACRO_H_
+
+#include <stdint.h>
+#include <time.h>
+
+
+/*	PORT MACROS	*/
+#if defined(__x86_64__) || defined(__i386__)
+#define EOS_PORT_CYCLE_HZ 0 //time stamp counter, frequency unknown
+#define EOS_PortGetCycles() ((uint32_t)__builtin_ia32_rdtsc())
+#else
+#define EOS_PORT_CYCLE_HZ 1000000000u
+uint32_t EOS_PortGetCycles(void);
+#endif
+
+extern volatile uint8_t eos_sim_switch_pending;
+
+#define EOS_PortDisableInterrupts()
+#define EOS_PortEnableInterrupts()
+#define EOS_PortMaskInterrupts() 0
+#define EOS_PortRestoreInterrupts(state) ((void)(state))
+#define EOS_PortYield() (eos_sim_switch_pending = 1)
+#define EOS_PortIdle()
+
+#endif /* INC_EOS_PORTMACRO_H_ */
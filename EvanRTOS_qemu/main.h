@@ -0,0 +1,47 @@
+/*
+ * main.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Board support for running EvanRTOS on QEMU's mps2-an500 machine (Cortex-M7), with the unchanged ARM_CM7 port.
+ *      The port includes this file in place of the STM32 demo's main.h, so it provides CMSIS, the tick hook the port's
+ *      SysTick handler calls (HAL_IncTick()), and the cycle counter: QEMU has no DWT cycle counter, so the second
+ *      timer of the CMSDK dual timer counts down from 0xFFFFFFFF at the system clock instead.
+ */
+
+#ifndef INC_MAIN_H_
+#define INC_MAIN_H_
+
+#include "mps2_an500.h"
+
+
+/*	CYCLE COUNTER	*/
+#define EOS_PortGetCycles() (~CMSDK_DUALTIMER2->VALUE)
+#define EOS_PORT_CYCLE_HZ MPS2_SYSCLK_HZ
+
+
+/*	SPARE INTERRUPTS	*/
+
+/* GPIO0 pin interrupts, which QEMU never raises, pended with NVIC_SetPendingIRQ() by the benchmarks */
+#define EOS_BSP_SOFT0_IRQn GPIO0_6_IRQn
+#define EOS_BSP_SOFT0_IRQHandler GPIO0_6_IRQHandler
+#define EOS_BSP_SOFT1_IRQn GPIO0_7_IRQn
+#define EOS_BSP_SOFT1_IRQHandler GPIO0_7_IRQHandler
+
+/* Priority of the interrupts above the kernel's (PendSV is the lowest, SysTick the second lowest) */
+#define EOS_BSP_IRQ_PRIORITY 4
+
+
+/*	FUNCTION DECLARATIONS	*/
+extern uint32_t SystemCoreClock;
+
+void SystemInit(void);
+void EOS_BspInit(void);
+void EOS_BspUartWrite(CMSDK_UART_TypeDef* uart, const void* data, uint32_t length);
+void EOS_BspExit(int status);
+
+void HAL_IncTick(void);
+uint32_t HAL_GetTick(void);
+
+#endif /* INC_MAIN_H_ */
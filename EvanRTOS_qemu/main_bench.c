@@ -0,0 +1,37 @@
+/*
+ * main_bench.c
+ *
+ *      QEMU entry point for the EvanRTOS microbenchmarks. The isr_wakeup benchmark pends a spare interrupt
+ *      (EOS_BSP_SOFT0_IRQn). Cycle counts on this board are ticks of the 25 MHz system clock, in QEMU's virtual time.
+ */
+
+
+/*	INCLUDES	*/
+#include "main.h"
+#include "eos_bench.h"
+
+
+uint8_t EOS_BenchTriggerIsr(void){
+	NVIC_SetPendingIRQ(EOS_BSP_SOFT0_IRQn);
+	return 1;
+}
+
+
+void EOS_BSP_SOFT0_IRQHandler(void){
+	EOS_BenchIsr();
+}
+
+
+void EOS_BenchComplete(void){
+	EOS_BspExit(0);
+}
+
+
+int main(void){
+	EOS_BspInit();
+	NVIC_SetPriority(EOS_BSP_SOFT0_IRQn, EOS_BSP_IRQ_PRIORITY);
+	NVIC_EnableIRQ(EOS_BSP_SOFT0_IRQn);
+
+	EOS_BenchInit(); //does not return
+	return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * main_demo.c
+ *
+ *      QEMU entry point for the EvanRTOS demo. Runs the unchanged demo application (EvanRTOS_demo/CM7/Core/Src/eos.c)
+ *      on the mps2-an500 board for EOS_QEMU_DEMO_SECONDS of virtual time (default 5, set with DEMO_SECONDS in the
+ *      Makefile), then prints the demo's global counters and ends the run. The run is timed by CMSDK TIMER1. When
+ *      built with EOS_CRITICAL_PROFILE_ENABLE, EOS_WAIT_PROFILE_ENABLE, EOS_CONTENTION_PROFILE_ENABLE or
+ *      EOS_INVERSION_DETECT_ENABLE, their reports are printed as well. When built with EOS_MONITOR_ENABLE, the monitor
+ *      task's CSV goes to the console, and when built with EOS_LOG_ENABLE, the log stream goes to UART1 (eos_log.bin,
+ *      see tools/eos_log_decode.py).
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "main.h"
+#include "eos_kernel.h"
+#include "eos_critical.h"
+#include "eos_wait.h"
+#include "eos_contention.h"
+#include "eos_inversion.h"
+#include "eos_monitor.h"
+#include "eos_log.h"
+
+
+#ifndef EOS_QEMU_DEMO_SECONDS
+#define EOS_QEMU_DEMO_SECONDS 5
+#endif
+
+
+/*	DEMO VARIABLES	(eos.c)	*/
+void EvanRTOS_Init();
+
+extern uint32_t t0count;
+extern double t1count;
+extern uint32_t t2count;
+extern uint32_t t3count;
+extern uint32_t t4count;
+extern uint32_t t5_queue_item;
+
+
+#if EOS_MONITOR_ENABLE
+/**
+ * @brief Plays the part of USART1 for the monitor task.
+ */
+void EOS_MonitorWrite(const char* data, uint32_t length){
+	EOS_BspUartWrite(CMSDK_UART0, data, length);
+}
+#endif
+
+
+#if EOS_LOG_ENABLE
+/**
+ * @brief Plays the part of USART1 for the log drain task.
+ */
+void EOS_LogOutput(const uint8_t* data, uint32_t length){
+	EOS_BspUartWrite(CMSDK_UART1, data, length);
+}
+#endif
+
+
+/**
+ * @brief Stops the demo once EOS_QEMU_DEMO_SECONDS have passed.
+ */
+void TIMER1_IRQHandler(void){
+
+	EOS_PortDisableInterrupts();
+	CMSDK_TIMER1->INTSTATUS = 1;
+
+	printf("t0count=%u t1count=%f t2count=%u t3count=%u t4count=%u t5_queue_item=%u\n",
+			(unsigned int)t0count, t1count, (unsigned int)t2count, (unsigned int)t3count, (unsigned int)t4count,
+			(unsigned int)t5_queue_item);
+
+#if EOS_CRITICAL_PROFILE_ENABLE
+	EOS_CriticalProfileReport();
+#endif
+
+#if EOS_WAIT_PROFILE_ENABLE
+	EOS_WaitProfileReport();
+#endif
+
+#if EOS_CONTENTION_PROFILE_ENABLE
+	EOS_ContentionReport();
+#endif
+
+#if EOS_INVERSION_DETECT_ENABLE
+	EOS_InversionReport();
+#endif
+
+#if EOS_LOG_ENABLE
+	const EOS_log_stats_t* log_stats = EOS_LogStats();
+	printf("{\"log\":\"summary\",\"written\":%u,\"dropped\":%u,\"high_water\":%u,\"buffer\":%u}\n",
+			(unsigned int)log_stats->written, (unsigned int)log_stats->dropped, (unsigned int)log_stats->high_water,
+			(unsigned int)EOS_LOG_BUFFER_WORDS);
+#endif
+
+	EOS_BspExit(0);
+}
+
+
+int main(void){
+
+	EOS_BspInit();
+
+	CMSDK_TIMER1->RELOAD = EOS_QEMU_DEMO_SECONDS * MPS2_SYSCLK_HZ;
+	CMSDK_TIMER1->VALUE = EOS_QEMU_DEMO_SECONDS * MPS2_SYSCLK_HZ;
+	CMSDK_TIMER1->CTRL = CMSDK_TIMER_CTRL_EN | CMSDK_TIMER_CTRL_IRQEN;
+	NVIC_SetPriority(TIMER1_IRQn, EOS_BSP_IRQ_PRIORITY);
+	NVIC_EnableIRQ(TIMER1_IRQn);
+
+	EvanRTOS_Init(); //does not return
+	return 0;
+}
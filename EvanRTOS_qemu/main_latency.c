@@ -0,0 +1,73 @@
+/*
+ * main_latency.c
+ *
+ *      QEMU entry point for the EvanRTOS latency test (EvanRTOS_bench/eos_latency.c). The test runs for
+ *      EOS_QEMU_LATENCY_SECONDS of virtual time under EOS_QEMU_LATENCY_LOAD (set with LATENCY_SECONDS and LATENCY_LOAD
+ *      in the Makefile). The test timer is CMSDK TIMER0, and the cycles since it expired are read from its counter.
+ *      The interrupt flood pends a spare interrupt (EOS_BSP_SOFT1_IRQn). Cycle counts on this board are ticks of the
+ *      25 MHz system clock, in QEMU's virtual time.
+ */
+
+
+/*	INCLUDES	*/
+#include "main.h"
+#include "eos_latency.h"
+
+
+#ifndef EOS_QEMU_LATENCY_SECONDS
+#define EOS_QEMU_LATENCY_SECONDS 10
+#endif
+
+#ifndef EOS_QEMU_LATENCY_LOAD
+#define EOS_QEMU_LATENCY_LOAD EOS_LATENCY_LOAD_ALL
+#endif
+
+
+uint8_t EOS_LatencyTimerStart(uint32_t period_us){
+
+	CMSDK_TIMER0->CTRL = 0;
+	CMSDK_TIMER0->RELOAD = period_us * (MPS2_SYSCLK_HZ / 1000000u) - 1u;
+	CMSDK_TIMER0->VALUE = CMSDK_TIMER0->RELOAD;
+	CMSDK_TIMER0->INTSTATUS = 1;
+	NVIC_SetPriority(TIMER0_IRQn, EOS_BSP_IRQ_PRIORITY);
+	NVIC_EnableIRQ(TIMER0_IRQn);
+	CMSDK_TIMER0->CTRL = CMSDK_TIMER_CTRL_EN | CMSDK_TIMER_CTRL_IRQEN;
+	return 1;
+}
+
+
+/**
+ * @brief The timer counts down from RELOAD, starting again as it expires, so RELOAD - VALUE is the time since then.
+ */
+void TIMER0_IRQHandler(void){
+	uint32_t elapsed = CMSDK_TIMER0->RELOAD - CMSDK_TIMER0->VALUE;
+
+	CMSDK_TIMER0->INTSTATUS = 1;
+	EOS_LatencyIsr(elapsed);
+}
+
+
+uint8_t EOS_LatencyTriggerFlood(void){
+	NVIC_SetPendingIRQ(EOS_BSP_SOFT1_IRQn);
+	return 1;
+}
+
+
+void EOS_BSP_SOFT1_IRQHandler(void){
+	EOS_LatencyFloodIsr();
+}
+
+
+void EOS_LatencyComplete(void){
+	EOS_BspExit(0);
+}
+
+
+int main(void){
+	EOS_BspInit();
+	NVIC_SetPriority(EOS_BSP_SOFT1_IRQn, EOS_BSP_IRQ_PRIORITY);
+	NVIC_EnableIRQ(EOS_BSP_SOFT1_IRQn);
+
+	EOS_LatencyInit(EOS_QEMU_LATENCY_SECONDS, EOS_QEMU_LATENCY_LOAD); //does not return
+	return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * mps2_an500.c
+ *
+ *      Board support for running EvanRTOS on QEMU's mps2-an500 machine. Sets up what the STM32 demo gets from HAL and
+ *      CubeMX: the FPU, the 1 ms SysTick and the PendSV/SysTick priorities the ARM_CM7 port needs, the console on
+ *      CMSDK UART0 (printf() goes there through the demo's syscalls.c), and the free running cycle counter on the
+ *      second half of the CMSDK dual timer. UART1 is left for binary streams, such as the EOS_LOG() stream.
+ *
+ *      A run ends with EOS_BspExit(), which asks QEMU to quit through semihosting (-semihosting-config enable=on)
+ *      with the given exit status. A stack overflow, a fault, or an interrupt without a handler ends the run with
+ *      status 1, so a test run fails instead of hanging.
+ */
+
+
+/*	INCLUDES	*/
+#include <stdio.h>
+#include "main.h"
+#include "eos_kernel.h"
+#include "eos_port.h"
+
+#if EOS_PROFILE_ENABLE
+#error "the sampling profiler (EOS_PROFILE_ENABLE) needs an STM32 timer, and is not supported on the QEMU board"
+#endif
+
+
+/*	DEFINES	*/
+#define EOS_BSP_BAUD 115200u
+
+/* Semihosting SYS_EXIT, and the reasons QEMU turns into exit status 0 and 1 */
+#define EOS_BSP_SYS_EXIT 0x18u
+#define EOS_BSP_EXIT_SUCCESS 0x20026u		//ADP_Stopped_ApplicationExit
+#define EOS_BSP_EXIT_FAILURE 0x20023u		//ADP_Stopped_RunTimeErrorUnknown
+
+
+/*	GLOBAL VARIABLES	*/
+uint32_t SystemCoreClock = MPS2_SYSCLK_HZ;
+static volatile uint32_t bsp_tick = 0;
+
+
+
+/*	BOARD SETUP	*/
+
+
+/**
+ * @brief Called by Reset_Handler before the C runtime is set up. Gives the core full access to the FPU.
+ */
+void SystemInit(void)
+{
+	SCB->CPACR |= (3u << 20) | (3u << 22); //CP10 and CP11
+	__DSB();
+	__ISB();
+}
+
+
+/**
+ * @brief Starts the console UARTs, the cycle counter and the 1 ms SysTick, and sets the interrupt priorities EvanRTOS
+ * 			expects: PendSV lowest, SysTick second lowest. Call at the start of main(), before EvanRTOS_Init().
+ */
+void EOS_BspInit(void)
+{
+	CMSDK_UART0->BAUDDIV = MPS2_SYSCLK_HZ / EOS_BSP_BAUD;
+	CMSDK_UART0->CTRL = CMSDK_UART_CTRL_TXEN | CMSDK_UART_CTRL_RXEN;
+	CMSDK_UART1->BAUDDIV = MPS2_SYSCLK_HZ / EOS_BSP_BAUD;
+	CMSDK_UART1->CTRL = CMSDK_UART_CTRL_TXEN;
+
+	CMSDK_DUALTIMER2->CTRL = 0;
+	CMSDK_DUALTIMER2->LOAD = 0xFFFFFFFFu;
+	CMSDK_DUALTIMER2->CTRL = CMSDK_DUALTIMER_CTRL_SIZE32 | CMSDK_DUALTIMER_CTRL_EN; //free running, no interrupt
+
+	SysTick_Config(SystemCoreClock / 1000u);
+	NVIC_SetPriority(PendSV_IRQn, (1u << __NVIC_PRIO_BITS) - 1u);
+	NVIC_SetPriority(SysTick_IRQn, (1u << __NVIC_PRIO_BITS) - 2u);
+}
+
+
+/**
+ * @brief Counts milliseconds, called by the port's SysTick handler.
+ */
+void HAL_IncTick(void)
+{
+	bsp_tick++;
+}
+
+
+/**
+ * @brief Returns the milliseconds since EOS_BspInit().
+ */
+uint32_t HAL_GetTick(void)
+{
+	return bsp_tick;
+}
+
+
+
+/*	CONSOLE	*/
+
+
+/**
+ * @brief Writes to a CMSDK UART, waiting for room in its transmit buffer.
+ */
+void EOS_BspUartWrite(CMSDK_UART_TypeDef* uart, const void* data, uint32_t length)
+{
+	const uint8_t* bytes = data;
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		while (uart->STATE & CMSDK_UART_STATE_TXFULL)
+		{
+		}
+		uart->DATA = bytes[i];
+	}
+}
+
+
+/**
+ * @brief Output of printf(), through _write() in syscalls.c.
+ */
+int __io_putchar(int ch)
+{
+	uint8_t byte = (uint8_t)ch;
+
+	EOS_BspUartWrite(CMSDK_UART0, &byte, 1);
+	return ch;
+}
+
+
+/**
+ * @brief Input of scanf() and getchar(), through _read() in syscalls.c. Waits for a byte on UART0.
+ */
+int __io_getchar(void)
+{
+	while (!(CMSDK_UART0->STATE & CMSDK_UART_STATE_RXFULL))
+	{
+	}
+	return (int)(CMSDK_UART0->DATA & 0xFF);
+}
+
+
+
+/*	ENDING A RUN	*/
+
+
+/**
+ * @brief Ends the QEMU run. QEMU exits with status 0 if status is 0, and 1 otherwise.
+ */
+void EOS_BspExit(int status)
+{
+	fflush(stdout);
+
+	register uint32_t operation __asm("r0") = EOS_BSP_SYS_EXIT;
+	register uint32_t reason __asm("r1") = (status == 0) ? EOS_BSP_EXIT_SUCCESS : EOS_BSP_EXIT_FAILURE;
+	__asm volatile("BKPT 0xAB" : : "r"(operation), "r"(reason) : "memory");
+
+	while (1) //semihosting is off
+	{
+	}
+}
+
+
+/**
+ * @brief Reports the task that overflowed its stack, and ends the run with a failure.
+ */
+void EOS_StackOverflow(EOS_task_id_t task)
+{
+	EOS_PortDisableInterrupts();
+	printf("stack overflow in task %u\n", (unsigned int)task->id);
+	EOS_BspExit(1);
+}
+
+
+#if EOS_MPU_GUARD_ENABLE
+/**
+ * @brief Reports the running task hitting its MPU stack guard as an overflow, and any other memory fault as such.
+ */
+void MemManage_Handler(void)
+{
+	if (EOS_PortMpuGuardFault())
+	{
+		EOS_StackOverflow(run_ptr);
+	}
+	printf("memory fault\n");
+	EOS_BspExit(1);
+}
+
+
+/**
+ * @brief Reports a guard hit with PRIMASK set, which escalates to a HardFault, as an overflow, and any other HardFault
+ * 			as such.
+ */
+void HardFault_Handler(void)
+{
+	if (EOS_PortMpuGuardFault())
+	{
+		EOS_StackOverflow(run_ptr);
+	}
+	printf("hard fault\n");
+	EOS_BspExit(1);
+}
+#endif
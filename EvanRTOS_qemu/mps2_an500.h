@@ -0,0 +1,136 @@
+/*
+ * mps2_an500.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: EO12
+ *
+ *      Device header for the ARM MPS2 AN500 FPGA image (Cortex-M7 with CMSDK peripherals), as emulated by QEMU's
+ *      mps2-an500 machine: the interrupt numbers, the CMSIS core configuration, and the few CMSDK peripherals the
+ *      board support package uses. Only what QEMU implements is described here.
+ */
+
+#ifndef INC_MPS2_AN500_H_
+#define INC_MPS2_AN500_H_
+
+#include <stdint.h>
+
+
+/*	INTERRUPT NUMBERS	*/
+typedef enum {
+	NonMaskableInt_IRQn		= -14,
+	HardFault_IRQn			= -13,
+	MemoryManagement_IRQn	= -12,
+	BusFault_IRQn			= -11,
+	UsageFault_IRQn			= -10,
+	SVCall_IRQn				= -5,
+	DebugMonitor_IRQn		= -4,
+	PendSV_IRQn				= -2,
+	SysTick_IRQn			= -1,
+
+	UART0RX_IRQn			= 0,
+	UART0TX_IRQn			= 1,
+	UART1RX_IRQn			= 2,
+	UART1TX_IRQn			= 3,
+	UART2RX_IRQn			= 4,
+	UART2TX_IRQn			= 5,
+	GPIO0ALL_IRQn			= 6,
+	GPIO1ALL_IRQn			= 7,
+	TIMER0_IRQn				= 8,
+	TIMER1_IRQn				= 9,
+	DUALTIMER_IRQn			= 10,
+	SPI_0_1_IRQn			= 11,
+	UART_0_1_2_OVF_IRQn		= 12,
+	ETHERNET_IRQn			= 13,
+	I2S_IRQn				= 14,
+	TSC_IRQn				= 15,
+	GPIO2_IRQn				= 16,
+	GPIO3_IRQn				= 17,
+	UART3RX_IRQn			= 18,
+	UART3TX_IRQn			= 19,
+	UART4RX_IRQn			= 20,
+	UART4TX_IRQn			= 21,
+	SPI_2_IRQn				= 22,
+	SPI_3_4_IRQn			= 23,
+	GPIO0_0_IRQn			= 24,
+	GPIO0_1_IRQn			= 25,
+	GPIO0_2_IRQn			= 26,
+	GPIO0_3_IRQn			= 27,
+	GPIO0_4_IRQn			= 28,
+	GPIO0_5_IRQn			= 29,
+	GPIO0_6_IRQn			= 30,
+	GPIO0_7_IRQn			= 31,
+} IRQn_Type;
+
+#define MPS2_IRQ_COUNT 32
+
+
+/*	CORE CONFIGURATION	*/
+#define __CM7_REV				0x0001U		//r0p1
+#define __MPU_PRESENT			1U
+#define __NVIC_PRIO_BITS		3U
+#define __Vendor_SysTickConfig	0U
+#define __FPU_PRESENT			1U
+#define __FPU_DP				1U			//QEMU's Cortex-M7 has the double precision FPv5
+#define __ICACHE_PRESENT		0U			//QEMU does not model the caches
+#define __DCACHE_PRESENT		0U
+#define __DTCM_PRESENT			0U
+
+#include "core_cm7.h"
+
+
+/*	PERIPHERALS	*/
+
+/* CMSDK APB UART */
+typedef struct {
+	volatile uint32_t DATA;
+	volatile uint32_t STATE;
+	volatile uint32_t CTRL;
+	volatile uint32_t INTSTATUS;			//write 1 to clear
+	volatile uint32_t BAUDDIV;				//at least 16
+} CMSDK_UART_TypeDef;
+
+#define CMSDK_UART_STATE_TXFULL		(1u << 0)
+#define CMSDK_UART_STATE_RXFULL		(1u << 1)
+#define CMSDK_UART_CTRL_TXEN		(1u << 0)
+#define CMSDK_UART_CTRL_RXEN		(1u << 1)
+
+/* CMSDK APB timer, counts down from RELOAD to 0 and interrupts when it reloads */
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t VALUE;
+	volatile uint32_t RELOAD;
+	volatile uint32_t INTSTATUS;			//write 1 to clear
+} CMSDK_TIMER_TypeDef;
+
+#define CMSDK_TIMER_CTRL_EN			(1u << 0)
+#define CMSDK_TIMER_CTRL_IRQEN		(1u << 3)
+
+/* One half of the CMSDK APB dual timer (an SP804) */
+typedef struct {
+	volatile uint32_t LOAD;
+	volatile uint32_t VALUE;
+	volatile uint32_t CTRL;
+	volatile uint32_t INTCLR;
+	volatile uint32_t RIS;
+	volatile uint32_t MIS;
+	volatile uint32_t BGLOAD;
+	uint32_t reserved;
+} CMSDK_DUALTIMER_TypeDef;
+
+#define CMSDK_DUALTIMER_CTRL_SIZE32	(1u << 1)
+#define CMSDK_DUALTIMER_CTRL_INTEN	(1u << 5)
+#define CMSDK_DUALTIMER_CTRL_PERIODIC	(1u << 6)
+#define CMSDK_DUALTIMER_CTRL_EN		(1u << 7)
+
+#define CMSDK_TIMER0		((CMSDK_TIMER_TypeDef*)0x40000000u)
+#define CMSDK_TIMER1		((CMSDK_TIMER_TypeDef*)0x40001000u)
+#define CMSDK_DUALTIMER1	((CMSDK_DUALTIMER_TypeDef*)0x40002000u)
+#define CMSDK_DUALTIMER2	((CMSDK_DUALTIMER_TypeDef*)0x40002020u)
+#define CMSDK_UART0			((CMSDK_UART_TypeDef*)0x40004000u)
+#define CMSDK_UART1			((CMSDK_UART_TypeDef*)0x40005000u)
+#define CMSDK_UART2			((CMSDK_UART_TypeDef*)0x40006000u)
+
+/* The FPGA's system clock, which clocks the core, SysTick, and the APB peripherals */
+#define MPS2_SYSCLK_HZ 25000000u
+
+#endif /* INC_MPS2_AN500_H_ */
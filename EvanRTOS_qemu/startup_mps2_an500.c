@@ -0,0 +1,176 @@
+/*
+ * startup_mps2_an500.c
+ *
+ *      Vector table and reset handler for the mps2-an500 board. QEMU loads the image at address 0, takes the initial
+ *      stack pointer and reset handler from the vector table there, and starts executing.
+ *
+ *      Every handler is a weak alias of Default_Handler, which reports the exception and ends the run, so an image
+ *      only defines the handlers it uses. PendSV_Handler and SysTick_Handler come from the ARM_CM7 port.
+ */
+
+
+/*	INCLUDES	*/
+#include "main.h"
+
+
+/*	LINKER SYMBOLS	*/
+extern uint32_t _sidata;
+extern uint32_t _sdata;
+extern uint32_t _edata;
+extern uint32_t _sbss;
+extern uint32_t _ebss;
+extern uint32_t _estack;
+
+
+/*	FUNCTION PROTOTYPES	*/
+int main(void);
+void __libc_init_array(void);
+void Reset_Handler(void);
+void Default_Handler(void);
+
+#define EOS_BSP_HANDLER(name) void name(void) __attribute__((weak, alias("Default_Handler")))
+
+EOS_BSP_HANDLER(NMI_Handler);
+EOS_BSP_HANDLER(HardFault_Handler);
+EOS_BSP_HANDLER(MemManage_Handler);
+EOS_BSP_HANDLER(BusFault_Handler);
+EOS_BSP_HANDLER(UsageFault_Handler);
+EOS_BSP_HANDLER(SVC_Handler);
+EOS_BSP_HANDLER(DebugMon_Handler);
+EOS_BSP_HANDLER(PendSV_Handler);
+EOS_BSP_HANDLER(SysTick_Handler);
+
+EOS_BSP_HANDLER(UART0RX_IRQHandler);
+EOS_BSP_HANDLER(UART0TX_IRQHandler);
+EOS_BSP_HANDLER(UART1RX_IRQHandler);
+EOS_BSP_HANDLER(UART1TX_IRQHandler);
+EOS_BSP_HANDLER(UART2RX_IRQHandler);
+EOS_BSP_HANDLER(UART2TX_IRQHandler);
+EOS_BSP_HANDLER(GPIO0ALL_IRQHandler);
+EOS_BSP_HANDLER(GPIO1ALL_IRQHandler);
+EOS_BSP_HANDLER(TIMER0_IRQHandler);
+EOS_BSP_HANDLER(TIMER1_IRQHandler);
+EOS_BSP_HANDLER(DUALTIMER_IRQHandler);
+EOS_BSP_HANDLER(SPI_0_1_IRQHandler);
+EOS_BSP_HANDLER(UART_0_1_2_OVF_IRQHandler);
+EOS_BSP_HANDLER(ETHERNET_IRQHandler);
+EOS_BSP_HANDLER(I2S_IRQHandler);
+EOS_BSP_HANDLER(TSC_IRQHandler);
+EOS_BSP_HANDLER(GPIO2_IRQHandler);
+EOS_BSP_HANDLER(GPIO3_IRQHandler);
+EOS_BSP_HANDLER(UART3RX_IRQHandler);
+EOS_BSP_HANDLER(UART3TX_IRQHandler);
+EOS_BSP_HANDLER(UART4RX_IRQHandler);
+EOS_BSP_HANDLER(UART4TX_IRQHandler);
+EOS_BSP_HANDLER(SPI_2_IRQHandler);
+EOS_BSP_HANDLER(SPI_3_4_IRQHandler);
+EOS_BSP_HANDLER(GPIO0_0_IRQHandler);
+EOS_BSP_HANDLER(GPIO0_1_IRQHandler);
+EOS_BSP_HANDLER(GPIO0_2_IRQHandler);
+EOS_BSP_HANDLER(GPIO0_3_IRQHandler);
+EOS_BSP_HANDLER(GPIO0_4_IRQHandler);
+EOS_BSP_HANDLER(GPIO0_5_IRQHandler);
+EOS_BSP_HANDLER(GPIO0_6_IRQHandler);
+EOS_BSP_HANDLER(GPIO0_7_IRQHandler);
+
+
+/*	VECTOR TABLE	*/
+__attribute__((section(".isr_vector"), used)) void (* const eos_vectors[16 + MPS2_IRQ_COUNT])(void) = {
+	(void (*)(void))&_estack,
+	Reset_Handler,
+	NMI_Handler,
+	HardFault_Handler,
+	MemManage_Handler,
+	BusFault_Handler,
+	UsageFault_Handler,
+	0,
+	0,
+	0,
+	0,
+	SVC_Handler,
+	DebugMon_Handler,
+	0,
+	PendSV_Handler,
+	SysTick_Handler,
+
+	UART0RX_IRQHandler,
+	UART0TX_IRQHandler,
+	UART1RX_IRQHandler,
+	UART1TX_IRQHandler,
+	UART2RX_IRQHandler,
+	UART2TX_IRQHandler,
+	GPIO0ALL_IRQHandler,
+	GPIO1ALL_IRQHandler,
+	TIMER0_IRQHandler,
+	TIMER1_IRQHandler,
+	DUALTIMER_IRQHandler,
+	SPI_0_1_IRQHandler,
+	UART_0_1_2_OVF_IRQHandler,
+	ETHERNET_IRQHandler,
+	I2S_IRQHandler,
+	TSC_IRQHandler,
+	GPIO2_IRQHandler,
+	GPIO3_IRQHandler,
+	UART3RX_IRQHandler,
+	UART3TX_IRQHandler,
+	UART4RX_IRQHandler,
+	UART4TX_IRQHandler,
+	SPI_2_IRQHandler,
+	SPI_3_4_IRQHandler,
+	GPIO0_0_IRQHandler,
+	GPIO0_1_IRQHandler,
+	GPIO0_2_IRQHandler,
+	GPIO0_3_IRQHandler,
+	GPIO0_4_IRQHandler,
+	GPIO0_5_IRQHandler,
+	GPIO0_6_IRQHandler,
+	GPIO0_7_IRQHandler,
+};
+
+
+
+/*	RESET	*/
+
+
+/**
+ * @brief Enables the FPU, copies the initialized data out of the image, clears the bss, runs the C library
+ * 			constructors, and calls main().
+ */
+void Reset_Handler(void)
+{
+	SystemInit();
+
+	uint32_t* source = &_sidata;
+	for (uint32_t* destination = &_sdata; destination < &_edata; destination++)
+	{
+		*destination = *source++;
+	}
+	for (uint32_t* destination = &_sbss; destination < &_ebss; destination++)
+	{
+		*destination = 0;
+	}
+
+	__libc_init_array();
+	main();
+
+	EOS_BspExit(0);
+}
+
+
+/**
+ * @brief Handler of every exception and interrupt the image does not handle itself. Reports which one it was, and
+ * 			ends the run with a failure.
+ */
+void Default_Handler(void)
+{
+	static const char hex[] = "0123456789abcdef";
+	char message[] = "unhandled exception 0x000\n";
+	uint32_t number = __get_IPSR();
+
+	message[22] = hex[(number >> 8) & 0xF];
+	message[23] = hex[(number >> 4) & 0xF];
+	message[24] = hex[number & 0xF];
+	EOS_BspUartWrite(CMSDK_UART0, message, sizeof(message) - 1);
+
+	EOS_BspExit(1);
+}
@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+"""
+eos_log_decode.py
+
+Decodes the EvanRTOS deferred formatting log (see eos_log.c). The target only sends the offset of each message's format
+string in the eos_log section, a timestamp, and the raw arguments. This script reads the format strings (and the
+constant strings passed to %s) back from the ELF file the target runs, and prints the formatted messages:
+
+    [    2.000135] task2: put 4 in queue1, t2count=2
+
+Usage:
+    eos_log_decode.py firmware.elf [eos_log.bin | /dev/ttyACM0 | -] [--baud 115200] [--hz 480000000]
+
+The input defaults to stdin. Reading a serial device needs pyserial. The timestamp rate is taken from the stream header
+the drain task sends when it starts, --hz gives it when the stream was joined later (in which case the build is also
+assumed not to be position independent).
+
+Supported conversions are d i u o x X c s p e E f F g G and %%, with any flags, width and precision. Length modifiers
+are ignored, every argument is one 32 bit word.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_MAGIC = 0x4C534F45
+LOG_VERSION = 1
+LOG_SYNC = 0xE0
+LOG_ID_DROPPED = 0xFFFF
+LOG_MAX_ARGS = 8
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+CONVERSION = re.compile(r"%([-+ #0]*)(\d+)?(?:\.(\d+))?(?:hh|h|ll|l|j|z|t|L)?([diouxXcspeEfFgG%])")
+
+
+class Elf:
+    """The allocated sections of an ELF file, enough to read strings at their link addresses."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            sys.exit("%s is not an ELF file" % path)
+        if data[5] != 1:
+            sys.exit("%s is big endian, only little endian targets are supported" % path)
+
+        if data[4] == 1:
+            shoff, = struct.unpack_from("<I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+            section = struct.Struct("<IIIIIIIIII")
+        else:
+            shoff, = struct.unpack_from("<Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+            section = struct.Struct("<IIQQQQIIQQ")
+
+        headers = [section.unpack_from(data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx]
+        self.sections = {}
+        for name, kind, flags, addr, offset, size in (h[:6] for h in headers):
+            end = data.index(b"\0", names[4] + name)
+            name = data[names[4] + name:end].decode("ascii", "replace")
+            if flags & SHF_ALLOC and kind != SHT_NOBITS:
+                self.sections[name] = (addr, data[offset:offset + size])
+
+        if "eos_log" not in self.sections:
+            sys.exit("%s has no eos_log section, was it built with EOS_LOG_ENABLE?" % path)
+        self.log_addr, self.log_data = self.sections["eos_log"]
+
+    def string_at(self, addr):
+        for base, data in self.sections.values():
+            if base <= addr < base + len(data):
+                start = addr - base
+                end = data.find(b"\0", start)
+                return data[start:end if end >= 0 else len(data)].decode("utf-8", "replace")
+        return None
+
+    def format_at(self, offset):
+        """The format string with the given offset in eos_log, or None if no string starts there."""
+        if offset >= len(self.log_data) or (offset > 0 and self.log_data[offset - 1] != 0):
+            return None
+        return self.string_at(self.log_addr + offset)
+
+
+def signed(word):
+    return word - (1 << 32) if word & 0x80000000 else word
+
+
+def format_message(elf, relocation, fmt, args):
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, kind = match.groups()
+        if kind == "%":
+            return "%"
+        if not args:
+            return "<missing>"
+        word = args.pop(0)
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+
+        if kind in "di":
+            return (spec + "d") % signed(word)
+        if kind in "uoxX":
+            return (spec + kind.replace("u", "d")) % word
+        if kind == "c":
+            return (spec + "c") % chr(word & 0xFF)
+        if kind == "p":
+            return (spec + "s") % ("0x%08x" % word)
+        if kind == "s":
+            text = elf.string_at((word + relocation) & 0xFFFFFFFF)
+            return (spec + "s") % (text if text is not None else "<0x%08x>" % word)
+        return (spec + kind) % struct.unpack("<f", struct.pack("<I", word))[0]
+
+    return CONVERSION.sub(convert, fmt)
+
+
+class Decoder:
+    def __init__(self, elf, hz):
+        self.elf = elf
+        self.hz = hz
+        self.relocation = 0
+        self.time = None
+        self.last = 0
+        self.buffer = bytearray()
+        self.skipped = 0
+
+    def timestamp(self, cycles):
+        if self.time is None:
+            self.time = 0
+        else:
+            self.time += signed((cycles - self.last) & 0xFFFFFFFF)
+        self.last = cycles
+        if self.hz:
+            return "%12.6f" % (self.time / self.hz)
+        return "%12d" % self.time
+
+    def feed(self, data):
+        """Adds bytes from the stream, and returns the lines of every message now complete."""
+        self.buffer += data
+        buf = self.buffer
+        lines = []
+        i = 0
+
+        while len(buf) - i >= 4:
+            first, = struct.unpack_from("<I", buf, i)
+
+            if first == LOG_MAGIC:
+                if len(buf) - i < 16:
+                    break
+                _, version, hz, base = struct.unpack_from("<IIII", buf, i)
+                if version != LOG_VERSION:
+                    lines.append("# stream version %d, this decoder reads version %d" % (version, LOG_VERSION))
+                self.hz = hz
+                self.relocation = (self.elf.log_addr - base) & 0xFFFFFFFF
+                self.time = None
+                lines.append("# log started, %d Hz timestamps" % hz)
+                i += 16
+                continue
+
+            count = (first >> 16) & 0xFF
+            fid = first & 0xFFFF
+            fmt = None if fid == LOG_ID_DROPPED else self.elf.format_at(fid)
+            if first >> 24 != LOG_SYNC or count > LOG_MAX_ARGS or (fmt is None and fid != LOG_ID_DROPPED):
+                i += 1  # not a record, look for the next one a byte further on
+                self.skipped += 1
+                continue
+
+            length = 4 * (count + 2)
+            if len(buf) - i < length:
+                break
+            words = struct.unpack_from("<%dI" % (count + 2), buf, i)
+            i += length
+
+            if self.skipped:
+                lines.append("# skipped %d bytes" % self.skipped)
+                self.skipped = 0
+
+            stamp = self.timestamp(words[1])
+            if fid == LOG_ID_DROPPED:
+                lines.append("[%s] # %d messages dropped, the log ring was full" % (stamp, words[2]))
+            else:
+                lines.append("[%s] %s" % (stamp, format_message(self.elf, self.relocation, fmt, words[2:])))
+
+        del buf[:i]
+        return lines
+
+
+def open_stream(source, baud):
+    if source in (None, "-"):
+        return sys.stdin.buffer
+    if source.startswith("/dev/") or source.upper().startswith("COM"):
+        try:
+            import serial
+        except ImportError:
+            sys.exit("reading %s needs pyserial (pip install pyserial)" % source)
+        return serial.Serial(source, baud, timeout=None)
+    return open(source, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the EvanRTOS deferred formatting log")
+    parser.add_argument("elf", help="ELF file of the firmware that wrote the log")
+    parser.add_argument("input", nargs="?", help="log dump or serial device (default: read stdin)")
+    parser.add_argument("--baud", type=int, default=115200, help="serial baud rate (default: 115200)")
+    parser.add_argument("--hz", type=int, default=0, help="timestamp rate, if the stream header was missed")
+    args = parser.parse_args()
+
+    decoder = Decoder(Elf(args.elf), args.hz)
+    stream = open_stream(args.input, args.baud)
+
+    try:
+        while True:
+            if hasattr(stream, "in_waiting"):
+                data = stream.read(max(1, stream.in_waiting)) #serial port, returns as soon as something arrives
+            else:
+                data = stream.read1(4096)
+            if not data:
+                break
+            for line in decoder.feed(data):
+                print(line)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
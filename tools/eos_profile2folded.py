@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""
+eos_profile2folded.py
+
+Symbolizes an EvanRTOS sampling profile (the raw bytes of the eos_profile variable, see eos_profile.c) against the
+firmware ELF, and prints it in the folded stack format read by flamegraph.pl and https://www.speedscope.app:
+    task0;EOS_QueuePut;memcpy 42
+
+Each stack starts with the task the samples were taken in, followed by the function (and any functions inlined into
+it, outermost first) holding the sampled PC bucket. Samples taken while another interrupt handler was running are
+under the "isr" task.
+
+Usage:
+    eos_profile2folded.py profile.bin EvanRTOS_CM7.elf [-o profile.folded] [--names names.txt] [--task NAME]
+                          [--lines] [--top N] [--toolchain-prefix arm-none-eabi-]
+
+    flamegraph.pl profile.folded > profile.svg
+
+The optional names file is the one used by eos_trace2json.py, only its "task" lines are used:
+    task 1 task0
+"""
+
+import argparse
+import collections
+import shutil
+import struct
+import subprocess
+import sys
+
+PROFILE_MAGIC = 0x50534F45
+HEADER = struct.Struct("<IHHIIIIII")
+ENTRY = struct.Struct("<IBBH")
+
+PROFILE_ISR = 0xFF
+
+
+def read_profile(data):
+    """Returns (header dict, list of (pc, task, count))."""
+    if len(data) < HEADER.size:
+        sys.exit("dump is too short to hold a profile header")
+
+    magic, version, entry_size, capacity, sample_hz, samples, dropped, pc_shift, anchor = HEADER.unpack_from(data, 0)
+    if magic != PROFILE_MAGIC:
+        sys.exit("bad magic 0x%08x, is this a dump of eos_profile?" % magic)
+    if entry_size != ENTRY.size:
+        sys.exit("unsupported entry size %d (version %d)" % (entry_size, version))
+    if len(data) < HEADER.size + capacity * entry_size:
+        sys.exit("dump is truncated, expected %d entries" % capacity)
+
+    entries = []
+    for i in range(capacity):
+        pc, task, _, count = ENTRY.unpack_from(data, HEADER.size + i * entry_size)
+        if pc != 0 and count != 0:
+            entries.append((pc, task, count))
+
+    header = {"sample_hz": sample_hz, "samples": samples, "dropped": dropped, "pc_shift": pc_shift, "anchor": anchor}
+    return header, entries
+
+
+def load_task_names(path):
+    names = {}
+    if path is None:
+        return names
+    with open(path) as f:
+        for line in f:
+            parts = line.split(None, 2)
+            if len(parts) == 3 and parts[0] == "task":
+                names[int(parts[1], 0)] = parts[2].strip()
+    return names
+
+
+def task_name(names, task):
+    if task == PROFILE_ISR:
+        return "isr"
+    return names.get(task, "idle" if task == 0 else "task %d" % task)
+
+
+def find_tool(prefix, name):
+    for candidate in ([prefix + name] if prefix else []) + ["arm-none-eabi-" + name, name]:
+        if shutil.which(candidate):
+            return candidate
+    sys.exit("could not find %s, set --toolchain-prefix" % name)
+
+
+def load_offset(nm, elf, anchor):
+    """Returns the amount to add to a sampled PC to get its ELF address. This is only non zero for position
+    independent builds (the POSIX host port), where the image is loaded at a random address."""
+    if anchor == 0:
+        return 0
+    output = subprocess.run([nm, elf], capture_output=True, text=True, check=True).stdout
+    for line in output.splitlines():
+        parts = line.split()
+        if len(parts) == 3 and parts[2] == "EOS_ProfileSample":
+            return (int(parts[0], 16) - anchor) & 0xFFFFFFFF
+    print("note: EOS_ProfileSample not found in the ELF, PCs are not relocated", file=sys.stderr)
+    return 0
+
+
+def symbolize(addr2line, elf, addresses, with_lines):
+    """Returns {address: [frame, ...]} with inlined frames outermost first."""
+    frames = {}
+    if not addresses:
+        return frames
+
+    args = [addr2line, "-e", elf, "-f", "-i", "-a", "-C"]
+    output = subprocess.run(args + ["0x%x" % a for a in addresses], capture_output=True, text=True,
+                            check=True).stdout
+
+    current = None
+    pending = None
+    for line in output.splitlines():
+        if line.startswith("0x") and pending is None:
+            current = int(line, 16)
+            frames[current] = []
+            continue
+        if pending is None:
+            pending = line
+            continue
+        function, location = pending, line
+        pending = None
+        if function == "??":
+            continue
+        if with_lines and location and not location.startswith("??"):
+            function = "%s (%s)" % (function, location.rsplit("/", 1)[-1].split(" ")[0])
+        frames[current].insert(0, function)
+
+    return frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Symbolize an EvanRTOS sampling profile into folded stacks")
+    parser.add_argument("dump", help="binary dump of the eos_profile variable")
+    parser.add_argument("elf", help="firmware ELF the profile was taken from (e.g. EvanRTOS_CM7.elf)")
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    parser.add_argument("--names", help="file mapping task ids to names")
+    parser.add_argument("--task", help="only output samples of this task (name or id)")
+    parser.add_argument("--lines", action="store_true", help="add file:line to the innermost frame")
+    parser.add_argument("--top", type=int, default=0, help="also print the N hottest functions per task to stderr")
+    parser.add_argument("--toolchain-prefix", default="", help="prefix of addr2line/nm (default: arm-none-eabi- "
+                        "if installed, otherwise the host tools)")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        header, entries = read_profile(f.read())
+
+    names = load_task_names(args.names)
+    addr2line = find_tool(args.toolchain_prefix, "addr2line")
+    nm = find_tool(args.toolchain_prefix, "nm")
+
+    offset = load_offset(nm, args.elf, header["anchor"])
+    addresses = sorted({(pc + offset) & 0xFFFFFFFF for pc, _, _ in entries})
+    frames = symbolize(addr2line, args.elf, addresses, args.lines)
+
+    folded = collections.Counter()
+    per_task = collections.defaultdict(collections.Counter)
+    for pc, task, count in entries:
+        label = task_name(names, task)
+        if args.task is not None and args.task not in (label, str(task)):
+            continue
+        stack = frames.get((pc + offset) & 0xFFFFFFFF) or ["[0x%x]" % pc]
+        folded[";".join([label] + stack)] += count
+        per_task[label][stack[-1]] += count
+
+    lines = ["%s %d" % (stack, count) for stack, count in sorted(folded.items())]
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write("\n".join(lines) + "\n")
+    else:
+        print("\n".join(lines))
+
+    hz = header["sample_hz"]
+    print("%d samples at %d Hz (%.1f s), %d dropped" % (header["samples"], hz, header["samples"] / hz if hz else 0,
+                                                        header["dropped"]), file=sys.stderr)
+    if header["dropped"]:
+        print("note: samples were dropped, increase EOS_PROFILE_ENTRIES or EOS_PROFILE_PC_SHIFT", file=sys.stderr)
+
+    if args.top:
+        for label in sorted(per_task):
+            total = sum(per_task[label].values())
+            print("%s: %d samples" % (label, total), file=sys.stderr)
+            for function, count in per_task[label].most_common(args.top):
+                print("  %6.2f%%  %s" % (100.0 * count / total, function), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
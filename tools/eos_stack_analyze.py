@@ -0,0 +1,273 @@
+#!/usr/bin/env python3
+"""
+eos_stack_analyze.py
+
+Static worst case stack analysis for EvanRTOS tasks. Combines the per function stack usage GCC writes with
+-fstack-usage (.su files) with the call graph disassembled from the firmware ELF, and adds the context frame the kernel
+saves on a task stack when it switches the task out:
+    17 words for a task created with EOS_NO_FPU (EOS_InitStack), 51 words with EOS_USE_FPU (EOS_InitFpuStack)
+This frame includes the hardware exception frame, so it also covers an interrupt taken at the deepest point of the
+task. Interrupt handlers run on the main stack (MSP), and nest there, so they are reported separately.
+
+Task functions are found in the C sources, as the first argument of each EOS_ThreadNew() call, along with the stack
+size and FPU flag passed to it. Extra tasks can be given with --task.
+
+Usage:
+    eos_stack_analyze.py EvanRTOS_CM7.elf Debug/ --src Core/Src [--header eos_stack_sizes.h] [--margin 16]
+                         [--task name[:fpu]] [--isr-nesting 3] [--toolchain-prefix arm-none-eabi-]
+
+Build with -fstack-usage first (STM32CubeIDE: Properties, C/C++ Build, Settings, MCU GCC Compiler, Debugging,
+"Generate per function stack usage information"). The .su arguments are files or directories searched recursively.
+
+Functions with no .su entry (assembly, precompiled libraries) count as 0 bytes and are listed, as are indirect calls
+(function pointers), recursion and dynamically sized frames: the result is only an upper bound when none are
+reported for a task.
+"""
+
+import argparse
+import collections
+import math
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+FRAME_WORDS = 17
+FPU_FRAME_WORDS = 51
+FPU_EXCEPTION_FRAME_WORDS = 26
+WORD = 4
+
+SU_LINE = re.compile(r"^(.*):(\d+):(\d+):(.+)\t(\d+)\t(\S+)$")
+FUNCTION_LABEL = re.compile(r"^[0-9a-f]+ <(.+)>:$")
+DIRECT_TARGET = re.compile(r"^[0-9a-f]+ <([^+>]+)>$")
+THREAD_NEW = re.compile(r"EOS_ThreadNew\s*\(\s*(\w+)\s*,\s*([^,]+?)\s*,\s*([^,]+?)\s*,\s*([^,]+?)\s*,\s*(\w+)\s*\)")
+HANDLER = re.compile(r".*_(IRQ)?Handler$")
+
+
+def find_tool(prefix, name):
+    candidates = [prefix + name] if prefix is not None else ["arm-none-eabi-" + name, name]
+    for candidate in candidates:
+        if shutil.which(candidate):
+            return candidate
+    sys.exit("could not find %s, set --toolchain-prefix" % name)
+
+
+def read_stack_usage(paths):
+    """Returns {function: (bytes, qualifier)}. Static functions with the same name keep the largest frame."""
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, names in os.walk(path):
+                files += [os.path.join(root, n) for n in names if n.endswith(".su")]
+        else:
+            files.append(path)
+    if not files:
+        sys.exit("no .su files found, was the firmware built with -fstack-usage?")
+
+    usage = {}
+    for path in files:
+        with open(path) as f:
+            for line in f:
+                match = SU_LINE.match(line.rstrip("\n"))
+                if match is None:
+                    continue
+                name = match.group(4).split()[-1].split("(")[0] # C++ lines hold a full signature
+                size = int(match.group(5))
+                if name not in usage or size > usage[name][0]:
+                    usage[name] = (size, match.group(6))
+    return usage
+
+
+def read_call_graph(objdump, elf):
+    """Returns ({function: set of direct callees}, {function: number of indirect calls})."""
+    output = subprocess.run([objdump, "-d", "--no-show-raw-insn", elf], capture_output=True, text=True,
+                            check=True).stdout
+    calls = collections.defaultdict(set)
+    indirect = collections.Counter()
+    current = None
+
+    for line in output.splitlines():
+        label = FUNCTION_LABEL.match(line)
+        if label:
+            current = label.group(1).split("@")[0]
+            calls[current]
+            continue
+        if current is None or ":" not in line:
+            continue
+
+        fields = line.split(":", 1)[1].split(None, 1)
+        if not fields:
+            continue
+        mnemonic = fields[0]
+        operands = fields[1].split(";")[0].split("#")[0].strip() if len(fields) > 1 else ""
+
+        is_call = mnemonic.startswith(("bl", "call"))
+        is_branch = mnemonic.startswith(("b", "j")) and not mnemonic.startswith("bic")
+        if not (is_call or is_branch):
+            continue
+
+        target = DIRECT_TARGET.match(operands)
+        if target:
+            callee = target.group(1).split("@")[0]
+            if callee != current:
+                calls[current].add(callee)
+        elif is_call and (operands.startswith("*") or re.match(r"^(r\d+|ip|lr)$", operands)):
+            indirect[current] += 1 # blx rN, call *%rax
+    return calls, indirect
+
+
+class Analysis:
+    def __init__(self, usage, calls, indirect):
+        self.usage = usage
+        self.calls = calls
+        self.indirect = indirect
+        self.memo = {}
+        self.active = set()
+
+    def worst(self, function):
+        """Returns (bytes, path, notes) for the deepest call path starting at function."""
+        if function in self.memo:
+            return self.memo[function]
+        if function in self.active:
+            return 0, [function], {"recursion through %s" % function}
+
+        self.active.add(function)
+        own, qualifier = self.usage.get(function, (0, None))
+        notes = set()
+        if qualifier is None and function in self.calls:
+            notes.add("no stack usage for %s" % function)
+        elif qualifier is not None and qualifier.startswith("dynamic"):
+            notes.add("%s frame in %s" % (qualifier, function))
+        if self.indirect.get(function):
+            notes.add("indirect call in %s" % function)
+
+        best = (0, [], set())
+        for callee in sorted(self.calls.get(function, ())):
+            result = self.worst(callee)
+            notes |= result[2]
+            if result[0] > best[0] or not best[1]:
+                best = result
+        self.active.discard(function)
+
+        result = (own + best[0], [function] + best[1], notes)
+        if not any(note.startswith("recursion") for note in notes):
+            self.memo[function] = result
+        return result
+
+
+def read_sources(paths):
+    """Returns the text of every .c/.h file under paths."""
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, names in os.walk(path):
+                files += [os.path.join(root, n) for n in names if n.endswith((".c", ".h"))]
+        else:
+            files.append(path)
+
+    texts = []
+    for path in files:
+        with open(path, errors="replace") as f:
+            texts.append(f.read())
+    return texts
+
+
+def resolve(expression, texts):
+    """Evaluates a stack size argument: a number, or a name assigned or #defined to one in the sources."""
+    expression = expression.strip("() ")
+    if re.match(r"^\d+$", expression):
+        return int(expression)
+    for text in texts:
+        match = re.search(r"(?:#define\s+%s\s+\(?|\b%s\s*=\s*)(\d+)" % (re.escape(expression), re.escape(expression)),
+                          text)
+        if match:
+            return int(match.group(1))
+    return None
+
+
+def find_tasks(texts):
+    tasks = collections.OrderedDict()
+    for text in texts:
+        for match in THREAD_NEW.finditer(text):
+            function, _, _, size, fpu = match.groups()
+            if function in ("function", "NULL"): # the definition of EOS_ThreadNew() itself
+                continue
+            tasks[function] = (fpu == "EOS_USE_FPU", resolve(size, texts))
+    return tasks
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Worst case stack of each EvanRTOS task")
+    parser.add_argument("elf", help="firmware ELF file")
+    parser.add_argument("su", nargs="+", help=".su files, or directories holding them")
+    parser.add_argument("--src", action="append", default=[], help="source directory to find EOS_ThreadNew() calls in")
+    parser.add_argument("--task", action="append", default=[], help="extra task function, name or name:fpu")
+    parser.add_argument("--margin", type=int, default=16, help="words added to each recommended size (default: 16)")
+    parser.add_argument("--isr-nesting", type=int, default=3, help="interrupt levels that can nest on the main "
+                        "stack (default: 3)")
+    parser.add_argument("--header", help="write the recommended sizes to this C header")
+    parser.add_argument("--toolchain-prefix", default=None, help="prefix of objdump (default: arm-none-eabi- if "
+                        "installed, otherwise none)")
+    args = parser.parse_args()
+
+    usage = read_stack_usage(args.su)
+    calls, indirect = read_call_graph(find_tool(args.toolchain_prefix, "objdump"), args.elf)
+    analysis = Analysis(usage, calls, indirect)
+
+    texts = read_sources(args.src)
+    tasks = find_tasks(texts)
+    for extra in args.task:
+        name, _, flag = extra.partition(":")
+        tasks[name] = (flag == "fpu", None)
+    if not tasks:
+        sys.exit("no tasks found, give the sources with --src or the task functions with --task")
+
+    print("%-22s %4s %8s %8s %10s %9s %9s  %s" % ("TASK", "FPU", "PATH B", "FRAME B", "NEED WORDS", "DECLARED",
+                                                 "RECOMMEND", "DEEPEST PATH"))
+    recommended = collections.OrderedDict()
+    all_notes = collections.OrderedDict()
+
+    for function, (fpu, declared) in tasks.items():
+        if function not in calls and function not in usage:
+            print("%-22s not in the ELF file (not built?)" % function)
+            continue
+        path_bytes, path, notes = analysis.worst(function)
+        frame = (FPU_FRAME_WORDS if fpu else FRAME_WORDS) * WORD
+        need = int(math.ceil((path_bytes + frame) / WORD))
+        recommend = (need + args.margin + 7) // 8 * 8 # whole 32 byte blocks, which also suits the MPU stack guard
+        recommended[function] = recommend
+        all_notes[function] = notes
+
+        print("%-22s %4s %8d %8d %10d %9s %9d  %s" % (function, "yes" if fpu else "no", path_bytes, frame, need,
+                                                    declared if declared is not None else "?", recommend,
+                                                    " > ".join(path)))
+
+    handlers = [name for name in calls if HANDLER.match(name)]
+    if handlers:
+        worst = sorted(((analysis.worst(name)[0], name) for name in handlers), reverse=True)[:args.isr_nesting]
+        frames = max(0, len(worst) - 1) * FPU_EXCEPTION_FRAME_WORDS * WORD
+        total = sum(size for size, _ in worst) + frames
+        print("\nmain stack (MSP), %d nested interrupts: %d bytes (%s, plus %d bytes of nested exception frames)" %
+              (len(worst), total, ", ".join("%s %d" % (name, size) for size, name in worst), frames))
+
+    for function, notes in all_notes.items():
+        for note in sorted(notes):
+            print("warning: %s: %s" % (function, note))
+
+    if args.header:
+        guard = "INC_" + re.sub(r"\W", "_", os.path.basename(args.header)).upper() + "_"
+        with open(args.header, "w") as f:
+            f.write("/*\n * %s\n *\n *      Generated by tools/eos_stack_analyze.py from %s, do not edit. Stack sizes "
+                    "in words, for EOS_ThreadNew(),\n *      including a margin of %d words.\n */\n\n" %
+                    (os.path.basename(args.header), os.path.basename(args.elf), args.margin))
+            f.write("#ifndef %s\n#define %s\n\n" % (guard, guard))
+            for function, words in recommended.items():
+                f.write("#define EOS_STACK_WORDS_%s %d%s\n" % (function, words,
+                                                             "  /* not an upper bound, see the analyzer warnings */"
+                                                             if all_notes[function] else ""))
+            f.write("\n#endif /* %s */\n" % guard)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+eos_top.py
+
+Shows the CSV stream of the EvanRTOS monitor task (see eos_monitor.c) as a live, top style table:
+
+     ID NAME          STATE    PRI   CPU%  SWITCHES  STACK        WAITING ON
+      1 task0         delayed    3    0.4       523   96/128  75%
+      2 task1         blocked    2    0.0        12   40/128  31%  0x200004c0
+
+Usage:
+    eos_top.py [/dev/ttyACM0] [--baud 115200] [--names names.txt] [--once]
+
+Without a device, the stream is read from stdin, so it also works with the host demo:
+    ./eos_demo 60 2>&1 >/dev/null | tools/eos_top.py
+
+Reading a serial device needs pyserial. The optional names file is the one used by eos_trace2json.py, only its "task"
+lines are used:
+    task 1 task0
+"""
+
+import argparse
+import sys
+
+STATES = {"R": "running", "r": "ready", "B": "blocked", "D": "delayed", "P": "paused"}
+FIELDS = ["seq", "id", "state", "priority", "cpu", "switches", "stack_used", "stack_size", "object"]
+
+
+def load_task_names(path):
+    names = {}
+    if path is None:
+        return names
+    with open(path) as f:
+        for line in f:
+            parts = line.split(None, 2)
+            if len(parts) == 3 and parts[0] == "task":
+                names[int(parts[1], 0)] = parts[2].strip()
+    return names
+
+
+def open_stream(device, baud):
+    if device is None:
+        return sys.stdin
+    try:
+        import serial
+    except ImportError:
+        sys.exit("reading %s needs pyserial (pip install pyserial)" % device)
+    port = serial.Serial(device, baud, timeout=None)
+    return (line.decode("ascii", "replace") for line in iter(port.readline, b""))
+
+
+def parse(line):
+    parts = line.strip().split(",")
+    if len(parts) != len(FIELDS) or parts[0] == "seq":
+        return None
+    try:
+        row = dict(zip(FIELDS, [int(parts[0]), int(parts[1]), parts[2]] + [int(p) for p in parts[3:8]] +
+                       [int(parts[8], 16)]))
+    except ValueError:
+        return None
+    return row
+
+
+def render(rows, names, clear):
+    out = []
+    if clear:
+        out.append("\x1b[H\x1b[2J")
+    busy = sum(row["cpu"] for row in rows if row["id"] != 0) / 10.0
+    out.append("EvanRTOS  snapshot %d  tasks %d  cpu %.1f%%\n\n" % (rows[0]["seq"], len(rows), busy))
+    out.append("%4s %-13s %-8s %4s %6s %9s %12s  %s\n" % ("ID", "NAME", "STATE", "PRI", "CPU%", "SWITCHES", "STACK",
+                                                       "WAITING ON"))
+    for row in sorted(rows, key=lambda r: (-r["cpu"], r["id"])):
+        name = names.get(row["id"], "idle" if row["id"] == 0 else "task %d" % row["id"])
+        if row["stack_used"]:
+            stack = "%d/%d %3d%%" % (row["stack_used"], row["stack_size"], 100 * row["stack_used"] // row["stack_size"])
+        else:
+            stack = "-/%d" % row["stack_size"]
+        waiting = "0x%08x" % row["object"] if row["state"] == "B" else ""
+        out.append("%4d %-13s %-8s %4d %6.1f %9d %12s  %s\n" % (row["id"], name[:13], STATES.get(row["state"], "?"),
+                                                              row["priority"], row["cpu"] / 10.0, row["switches"],
+                                                              stack, waiting))
+    sys.stdout.write("".join(out))
+    sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Live view of the EvanRTOS monitor stream")
+    parser.add_argument("device", nargs="?", help="serial device (default: read stdin)")
+    parser.add_argument("--baud", type=int, default=115200, help="serial baud rate (default: 115200)")
+    parser.add_argument("--names", help="file mapping task ids to names")
+    parser.add_argument("--once", action="store_true", help="print the first complete snapshot and exit")
+    args = parser.parse_args()
+
+    names = load_task_names(args.names)
+    clear = sys.stdout.isatty() and not args.once
+    rows = []
+
+    try:
+        for line in open_stream(args.device, args.baud):
+            row = parse(line)
+            if row is None:
+                continue
+            if rows and row["seq"] != rows[0]["seq"]:
+                render(rows, names, clear)
+                if args.once:
+                    return
+                rows = []
+            rows.append(row)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+eos_trace2json.py
+
+Converts an EvanRTOS trace dump (the raw bytes of the eos_trace variable, see eos_trace.c) into Chrome trace event
+JSON, which can be opened in chrome://tracing or https://ui.perfetto.dev.
+
+Usage:
+    eos_trace2json.py trace.bin [-o trace.json] [--names names.txt]
+
+The optional names file maps task ids, isr ids and object addresses to readable names, one per line:
+    task 1 task0
+    isr 3 USART1
+    object 0x24000a10 queue1
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x54534F45
+HEADER = struct.Struct("<IHHIIII")
+RECORD = struct.Struct("<BBHI")
+
+EVT_TIME = 0
+EVT_TASK_IN = 1
+EVT_TASK_OUT = 2
+EVT_BLOCK = 3
+EVT_UNBLOCK = 4
+EVT_QUEUE_PUT = 5
+EVT_QUEUE_GET = 6
+EVT_SEM_ACQUIRE = 7
+EVT_SEM_RELEASE = 8
+EVT_ISR_ENTER = 9
+EVT_ISR_EXIT = 10
+
+EOS_TIMED_OUT = 2
+
+INSTANT_NAMES = {
+    EVT_BLOCK: "block",
+    EVT_UNBLOCK: "unblock",
+    EVT_QUEUE_PUT: "queue put",
+    EVT_QUEUE_GET: "queue get",
+    EVT_SEM_ACQUIRE: "semaphore acquire",
+    EVT_SEM_RELEASE: "semaphore release",
+}
+
+ISR_TID_BASE = 1000
+
+
+def read_records(data):
+    """Returns (ts_hz, records) with records in the order they were written."""
+    if len(data) < HEADER.size:
+        sys.exit("dump is too short to hold a trace header")
+
+    magic, version, record_size, capacity, head, written, ts_hz = HEADER.unpack_from(data, 0)
+    if magic != TRACE_MAGIC:
+        sys.exit("bad magic 0x%08x, is this a dump of eos_trace?" % magic)
+    if record_size != RECORD.size:
+        sys.exit("unsupported record size %d (version %d)" % (record_size, version))
+    if len(data) < HEADER.size + capacity * record_size:
+        sys.exit("dump is truncated, expected %d records" % capacity)
+
+    raw = [RECORD.unpack_from(data, HEADER.size + i * record_size) for i in range(capacity)]
+
+    if written <= capacity:
+        ordered = raw[:written]
+    else:
+        ordered = raw[head:] + raw[:head]
+
+    return ts_hz, ordered, written > capacity
+
+
+def load_names(path):
+    names = {"task": {}, "isr": {}, "object": {}}
+    if path is None:
+        return names
+    with open(path) as f:
+        for line in f:
+            parts = line.split(None, 2)
+            if len(parts) != 3 or parts[0] not in names:
+                continue
+            names[parts[0]][int(parts[1], 0)] = parts[2].strip()
+    return names
+
+
+def object_name(names, obj, event):
+    if event in (EVT_BLOCK, EVT_UNBLOCK) and obj == EOS_TIMED_OUT:
+        return "delay"
+    return names["object"].get(obj, "0x%08x" % obj)
+
+
+def convert(ts_hz, records, names):
+    events = []
+    ts = 0
+    running = None
+    seen_tasks = set()
+    seen_isrs = set()
+
+    def us(t):
+        return t * 1e6 / ts_hz if ts_hz else float(t)
+
+    for event, task, delta, obj in records:
+        if event == EVT_TIME:
+            ts += obj
+            continue
+        ts += delta
+
+        if event == EVT_TASK_IN:
+            seen_tasks.add(task)
+            running = task
+            events.append({"name": "running", "ph": "B", "pid": 0, "tid": task, "ts": us(ts)})
+        elif event == EVT_TASK_OUT:
+            seen_tasks.add(task)
+            if running == task:
+                events.append({"name": "running", "ph": "E", "pid": 0, "tid": task, "ts": us(ts)})
+            running = None
+        elif event == EVT_ISR_ENTER:
+            seen_isrs.add(task)
+            events.append({"name": names["isr"].get(task, "isr %d" % task), "ph": "B", "pid": 0,
+                           "tid": ISR_TID_BASE + task, "ts": us(ts)})
+        elif event == EVT_ISR_EXIT:
+            seen_isrs.add(task)
+            events.append({"name": names["isr"].get(task, "isr %d" % task), "ph": "E", "pid": 0,
+                           "tid": ISR_TID_BASE + task, "ts": us(ts)})
+        elif event in INSTANT_NAMES:
+            seen_tasks.add(task)
+            events.append({"name": INSTANT_NAMES[event], "ph": "i", "s": "t", "pid": 0, "tid": task,
+                           "ts": us(ts), "args": {"object": object_name(names, obj, event)}})
+
+    if running is not None:
+        events.append({"name": "running", "ph": "E", "pid": 0, "tid": running, "ts": us(ts)})
+
+    meta = [{"name": "process_name", "ph": "M", "pid": 0, "args": {"name": "EvanRTOS"}}]
+    for task in sorted(seen_tasks):
+        label = names["task"].get(task, "idle" if task == 0 else "task %d" % task)
+        meta.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": task, "args": {"name": label}})
+    for isr in sorted(seen_isrs):
+        label = names["isr"].get(isr, "isr %d" % isr)
+        meta.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": ISR_TID_BASE + isr, "args": {"name": label}})
+
+    return meta + events
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert an EvanRTOS trace dump to Chrome trace JSON")
+    parser.add_argument("dump", help="binary dump of the eos_trace variable")
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    parser.add_argument("--names", help="file mapping task/isr ids and object addresses to names")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+
+    ts_hz, records, wrapped = read_records(data)
+    if wrapped:
+        print("note: trace buffer wrapped, oldest records were lost", file=sys.stderr)
+
+    trace = {"traceEvents": convert(ts_hz, records, load_names(args.names)), "displayTimeUnit": "ns"}
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f, indent=1)
+    else:
+        json.dump(trace, sys.stdout, indent=1)
+
+
+if __name__ == "__main__":
+    main()